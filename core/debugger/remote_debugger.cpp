@@ -91,6 +91,46 @@ public:
 	}
 };
 
+class RemoteDebugger::MemoryProfiler : public EngineProfiler {
+	uint64_t last_tick_time = 0;
+	uint64_t interval_msec = 1000;
+	uint64_t last_alloc_count[Memory::TAG_MAX] = {};
+
+public:
+	void toggle(bool p_enable, const Array &p_opts) {
+		Memory::set_tracking_enabled(p_enable);
+		if (p_enable) {
+			interval_msec = p_opts.size() > 0 ? MAX(int64_t(p_opts[0]), 1) : 1000;
+			last_tick_time = OS::get_singleton()->get_ticks_msec();
+			for (int i = 0; i < Memory::TAG_MAX; i++) {
+				last_alloc_count[i] = Memory::get_tag_alloc_count(Memory::Tag(i));
+			}
+		}
+	}
+	void add(const Array &p_data) {}
+	void tick(double p_frame_time, double p_process_time, double p_physics_time, double p_physics_frame_time) {
+		uint64_t time = OS::get_singleton()->get_ticks_msec();
+		if (time - last_tick_time < interval_msec) {
+			return;
+		}
+		double elapsed = (time - last_tick_time) / 1000.0;
+		last_tick_time = time;
+
+		// Live bytes and allocation rate for each tag, flattened as [name, bytes, allocations per second].
+		Array arr;
+		arr.resize(Memory::TAG_MAX * 3);
+		for (int i = 0; i < Memory::TAG_MAX; i++) {
+			uint64_t alloc_count = Memory::get_tag_alloc_count(Memory::Tag(i));
+			arr[i * 3 + 0] = Memory::get_tag_name(Memory::Tag(i));
+			arr[i * 3 + 1] = Memory::get_tag_usage(Memory::Tag(i));
+			arr[i * 3 + 2] = (alloc_count - last_alloc_count[i]) / elapsed;
+			last_alloc_count[i] = alloc_count;
+		}
+
+		EngineDebugger::get_singleton()->send_message("memory:profile_frame", arr);
+	}
+};
+
 Error RemoteDebugger::_put_msg(String p_message, Array p_data) {
 	Array msg;
 	msg.push_back(p_message);
@@ -653,6 +693,10 @@ RemoteDebugger::RemoteDebugger(Ref<RemoteDebuggerPeer> p_peer) {
 		profiler_enable("performance", true);
 	}
 
+	// Memory Profiler (tagged allocations, only tracked in debug builds).
+	memory_profiler.instantiate();
+	memory_profiler->bind("memory");
+
 	// Core and profiler captures.
 	Capture core_cap(this,
 			[](void *p_user, const String &p_cmd, const Array &p_data, bool &r_captured) {
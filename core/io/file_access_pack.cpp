@@ -30,14 +30,18 @@
 
 #include "file_access_pack.h"
 
+#include "core/io/compression.h"
 #include "core/io/file_access_encrypted.h"
+#include "core/io/marshalls.h"
 #include "core/object/script_language.h"
+#include "core/object/worker_thread_pool.h"
 #include "core/os/os.h"
 #include "core/version.h"
 
 #include <stdio.h>
 
 Error PackedData::add_pack(const String &p_path, bool p_replace_files, uint64_t p_offset) {
+	pack_count++;
 	for (int i = 0; i < sources.size(); i++) {
 		if (sources[i]->try_open_pack(p_path, p_replace_files, p_offset)) {
 			return OK;
@@ -49,9 +53,17 @@ Error PackedData::add_pack(const String &p_path, bool p_replace_files, uint64_t
 
 void PackedData::add_path(const String &p_pkg_path, const String &p_path, uint64_t p_ofs, uint64_t p_size, const uint8_t *p_md5, PackSource *p_src, bool p_replace_files, bool p_encrypted) {
 	String simplified_path = p_path.simplify_path();
-	PathMD5 pmd5(simplified_path.md5_buffer());
+	Vector<uint8_t> path_md5 = simplified_path.md5_buffer();
+	PathMD5 pmd5(path_md5);
 
 	bool exists = files.has(pmd5);
+	bool exists_in_index = false;
+	for (const PackIndex *index : indexes) {
+		if (index->find(path_md5.ptr()) >= 0) {
+			exists_in_index = true;
+			break;
+		}
+	}
 
 	PackedFile pf;
 	pf.encrypted = p_encrypted;
@@ -62,38 +74,152 @@ void PackedData::add_path(const String &p_pkg_path, const String &p_path, uint64
 		pf.md5[i] = p_md5[i];
 	}
 	pf.src = p_src;
+	pf.pack_index = pack_count;
 
-	if (!exists || p_replace_files) {
+	if ((!exists && !exists_in_index) || p_replace_files) {
 		files[pmd5] = pf;
 	}
 
 	if (!exists) {
-		//search for dir
-		String p = simplified_path.replace_first("res://", "");
-		PackedDir *cd = root;
-
-		if (p.contains("/")) { //in a subdir
-
-			Vector<String> ds = p.get_base_dir().split("/");
-
-			for (int j = 0; j < ds.size(); j++) {
-				if (!cd->subdirs.has(ds[j])) {
-					PackedDir *pd = memnew(PackedDir);
-					pd->name = ds[j];
-					pd->parent = cd;
-					cd->subdirs[pd->name] = pd;
-					cd = pd;
-				} else {
-					cd = cd->subdirs[ds[j]];
-				}
+		MutexLock lock(dirs_mutex);
+		_add_dir_path(simplified_path);
+	}
+}
+
+void PackedData::_add_dir_path(const String &p_simplified_path) {
+	//search for dir
+	String p = p_simplified_path.replace_first("res://", "");
+	PackedDir *cd = root;
+
+	if (p.contains("/")) { //in a subdir
+
+		Vector<String> ds = p.get_base_dir().split("/");
+
+		for (int j = 0; j < ds.size(); j++) {
+			if (!cd->subdirs.has(ds[j])) {
+				PackedDir *pd = memnew(PackedDir);
+				pd->name = ds[j];
+				pd->parent = cd;
+				cd->subdirs[pd->name] = pd;
+				cd = pd;
+			} else {
+				cd = cd->subdirs[ds[j]];
 			}
 		}
-		String filename = simplified_path.get_file();
-		// Don't add as a file if the path points to a directory
-		if (!filename.is_empty()) {
-			cd->files.insert(filename);
+	}
+	String filename = p_simplified_path.get_file();
+	// Don't add as a file if the path points to a directory
+	if (!filename.is_empty()) {
+		cd->files.insert(filename);
+	}
+}
+
+void PackedData::add_index(const String &p_pkg_path, uint64_t p_file_base, uint32_t p_file_count, const Vector<uint8_t> &p_data, PackSource *p_src, bool p_replace_files) {
+	PackIndex *index = memnew(PackIndex);
+	index->pack = p_pkg_path;
+	index->src = p_src;
+	index->file_base = p_file_base;
+	index->replace_files = p_replace_files;
+	index->pack_index = pack_count;
+	index->file_count = p_file_count;
+	index->data = p_data;
+	indexes.push_back(index);
+}
+
+PackedData::PackedDir *PackedData::_get_root() {
+	// Directories of indexed packs are only needed when browsing them, so they are added on first use.
+	MutexLock lock(dirs_mutex);
+	for (PackIndex *index : indexes) {
+		if (index->dirs_added) {
+			continue;
+		}
+		for (uint32_t i = 0; i < index->file_count; i++) {
+			_add_dir_path(index->get_path(i));
 		}
+		index->dirs_added = true;
 	}
+	return root;
+}
+
+bool PackedData::_find_file(const String &p_simplified_path, PackedFile &r_file) const {
+	Vector<uint8_t> path_md5 = p_simplified_path.md5_buffer();
+	HashMap<PathMD5, PackedFile, PathMD5>::ConstIterator E = files.find(PathMD5(path_md5));
+
+	// Like with add_path(), a file comes from the first pack containing it,
+	// unless a later pack containing it too was added with p_replace_files.
+	for (int i = int(indexes.size()) - 1; i >= 0; i--) {
+		const PackIndex *index = indexes[i];
+		if (E && index->pack_index < E->value.pack_index) {
+			break;
+		}
+		if (!index->replace_files) {
+			continue;
+		}
+		int64_t entry = index->find(path_md5.ptr());
+		if (entry >= 0) {
+			index->get_file(entry, r_file);
+			return true;
+		}
+	}
+
+	if (E) {
+		r_file = E->value;
+		return true;
+	}
+
+	for (const PackIndex *index : indexes) {
+		int64_t entry = index->find(path_md5.ptr());
+		if (entry >= 0) {
+			index->get_file(entry, r_file);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+int64_t PackedData::PackIndex::find(const uint8_t *p_path_md5) const {
+	const uint8_t *entries = data.ptr();
+	int64_t low = 0;
+	int64_t high = int64_t(file_count) - 1;
+	while (low <= high) {
+		int64_t middle = (low + high) / 2;
+		int cmp = memcmp(entries + middle * PACK_INDEX_ENTRY_SIZE, p_path_md5, 16);
+		if (cmp == 0) {
+			return middle;
+		} else if (cmp < 0) {
+			low = middle + 1;
+		} else {
+			high = middle - 1;
+		}
+	}
+	return -1;
+}
+
+String PackedData::PackIndex::get_path(uint32_t p_entry) const {
+	const uint8_t *entry = data.ptr() + p_entry * PACK_INDEX_ENTRY_SIZE;
+	const uint64_t strings_ofs = uint64_t(file_count) * PACK_INDEX_ENTRY_SIZE;
+	const uint64_t path_ofs = strings_ofs + decode_uint32(entry + 52);
+	ERR_FAIL_COND_V_MSG(path_ofs >= (uint64_t)data.size(), String(), "Invalid path in pack directory.");
+
+	const char *path = (const char *)data.ptr() + path_ofs;
+	String s;
+	s.parse_utf8(path, strnlen(path, data.size() - path_ofs));
+	return s;
+}
+
+void PackedData::PackIndex::get_file(uint32_t p_entry, PackedFile &r_file) const {
+	const uint8_t *entry = data.ptr() + p_entry * PACK_INDEX_ENTRY_SIZE;
+	const uint32_t flags = decode_uint32(entry + 48);
+
+	r_file.pack = pack;
+	r_file.offset = file_base + decode_uint64(entry + 16);
+	r_file.size = decode_uint64(entry + 24);
+	memcpy(r_file.md5, entry + 32, 16);
+	r_file.src = src;
+	r_file.encrypted = (flags & PACK_FILE_ENCRYPTED);
+	r_file.compressed = (flags & PACK_FILE_COMPRESSED);
+	r_file.pack_index = pack_index;
 }
 
 void PackedData::add_pack_source(PackSource *p_source) {
@@ -105,6 +231,8 @@ void PackedData::add_pack_source(PackSource *p_source) {
 PackedData *PackedData::singleton = nullptr;
 
 PackedData::PackedData() {
+	// A nested instance (like in tests) replaces the singleton until it's deleted.
+	previous_singleton = singleton;
 	singleton = this;
 	root = memnew(PackedDir);
 
@@ -122,7 +250,13 @@ PackedData::~PackedData() {
 	for (int i = 0; i < sources.size(); i++) {
 		memdelete(sources[i]);
 	}
+	for (PackIndex *index : indexes) {
+		memdelete(index);
+	}
 	_free_packed_dirs(root);
+	if (singleton == this) {
+		singleton = previous_singleton;
+	}
 }
 
 //////////////////////////////////////////////////////////////////
@@ -201,7 +335,7 @@ bool PackedSourcePCK::try_open_pack(const String &p_path, bool p_replace_files,
 	uint32_t ver_minor = f->get_32();
 	f->get_32(); // patch number, not used for validation.
 
-	ERR_FAIL_COND_V_MSG(version != PACK_FORMAT_VERSION, false, "Pack version unsupported: " + itos(version) + ".");
+	ERR_FAIL_COND_V_MSG(version < PACK_FORMAT_VERSION_MIN || version > PACK_FORMAT_VERSION, false, "Pack version unsupported: " + itos(version) + ".");
 	ERR_FAIL_COND_V_MSG(ver_major > VERSION_MAJOR || (ver_major == VERSION_MAJOR && ver_minor > VERSION_MINOR), false, "Pack created with a newer version of the engine: " + itos(ver_major) + "." + itos(ver_minor) + ".");
 
 	uint32_t pack_flags = f->get_32();
@@ -215,6 +349,10 @@ bool PackedSourcePCK::try_open_pack(const String &p_path, bool p_replace_files,
 	}
 
 	int file_count = f->get_32();
+	uint32_t strings_size = 0;
+	if (version >= 3) {
+		strings_size = f->get_32();
+	}
 
 	if (enc_directory) {
 		Ref<FileAccessEncrypted> fae;
@@ -232,6 +370,18 @@ bool PackedSourcePCK::try_open_pack(const String &p_path, bool p_replace_files,
 		f = fae;
 	}
 
+	if (version >= 3) {
+		// The whole directory is read at once, and files are looked up in it directly.
+		Vector<uint8_t> index;
+		uint64_t index_size = uint64_t(file_count) * PACK_INDEX_ENTRY_SIZE + strings_size;
+		ERR_FAIL_COND_V_MSG(file_count < 0 || index_size > f->get_length(), false, "Invalid pack directory.");
+		index.resize(index_size);
+		ERR_FAIL_COND_V_MSG(f->get_buffer(index.ptrw(), index_size) != index_size, false, "Can't read pack directory.");
+
+		PackedData::get_singleton()->add_index(p_path, file_base + p_offset, file_count, index, this, p_replace_files);
+		return true;
+	}
+
 	for (int i = 0; i < file_count; i++) {
 		uint32_t sl = f->get_32();
 		CharString cs;
@@ -282,7 +432,9 @@ void FileAccessPack::seek(uint64_t p_position) {
 		eof = false;
 	}
 
-	f->seek(off + p_position);
+	if (!pf.compressed) {
+		f->seek(off + p_position);
+	}
 	pos = p_position;
 }
 
@@ -309,10 +461,77 @@ uint8_t FileAccessPack::get_8() const {
 		return 0;
 	}
 
+	if (pf.compressed) {
+		const uint32_t block = pos / block_size;
+		if (block >= cache_block && block < cache_block + cache_block_count) {
+			// Already decompressed, as is the case for most bytes read one by one.
+			return cache[pos++ - (uint64_t)cache_block * block_size];
+		}
+		uint8_t byte = 0;
+		get_buffer(&byte, 1);
+		return byte;
+	}
+
 	pos++;
 	return f->get_8();
 }
 
+void FileAccessPack::_decompress_block(uint32_t p_index, ReadBlocks *p_read) const {
+	const uint32_t block = p_read->first + p_index;
+	const uint8_t *src = read_buffer.ptr() + (block_offsets[block] - block_offsets[p_read->first]);
+	const uint64_t src_size = block_offsets[block + 1] - block_offsets[block];
+	const uint64_t length = _get_block_length(block);
+	uint8_t *dst = cache.ptr() + (uint64_t)p_index * block_size;
+
+	// Blocks which don't get smaller are stored as they are.
+	if (src_size == length) {
+		memcpy(dst, src, length);
+	} else if (Compression::decompress(dst, length, src, src_size, Compression::MODE_ZSTD) != (int)length) {
+		p_read->failed.set();
+	}
+}
+
+bool FileAccessPack::_read_blocks(uint32_t p_block, uint32_t p_count) const {
+	const uint32_t block_count = block_offsets.size() - 1;
+
+	// Read further ahead as long as the file is read sequentially.
+	if (cache_block_count > 0 && p_block == cache_block + cache_block_count) {
+		read_ahead = MIN(read_ahead * 2, (uint32_t)PACK_COMPRESSED_READ_BLOCKS);
+	} else {
+		read_ahead = 1;
+	}
+	const uint32_t count = MIN(MIN(MAX(p_count, read_ahead), (uint32_t)PACK_COMPRESSED_READ_BLOCKS), block_count - p_block);
+
+	// All compressed blocks are next to each other, so they are read at once.
+	const uint64_t read_size = block_offsets[p_block + count] - block_offsets[p_block];
+	read_buffer.resize(read_size);
+	cache.resize((uint64_t)count * block_size);
+	cache_block_count = 0;
+
+	f->seek(off + block_offsets[p_block]);
+	if (f->get_buffer(read_buffer.ptr(), read_size) != read_size) {
+		ERR_FAIL_V_MSG(false, "Can't read compressed pack-referenced file '" + String(pf.pack) + "'.");
+	}
+
+	ReadBlocks read;
+	read.first = p_block;
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	// Waiting from a pool thread could use up the threads needed to finish the work.
+	if (count > 1 && pool && pool->get_thread_index() == -1) {
+		WorkerThreadPool::GroupID group_task = pool->add_template_group_task(this, &FileAccessPack::_decompress_block, &read, count, -1, true, SNAME("DecompressPackBlocks"));
+		pool->wait_for_group_task_completion(group_task);
+	} else {
+		for (uint32_t i = 0; i < count; i++) {
+			_decompress_block(i, &read);
+		}
+	}
+	ERR_FAIL_COND_V_MSG(read.failed.is_set(), false, "Can't decompress pack-referenced file '" + String(pf.pack) + "'.");
+
+	cache_block = p_block;
+	cache_block_count = count;
+	return true;
+}
+
 uint64_t FileAccessPack::get_buffer(uint8_t *p_dst, uint64_t p_length) const {
 	ERR_FAIL_COND_V_MSG(f.is_null(), -1, "File must be opened before use.");
 	ERR_FAIL_COND_V(!p_dst && p_length > 0, -1);
@@ -327,14 +546,37 @@ uint64_t FileAccessPack::get_buffer(uint8_t *p_dst, uint64_t p_length) const {
 		to_read = (int64_t)pf.size - (int64_t)pos;
 	}
 
-	pos += p_length;
-
 	if (to_read <= 0) {
+		pos += p_length;
 		return 0;
 	}
-	f->get_buffer(p_dst, to_read);
 
-	return to_read;
+	if (!pf.compressed) {
+		pos += p_length;
+		f->get_buffer(p_dst, to_read);
+		return to_read;
+	}
+
+	uint64_t done = 0;
+	while (done < (uint64_t)to_read) {
+		const uint64_t read_pos = pos + done;
+		const uint32_t block = read_pos / block_size;
+		if (block < cache_block || block >= cache_block + cache_block_count) {
+			const uint32_t last_block = (pos + to_read - 1) / block_size;
+			if (!_read_blocks(block, last_block - block + 1)) {
+				break;
+			}
+		}
+
+		const uint64_t cache_pos = read_pos - (uint64_t)cache_block * block_size;
+		const uint64_t cache_length = (uint64_t)(cache_block_count - 1) * block_size + _get_block_length(cache_block + cache_block_count - 1);
+		const uint64_t length = MIN((uint64_t)to_read - done, cache_length - cache_pos);
+		memcpy(p_dst + done, cache.ptr() + cache_pos, length);
+		done += length;
+	}
+
+	pos += p_length;
+	return done;
 }
 
 void FileAccessPack::set_big_endian(bool p_big_endian) {
@@ -391,12 +633,44 @@ FileAccessPack::FileAccessPack(const String &p_path, const PackedData::PackedFil
 		}
 
 		Error err = fae->open_and_parse(f, key, FileAccessEncrypted::MODE_READ, false);
-		ERR_FAIL_COND_MSG(err, "Can't open encrypted pack-referenced file '" + String(pf.pack) + "'.");
+		if (err) {
+			f = Ref<FileAccess>(); // Leave the file closed, so it's never read.
+			ERR_FAIL_MSG("Can't open encrypted pack-referenced file '" + String(pf.pack) + "'.");
+		}
 		f = fae;
 		off = 0;
 	}
 	pos = 0;
 	eof = false;
+
+	if (pf.compressed) {
+		// Block size, then the compressed size of each block, then the blocks.
+		f->seek(off);
+		block_size = f->get_32();
+		if (block_size == 0) {
+			f = Ref<FileAccess>();
+			ERR_FAIL_MSG("Invalid compressed pack-referenced file '" + String(pf.pack) + "'.");
+		}
+
+		const uint32_t block_count = (pf.size + block_size - 1) / block_size;
+		LocalVector<uint8_t> block_sizes;
+		block_sizes.resize((uint64_t)block_count * 4);
+		if (f->get_buffer(block_sizes.ptr(), block_sizes.size()) != block_sizes.size()) {
+			f = Ref<FileAccess>();
+			ERR_FAIL_MSG("Can't read compressed pack-referenced file '" + String(pf.pack) + "'.");
+		}
+
+		block_offsets.resize(block_count + 1);
+		block_offsets[0] = 4 + block_sizes.size();
+		for (uint32_t i = 0; i < block_count; i++) {
+			block_offsets[i + 1] = block_offsets[i] + decode_uint32(&block_sizes[i * 4]);
+		}
+		if (off > f->get_length() || block_offsets[block_count] > f->get_length() - off) {
+			block_offsets.clear();
+			f = Ref<FileAccess>();
+			ERR_FAIL_MSG("Compressed pack-referenced file '" + String(pf.pack) + "' is truncated.");
+		}
+	}
 }
 
 //////////////////////////////////////////////////////////////////////////////////
@@ -485,7 +759,7 @@ PackedData::PackedDir *DirAccessPack::_find_dir(String p_dir) {
 	PackedData::PackedDir *pd;
 
 	if (absolute) {
-		pd = PackedData::get_singleton()->root;
+		pd = PackedData::get_singleton()->_get_root();
 	} else {
 		pd = current;
 	}
@@ -568,5 +842,5 @@ String DirAccessPack::get_filesystem_type() const {
 }
 
 DirAccessPack::DirAccessPack() {
-	current = PackedData::get_singleton()->root;
+	current = PackedData::get_singleton()->_get_root();
 }
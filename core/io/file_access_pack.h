@@ -33,22 +33,35 @@
 
 #include "core/io/dir_access.h"
 #include "core/io/file_access.h"
+#include "core/os/mutex.h"
 #include "core/string/print_string.h"
 #include "core/templates/hash_set.h"
 #include "core/templates/list.h"
+#include "core/templates/local_vector.h"
 #include "core/templates/rb_map.h"
+#include "core/templates/safe_refcount.h"
 
 // Godot's packed file magic header ("GDPC" in ASCII).
 #define PACK_HEADER_MAGIC 0x43504447
 // The current packed file format version number.
-#define PACK_FORMAT_VERSION 2
+#define PACK_FORMAT_VERSION 3
+// The oldest packed file format version that can still be loaded.
+#define PACK_FORMAT_VERSION_MIN 2
+
+// Size of a directory entry, since version 3 (path MD5, offset, size, MD5, flags, path offset).
+#define PACK_INDEX_ENTRY_SIZE 56
+// Compressed files are split in blocks of this size, each one can be decompressed on its own.
+#define PACK_COMPRESSED_BLOCK_SIZE 65536
+// Most blocks of a compressed file read (and decompressed in parallel) at once.
+#define PACK_COMPRESSED_READ_BLOCKS 64
 
 enum PackFlags {
 	PACK_DIR_ENCRYPTED = 1 << 0
 };
 
 enum PackFileFlags {
-	PACK_FILE_ENCRYPTED = 1 << 0
+	PACK_FILE_ENCRYPTED = 1 << 0,
+	PACK_FILE_COMPRESSED = 1 << 1,
 };
 
 class PackSource;
@@ -66,6 +79,8 @@ public:
 		uint8_t md5[16];
 		PackSource *src = nullptr;
 		bool encrypted;
+		bool compressed = false;
+		uint32_t pack_index = 0; // Which add_pack() call the file comes from.
 	};
 
 private:
@@ -96,20 +111,45 @@ private:
 		}
 	};
 
+	// Directory of a pack since version 3, kept as loaded: entries sorted by path MD5, then the paths.
+	// Files are looked up in it directly, so loading a pack doesn't build any table.
+	struct PackIndex {
+		String pack;
+		PackSource *src = nullptr;
+		uint64_t file_base = 0;
+		bool replace_files = false;
+		uint32_t pack_index = 0;
+		uint32_t file_count = 0;
+		Vector<uint8_t> data;
+		bool dirs_added = false;
+
+		int64_t find(const uint8_t *p_path_md5) const;
+		String get_path(uint32_t p_entry) const;
+		void get_file(uint32_t p_entry, PackedFile &r_file) const;
+	};
+
 	HashMap<PathMD5, PackedFile, PathMD5> files;
+	LocalVector<PackIndex *> indexes;
+	uint32_t pack_count = 0;
 
 	Vector<PackSource *> sources;
 
 	PackedDir *root = nullptr;
+	Mutex dirs_mutex;
 
 	static PackedData *singleton;
+	PackedData *previous_singleton = nullptr;
 	bool disabled = false;
 
 	void _free_packed_dirs(PackedDir *p_dir);
+	void _add_dir_path(const String &p_simplified_path);
+	PackedDir *_get_root();
+	bool _find_file(const String &p_simplified_path, PackedFile &r_file) const;
 
 public:
 	void add_pack_source(PackSource *p_source);
 	void add_path(const String &p_pkg_path, const String &p_path, uint64_t p_ofs, uint64_t p_size, const uint8_t *p_md5, PackSource *p_src, bool p_replace_files, bool p_encrypted = false); // for PackSource
+	void add_index(const String &p_pkg_path, uint64_t p_file_base, uint32_t p_file_count, const Vector<uint8_t> &p_data, PackSource *p_src, bool p_replace_files); // for PackSource
 
 	void set_disabled(bool p_disabled) { disabled = p_disabled; }
 	_FORCE_INLINE_ bool is_disabled() const { return disabled; }
@@ -143,11 +183,32 @@ public:
 class FileAccessPack : public FileAccess {
 	PackedData::PackedFile pf;
 
-	mutable uint64_t pos;
-	mutable bool eof;
-	uint64_t off;
+	mutable uint64_t pos = 0;
+	mutable bool eof = false;
+	uint64_t off = 0;
 
 	Ref<FileAccess> f;
+
+	// Compressed files are read several blocks at a time, which are decompressed in parallel.
+	// Sequential reads double the amount of blocks read ahead, up to PACK_COMPRESSED_READ_BLOCKS.
+	struct ReadBlocks {
+		uint32_t first = 0;
+		SafeFlag failed;
+	};
+
+	uint32_t block_size = 0;
+	LocalVector<uint64_t> block_offsets; // Offset of each block, plus the end of the last one.
+	mutable LocalVector<uint8_t> read_buffer;
+	mutable LocalVector<uint8_t> cache;
+	mutable uint32_t cache_block = 0;
+	mutable uint32_t cache_block_count = 0;
+	mutable uint32_t read_ahead = 1;
+
+	_FORCE_INLINE_ uint64_t _get_block_length(uint32_t p_block) const {
+		return MIN((uint64_t)block_size, pf.size - (uint64_t)p_block * block_size);
+	}
+	void _decompress_block(uint32_t p_index, ReadBlocks *p_read) const;
+	bool _read_blocks(uint32_t p_block, uint32_t p_count) const;
 	virtual Error open_internal(const String &p_path, int p_mode_flags) override;
 	virtual uint64_t _get_modified_time(const String &p_file) override { return 0; }
 	virtual BitField<FileAccess::UnixPermissionFlags> _get_unix_permissions(const String &p_file) override { return 0; }
@@ -189,21 +250,20 @@ public:
 };
 
 Ref<FileAccess> PackedData::try_open_path(const String &p_path) {
-	String simplified_path = p_path.simplify_path();
-	PathMD5 pmd5(simplified_path.md5_buffer());
-	HashMap<PathMD5, PackedFile, PathMD5>::Iterator E = files.find(pmd5);
-	if (!E) {
+	PackedFile pf;
+	if (!_find_file(p_path.simplify_path(), pf)) {
 		return nullptr; //not found
 	}
-	if (E->value.offset == 0) {
+	if (pf.offset == 0) {
 		return nullptr; //was erased
 	}
 
-	return E->value.src->get_file(p_path, &E->value);
+	return pf.src->get_file(p_path, &pf);
 }
 
 bool PackedData::has_path(const String &p_path) {
-	return files.has(PathMD5(p_path.simplify_path().md5_buffer()));
+	PackedFile pf;
+	return _find_file(p_path.simplify_path(), pf);
 }
 
 bool PackedData::has_directory(const String &p_path) {
@@ -59,6 +59,88 @@ ObjectID EncodedObjectAsID::get_object_id() const {
 #define ENCODE_FLAG_64 1 << 16
 #define ENCODE_FLAG_OBJECT_AS_ID 1 << 16
 
+// Packed arrays are encoded in little-endian with the same layout they have in memory,
+// so on little-endian hosts they can be copied in bulk rather than element by element.
+#ifndef BIG_ENDIAN_ENABLED
+#define MARSHALLS_BULK_COPY
+#endif
+
+// Length of p_string once encoded in UTF-8, without converting it. Must match String::utf8().
+static int _get_utf8_length(const String &p_string, bool &r_is_ascii) {
+	int l = p_string.length();
+	const char32_t *d = p_string.ptr();
+	int fl = 0;
+	r_is_ascii = true;
+	for (int i = 0; i < l; i++) {
+		uint32_t c = d[i];
+		if (c <= 0x7f) { // 7 bits.
+			fl += 1;
+			continue;
+		}
+		r_is_ascii = false;
+		if (c <= 0x7ff) { // 11 bits
+			fl += 2;
+		} else if (c <= 0xffff) { // 16 bits
+			fl += 3;
+		} else if (c <= 0x001fffff) { // 21 bits
+			fl += 4;
+		} else if (c <= 0x03ffffff) { // 26 bits
+			fl += 5;
+		} else if (c <= 0x7fffffff) { // 31 bits
+			fl += 6;
+		} else {
+			fl += 1;
+		}
+	}
+	return fl;
+}
+
+// Encoded size of variants of a given type, including the header, or -1 when it depends on the value.
+static int _get_fixed_encoded_size(Variant::Type p_type) {
+	switch (p_type) {
+		case Variant::NIL:
+			return 4;
+		case Variant::BOOL:
+			return 4 + 4;
+		case Variant::VECTOR2:
+			return 4 + 2 * sizeof(real_t);
+		case Variant::VECTOR2I:
+			return 4 + 2 * 4;
+		case Variant::RECT2:
+			return 4 + 4 * sizeof(real_t);
+		case Variant::RECT2I:
+			return 4 + 4 * 4;
+		case Variant::VECTOR3:
+			return 4 + 3 * sizeof(real_t);
+		case Variant::VECTOR3I:
+			return 4 + 3 * 4;
+		case Variant::TRANSFORM2D:
+			return 4 + 6 * sizeof(real_t);
+		case Variant::VECTOR4:
+			return 4 + 4 * sizeof(real_t);
+		case Variant::VECTOR4I:
+			return 4 + 4 * 4;
+		case Variant::PLANE:
+			return 4 + 4 * sizeof(real_t);
+		case Variant::QUATERNION:
+			return 4 + 4 * sizeof(real_t);
+		case Variant::AABB:
+			return 4 + 6 * sizeof(real_t);
+		case Variant::BASIS:
+			return 4 + 9 * sizeof(real_t);
+		case Variant::TRANSFORM3D:
+			return 4 + 12 * sizeof(real_t);
+		case Variant::PROJECTION:
+			return 4 + 16 * sizeof(real_t);
+		case Variant::COLOR:
+			return 4 + 4 * 4;
+		case Variant::RID:
+			return 4 + 8;
+		default:
+			return -1;
+	}
+}
+
 static Error _decode_string(const uint8_t *&buf, int &len, int *r_len, String &r_string) {
 	ERR_FAIL_COND_V(len < 4, ERR_INVALID_DATA);
 
@@ -757,16 +839,18 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 				(*r_len) += 4; // Size of count number.
 			}
 
+			// Every element takes at least 4 bytes, so the array can be sized upfront safely.
+			ERR_FAIL_COND_V(count > len / 4, ERR_INVALID_DATA);
+
 			Array varr;
+			varr.resize(count);
 
 			for (int i = 0; i < count; i++) {
 				int used = 0;
-				Variant v;
-				Error err = decode_variant(v, buf, len, &used, p_allow_objects, p_depth + 1);
+				Error err = decode_variant(varr[i], buf, len, &used, p_allow_objects, p_depth + 1);
 				ERR_FAIL_COND_V_MSG(err != OK, err, "Error when trying to decode Variant.");
 				buf += used;
 				len -= used;
-				varr.push_back(v);
 				if (r_len) {
 					(*r_len) += used;
 				}
@@ -788,10 +872,7 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 
 			if (count) {
 				data.resize(count);
-				uint8_t *w = data.ptrw();
-				for (int32_t i = 0; i < count; i++) {
-					w[i] = buf[i];
-				}
+				memcpy(data.ptrw(), buf, count);
 			}
 
 			r_variant = data;
@@ -818,9 +899,13 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 				//const int*rbuf=(const int*)buf;
 				data.resize(count);
 				int32_t *w = data.ptrw();
+#ifdef MARSHALLS_BULK_COPY
+				memcpy(w, buf, count * 4);
+#else
 				for (int32_t i = 0; i < count; i++) {
 					w[i] = decode_uint32(&buf[i * 4]);
 				}
+#endif
 			}
 			r_variant = Variant(data);
 			if (r_len) {
@@ -842,9 +927,13 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 				//const int*rbuf=(const int*)buf;
 				data.resize(count);
 				int64_t *w = data.ptrw();
+#ifdef MARSHALLS_BULK_COPY
+				memcpy(w, buf, count * 8);
+#else
 				for (int64_t i = 0; i < count; i++) {
 					w[i] = decode_uint64(&buf[i * 8]);
 				}
+#endif
 			}
 			r_variant = Variant(data);
 			if (r_len) {
@@ -866,9 +955,13 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 				//const float*rbuf=(const float*)buf;
 				data.resize(count);
 				float *w = data.ptrw();
+#ifdef MARSHALLS_BULK_COPY
+				memcpy(w, buf, count * 4);
+#else
 				for (int32_t i = 0; i < count; i++) {
 					w[i] = decode_float(&buf[i * 4]);
 				}
+#endif
 			}
 			r_variant = data;
 
@@ -890,9 +983,13 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 			if (count) {
 				data.resize(count);
 				double *w = data.ptrw();
+#ifdef MARSHALLS_BULK_COPY
+				memcpy(w, buf, count * 8);
+#else
 				for (int64_t i = 0; i < count; i++) {
 					w[i] = decode_double(&buf[i * 8]);
 				}
+#endif
 			}
 			r_variant = data;
 
@@ -946,10 +1043,14 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 					varray.resize(count);
 					Vector2 *w = varray.ptrw();
 
+#if defined(MARSHALLS_BULK_COPY) && defined(REAL_T_IS_DOUBLE)
+					memcpy(w, buf, count * sizeof(double) * 2);
+#else
 					for (int32_t i = 0; i < count; i++) {
 						w[i].x = decode_double(buf + i * sizeof(double) * 2 + sizeof(double) * 0);
 						w[i].y = decode_double(buf + i * sizeof(double) * 2 + sizeof(double) * 1);
 					}
+#endif
 
 					int adv = sizeof(double) * 2 * count;
 
@@ -971,10 +1072,14 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 					varray.resize(count);
 					Vector2 *w = varray.ptrw();
 
+#if defined(MARSHALLS_BULK_COPY) && !defined(REAL_T_IS_DOUBLE)
+					memcpy(w, buf, count * sizeof(float) * 2);
+#else
 					for (int32_t i = 0; i < count; i++) {
 						w[i].x = decode_float(buf + i * sizeof(float) * 2 + sizeof(float) * 0);
 						w[i].y = decode_float(buf + i * sizeof(float) * 2 + sizeof(float) * 1);
 					}
+#endif
 
 					int adv = sizeof(float) * 2 * count;
 
@@ -1006,11 +1111,15 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 					varray.resize(count);
 					Vector3 *w = varray.ptrw();
 
+#if defined(MARSHALLS_BULK_COPY) && defined(REAL_T_IS_DOUBLE)
+					memcpy(w, buf, count * sizeof(double) * 3);
+#else
 					for (int32_t i = 0; i < count; i++) {
 						w[i].x = decode_double(buf + i * sizeof(double) * 3 + sizeof(double) * 0);
 						w[i].y = decode_double(buf + i * sizeof(double) * 3 + sizeof(double) * 1);
 						w[i].z = decode_double(buf + i * sizeof(double) * 3 + sizeof(double) * 2);
 					}
+#endif
 
 					int adv = sizeof(double) * 3 * count;
 
@@ -1032,11 +1141,15 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 					varray.resize(count);
 					Vector3 *w = varray.ptrw();
 
+#if defined(MARSHALLS_BULK_COPY) && !defined(REAL_T_IS_DOUBLE)
+					memcpy(w, buf, count * sizeof(float) * 3);
+#else
 					for (int32_t i = 0; i < count; i++) {
 						w[i].x = decode_float(buf + i * sizeof(float) * 3 + sizeof(float) * 0);
 						w[i].y = decode_float(buf + i * sizeof(float) * 3 + sizeof(float) * 1);
 						w[i].z = decode_float(buf + i * sizeof(float) * 3 + sizeof(float) * 2);
 					}
+#endif
 
 					int adv = sizeof(float) * 3 * count;
 
@@ -1069,6 +1182,10 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 				carray.resize(count);
 				Color *w = carray.ptrw();
 
+#ifdef MARSHALLS_BULK_COPY
+				static_assert(sizeof(Color) == 4 * 4);
+				memcpy(w, buf, count * 4 * 4);
+#else
 				for (int32_t i = 0; i < count; i++) {
 					// Colors should always be in single-precision.
 					w[i].r = decode_float(buf + i * 4 * 4 + 4 * 0);
@@ -1076,6 +1193,7 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 					w[i].b = decode_float(buf + i * 4 * 4 + 4 * 2);
 					w[i].a = decode_float(buf + i * 4 * 4 + 4 * 3);
 				}
+#endif
 
 				int adv = 4 * 4 * count;
 
@@ -1095,17 +1213,81 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 	return OK;
 }
 
+Error decode_packed_array_view(PackedArrayView &r_view, const uint8_t *p_buffer, int p_len, int *r_len) {
+	const uint8_t *buf = p_buffer;
+	int len = p_len;
+
+	ERR_FAIL_COND_V(len < 8, ERR_INVALID_DATA);
+
+	uint32_t type = decode_uint32(buf);
+	int element_size = 0;
+	switch (type & ENCODE_MASK) {
+		case Variant::PACKED_BYTE_ARRAY: {
+			element_size = 1;
+		} break;
+		case Variant::PACKED_INT32_ARRAY:
+		case Variant::PACKED_FLOAT32_ARRAY: {
+			element_size = 4;
+		} break;
+		case Variant::PACKED_INT64_ARRAY:
+		case Variant::PACKED_FLOAT64_ARRAY: {
+			element_size = 8;
+		} break;
+		case Variant::PACKED_VECTOR2_ARRAY: {
+			element_size = (type & ENCODE_FLAG_64) ? sizeof(double) * 2 : sizeof(float) * 2;
+		} break;
+		case Variant::PACKED_VECTOR3_ARRAY: {
+			element_size = (type & ENCODE_FLAG_64) ? sizeof(double) * 3 : sizeof(float) * 3;
+		} break;
+		case Variant::PACKED_COLOR_ARRAY: {
+			element_size = 4 * 4;
+		} break;
+		default: {
+			ERR_FAIL_V_MSG(ERR_INVALID_DATA, "Only packed arrays of fixed size elements can be decoded as views.");
+		}
+	}
+
+	int32_t count = decode_uint32(buf + 4);
+	buf += 8;
+	len -= 8;
+	ERR_FAIL_COND_V(count < 0, ERR_INVALID_DATA);
+	ERR_FAIL_MUL_OF(count, element_size, ERR_INVALID_DATA);
+	ERR_FAIL_COND_V(count * element_size > len, ERR_INVALID_DATA);
+
+	r_view.type = Variant::Type(type & ENCODE_MASK);
+	r_view.data = buf;
+	r_view.count = count;
+	r_view.element_size = element_size;
+
+	if (r_len) {
+		int data_len = count * element_size;
+		*r_len = 8 + data_len + (4 - data_len % 4) % 4;
+	}
+
+	return OK;
+}
+
 static void _encode_string(const String &p_string, uint8_t *&buf, int &r_len) {
-	CharString utf8 = p_string.utf8();
+	bool is_ascii = false;
+	int utf8_length = _get_utf8_length(p_string, is_ascii);
 
 	if (buf) {
-		encode_uint32(utf8.length(), buf);
+		encode_uint32(utf8_length, buf);
 		buf += 4;
-		memcpy(buf, utf8.get_data(), utf8.length());
-		buf += utf8.length();
+		if (is_ascii) {
+			// Write directly, without going through an intermediate CharString.
+			const char32_t *src = p_string.ptr();
+			for (int i = 0; i < utf8_length; i++) {
+				buf[i] = uint8_t(src[i]);
+			}
+		} else {
+			CharString utf8 = p_string.utf8();
+			memcpy(buf, utf8.get_data(), utf8_length);
+		}
+		buf += utf8_length;
 	}
 
-	r_len += 4 + utf8.length();
+	r_len += 4 + utf8_length;
 	while (r_len % 4) {
 		r_len++; //pad
 		if (buf) {
@@ -1565,19 +1747,20 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 			}
 			r_len += 4;
 
-			List<Variant> keys;
-			d.get_key_list(&keys);
-
-			for (const Variant &E : keys) {
+			// Unlike typed arrays, there is no precomputed size here. Dictionaries
+			// are untyped, so every key and value has to be visited to know the
+			// encoded size, and this loop already does that once.
+			const Variant *K = nullptr;
+			while ((K = d.next(K))) {
 				int len;
-				Error err = encode_variant(E, buf, len, p_full_objects, p_depth + 1);
+				Error err = encode_variant(*K, buf, len, p_full_objects, p_depth + 1);
 				ERR_FAIL_COND_V(err, err);
 				ERR_FAIL_COND_V(len % 4, ERR_BUG);
 				r_len += len;
 				if (buf) {
 					buf += len;
 				}
-				Variant *v = d.getptr(E);
+				const Variant *v = d.getptr(*K);
 				ERR_FAIL_NULL_V(v, ERR_BUG);
 				err = encode_variant(*v, buf, len, p_full_objects, p_depth + 1);
 				ERR_FAIL_COND_V(err, err);
@@ -1599,6 +1782,15 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 
 			r_len += 4;
 
+			if (!buf && v.is_typed() && v.get_typed_builtin() != Variant::OBJECT) {
+				// Typed arrays only hold elements of their own type, so their size can be known without visiting them.
+				int element_size = _get_fixed_encoded_size(Variant::Type(v.get_typed_builtin()));
+				if (element_size > 0) {
+					r_len += element_size * v.size();
+					break;
+				}
+			}
+
 			for (int i = 0; i < v.size(); i++) {
 				int len;
 				Error err = encode_variant(v.get(i), buf, len, p_full_objects, p_depth + 1);
@@ -1645,9 +1837,13 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 				encode_uint32(datalen, buf);
 				buf += 4;
 				const int32_t *r = data.ptr();
+#ifdef MARSHALLS_BULK_COPY
+				memcpy(buf, r, datalen * datasize);
+#else
 				for (int32_t i = 0; i < datalen; i++) {
 					encode_uint32(r[i], &buf[i * datasize]);
 				}
+#endif
 			}
 
 			r_len += 4 + datalen * datasize;
@@ -1662,9 +1858,13 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 				encode_uint32(datalen, buf);
 				buf += 4;
 				const int64_t *r = data.ptr();
+#ifdef MARSHALLS_BULK_COPY
+				memcpy(buf, r, datalen * datasize);
+#else
 				for (int64_t i = 0; i < datalen; i++) {
 					encode_uint64(r[i], &buf[i * datasize]);
 				}
+#endif
 			}
 
 			r_len += 4 + datalen * datasize;
@@ -1679,9 +1879,13 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 				encode_uint32(datalen, buf);
 				buf += 4;
 				const float *r = data.ptr();
+#ifdef MARSHALLS_BULK_COPY
+				memcpy(buf, r, datalen * datasize);
+#else
 				for (int i = 0; i < datalen; i++) {
 					encode_float(r[i], &buf[i * datasize]);
 				}
+#endif
 			}
 
 			r_len += 4 + datalen * datasize;
@@ -1696,9 +1900,13 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 				encode_uint32(datalen, buf);
 				buf += 4;
 				const double *r = data.ptr();
+#ifdef MARSHALLS_BULK_COPY
+				memcpy(buf, r, datalen * datasize);
+#else
 				for (int i = 0; i < datalen; i++) {
 					encode_double(r[i], &buf[i * datasize]);
 				}
+#endif
 			}
 
 			r_len += 4 + datalen * datasize;
@@ -1716,6 +1924,14 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 			r_len += 4;
 
 			for (int i = 0; i < len; i++) {
+				if (!buf) {
+					// Only measuring, avoid converting the string.
+					bool is_ascii = false;
+					r_len += 4 + _get_utf8_length(data[i], is_ascii) + 1;
+					r_len += (4 - r_len % 4) % 4; //pad
+					continue;
+				}
+
 				CharString utf8 = data.get(i).utf8();
 
 				if (buf) {
@@ -1747,6 +1963,10 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 			r_len += 4;
 
 			if (buf) {
+#ifdef MARSHALLS_BULK_COPY
+				memcpy(buf, data.ptr(), sizeof(real_t) * 2 * len);
+				buf += sizeof(real_t) * 2 * len;
+#else
 				for (int i = 0; i < len; i++) {
 					Vector2 v = data.get(i);
 
@@ -1754,6 +1974,7 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 					encode_real(v.y, &buf[sizeof(real_t)]);
 					buf += sizeof(real_t) * 2;
 				}
+#endif
 			}
 
 			r_len += sizeof(real_t) * 2 * len;
@@ -1771,6 +1992,10 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 			r_len += 4;
 
 			if (buf) {
+#ifdef MARSHALLS_BULK_COPY
+				memcpy(buf, data.ptr(), sizeof(real_t) * 3 * len);
+				buf += sizeof(real_t) * 3 * len;
+#else
 				for (int i = 0; i < len; i++) {
 					Vector3 v = data.get(i);
 
@@ -1779,6 +2004,7 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 					encode_real(v.z, &buf[sizeof(real_t) * 2]);
 					buf += sizeof(real_t) * 3;
 				}
+#endif
 			}
 
 			r_len += sizeof(real_t) * 3 * len;
@@ -1796,6 +2022,10 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 			r_len += 4;
 
 			if (buf) {
+#ifdef MARSHALLS_BULK_COPY
+				memcpy(buf, data.ptr(), 4 * 4 * len);
+				buf += 4 * 4 * len;
+#else
 				for (int i = 0; i < len; i++) {
 					Color c = data.get(i);
 
@@ -1805,6 +2035,7 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 					encode_float(c.a, &buf[12]);
 					buf += 4 * 4; // Colors should always be in single-precision.
 				}
+#endif
 			}
 
 			r_len += 4 * 4 * len;
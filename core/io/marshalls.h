@@ -213,6 +213,17 @@ public:
 };
 
 Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int *r_len = nullptr, bool p_allow_objects = false, int p_depth = 0);
+
+// A packed array of fixed size elements, as found in an encoded buffer. It is decoded
+// in place: data points into the source buffer, so it must outlive the view.
+struct PackedArrayView {
+	Variant::Type type = Variant::NIL;
+	const uint8_t *data = nullptr; // Elements in little-endian, tightly packed and not necessarily aligned.
+	int count = 0;
+	int element_size = 0; // As encoded, doubles are used for vectors encoded with 64-bit precision.
+};
+
+Error decode_packed_array_view(PackedArrayView &r_view, const uint8_t *p_buffer, int p_len, int *r_len = nullptr);
 Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bool p_full_objects = false, int p_depth = 0);
 
 Vector<float> vector3_to_float32_array(const Vector3 *vecs, size_t count);
@@ -29,11 +29,16 @@
 /**************************************************************************/
 
 #include "pck_packer.h"
+#include "pck_packer.compat.inc"
 
 #include "core/crypto/crypto_core.h"
+#include "core/io/compression.h"
 #include "core/io/file_access.h"
 #include "core/io/file_access_encrypted.h"
 #include "core/io/file_access_pack.h" // PACK_HEADER_MAGIC, PACK_FORMAT_VERSION
+#include "core/io/marshalls.h"
+#include "core/object/worker_thread_pool.h"
+#include "core/templates/local_vector.h"
 #include "core/version.h"
 
 static int _get_pad(int p_alignment, int p_n) {
@@ -48,7 +53,7 @@ static int _get_pad(int p_alignment, int p_n) {
 
 void PCKPacker::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("pck_start", "pck_name", "alignment", "key", "encrypt_directory"), &PCKPacker::pck_start, DEFVAL(32), DEFVAL("0000000000000000000000000000000000000000000000000000000000000000"), DEFVAL(false));
-	ClassDB::bind_method(D_METHOD("add_file", "pck_path", "source_path", "encrypt"), &PCKPacker::add_file, DEFVAL(false));
+	ClassDB::bind_method(D_METHOD("add_file", "pck_path", "source_path", "encrypt", "compress"), &PCKPacker::add_file, DEFVAL(false), DEFVAL(false));
 	ClassDB::bind_method(D_METHOD("flush", "verbose"), &PCKPacker::flush, DEFVAL(false));
 }
 
@@ -101,12 +106,11 @@ Error PCKPacker::pck_start(const String &p_file, int p_alignment, const String &
 	file->store_32(pack_flags); // flags
 
 	files.clear();
-	ofs = 0;
 
 	return OK;
 }
 
-Error PCKPacker::add_file(const String &p_file, const String &p_src, bool p_encrypt) {
+Error PCKPacker::add_file(const String &p_file, const String &p_src, bool p_encrypt, bool p_compress) {
 	ERR_FAIL_COND_V_MSG(file.is_null(), ERR_INVALID_PARAMETER, "File must be opened before use.");
 
 	Ref<FileAccess> f = FileAccess::open(p_src, FileAccess::READ);
@@ -119,7 +123,6 @@ Error PCKPacker::add_file(const String &p_file, const String &p_src, bool p_encr
 	// symbols in them still match to the MD5 hash for the saved path.
 	pf.path = p_file.simplify_path();
 	pf.src_path = p_src;
-	pf.ofs = ofs;
 	pf.size = f->get_length();
 
 	Vector<uint8_t> data = FileAccess::get_file_as_bytes(p_src);
@@ -132,75 +135,187 @@ Error PCKPacker::add_file(const String &p_file, const String &p_src, bool p_encr
 		}
 	}
 	pf.encrypted = p_encrypt;
-
-	uint64_t _size = pf.size;
-	if (p_encrypt) { // Add encryption overhead.
-		if (_size % 16) { // Pad to encryption block size.
-			_size += 16 - (_size % 16);
-		}
-		_size += 16; // hash
-		_size += 8; // data size
-		_size += 16; // iv
-	}
-
-	int pad = _get_pad(alignment, ofs + _size);
-	ofs = ofs + _size + pad;
+	pf.compressed = p_compress;
 
 	files.push_back(pf);
 
 	return OK;
 }
 
-Error PCKPacker::flush(bool p_verbose) {
-	ERR_FAIL_COND_V_MSG(file.is_null(), ERR_INVALID_PARAMETER, "File must be opened before use.");
+Vector<uint8_t> PCKPacker::make_directory(const Vector<File> &p_files, uint32_t &r_file_count, LocalVector<int> *r_entry_files) {
+	struct Entry {
+		uint8_t path_md5[16];
+		int file = 0;
 
-	int64_t file_base_ofs = file->get_position();
-	file->store_64(0); // files base
+		bool operator<(const Entry &p_other) const {
+			int cmp = memcmp(path_md5, p_other.path_md5, 16);
+			return cmp < 0 || (cmp == 0 && file < p_other.file);
+		}
+	};
+
+	LocalVector<Entry> entries;
+	entries.resize(p_files.size());
+	for (int i = 0; i < p_files.size(); i++) {
+		CharString path = p_files[i].path.utf8();
+		CryptoCore::md5((const uint8_t *)path.get_data(), path.length(), entries[i].path_md5);
+		entries[i].file = i;
+	}
+	// Files are looked up with a binary search on the path hash.
+	entries.sort();
 
-	for (int i = 0; i < 16; i++) {
-		file->store_32(0); // reserved
+	// When a path was added more than once, the last one is kept.
+	LocalVector<const File *> sorted;
+	if (r_entry_files) {
+		r_entry_files->clear();
+	}
+	for (uint32_t i = 0; i < entries.size(); i++) {
+		if (i + 1 < entries.size() && memcmp(entries[i].path_md5, entries[i + 1].path_md5, 16) == 0) {
+			continue;
+		}
+		sorted.push_back(&p_files[entries[i].file]);
+		if (r_entry_files) {
+			r_entry_files->push_back(entries[i].file);
+		}
 	}
 
-	// write the index
-	file->store_32(files.size());
+	Vector<CharString> paths;
+	uint64_t strings_size = 0;
+	for (const File *file : sorted) {
+		paths.push_back(file->path.utf8());
+		strings_size += paths[paths.size() - 1].length() + 1;
+	}
 
-	Ref<FileAccessEncrypted> fae;
-	Ref<FileAccess> fhead = file;
+	Vector<uint8_t> directory;
+	directory.resize(sorted.size() * PACK_INDEX_ENTRY_SIZE + strings_size);
+	memset(directory.ptrw(), 0, directory.size());
 
-	if (enc_dir) {
-		fae.instantiate();
-		ERR_FAIL_COND_V(fae.is_null(), ERR_CANT_CREATE);
+	uint8_t *entry = directory.ptrw();
+	uint8_t *strings = entry + sorted.size() * PACK_INDEX_ENTRY_SIZE;
+	uint32_t path_ofs = 0;
+	for (uint32_t i = 0; i < sorted.size(); i++) {
+		const File *file = sorted[i];
+		uint32_t flags = 0;
+		if (file->encrypted) {
+			flags |= PACK_FILE_ENCRYPTED;
+		}
+		if (file->compressed) {
+			flags |= PACK_FILE_COMPRESSED;
+		}
 
-		Error err = fae->open_and_parse(file, key, FileAccessEncrypted::MODE_WRITE_AES256, false);
-		ERR_FAIL_COND_V(err != OK, ERR_CANT_CREATE);
+		const CharString &path = paths[i];
+		CryptoCore::md5((const uint8_t *)path.get_data(), path.length(), entry);
+		encode_uint64(file->ofs, entry + 16);
+		encode_uint64(file->size, entry + 24);
+		memcpy(entry + 32, file->md5.ptr(), 16);
+		encode_uint32(flags, entry + 48);
+		encode_uint32(path_ofs, entry + 52);
+
+		memcpy(strings + path_ofs, path.get_data(), path.length());
+		path_ofs += path.length() + 1;
+		entry += PACK_INDEX_ENTRY_SIZE;
+	}
 
-		fhead = fae;
+	r_file_count = sorted.size();
+	return directory;
+}
+
+void PCKPacker::_compress_block(void *p_userdata, uint32_t p_index) {
+	CompressBlocks *blocks = (CompressBlocks *)p_userdata;
+	const uint64_t block_ofs = (uint64_t)p_index * PACK_COMPRESSED_BLOCK_SIZE;
+	const int length = MIN(blocks->src_size - block_ofs, (uint64_t)PACK_COMPRESSED_BLOCK_SIZE);
+	uint8_t *dst = blocks->dst + (uint64_t)p_index * blocks->dst_block_size;
+
+	int size = Compression::compress(dst, blocks->src + block_ofs, length, Compression::MODE_ZSTD);
+	// Blocks which don't get smaller are stored as they are.
+	if (size <= 0 || size >= length) {
+		memcpy(dst, blocks->src + block_ofs, length);
+		size = length;
 	}
+	blocks->sizes[p_index] = size;
+}
 
-	for (int i = 0; i < files.size(); i++) {
-		int string_len = files[i].path.utf8().length();
-		int pad = _get_pad(4, string_len);
+Error PCKPacker::store_compressed(const Ref<FileAccess> &p_dst, const Ref<FileAccess> &p_src, uint64_t p_size) {
+	// Block size, then the compressed size of each block, then the blocks.
+	const uint32_t block_count = (p_size + PACK_COMPRESSED_BLOCK_SIZE - 1) / PACK_COMPRESSED_BLOCK_SIZE;
+	p_dst->store_32(PACK_COMPRESSED_BLOCK_SIZE);
+	const uint64_t table_ofs = p_dst->get_position();
+	for (uint32_t i = 0; i < block_count; i++) {
+		p_dst->store_32(0);
+	}
 
-		fhead->store_32(string_len + pad);
-		fhead->store_buffer((const uint8_t *)files[i].path.utf8().get_data(), string_len);
-		for (int j = 0; j < pad; j++) {
-			fhead->store_8(0);
+	// Blocks are compressed in batches, as many as the reader decompresses at once.
+	const uint32_t batch_blocks = PACK_COMPRESSED_READ_BLOCKS;
+	LocalVector<uint8_t> src;
+	LocalVector<uint8_t> dst;
+	LocalVector<uint32_t> sizes;
+	src.resize((uint64_t)MIN(block_count, batch_blocks) * PACK_COMPRESSED_BLOCK_SIZE);
+	const uint32_t dst_block_size = Compression::get_max_compressed_buffer_size(PACK_COMPRESSED_BLOCK_SIZE, Compression::MODE_ZSTD);
+	dst.resize((uint64_t)MIN(block_count, batch_blocks) * dst_block_size);
+	sizes.resize(block_count);
+
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	for (uint32_t first = 0; first < block_count; first += batch_blocks) {
+		const uint32_t count = MIN(batch_blocks, block_count - first);
+		const uint64_t batch_ofs = (uint64_t)first * PACK_COMPRESSED_BLOCK_SIZE;
+		const uint64_t batch_size = MIN(p_size - batch_ofs, (uint64_t)count * PACK_COMPRESSED_BLOCK_SIZE);
+		ERR_FAIL_COND_V(p_src->get_buffer(src.ptr(), batch_size) != batch_size, ERR_FILE_CANT_READ);
+
+		CompressBlocks blocks;
+		blocks.src = src.ptr();
+		blocks.src_size = batch_size;
+		blocks.dst = dst.ptr();
+		blocks.dst_block_size = dst_block_size;
+		blocks.sizes = sizes.ptr() + first;
+		// Waiting from a pool thread could use up the threads needed to finish the work.
+		if (count > 1 && pool && pool->get_thread_index() == -1) {
+			WorkerThreadPool::GroupID group_task = pool->add_native_group_task(&PCKPacker::_compress_block, &blocks, count, -1, true, SNAME("CompressPackBlocks"));
+			pool->wait_for_group_task_completion(group_task);
+		} else {
+			for (uint32_t i = 0; i < count; i++) {
+				_compress_block(&blocks, i);
+			}
 		}
 
-		fhead->store_64(files[i].ofs);
-		fhead->store_64(files[i].size); // pay attention here, this is where file is
-		fhead->store_buffer(files[i].md5.ptr(), 16); //also save md5 for file
-
-		uint32_t flags = 0;
-		if (files[i].encrypted) {
-			flags |= PACK_FILE_ENCRYPTED;
+		for (uint32_t i = 0; i < count; i++) {
+			p_dst->store_buffer(dst.ptr() + (uint64_t)i * dst_block_size, sizes[first + i]);
 		}
-		fhead->store_32(flags);
 	}
 
-	if (fae.is_valid()) {
-		fhead.unref();
-		fae.unref();
+	const uint64_t end = p_dst->get_position();
+	p_dst->seek(table_ofs);
+	for (uint32_t i = 0; i < block_count; i++) {
+		p_dst->store_32(sizes[i]);
+	}
+	p_dst->seek(end);
+
+	return OK;
+}
+
+Error PCKPacker::flush(bool p_verbose) {
+	ERR_FAIL_COND_V_MSG(file.is_null(), ERR_INVALID_PARAMETER, "File must be opened before use.");
+
+	int64_t file_base_ofs = file->get_position();
+	file->store_64(0); // files base
+
+	for (int i = 0; i < 16; i++) {
+		file->store_32(0); // reserved
+	}
+
+	// The directory size doesn't depend on the file offsets, so its space is reserved
+	// here. The offsets are filled in, and it is written, once all files are stored.
+	uint32_t file_count = 0;
+	LocalVector<int> entry_files;
+	Vector<uint8_t> directory = make_directory(files, file_count, &entry_files);
+	uint64_t directory_size = directory.size();
+	file->store_32(file_count);
+	file->store_32(directory_size - (uint64_t)file_count * PACK_INDEX_ENTRY_SIZE); // strings size
+
+	int64_t directory_ofs = file->get_position();
+	if (enc_dir) { // Add encryption overhead.
+		directory_size += _get_pad(16, directory_size) + 16 + 8 + 16; // padding, hash, data size, iv
+	}
+	for (uint64_t i = 0; i < directory_size; i++) {
+		file->store_8(0);
 	}
 
 	int header_padding = _get_pad(alignment, file->get_position());
@@ -213,13 +328,17 @@ Error PCKPacker::flush(bool p_verbose) {
 	file->store_64(file_base); // update files base
 	file->seek(file_base);
 
+	Ref<FileAccessEncrypted> fae;
+
 	const uint32_t buf_max = 65536;
 	uint8_t *buf = memnew_arr(uint8_t, buf_max);
 
 	int count = 0;
 	for (int i = 0; i < files.size(); i++) {
 		Ref<FileAccess> src = FileAccess::open(files[i].src_path, FileAccess::READ);
+		ERR_FAIL_COND_V_MSG(src.is_null(), ERR_FILE_CANT_OPEN, "Can't open file to read: " + files[i].src_path + ".");
 		uint64_t to_write = files[i].size;
+		files.write[i].ofs = file->get_position() - file_base;
 
 		Ref<FileAccess> ftmp = file;
 		if (files[i].encrypted) {
@@ -231,10 +350,15 @@ Error PCKPacker::flush(bool p_verbose) {
 			ftmp = fae;
 		}
 
-		while (to_write > 0) {
-			uint64_t read = src->get_buffer(buf, MIN(to_write, buf_max));
-			ftmp->store_buffer(buf, read);
-			to_write -= read;
+		if (files[i].compressed) {
+			Error err = store_compressed(ftmp, src, to_write);
+			ERR_FAIL_COND_V(err != OK, err);
+		} else {
+			while (to_write > 0) {
+				uint64_t read = src->get_buffer(buf, MIN(to_write, buf_max));
+				ftmp->store_buffer(buf, read);
+				to_write -= read;
+			}
 		}
 
 		if (fae.is_valid()) {
@@ -254,8 +378,27 @@ Error PCKPacker::flush(bool p_verbose) {
 		}
 	}
 
-	file.unref();
 	memdelete_arr(buf);
 
+	uint8_t *entry = directory.ptrw();
+	for (uint32_t i = 0; i < entry_files.size(); i++) {
+		encode_uint64(files[entry_files[i]].ofs, entry + 16);
+		entry += PACK_INDEX_ENTRY_SIZE;
+	}
+	file->seek(directory_ofs);
+	if (enc_dir) {
+		fae.instantiate();
+		ERR_FAIL_COND_V(fae.is_null(), ERR_CANT_CREATE);
+
+		Error err = fae->open_and_parse(file, key, FileAccessEncrypted::MODE_WRITE_AES256, false);
+		ERR_FAIL_COND_V(err != OK, ERR_CANT_CREATE);
+		fae->store_buffer(directory.ptr(), directory.size());
+		fae.unref();
+	} else {
+		file->store_buffer(directory.ptr(), directory.size());
+	}
+
+	file.unref();
+
 	return OK;
 }
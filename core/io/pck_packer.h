@@ -32,36 +32,58 @@
 #define PCK_PACKER_H
 
 #include "core/object/ref_counted.h"
+#include "core/templates/local_vector.h"
 
 class FileAccess;
 
 class PCKPacker : public RefCounted {
 	GDCLASS(PCKPacker, RefCounted);
 
+public:
+	struct File {
+		String path;
+		String src_path;
+		uint64_t ofs = 0;
+		uint64_t size = 0;
+		bool encrypted = false;
+		bool compressed = false;
+		Vector<uint8_t> md5;
+	};
+
+private:
 	Ref<FileAccess> file;
 	int alignment = 0;
-	uint64_t ofs = 0;
 
 	Vector<uint8_t> key;
 	bool enc_dir = false;
 
 	static void _bind_methods();
 
-	struct File {
-		String path;
-		String src_path;
-		uint64_t ofs = 0;
-		uint64_t size = 0;
-		bool encrypted = false;
-		Vector<uint8_t> md5;
+#ifndef DISABLE_DEPRECATED
+	Error _add_file_bind_compat_50(const String &p_file, const String &p_src, bool p_encrypt = false);
+	static void _bind_compatibility_methods();
+#endif
+
+	struct CompressBlocks {
+		const uint8_t *src = nullptr;
+		uint64_t src_size = 0;
+		uint8_t *dst = nullptr;
+		uint32_t dst_block_size = 0;
+		uint32_t *sizes = nullptr;
 	};
+	static void _compress_block(void *p_userdata, uint32_t p_index);
+
 	Vector<File> files;
 
 public:
 	Error pck_start(const String &p_file, int p_alignment = 32, const String &p_key = "0000000000000000000000000000000000000000000000000000000000000000", bool p_encrypt_directory = false);
-	Error add_file(const String &p_file, const String &p_src, bool p_encrypt = false);
+	Error add_file(const String &p_file, const String &p_src, bool p_encrypt = false, bool p_compress = false);
 	Error flush(bool p_verbose = false);
 
+	// Shared with the project exporter.
+	static Vector<uint8_t> make_directory(const Vector<File> &p_files, uint32_t &r_file_count, LocalVector<int> *r_entry_files = nullptr);
+	static Error store_compressed(const Ref<FileAccess> &p_dst, const Ref<FileAccess> &p_src, uint64_t p_size);
+
 	PCKPacker() {}
 };
 
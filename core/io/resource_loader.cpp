@@ -239,6 +239,8 @@ ResourceLoader::LoadToken::~LoadToken() {
 }
 
 Ref<Resource> ResourceLoader::_load(const String &p_path, const String &p_original_path, const String &p_type_hint, ResourceFormatLoader::CacheMode p_cache_mode, Error *r_error, bool p_use_sub_threads, float *r_progress) {
+	MemoryTagScope memory_tag(Memory::TAG_RESOURCES);
+
 	load_nesting++;
 	if (load_paths_stack->size()) {
 		thread_load_mutex.lock();
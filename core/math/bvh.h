@@ -52,6 +52,7 @@
 // and pairable_mask is either 0 if static, or set to all if non static
 
 #include "bvh_tree.h"
+#include "core/object/worker_thread_pool.h"
 #include "core/os/mutex.h"
 
 #define BVHTREE_CLASS BVH_Tree<T, NUM_TREES, 2, MAX_ITEMS, USER_PAIR_TEST_FUNCTION, USER_CULL_TEST_FUNCTION, USE_PAIRS, BOUNDS, POINT>
@@ -381,6 +382,27 @@ public:
 		return params.result_count_overall;
 	}
 
+	// Culls many segments at once, traversing the tree once per packet of segments rather than once per segment.
+	// The results of segment n are written from p_result_array[n * p_result_max], and their amount to r_result_counts[n].
+	void cull_segments(const POINT *p_from, const POINT *p_to, int p_count, T **p_result_array, int *r_result_counts, int p_result_max, const T *p_tester, uint32_t p_tree_collision_mask = 0xFFFFFFFF, int *p_subindex_array = nullptr) {
+		for (int offset = 0; offset < p_count; offset += BVHTREE_CLASS::SEGMENT_PACKET_MAX) {
+			BVH_LOCKED_FUNCTION
+			typename BVHTREE_CLASS::CullSegmentPacketParams params;
+
+			params.count = MIN(p_count - offset, int(BVHTREE_CLASS::SEGMENT_PACKET_MAX));
+			params.from = p_from + offset;
+			params.to = p_to + offset;
+			params.result_max = p_result_max;
+			params.result_array = p_result_array + offset * p_result_max;
+			params.subindex_array = p_subindex_array ? p_subindex_array + offset * p_result_max : nullptr;
+			params.result_counts = r_result_counts + offset;
+			params.tester = p_tester;
+			params.tree_collision_mask = p_tree_collision_mask;
+
+			tree.cull_segment_packet(params);
+		}
+	}
+
 	int cull_point(const POINT &p_point, T **p_result_array, int p_result_max, const T *p_tester, uint32_t p_tree_collision_mask = 0xFFFFFFFF, int *p_subindex_array = nullptr) {
 		BVH_LOCKED_FUNCTION
 		typename BVHTREE_CLASS::CullParams params;
@@ -429,13 +451,58 @@ public:
 
 private:
 	// do this after moving etc.
+	// Finding the pairs that changed only reads the tree, so it is split over worker threads
+	// (each with its own cull and pair lists). The pairs found are then sorted, so the callbacks
+	// are always sent in the same order, however the work was split.
 	void _check_for_collisions(bool p_full_check = false) {
 		if (!changed_items.size()) {
 			// noop
 			return;
 		}
 
-		BOUNDS bb;
+		const uint32_t task_count = (changed_items.size() + PAIRING_TASK_SIZE - 1) / PAIRING_TASK_SIZE;
+		if (_pairing_tasks.size() < task_count) {
+			_pairing_tasks.resize(task_count);
+		}
+		_pairing_full_check = p_full_check;
+
+		WorkerThreadPool *thread_pool = WorkerThreadPool::get_singleton();
+		if (task_count > 1 && thread_pool) {
+			WorkerThreadPool::GroupID group_task = thread_pool->add_template_group_task(this, &BVH_Manager::_find_pairing_changes, nullptr, task_count, -1, true, SNAME("BVHPairing"));
+			thread_pool->wait_for_group_task_completion(group_task);
+		} else {
+			for (uint32_t n = 0; n < task_count; n++) {
+				_find_pairing_changes(n, nullptr);
+			}
+		}
+
+		// Pairs are found from both sides when both items changed, so duplicates are skipped.
+		// Leavers are sent first, as when each item dropped its old pairs before finding new ones.
+		_gather_pair_keys(task_count, false);
+		for (uint32_t n = 0; n < _pair_keys.size(); n++) {
+			if (n && _pair_keys[n] == _pair_keys[n - 1]) {
+				continue;
+			}
+			_unpair(_pair_key_get_from(_pair_keys[n]), _pair_key_get_to(_pair_keys[n]));
+		}
+
+		_gather_pair_keys(task_count, true);
+		for (uint32_t n = 0; n < _pair_keys.size(); n++) {
+			if (n && _pair_keys[n] == _pair_keys[n - 1]) {
+				continue;
+			}
+			// find NEW enterers, and send callbacks for them only
+			_collide(_pair_key_get_from(_pair_keys[n]), _pair_key_get_to(_pair_keys[n]));
+		}
+
+		_reset();
+	}
+
+	// Finds the pairs leaving and entering for one range of changed items, without modifying anything.
+	void _find_pairing_changes(uint32_t p_task_index, void *p_userdata) {
+		PairingTask &task = _pairing_tasks[p_task_index];
+		task.leavers.clear();
+		task.enterers.clear();
 
 		typename BVHTREE_CLASS::CullParams params;
 
@@ -443,8 +510,14 @@ private:
 		params.result_max = INT_MAX;
 		params.result_array = nullptr;
 		params.subindex_array = nullptr;
+		params.hits = &task.cull_hits;
+
+		const uint32_t begin = p_task_index * PAIRING_TASK_SIZE;
+		const uint32_t end = MIN(begin + PAIRING_TASK_SIZE, changed_items.size());
+
+		for (uint32_t i = begin; i < end; i++) {
+			const BVHHandle h = changed_items[i];
 
-		for (const BVHHandle &h : changed_items) {
 			// use the expanded aabb for pairing
 			const BOUNDS &expanded_aabb = tree._pairs[h.id()].expanded_aabb;
 			BVHABB_CLASS abb;
@@ -452,9 +525,14 @@ private:
 
 			tree.item_fill_cullparams(h, params);
 
-			// find all the existing paired aabbs that are no longer
-			// paired, and send callbacks
-			_find_leavers(h, abb, p_full_check);
+			// find all the existing paired aabbs that are no longer paired
+			const typename BVHTREE_CLASS::ItemPairs &pairs = tree._pairs[h.id()];
+			for (unsigned int n = 0; n < pairs.extended_pairs.size(); n++) {
+				BVHHandle h_to = pairs.extended_pairs[n].handle;
+				if (_is_leaver(abb, h, h_to, _pairing_full_check)) {
+					task.leavers.push_back(_make_pair_key(h, h_to));
+				}
+			}
 
 			uint32_t changed_item_ref_id = h.id();
 
@@ -463,7 +541,7 @@ private:
 			params.result_count_overall = 0; // might not be needed
 			tree.cull_aabb(params, false);
 
-			for (const uint32_t ref_id : tree._cull_hits) {
+			for (const uint32_t ref_id : task.cull_hits) {
 				// don't collide against ourself
 				if (ref_id == changed_item_ref_id) {
 					continue;
@@ -473,11 +551,38 @@ private:
 				BVHHandle h_collidee;
 				h_collidee.set_id(ref_id);
 
-				// find NEW enterers, and send callbacks for them only
-				_collide(h, h_collidee);
+				if (_is_new_pair(h, h_collidee)) {
+					task.enterers.push_back(_make_pair_key(h, h_collidee));
+				}
 			}
 		}
-		_reset();
+	}
+
+	// The lower id goes in the high bits, so sorted keys are ordered as the pairs would be.
+	uint64_t _make_pair_key(BVHHandle p_ha, BVHHandle p_hb) const {
+		tree._handle_sort(p_ha, p_hb);
+		return (uint64_t(p_ha.id()) << 32) | p_hb.id();
+	}
+	BVHHandle _pair_key_get_from(uint64_t p_key) const {
+		BVHHandle h;
+		h.set_id(p_key >> 32);
+		return h;
+	}
+	BVHHandle _pair_key_get_to(uint64_t p_key) const {
+		BVHHandle h;
+		h.set_id(p_key & 0xFFFFFFFF);
+		return h;
+	}
+
+	void _gather_pair_keys(uint32_t p_task_count, bool p_enterers) {
+		_pair_keys.clear();
+		for (uint32_t n = 0; n < p_task_count; n++) {
+			const LocalVector<uint64_t, uint32_t, true> &keys = p_enterers ? _pairing_tasks[n].enterers : _pairing_tasks[n].leavers;
+			for (const uint64_t key : keys) {
+				_pair_keys.push_back(key);
+			}
+		}
+		_pair_keys.sort();
 	}
 
 public:
@@ -540,8 +645,8 @@ private:
 		return p_pair_data;
 	}
 
-	// returns true if unpair
-	bool _find_leavers_process_pair(typename BVHTREE_CLASS::ItemPairs &p_pairs_from, const BVHABB_CLASS &p_abb_from, BVHHandle p_from, BVHHandle p_to, bool p_full_check) {
+	// returns true if the pair should be unpaired
+	bool _is_leaver(const BVHABB_CLASS &p_abb_from, BVHHandle p_from, BVHHandle p_to, bool p_full_check) {
 		BVHABB_CLASS abb_to;
 		tree.item_get_ABB(p_to, abb_to);
 
@@ -568,27 +673,33 @@ private:
 			}
 		}
 
-		_unpair(p_from, p_to);
 		return true;
 	}
 
-	// find all the existing paired aabbs that are no longer
-	// paired, and send callbacks
-	void _find_leavers(BVHHandle p_handle, const BVHABB_CLASS &expanded_abb_from, bool p_full_check) {
-		typename BVHTREE_CLASS::ItemPairs &p_from = tree._pairs[p_handle.id()];
+	// returns true if the pair is allowed and doesn't exist yet
+	bool _is_new_pair(BVHHandle p_ha, BVHHandle p_hb) const {
+		const typename BVHTREE_CLASS::ItemExtra &exa = _get_extra(p_ha);
+		const typename BVHTREE_CLASS::ItemExtra &exb = _get_extra(p_hb);
 
-		BVHABB_CLASS abb_from = expanded_abb_from;
+		// user collision callback
+		if (!USER_PAIR_TEST_FUNCTION::user_pair_check(exa.userdata, exb.userdata)) {
+			return false;
+		}
 
-		// remove from pairing list for every partner
-		for (unsigned int n = 0; n < p_from.extended_pairs.size(); n++) {
-			BVHHandle h_to = p_from.extended_pairs[n].handle;
-			if (_find_leavers_process_pair(p_from, abb_from, p_handle, h_to, p_full_check)) {
-				// we need to keep the counter n up to date if we deleted a pair
-				// as the number of items in p_from.extended_pairs will have decreased by 1
-				// and we don't want to miss an item
-				n--;
-			}
+		// if the userdata is the same, no collisions should occur
+		if ((exa.userdata == exb.userdata) && exa.userdata) {
+			return false;
 		}
+
+		const typename BVHTREE_CLASS::ItemPairs &p_from = tree._pairs[p_ha.id()];
+		const typename BVHTREE_CLASS::ItemPairs &p_to = tree._pairs[p_hb.id()];
+
+		// does this pair exist already?
+		// or only check the one with lower number of pairs for greater speed
+		if (p_from.num_pairs <= p_to.num_pairs) {
+			return !p_from.contains_pair_to(p_hb);
+		}
+		return !p_to.contains_pair_to(p_ha);
 	}
 
 	// find NEW enterers, and send callbacks for them only
@@ -597,34 +708,16 @@ private:
 		// only have to do this oneway, lower ID then higher ID
 		tree._handle_sort(p_ha, p_hb);
 
-		const typename BVHTREE_CLASS::ItemExtra &exa = _get_extra(p_ha);
-		const typename BVHTREE_CLASS::ItemExtra &exb = _get_extra(p_hb);
-
-		// user collision callback
-		if (!USER_PAIR_TEST_FUNCTION::user_pair_check(exa.userdata, exb.userdata)) {
+		if (!_is_new_pair(p_ha, p_hb)) {
 			return;
 		}
 
-		// if the userdata is the same, no collisions should occur
-		if ((exa.userdata == exb.userdata) && exa.userdata) {
-			return;
-		}
+		const typename BVHTREE_CLASS::ItemExtra &exa = _get_extra(p_ha);
+		const typename BVHTREE_CLASS::ItemExtra &exb = _get_extra(p_hb);
 
 		typename BVHTREE_CLASS::ItemPairs &p_from = tree._pairs[p_ha.id()];
 		typename BVHTREE_CLASS::ItemPairs &p_to = tree._pairs[p_hb.id()];
 
-		// does this pair exist already?
-		// or only check the one with lower number of pairs for greater speed
-		if (p_from.num_pairs <= p_to.num_pairs) {
-			if (p_from.contains_pair_to(p_hb)) {
-				return;
-			}
-		} else {
-			if (p_to.contains_pair_to(p_ha)) {
-				return;
-			}
-		}
-
 		// callback
 		void *callback_userdata = nullptr;
 
@@ -773,6 +866,21 @@ private:
 	LocalVector<BVHHandle, uint32_t, true> changed_items;
 	uint32_t _tick = 1; // Start from 1 so items with 0 indicate never updated.
 
+	// Changed items checked by each pairing task, when they are spread over the worker threads.
+	enum {
+		PAIRING_TASK_SIZE = 128,
+	};
+
+	// Kept between ticks, to save on allocations.
+	struct PairingTask {
+		LocalVector<uint32_t, uint32_t, true> cull_hits;
+		LocalVector<uint64_t, uint32_t, true> leavers;
+		LocalVector<uint64_t, uint32_t, true> enterers;
+	};
+	LocalVector<PairingTask> _pairing_tasks;
+	LocalVector<uint64_t, uint32_t, true> _pair_keys;
+	bool _pairing_full_check = false;
+
 	class BVHLockedFunction {
 	public:
 		BVHLockedFunction(Mutex *p_mutex, bool p_thread_safe) {
@@ -38,6 +38,7 @@
 // Makes callable_mp readily available in all classes connecting signals.
 // Needs to come after method_bind and object have been included.
 #include "core/object/callable_method_pointer.h"
+#include "core/templates/flat_hash_map.h"
 #include "core/templates/hash_set.h"
 
 #include <type_traits>
@@ -125,7 +126,8 @@ public:
 		HashMap<StringName, Vector<Error>> method_error_values;
 		HashMap<StringName, List<StringName>> linked_properties;
 #endif
-		HashMap<StringName, PropertySetGet> property_setget;
+		// Looked up on every Object::set()/get() by name. Its order is never used, the property order is in property_list.
+		FlatHashMap<StringName, PropertySetGet> property_setget;
 
 		StringName inherits;
 		StringName name;
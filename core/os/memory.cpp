@@ -33,8 +33,13 @@
 #include "core/error/error_macros.h"
 #include "core/templates/safe_refcount.h"
 
+#ifdef SMALL_ALLOCATOR_ENABLED
+#include "core/os/small_object_allocator.h"
+#endif
+
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 void *operator new(size_t p_size, const char *p_description) {
 	return Memory::alloc_static(p_size, false);
@@ -65,14 +70,83 @@ SafeNumeric<uint64_t> Memory::max_usage;
 
 SafeNumeric<uint64_t> Memory::alloc_count;
 
-void *Memory::alloc_static(size_t p_bytes, bool p_pad_align) {
+#ifdef SMALL_ALLOCATOR_ENABLED
+// The small allocator needs the block size on free, so every allocation is
+// prepadded and the size stored in the header selects the allocator.
+_FORCE_INLINE_ static void *_raw_alloc(size_t p_bytes) {
+	if (SmallObjectAllocator::is_small(p_bytes)) {
+		return SmallObjectAllocator::alloc(p_bytes);
+	}
+	return malloc(p_bytes);
+}
+
+_FORCE_INLINE_ static void _raw_free(void *p_mem, size_t p_bytes) {
+	if (SmallObjectAllocator::is_small(p_bytes)) {
+		SmallObjectAllocator::free(p_mem, p_bytes);
+	} else {
+		free(p_mem);
+	}
+}
+
+static void *_raw_realloc(void *p_mem, size_t p_old_bytes, size_t p_bytes) {
+	const bool old_small = SmallObjectAllocator::is_small(p_old_bytes);
+	const bool new_small = SmallObjectAllocator::is_small(p_bytes);
+	if (!old_small && !new_small) {
+		return realloc(p_mem, p_bytes);
+	}
+	if (old_small && new_small && SmallObjectAllocator::get_size_class(p_old_bytes) == SmallObjectAllocator::get_size_class(p_bytes)) {
+		return p_mem;
+	}
+	void *new_mem = _raw_alloc(p_bytes);
+	if (new_mem) {
+		memcpy(new_mem, p_mem, MIN(p_old_bytes, p_bytes));
+		_raw_free(p_mem, p_old_bytes);
+	}
+	return new_mem;
+}
+#endif
+
 #ifdef DEBUG_ENABLED
+// In debug builds, the top byte of the allocation header holds the tag the
+// allocation was tracked under, the remaining bits hold its size.
+#define HEADER_TAG_SHIFT 56
+#define HEADER_SIZE_MASK ((uint64_t(1) << HEADER_TAG_SHIFT) - 1)
+#define HEADER_UNTRACKED 0xFF
+
+thread_local uint8_t Memory::current_tag = Memory::TAG_DEFAULT;
+SafeFlag Memory::tracking_enabled;
+SafeNumeric<uint64_t> Memory::tag_usage[Memory::TAG_MAX];
+SafeNumeric<uint64_t> Memory::tag_alloc_count[Memory::TAG_MAX];
+
+_FORCE_INLINE_ static uint64_t _header_get_size(const uint64_t *p_header) {
+	return *p_header & HEADER_SIZE_MASK;
+}
+
+_FORCE_INLINE_ static uint8_t _header_get_tag(const uint64_t *p_header) {
+	return *p_header >> HEADER_TAG_SHIFT;
+}
+
+_FORCE_INLINE_ static void _header_set(uint64_t *p_header, uint64_t p_size, uint8_t p_tag) {
+	*p_header = p_size | (uint64_t(p_tag) << HEADER_TAG_SHIFT);
+}
+#else
+_FORCE_INLINE_ static uint64_t _header_get_size(const uint64_t *p_header) {
+	return *p_header;
+}
+#endif
+
+void *Memory::alloc_static(size_t p_bytes, bool p_pad_align) {
+#if defined(DEBUG_ENABLED) || defined(SMALL_ALLOCATOR_ENABLED)
 	bool prepad = true;
 #else
 	bool prepad = p_pad_align;
 #endif
 
+#ifdef SMALL_ALLOCATOR_ENABLED
+	void *mem = _raw_alloc(p_bytes + PAD_ALIGN);
+#else
 	void *mem = malloc(p_bytes + (prepad ? PAD_ALIGN : 0));
+#endif
 
 	ERR_FAIL_NULL_V(mem, nullptr);
 
@@ -80,13 +154,22 @@ void *Memory::alloc_static(size_t p_bytes, bool p_pad_align) {
 
 	if (prepad) {
 		uint64_t *s = (uint64_t *)mem;
-		*s = p_bytes;
 
 		uint8_t *s8 = (uint8_t *)mem;
 
 #ifdef DEBUG_ENABLED
+		uint8_t tag = HEADER_UNTRACKED;
+		if (unlikely(tracking_enabled.is_set())) {
+			tag = current_tag;
+			tag_usage[tag].add(p_bytes);
+			tag_alloc_count[tag].increment();
+		}
+		_header_set(s, p_bytes, tag);
+
 		uint64_t new_mem_usage = mem_usage.add(p_bytes);
 		max_usage.exchange_if_greater(new_mem_usage);
+#else
+		*s = p_bytes;
 #endif
 		return s8 + PAD_ALIGN;
 	} else {
@@ -101,7 +184,7 @@ void *Memory::realloc_static(void *p_memory, size_t p_bytes, bool p_pad_align) {
 
 	uint8_t *mem = (uint8_t *)p_memory;
 
-#ifdef DEBUG_ENABLED
+#if defined(DEBUG_ENABLED) || defined(SMALL_ALLOCATOR_ENABLED)
 	bool prepad = true;
 #else
 	bool prepad = p_pad_align;
@@ -110,28 +193,46 @@ void *Memory::realloc_static(void *p_memory, size_t p_bytes, bool p_pad_align) {
 	if (prepad) {
 		mem -= PAD_ALIGN;
 		uint64_t *s = (uint64_t *)mem;
+		[[maybe_unused]] uint64_t old_bytes = _header_get_size(s);
 
 #ifdef DEBUG_ENABLED
-		if (p_bytes > *s) {
-			uint64_t new_mem_usage = mem_usage.add(p_bytes - *s);
+		uint8_t tag = _header_get_tag(s);
+		if (p_bytes > old_bytes) {
+			uint64_t new_mem_usage = mem_usage.add(p_bytes - old_bytes);
 			max_usage.exchange_if_greater(new_mem_usage);
+			if (tag != HEADER_UNTRACKED) {
+				tag_usage[tag].add(p_bytes - old_bytes);
+			}
 		} else {
-			mem_usage.sub(*s - p_bytes);
+			mem_usage.sub(old_bytes - p_bytes);
+			if (tag != HEADER_UNTRACKED) {
+				tag_usage[tag].sub(old_bytes - p_bytes);
+			}
 		}
 #endif
 
 		if (p_bytes == 0) {
+#ifdef SMALL_ALLOCATOR_ENABLED
+			_raw_free(mem, old_bytes + PAD_ALIGN);
+#else
 			free(mem);
+#endif
 			return nullptr;
 		} else {
-			*s = p_bytes;
-
+#ifdef SMALL_ALLOCATOR_ENABLED
+			mem = (uint8_t *)_raw_realloc(mem, old_bytes + PAD_ALIGN, p_bytes + PAD_ALIGN);
+#else
 			mem = (uint8_t *)realloc(mem, p_bytes + PAD_ALIGN);
+#endif
 			ERR_FAIL_NULL_V(mem, nullptr);
 
 			s = (uint64_t *)mem;
 
+#ifdef DEBUG_ENABLED
+			_header_set(s, p_bytes, tag);
+#else
 			*s = p_bytes;
+#endif
 
 			return mem + PAD_ALIGN;
 		}
@@ -149,7 +250,7 @@ void Memory::free_static(void *p_ptr, bool p_pad_align) {
 
 	uint8_t *mem = (uint8_t *)p_ptr;
 
-#ifdef DEBUG_ENABLED
+#if defined(DEBUG_ENABLED) || defined(SMALL_ALLOCATOR_ENABLED)
 	bool prepad = true;
 #else
 	bool prepad = p_pad_align;
@@ -162,10 +263,18 @@ void Memory::free_static(void *p_ptr, bool p_pad_align) {
 
 #ifdef DEBUG_ENABLED
 		uint64_t *s = (uint64_t *)mem;
-		mem_usage.sub(*s);
+		uint8_t tag = _header_get_tag(s);
+		if (tag != HEADER_UNTRACKED) {
+			tag_usage[tag].sub(_header_get_size(s));
+		}
+		mem_usage.sub(_header_get_size(s));
 #endif
 
+#ifdef SMALL_ALLOCATOR_ENABLED
+		_raw_free(mem, _header_get_size((uint64_t *)mem) + PAD_ALIGN);
+#else
 		free(mem);
+#endif
 	} else {
 		free(mem);
 	}
@@ -191,6 +300,52 @@ uint64_t Memory::get_mem_max_usage() {
 #endif
 }
 
+void Memory::set_tracking_enabled(bool p_enabled) {
+#ifdef DEBUG_ENABLED
+	tracking_enabled.set_to(p_enabled);
+#endif
+}
+
+bool Memory::is_tracking_enabled() {
+#ifdef DEBUG_ENABLED
+	return tracking_enabled.is_set();
+#else
+	return false;
+#endif
+}
+
+uint64_t Memory::get_tag_usage(Tag p_tag) {
+	ERR_FAIL_INDEX_V(p_tag, TAG_MAX, 0);
+#ifdef DEBUG_ENABLED
+	return tag_usage[p_tag].get();
+#else
+	return 0;
+#endif
+}
+
+uint64_t Memory::get_tag_alloc_count(Tag p_tag) {
+	ERR_FAIL_INDEX_V(p_tag, TAG_MAX, 0);
+#ifdef DEBUG_ENABLED
+	return tag_alloc_count[p_tag].get();
+#else
+	return 0;
+#endif
+}
+
+const char *Memory::get_tag_name(Tag p_tag) {
+	static const char *tag_names[TAG_MAX] = {
+		"default",
+		"rendering",
+		"physics",
+		"audio",
+		"navigation",
+		"scripts",
+		"resources",
+	};
+	ERR_FAIL_INDEX_V(p_tag, TAG_MAX, "");
+	return tag_names[p_tag];
+}
+
 _GlobalNil::_GlobalNil() {
 	left = this;
 	right = this;
@@ -43,13 +43,34 @@
 #endif
 
 class Memory {
+public:
+	// Engine subsystems that allocations can be attributed to while tracking is enabled.
+	enum Tag {
+		TAG_DEFAULT,
+		TAG_RENDERING,
+		TAG_PHYSICS,
+		TAG_AUDIO,
+		TAG_NAVIGATION,
+		TAG_SCRIPTS,
+		TAG_RESOURCES,
+		TAG_MAX,
+	};
+
+private:
 #ifdef DEBUG_ENABLED
 	static SafeNumeric<uint64_t> mem_usage;
 	static SafeNumeric<uint64_t> max_usage;
+
+	static thread_local uint8_t current_tag;
+	static SafeFlag tracking_enabled;
+	static SafeNumeric<uint64_t> tag_usage[TAG_MAX];
+	static SafeNumeric<uint64_t> tag_alloc_count[TAG_MAX];
 #endif
 
 	static SafeNumeric<uint64_t> alloc_count;
 
+	friend class MemoryTagScope;
+
 public:
 	static void *alloc_static(size_t p_bytes, bool p_pad_align = false);
 	static void *realloc_static(void *p_memory, size_t p_bytes, bool p_pad_align = false);
@@ -58,6 +79,32 @@ public:
 	static uint64_t get_mem_available();
 	static uint64_t get_mem_usage();
 	static uint64_t get_mem_max_usage();
+
+	// Allocation tracking (only works in debug).
+	static void set_tracking_enabled(bool p_enabled);
+	static bool is_tracking_enabled();
+	static uint64_t get_tag_usage(Tag p_tag);
+	static uint64_t get_tag_alloc_count(Tag p_tag);
+	static const char *get_tag_name(Tag p_tag);
+};
+
+// Attributes allocations made by the current thread to a tag for as long as it is in scope.
+class MemoryTagScope {
+#ifdef DEBUG_ENABLED
+	uint8_t previous_tag;
+
+public:
+	_FORCE_INLINE_ explicit MemoryTagScope(Memory::Tag p_tag) {
+		previous_tag = Memory::current_tag;
+		Memory::current_tag = p_tag;
+	}
+	_FORCE_INLINE_ ~MemoryTagScope() {
+		Memory::current_tag = previous_tag;
+	}
+#else
+public:
+	_FORCE_INLINE_ explicit MemoryTagScope(Memory::Tag p_tag) {}
+#endif
 };
 
 class DefaultAllocator {
@@ -36,6 +36,8 @@
 #include "core/io/file_access.h"
 #include "core/io/json.h"
 #include "core/os/midi_driver.h"
+#include "core/os/small_object_allocator.h"
+#include "core/variant/typed_array.h"
 #include "core/version_generated.gen.h"
 
 #include <stdarg.h>
@@ -323,6 +325,24 @@ uint64_t OS::get_static_memory_peak_usage() const {
 	return Memory::get_mem_max_usage();
 }
 
+TypedArray<Dictionary> OS::get_static_memory_size_classes() const {
+	TypedArray<Dictionary> size_classes;
+#ifdef SMALL_ALLOCATOR_ENABLED
+	SmallObjectAllocator::SizeClassInfo info[SmallObjectAllocator::SIZE_CLASS_COUNT];
+	SmallObjectAllocator::get_size_class_info(info);
+	for (int i = 0; i < SmallObjectAllocator::SIZE_CLASS_COUNT; i++) {
+		Dictionary size_class;
+		size_class["size"] = info[i].size;
+		size_class["reserved"] = info[i].reserved_blocks;
+		size_class["free"] = info[i].free_blocks;
+		size_class["held"] = info[i].thread_blocks;
+		size_class["refills"] = info[i].refills;
+		size_classes.push_back(size_class);
+	}
+#endif
+	return size_classes;
+}
+
 Error OS::set_cwd(const String &p_cwd) {
 	return ERR_CANT_OPEN;
 }
@@ -0,0 +1,237 @@
+/**************************************************************************/
+/*  small_object_allocator.cpp                                            */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "small_object_allocator.h"
+
+#include "core/error/error_macros.h"
+#include "core/os/spin_lock.h"
+
+#include <stdlib.h>
+
+namespace {
+
+enum {
+	CHUNK_SIZE = 64 * 1024,
+	BATCH_SIZE = 32,
+	THREAD_CACHE_MAX = BATCH_SIZE * 2,
+};
+
+struct FreeBlock {
+	FreeBlock *next;
+};
+
+// Everything here is constant-initialized, since allocations may happen
+// before or after static constructors and destructors run.
+
+struct SharedSizeClass {
+	SpinLock lock;
+	FreeBlock *free_list = nullptr;
+	uint64_t free_blocks = 0;
+	uint64_t reserved_blocks = 0;
+	uint64_t refills = 0;
+};
+
+struct ThreadCache {
+	FreeBlock *free_list[SmallObjectAllocator::SIZE_CLASS_COUNT] = {};
+	uint32_t free_blocks[SmallObjectAllocator::SIZE_CLASS_COUNT] = {};
+	bool registered = false;
+	bool released = false;
+};
+
+const uint32_t size_class_sizes[SmallObjectAllocator::SIZE_CLASS_COUNT] = {
+	16, 32, 48, 64, 80, 96, 112, 128,
+	160, 192, 224, 256,
+	320, 384, 448, 512
+};
+
+SharedSizeClass shared_classes[SmallObjectAllocator::SIZE_CLASS_COUNT];
+
+thread_local ThreadCache thread_cache;
+
+void _return_to_shared(uint32_t p_class, FreeBlock *p_first, FreeBlock *p_last, uint32_t p_count) {
+	SharedSizeClass &shared = shared_classes[p_class];
+	shared.lock.lock();
+	p_last->next = shared.free_list;
+	shared.free_list = p_first;
+	shared.free_blocks += p_count;
+	shared.lock.unlock();
+}
+
+// Flushes the thread cache when the thread exits. Kept separate from the
+// cache itself, so blocks freed by later thread_local destructors can still
+// find the (released) cache and go straight to the shared lists.
+struct ThreadCacheReleaser {
+	bool active = false;
+
+	~ThreadCacheReleaser() {
+		for (uint32_t i = 0; i < SmallObjectAllocator::SIZE_CLASS_COUNT; i++) {
+			FreeBlock *first = thread_cache.free_list[i];
+			if (!first) {
+				continue;
+			}
+			FreeBlock *last = first;
+			while (last->next) {
+				last = last->next;
+			}
+			_return_to_shared(i, first, last, thread_cache.free_blocks[i]);
+			thread_cache.free_list[i] = nullptr;
+			thread_cache.free_blocks[i] = 0;
+		}
+		thread_cache.released = true;
+	}
+};
+
+thread_local ThreadCacheReleaser thread_cache_releaser;
+
+_FORCE_INLINE_ void _register_thread_cache(ThreadCache &r_cache) {
+	if (unlikely(!r_cache.registered)) {
+		// First use of the releaser on this thread registers its destructor.
+		thread_cache_releaser.active = true;
+		r_cache.registered = true;
+	}
+}
+
+// Takes up to p_max blocks from the shared list, carving a new chunk if it is empty.
+FreeBlock *_take_from_shared(uint32_t p_class, uint32_t p_max, uint32_t &r_count) {
+	SharedSizeClass &shared = shared_classes[p_class];
+	const uint32_t block_size = size_class_sizes[p_class];
+
+	shared.lock.lock();
+
+	if (!shared.free_list) {
+		uint8_t *chunk = (uint8_t *)malloc(CHUNK_SIZE);
+		if (!chunk) {
+			shared.lock.unlock();
+			r_count = 0;
+			return nullptr;
+		}
+		const uint32_t block_count = CHUNK_SIZE / block_size;
+		for (uint32_t i = 0; i < block_count; i++) {
+			FreeBlock *block = (FreeBlock *)(chunk + i * block_size);
+			block->next = shared.free_list;
+			shared.free_list = block;
+		}
+		shared.free_blocks += block_count;
+		shared.reserved_blocks += block_count;
+	}
+
+	FreeBlock *first = shared.free_list;
+	FreeBlock *last = first;
+	uint32_t count = 1;
+	while (count < p_max && last->next) {
+		last = last->next;
+		count++;
+	}
+	shared.free_list = last->next;
+	shared.free_blocks -= count;
+	shared.refills++;
+
+	shared.lock.unlock();
+
+	last->next = nullptr;
+	r_count = count;
+	return first;
+}
+
+} // namespace
+
+uint32_t SmallObjectAllocator::get_size_class_size(uint32_t p_class) {
+	ERR_FAIL_UNSIGNED_INDEX_V(p_class, (uint32_t)SIZE_CLASS_COUNT, 0);
+	return size_class_sizes[p_class];
+}
+
+void *SmallObjectAllocator::alloc(size_t p_bytes) {
+	const uint32_t size_class = get_size_class(p_bytes);
+	ThreadCache &cache = thread_cache;
+
+	if (unlikely(cache.released)) {
+		// Thread is exiting, bypass the cache.
+		uint32_t count = 0;
+		return _take_from_shared(size_class, 1, count);
+	}
+
+	FreeBlock *block = cache.free_list[size_class];
+	if (unlikely(!block)) {
+		_register_thread_cache(cache);
+		uint32_t count = 0;
+		block = _take_from_shared(size_class, BATCH_SIZE, count);
+		if (!block) {
+			return nullptr;
+		}
+		cache.free_blocks[size_class] = count;
+	}
+
+	cache.free_list[size_class] = block->next;
+	cache.free_blocks[size_class]--;
+	return block;
+}
+
+void SmallObjectAllocator::free(void *p_ptr, size_t p_bytes) {
+	const uint32_t size_class = get_size_class(p_bytes);
+	ThreadCache &cache = thread_cache;
+	FreeBlock *block = (FreeBlock *)p_ptr;
+
+	if (unlikely(cache.released)) {
+		// Thread is exiting, don't keep blocks that would leak with it.
+		block->next = nullptr;
+		_return_to_shared(size_class, block, block, 1);
+		return;
+	}
+	_register_thread_cache(cache);
+
+	block->next = cache.free_list[size_class];
+	cache.free_list[size_class] = block;
+	cache.free_blocks[size_class]++;
+
+	if (unlikely(cache.free_blocks[size_class] > THREAD_CACHE_MAX)) {
+		// Give a batch back, so memory freed on one thread can be reused by others.
+		FreeBlock *first = cache.free_list[size_class];
+		FreeBlock *last = first;
+		for (uint32_t i = 1; i < BATCH_SIZE; i++) {
+			last = last->next;
+		}
+		cache.free_list[size_class] = last->next;
+		cache.free_blocks[size_class] -= BATCH_SIZE;
+		_return_to_shared(size_class, first, last, BATCH_SIZE);
+	}
+}
+
+void SmallObjectAllocator::get_size_class_info(SizeClassInfo *r_info) {
+	for (uint32_t i = 0; i < SIZE_CLASS_COUNT; i++) {
+		SharedSizeClass &shared = shared_classes[i];
+		shared.lock.lock();
+		r_info[i].size = size_class_sizes[i];
+		r_info[i].reserved_blocks = shared.reserved_blocks;
+		r_info[i].free_blocks = shared.free_blocks;
+		r_info[i].thread_blocks = shared.reserved_blocks - shared.free_blocks;
+		r_info[i].refills = shared.refills;
+		shared.lock.unlock();
+	}
+}
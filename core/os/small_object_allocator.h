@@ -0,0 +1,80 @@
+/**************************************************************************/
+/*  small_object_allocator.h                                              */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef SMALL_OBJECT_ALLOCATOR_H
+#define SMALL_OBJECT_ALLOCATOR_H
+
+#include "core/typedefs.h"
+
+#include <stddef.h>
+
+// Size-class allocator with per-thread caches, used by Memory for small blocks
+// when the engine is built with `small_allocator=yes`.
+//
+// Blocks are carved from chunks that are never returned to the system. Each
+// thread keeps a short free list per size class and exchanges blocks with the
+// shared lists in batches, so most allocations never touch a lock.
+class SmallObjectAllocator {
+public:
+	enum {
+		SIZE_CLASS_COUNT = 16,
+		MAX_SIZE = 512,
+	};
+
+	struct SizeClassInfo {
+		uint32_t size = 0;
+		uint64_t reserved_blocks = 0; // Blocks carved from chunks.
+		uint64_t free_blocks = 0; // Blocks in the shared free list.
+		uint64_t thread_blocks = 0; // Blocks in use or held by thread caches.
+		uint64_t refills = 0; // Batches handed out to thread caches.
+	};
+
+	_FORCE_INLINE_ static bool is_small(size_t p_bytes) { return p_bytes <= MAX_SIZE; }
+
+	_FORCE_INLINE_ static uint32_t get_size_class(size_t p_bytes) {
+		// 16 byte steps up to 128, 32 byte steps up to 256 and 64 byte steps up to 512.
+		if (p_bytes <= 128) {
+			return p_bytes <= 16 ? 0 : (p_bytes - 1) >> 4;
+		} else if (p_bytes <= 256) {
+			return 8 + ((p_bytes - 129) >> 5);
+		} else {
+			return 12 + ((p_bytes - 257) >> 6);
+		}
+	}
+
+	static uint32_t get_size_class_size(uint32_t p_class);
+
+	static void *alloc(size_t p_bytes);
+	static void free(void *p_ptr, size_t p_bytes);
+
+	static void get_size_class_info(SizeClassInfo *r_info);
+};
+
+#endif // SMALL_OBJECT_ALLOCATOR_H
@@ -48,7 +48,12 @@ class StringName {
 	enum {
 		STRING_TABLE_BITS = 16,
 		STRING_TABLE_LEN = 1 << STRING_TABLE_BITS,
-		STRING_TABLE_MASK = STRING_TABLE_LEN - 1
+		STRING_TABLE_MASK = STRING_TABLE_LEN - 1,
+		// Buckets are guarded by a set of interleaved locks, so threads interning
+		// unrelated names rarely contend with each other.
+		STRING_TABLE_LOCK_BITS = 6,
+		STRING_TABLE_LOCK_LEN = 1 << STRING_TABLE_LOCK_BITS,
+		STRING_TABLE_LOCK_MASK = STRING_TABLE_LOCK_LEN - 1
 	};
 
 	struct _Data {
@@ -81,6 +86,8 @@ class StringName {
 	friend void unregister_core_types();
 	friend class Main;
 	static Mutex mutex;
+	static Mutex table_mutex[STRING_TABLE_LOCK_LEN];
+	_FORCE_INLINE_ static Mutex &_get_table_mutex(uint32_t p_idx) { return table_mutex[p_idx & STRING_TABLE_LOCK_MASK]; }
 	static void setup();
 	static void cleanup();
 	static bool configured;
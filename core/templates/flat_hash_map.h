@@ -0,0 +1,480 @@
+/**************************************************************************/
+/*  flat_hash_map.h                                                       */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef FLAT_HASH_MAP_H
+#define FLAT_HASH_MAP_H
+
+#include "core/os/memory.h"
+#include "core/templates/hashfuncs.h"
+#include "core/templates/pair.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FLAT_HASH_MAP_SSE2
+#include <emmintrin.h>
+#endif
+
+/**
+ * A HashMap implementation with keys and values stored inline, in the style of
+ * Swiss tables. Slots are organized in groups of 16, each slot having a control
+ * byte that is either empty, deleted, or holds 7 bits of the key's hash. A
+ * lookup compares all 16 control bytes of a group at once (with SSE2 when
+ * available), so most hits only touch the key they are looking for.
+ *
+ * Compared to HashMap, lookups don't chase a pointer per element, but
+ * iteration is in slot order rather than insertion order, and elements move
+ * in memory when the map grows: pointers to values are only valid until the
+ * next insertion.
+ */
+
+template <class TKey, class TValue,
+		class Hasher = HashMapHasherDefault,
+		class Comparator = HashMapComparatorDefault<TKey>>
+class FlatHashMap {
+public:
+	static constexpr uint32_t GROUP_SIZE = 16;
+	static constexpr uint32_t MIN_CAPACITY = GROUP_SIZE;
+
+private:
+	typedef KeyValue<TKey, TValue> Slot;
+
+	static constexpr int8_t CTRL_EMPTY = -128; // 0b10000000
+	static constexpr int8_t CTRL_DELETED = -2; // 0b11111110
+
+	// Control bytes, one per slot. Full slots hold the low 7 bits of the hash.
+	int8_t *ctrl = nullptr;
+	KeyValue<TKey, TValue> *slots = nullptr;
+
+	uint32_t capacity = 0; // Always a power of two multiple of GROUP_SIZE.
+	uint32_t num_elements = 0;
+	uint32_t num_deleted = 0;
+
+	// Bitmask helpers, bit N is set when slot N of the group matches.
+	static _FORCE_INLINE_ uint32_t _match(const int8_t *p_group, int8_t p_value) {
+#ifdef FLAT_HASH_MAP_SSE2
+		__m128i group = _mm_loadu_si128((const __m128i *)p_group);
+		return _mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(p_value)));
+#else
+		uint32_t mask = 0;
+		for (uint32_t i = 0; i < GROUP_SIZE; i++) {
+			mask |= uint32_t(p_group[i] == p_value) << i;
+		}
+		return mask;
+#endif
+	}
+
+	static _FORCE_INLINE_ uint32_t _match_empty_or_deleted(const int8_t *p_group) {
+#ifdef FLAT_HASH_MAP_SSE2
+		// Only empty and deleted slots have the sign bit set.
+		return _mm_movemask_epi8(_mm_loadu_si128((const __m128i *)p_group));
+#else
+		uint32_t mask = 0;
+		for (uint32_t i = 0; i < GROUP_SIZE; i++) {
+			mask |= uint32_t(p_group[i] < 0) << i;
+		}
+		return mask;
+#endif
+	}
+
+	static _FORCE_INLINE_ uint32_t _lowest_bit(uint32_t p_mask) {
+#if defined(__GNUC__) || defined(__clang__)
+		return __builtin_ctz(p_mask);
+#else
+		uint32_t index = 0;
+		while (!(p_mask & 1)) {
+			p_mask >>= 1;
+			index++;
+		}
+		return index;
+#endif
+	}
+
+	static _FORCE_INLINE_ uint32_t _hash(const TKey &p_key) {
+		// Mix, since the low bits pick the control byte and the high bits the group.
+		return hash_fmix32(Hasher::hash(p_key));
+	}
+
+	static _FORCE_INLINE_ int8_t _h2(uint32_t p_hash) {
+		return int8_t(p_hash & 0x7F);
+	}
+
+	static _FORCE_INLINE_ uint32_t _max_load(uint32_t p_capacity) {
+		return p_capacity - p_capacity / 8;
+	}
+
+	// Probes groups in triangular order, which visits every group once when their count is a power of two.
+	bool _lookup_pos(const TKey &p_key, uint32_t p_hash, uint32_t &r_pos) const {
+		if (num_elements == 0) {
+			return false;
+		}
+		const uint32_t group_mask = capacity / GROUP_SIZE - 1;
+		const int8_t h2 = _h2(p_hash);
+		uint32_t group = (p_hash >> 7) & group_mask;
+		for (uint32_t step = 1;; step++) {
+			const int8_t *group_ctrl = ctrl + group * GROUP_SIZE;
+			uint32_t mask = _match(group_ctrl, h2);
+			while (mask) {
+				uint32_t pos = group * GROUP_SIZE + _lowest_bit(mask);
+				if (Comparator::compare(slots[pos].key, p_key)) {
+					r_pos = pos;
+					return true;
+				}
+				mask &= mask - 1;
+			}
+			if (_match(group_ctrl, CTRL_EMPTY)) {
+				return false;
+			}
+			if (step > group_mask) {
+				return false; // Visited every group.
+			}
+			group = (group + step) & group_mask;
+		}
+	}
+
+	uint32_t _find_insert_pos(uint32_t p_hash) const {
+		const uint32_t group_mask = capacity / GROUP_SIZE - 1;
+		uint32_t group = (p_hash >> 7) & group_mask;
+		for (uint32_t step = 1;; step++) {
+			uint32_t mask = _match_empty_or_deleted(ctrl + group * GROUP_SIZE);
+			if (mask) {
+				return group * GROUP_SIZE + _lowest_bit(mask);
+			}
+			group = (group + step) & group_mask;
+		}
+	}
+
+	void _resize_and_rehash(uint32_t p_new_capacity) {
+		int8_t *old_ctrl = ctrl;
+		KeyValue<TKey, TValue> *old_slots = slots;
+		uint32_t old_capacity = capacity;
+
+		capacity = p_new_capacity;
+		ctrl = reinterpret_cast<int8_t *>(Memory::alloc_static(sizeof(int8_t) * capacity));
+		slots = reinterpret_cast<KeyValue<TKey, TValue> *>(Memory::alloc_static(sizeof(KeyValue<TKey, TValue>) * capacity));
+		memset(ctrl, CTRL_EMPTY, capacity);
+		num_deleted = 0;
+
+		if (old_ctrl == nullptr) {
+			return;
+		}
+
+		for (uint32_t i = 0; i < old_capacity; i++) {
+			if (old_ctrl[i] < 0) {
+				continue;
+			}
+			uint32_t hash = _hash(old_slots[i].key);
+			uint32_t pos = _find_insert_pos(hash);
+			ctrl[pos] = _h2(hash);
+			// Relocate bitwise, like the other templates do.
+			memcpy((void *)&slots[pos], (void *)&old_slots[i], sizeof(KeyValue<TKey, TValue>));
+		}
+
+		Memory::free_static(old_ctrl);
+		Memory::free_static(old_slots);
+	}
+
+	uint32_t _insert(const TKey &p_key, const TValue &p_value) {
+		uint32_t hash = _hash(p_key);
+		uint32_t pos = 0;
+		if (_lookup_pos(p_key, hash, pos)) {
+			slots[pos].value = p_value;
+			return pos;
+		}
+
+		if (unlikely(capacity == 0)) {
+			_resize_and_rehash(MIN_CAPACITY);
+		} else if (unlikely(num_elements + num_deleted + 1 > _max_load(capacity))) {
+			// Grow, or just purge tombstones if they take most of the room.
+			_resize_and_rehash(num_elements + 1 > _max_load(capacity) / 2 ? capacity * 2 : capacity);
+		}
+
+		pos = _find_insert_pos(hash);
+		if (ctrl[pos] == CTRL_DELETED) {
+			num_deleted--;
+		}
+		ctrl[pos] = _h2(hash);
+		memnew_placement(&slots[pos], Slot(p_key, p_value));
+		num_elements++;
+		return pos;
+	}
+
+	void _erase_pos(uint32_t p_pos) {
+		slots[p_pos].~KeyValue<TKey, TValue>();
+		// If the group still has an empty slot, no probe sequence ever went past it,
+		// so the slot can be marked empty instead of leaving a tombstone.
+		const int8_t *group_ctrl = ctrl + (p_pos & ~(GROUP_SIZE - 1));
+		if (_match(group_ctrl, CTRL_EMPTY)) {
+			ctrl[p_pos] = CTRL_EMPTY;
+		} else {
+			ctrl[p_pos] = CTRL_DELETED;
+			num_deleted++;
+		}
+		num_elements--;
+	}
+
+	_FORCE_INLINE_ uint32_t _next_full(uint32_t p_pos) const {
+		while (p_pos < capacity && ctrl[p_pos] < 0) {
+			p_pos++;
+		}
+		return p_pos;
+	}
+
+public:
+	_FORCE_INLINE_ uint32_t get_capacity() const { return capacity; }
+	_FORCE_INLINE_ uint32_t size() const { return num_elements; }
+
+	/* Standard Godot Container API */
+
+	bool is_empty() const {
+		return num_elements == 0;
+	}
+
+	void clear() {
+		if (ctrl == nullptr || num_elements + num_deleted == 0) {
+			return;
+		}
+		for (uint32_t i = 0; i < capacity; i++) {
+			if (ctrl[i] >= 0) {
+				slots[i].~KeyValue<TKey, TValue>();
+			}
+		}
+		memset(ctrl, CTRL_EMPTY, capacity);
+		num_elements = 0;
+		num_deleted = 0;
+	}
+
+	TValue &get(const TKey &p_key) {
+		uint32_t pos = 0;
+		bool exists = _lookup_pos(p_key, _hash(p_key), pos);
+		CRASH_COND_MSG(!exists, "FlatHashMap key not found.");
+		return slots[pos].value;
+	}
+
+	const TValue &get(const TKey &p_key) const {
+		uint32_t pos = 0;
+		bool exists = _lookup_pos(p_key, _hash(p_key), pos);
+		CRASH_COND_MSG(!exists, "FlatHashMap key not found.");
+		return slots[pos].value;
+	}
+
+	const TValue *getptr(const TKey &p_key) const {
+		uint32_t pos = 0;
+		if (_lookup_pos(p_key, _hash(p_key), pos)) {
+			return &slots[pos].value;
+		}
+		return nullptr;
+	}
+
+	TValue *getptr(const TKey &p_key) {
+		uint32_t pos = 0;
+		if (_lookup_pos(p_key, _hash(p_key), pos)) {
+			return &slots[pos].value;
+		}
+		return nullptr;
+	}
+
+	_FORCE_INLINE_ bool has(const TKey &p_key) const {
+		uint32_t pos = 0;
+		return _lookup_pos(p_key, _hash(p_key), pos);
+	}
+
+	bool erase(const TKey &p_key) {
+		uint32_t pos = 0;
+		if (!_lookup_pos(p_key, _hash(p_key), pos)) {
+			return false;
+		}
+		_erase_pos(pos);
+		return true;
+	}
+
+	// Reserves space for a number of elements, useful to avoid many resizes and rehashes.
+	// If adding a known (possibly large) number of elements at once, must be larger than old capacity.
+	void reserve(uint32_t p_new_capacity) {
+		uint32_t new_capacity = MAX(MIN_CAPACITY, nearest_power_of_2_templated(p_new_capacity + p_new_capacity / 7 + 1));
+		if (new_capacity <= capacity) {
+			return;
+		}
+		_resize_and_rehash(new_capacity);
+	}
+
+	/** Iterator API **/
+
+	struct ConstIterator {
+		_FORCE_INLINE_ const KeyValue<TKey, TValue> &operator*() const {
+			return map->slots[pos];
+		}
+		_FORCE_INLINE_ const KeyValue<TKey, TValue> *operator->() const { return &map->slots[pos]; }
+		_FORCE_INLINE_ ConstIterator &operator++() {
+			pos = map->_next_full(pos + 1);
+			return *this;
+		}
+
+		_FORCE_INLINE_ bool operator==(const ConstIterator &b) const { return pos == b.pos; }
+		_FORCE_INLINE_ bool operator!=(const ConstIterator &b) const { return pos != b.pos; }
+
+		_FORCE_INLINE_ explicit operator bool() const {
+			return map && pos < map->capacity;
+		}
+
+		_FORCE_INLINE_ ConstIterator(const FlatHashMap *p_map, uint32_t p_pos) {
+			map = p_map;
+			pos = p_pos;
+		}
+		_FORCE_INLINE_ ConstIterator() {}
+
+	private:
+		const FlatHashMap *map = nullptr;
+		uint32_t pos = 0;
+	};
+
+	struct Iterator {
+		_FORCE_INLINE_ KeyValue<TKey, TValue> &operator*() const {
+			return map->slots[pos];
+		}
+		_FORCE_INLINE_ KeyValue<TKey, TValue> *operator->() const { return &map->slots[pos]; }
+		_FORCE_INLINE_ Iterator &operator++() {
+			pos = map->_next_full(pos + 1);
+			return *this;
+		}
+
+		_FORCE_INLINE_ bool operator==(const Iterator &b) const { return pos == b.pos; }
+		_FORCE_INLINE_ bool operator!=(const Iterator &b) const { return pos != b.pos; }
+
+		_FORCE_INLINE_ explicit operator bool() const {
+			return map && pos < map->capacity;
+		}
+
+		_FORCE_INLINE_ Iterator(FlatHashMap *p_map, uint32_t p_pos) {
+			map = p_map;
+			pos = p_pos;
+		}
+		_FORCE_INLINE_ Iterator() {}
+
+		operator ConstIterator() const {
+			return ConstIterator(map, pos);
+		}
+
+	private:
+		FlatHashMap *map = nullptr;
+		uint32_t pos = 0;
+
+		friend class FlatHashMap;
+	};
+
+	_FORCE_INLINE_ Iterator begin() {
+		return Iterator(this, _next_full(0));
+	}
+	_FORCE_INLINE_ Iterator end() {
+		return Iterator(this, capacity);
+	}
+
+	_FORCE_INLINE_ ConstIterator begin() const {
+		return ConstIterator(this, _next_full(0));
+	}
+	_FORCE_INLINE_ ConstIterator end() const {
+		return ConstIterator(this, capacity);
+	}
+
+	_FORCE_INLINE_ Iterator find(const TKey &p_key) {
+		uint32_t pos = 0;
+		if (!_lookup_pos(p_key, _hash(p_key), pos)) {
+			return end();
+		}
+		return Iterator(this, pos);
+	}
+
+	_FORCE_INLINE_ ConstIterator find(const TKey &p_key) const {
+		uint32_t pos = 0;
+		if (!_lookup_pos(p_key, _hash(p_key), pos)) {
+			return end();
+		}
+		return ConstIterator(this, pos);
+	}
+
+	_FORCE_INLINE_ void remove(const Iterator &p_iter) {
+		if (p_iter) {
+			_erase_pos(p_iter.pos);
+		}
+	}
+
+	/* Indexing */
+
+	const TValue &operator[](const TKey &p_key) const {
+		return get(p_key);
+	}
+
+	TValue &operator[](const TKey &p_key) {
+		uint32_t pos = 0;
+		if (!_lookup_pos(p_key, _hash(p_key), pos)) {
+			pos = _insert(p_key, TValue());
+		}
+		return slots[pos].value;
+	}
+
+	/* Insert */
+
+	Iterator insert(const TKey &p_key, const TValue &p_value) {
+		return Iterator(this, _insert(p_key, p_value));
+	}
+
+	/* Constructors */
+
+	FlatHashMap(const FlatHashMap &p_other) {
+		reserve(p_other.size());
+		for (const KeyValue<TKey, TValue> &E : p_other) {
+			_insert(E.key, E.value);
+		}
+	}
+
+	void operator=(const FlatHashMap &p_other) {
+		if (this == &p_other) {
+			return; // Ignore self assignment.
+		}
+		clear();
+		reserve(p_other.size());
+		for (const KeyValue<TKey, TValue> &E : p_other) {
+			_insert(E.key, E.value);
+		}
+	}
+
+	FlatHashMap(uint32_t p_initial_capacity) {
+		reserve(p_initial_capacity);
+	}
+	FlatHashMap() {}
+
+	~FlatHashMap() {
+		clear();
+		if (ctrl != nullptr) {
+			Memory::free_static(ctrl);
+			Memory::free_static(slots);
+		}
+	}
+};
+
+#endif // FLAT_HASH_MAP_H
@@ -36,11 +36,13 @@
 #include "core/string/print_string.h"
 #include "core/templates/hash_set.h"
 #include "core/templates/list.h"
+#include "core/templates/local_vector.h"
 #include "core/templates/oa_hash_map.h"
 #include "core/templates/rid.h"
 #include "core/templates/safe_refcount.h"
 
 #include <stdio.h>
+#include <atomic>
 #include <typeinfo>
 
 class RID_AllocBase {
@@ -69,11 +71,18 @@ public:
 
 template <class T, bool THREAD_SAFE = false>
 class RID_Alloc : public RID_AllocBase {
+	// When THREAD_SAFE, lookups don't lock. Chunks are never moved once allocated, and the
+	// arrays of chunk pointers are never freed while the allocator is alive, so a reader
+	// only needs to check `max_alloc` and the validator of the element it is looking for.
 	T **chunks = nullptr;
 	uint32_t **free_list_chunks = nullptr;
 	uint32_t **validator_chunks = nullptr;
 
+	// Chunk pointer arrays replaced while growing, kept alive for concurrent readers.
+	LocalVector<void *> retired_chunk_arrays;
+
 	uint32_t elements_in_chunk;
+	uint32_t chunk_capacity = 0;
 	uint32_t max_alloc = 0;
 	uint32_t alloc_count = 0;
 
@@ -81,24 +90,69 @@ class RID_Alloc : public RID_AllocBase {
 
 	mutable SpinLock spin_lock;
 
-	_FORCE_INLINE_ RID _allocate_rid() {
-		if (THREAD_SAFE) {
-			spin_lock.lock();
+	template <class V>
+	static _FORCE_INLINE_ V _load_acquire(const V &p_var) {
+		if constexpr (THREAD_SAFE) {
+			static_assert(sizeof(std::atomic<V>) == sizeof(V));
+			return reinterpret_cast<const std::atomic<V> *>(&p_var)->load(std::memory_order_acquire);
+		} else {
+			return p_var;
+		}
+	}
+
+	template <class V>
+	static _FORCE_INLINE_ void _store_release(V &p_var, V p_value) {
+		if constexpr (THREAD_SAFE) {
+			reinterpret_cast<std::atomic<V> *>(&p_var)->store(p_value, std::memory_order_release);
+		} else {
+			p_var = p_value;
+		}
+	}
+
+	_FORCE_INLINE_ uint32_t _get_validator(uint32_t p_chunk, uint32_t p_element) const {
+		return _load_acquire(_load_acquire(validator_chunks)[p_chunk][p_element]);
+	}
+
+	_FORCE_INLINE_ void _set_validator(uint32_t p_chunk, uint32_t p_element, uint32_t p_validator) {
+		_store_release(validator_chunks[p_chunk][p_element], p_validator);
+	}
+
+	void _grow_chunk_arrays() {
+		uint32_t new_capacity = chunk_capacity == 0 ? 1 : chunk_capacity * 2;
+
+		T **new_chunks = (T **)memalloc(sizeof(T *) * new_capacity);
+		uint32_t **new_validator_chunks = (uint32_t **)memalloc(sizeof(uint32_t *) * new_capacity);
+		if (chunk_capacity) {
+			memcpy(new_chunks, chunks, sizeof(T *) * chunk_capacity);
+			memcpy(new_validator_chunks, validator_chunks, sizeof(uint32_t *) * chunk_capacity);
 		}
 
+		if (THREAD_SAFE && chunks) {
+			// Lookups running concurrently may still be reading from the old arrays.
+			retired_chunk_arrays.push_back(chunks);
+			retired_chunk_arrays.push_back(validator_chunks);
+		} else if (chunks) {
+			memfree(chunks);
+			memfree(validator_chunks);
+		}
+
+		_store_release(chunks, new_chunks);
+		_store_release(validator_chunks, new_validator_chunks);
+		free_list_chunks = (uint32_t **)memrealloc(free_list_chunks, sizeof(uint32_t *) * new_capacity);
+		chunk_capacity = new_capacity;
+	}
+
+	// Must be called with the lock held.
+	_FORCE_INLINE_ RID _allocate_rid_locked() {
 		if (alloc_count == max_alloc) {
 			//allocate a new chunk
-			uint32_t chunk_count = alloc_count == 0 ? 0 : (max_alloc / elements_in_chunk);
+			uint32_t chunk_count = max_alloc / elements_in_chunk;
+			if (chunk_count == chunk_capacity) {
+				_grow_chunk_arrays();
+			}
 
-			//grow chunks
-			chunks = (T **)memrealloc(chunks, sizeof(T *) * (chunk_count + 1));
 			chunks[chunk_count] = (T *)memalloc(sizeof(T) * elements_in_chunk); //but don't initialize
-
-			//grow validators
-			validator_chunks = (uint32_t **)memrealloc(validator_chunks, sizeof(uint32_t *) * (chunk_count + 1));
 			validator_chunks[chunk_count] = (uint32_t *)memalloc(sizeof(uint32_t) * elements_in_chunk);
-			//grow free lists
-			free_list_chunks = (uint32_t **)memrealloc(free_list_chunks, sizeof(uint32_t *) * (chunk_count + 1));
 			free_list_chunks[chunk_count] = (uint32_t *)memalloc(sizeof(uint32_t) * elements_in_chunk);
 
 			//initialize
@@ -108,7 +162,8 @@ class RID_Alloc : public RID_AllocBase {
 				free_list_chunks[chunk_count][i] = alloc_count + i;
 			}
 
-			max_alloc += elements_in_chunk;
+			// Publish the new chunk to lock-free readers only once it is fully set up.
+			_store_release(max_alloc, max_alloc + elements_in_chunk);
 		}
 
 		uint32_t free_index = free_list_chunks[alloc_count / elements_in_chunk][alloc_count % elements_in_chunk];
@@ -122,17 +177,62 @@ class RID_Alloc : public RID_AllocBase {
 		id <<= 32;
 		id |= free_index;
 
-		validator_chunks[free_chunk][free_element] = validator;
-
-		validator_chunks[free_chunk][free_element] |= 0x80000000; //mark uninitialized bit
+		_set_validator(free_chunk, free_element, validator | 0x80000000); //mark uninitialized bit
 
 		alloc_count++;
 
+		return _make_from_id(id);
+	}
+
+	_FORCE_INLINE_ RID _allocate_rid() {
+		if (THREAD_SAFE) {
+			spin_lock.lock();
+		}
+
+		RID rid = _allocate_rid_locked();
+
 		if (THREAD_SAFE) {
 			spin_lock.unlock();
 		}
 
-		return _make_from_id(id);
+		return rid;
+	}
+
+	// Must be called with the lock held.
+	_FORCE_INLINE_ void _free_locked(const RID &p_rid) {
+		uint64_t id = p_rid.get_id();
+		uint32_t idx = uint32_t(id & 0xFFFFFFFF);
+		ERR_FAIL_COND(idx >= max_alloc);
+
+		uint32_t idx_chunk = idx / elements_in_chunk;
+		uint32_t idx_element = idx % elements_in_chunk;
+
+		uint32_t validator = uint32_t(id >> 32);
+		if (unlikely(validator_chunks[idx_chunk][idx_element] & 0x80000000)) {
+			ERR_FAIL_MSG("Attempted to free an uninitialized or invalid RID");
+		} else if (unlikely(validator_chunks[idx_chunk][idx_element] != validator)) {
+			ERR_FAIL();
+		}
+
+		// Invalidate before destroying, so lock-free lookups stop handing out the element.
+		_set_validator(idx_chunk, idx_element, 0xFFFFFFFF); // go invalid
+		chunks[idx_chunk][idx_element].~T();
+
+		alloc_count--;
+		free_list_chunks[alloc_count / elements_in_chunk][alloc_count % elements_in_chunk] = idx;
+	}
+
+	_FORCE_INLINE_ T *_lookup(uint64_t p_id, uint32_t &r_chunk, uint32_t &r_element, uint32_t &r_validator) const {
+		uint32_t idx = uint32_t(p_id & 0xFFFFFFFF);
+		if (unlikely(idx >= _load_acquire(max_alloc))) {
+			return nullptr;
+		}
+
+		r_chunk = idx / elements_in_chunk;
+		r_element = idx % elements_in_chunk;
+		r_validator = _get_validator(r_chunk, r_element);
+
+		return &_load_acquire(chunks)[r_chunk][r_element];
 	}
 
 public:
@@ -152,63 +252,74 @@ public:
 		return _allocate_rid();
 	}
 
-	_FORCE_INLINE_ T *get_or_null(const RID &p_rid, bool p_initialize = false) {
-		if (p_rid == RID()) {
-			return nullptr;
-		}
+	// Allocates many RIDs taking the lock only once, they must be initialized afterwards.
+	void allocate_rids(uint32_t p_count, RID *r_rids) {
 		if (THREAD_SAFE) {
 			spin_lock.lock();
 		}
 
-		uint64_t id = p_rid.get_id();
-		uint32_t idx = uint32_t(id & 0xFFFFFFFF);
-		if (unlikely(idx >= max_alloc)) {
-			if (THREAD_SAFE) {
-				spin_lock.unlock();
-			}
-			return nullptr;
+		for (uint32_t i = 0; i < p_count; i++) {
+			r_rids[i] = _allocate_rid_locked();
 		}
 
-		uint32_t idx_chunk = idx / elements_in_chunk;
-		uint32_t idx_element = idx % elements_in_chunk;
+		if (THREAD_SAFE) {
+			spin_lock.unlock();
+		}
+	}
 
+	// Allocates and default-initializes many RIDs, taking the lock only once.
+	void make_rids(uint32_t p_count, RID *r_rids) {
+		allocate_rids(p_count, r_rids);
+		for (uint32_t i = 0; i < p_count; i++) {
+			initialize_rid(r_rids[i]);
+		}
+	}
+
+	_FORCE_INLINE_ T *get_or_null(const RID &p_rid, bool p_initialize = false) {
+		if (p_rid == RID()) {
+			return nullptr;
+		}
+
+		uint64_t id = p_rid.get_id();
 		uint32_t validator = uint32_t(id >> 32);
 
+		uint32_t idx_chunk = 0;
+		uint32_t idx_element = 0;
+		uint32_t current_validator = 0;
+		T *ptr = _lookup(id, idx_chunk, idx_element, current_validator);
+		if (unlikely(!ptr)) {
+			return nullptr;
+		}
+
 		if (unlikely(p_initialize)) {
-			if (unlikely(!(validator_chunks[idx_chunk][idx_element] & 0x80000000))) {
-				if (THREAD_SAFE) {
-					spin_lock.unlock();
-				}
+			if (unlikely(!(current_validator & 0x80000000))) {
 				ERR_FAIL_V_MSG(nullptr, "Initializing already initialized RID");
 			}
 
-			if (unlikely((validator_chunks[idx_chunk][idx_element] & 0x7FFFFFFF) != validator)) {
-				if (THREAD_SAFE) {
-					spin_lock.unlock();
-				}
+			if (unlikely((current_validator & 0x7FFFFFFF) != validator)) {
 				ERR_FAIL_V_MSG(nullptr, "Attempting to initialize the wrong RID");
 			}
 
-			validator_chunks[idx_chunk][idx_element] &= 0x7FFFFFFF; //initialized
+			// Only the owner of an uninitialized RID touches its validator, so this doesn't need the lock.
+			_set_validator(idx_chunk, idx_element, validator); //initialized
 
-		} else if (unlikely(validator_chunks[idx_chunk][idx_element] != validator)) {
-			if (THREAD_SAFE) {
-				spin_lock.unlock();
-			}
-			if ((validator_chunks[idx_chunk][idx_element] & 0x80000000) && validator_chunks[idx_chunk][idx_element] != 0xFFFFFFFF) {
+		} else if (unlikely(current_validator != validator)) {
+			if ((current_validator & 0x80000000) && current_validator != 0xFFFFFFFF) {
 				ERR_FAIL_V_MSG(nullptr, "Attempting to use an uninitialized RID");
 			}
 			return nullptr;
 		}
 
-		T *ptr = &chunks[idx_chunk][idx_element];
+		return ptr;
+	}
 
-		if (THREAD_SAFE) {
-			spin_lock.unlock();
+	// Looks up many RIDs at once, setting the pointer of invalid ones to null.
+	void get_or_null_batch(const RID *p_rids, uint32_t p_count, T **r_ptrs) {
+		for (uint32_t i = 0; i < p_count; i++) {
+			r_ptrs[i] = get_or_null(p_rids[i]);
 		}
-
-		return ptr;
 	}
+
 	void initialize_rid(RID p_rid) {
 		T *mem = get_or_null(p_rid, true);
 		ERR_FAIL_NULL(mem);
@@ -221,69 +332,41 @@ public:
 	}
 
 	_FORCE_INLINE_ bool owns(const RID &p_rid) const {
-		if (THREAD_SAFE) {
-			spin_lock.lock();
-		}
-
 		uint64_t id = p_rid.get_id();
-		uint32_t idx = uint32_t(id & 0xFFFFFFFF);
-		if (unlikely(idx >= max_alloc)) {
-			if (THREAD_SAFE) {
-				spin_lock.unlock();
-			}
+		uint32_t validator = uint32_t(id >> 32);
+
+		uint32_t idx_chunk = 0;
+		uint32_t idx_element = 0;
+		uint32_t current_validator = 0;
+		if (unlikely(!_lookup(id, idx_chunk, idx_element, current_validator))) {
 			return false;
 		}
 
-		uint32_t idx_chunk = idx / elements_in_chunk;
-		uint32_t idx_element = idx % elements_in_chunk;
+		return (validator != 0x7FFFFFFF) && (current_validator & 0x7FFFFFFF) == validator;
+	}
 
-		uint32_t validator = uint32_t(id >> 32);
+	_FORCE_INLINE_ void free(const RID &p_rid) {
+		if (THREAD_SAFE) {
+			spin_lock.lock();
+		}
 
-		bool owned = (validator != 0x7FFFFFFF) && (validator_chunks[idx_chunk][idx_element] & 0x7FFFFFFF) == validator;
+		_free_locked(p_rid);
 
 		if (THREAD_SAFE) {
 			spin_lock.unlock();
 		}
-
-		return owned;
 	}
 
-	_FORCE_INLINE_ void free(const RID &p_rid) {
+	// Frees many RIDs taking the lock only once.
+	void free_rids(const RID *p_rids, uint32_t p_count) {
 		if (THREAD_SAFE) {
 			spin_lock.lock();
 		}
 
-		uint64_t id = p_rid.get_id();
-		uint32_t idx = uint32_t(id & 0xFFFFFFFF);
-		if (unlikely(idx >= max_alloc)) {
-			if (THREAD_SAFE) {
-				spin_lock.unlock();
-			}
-			ERR_FAIL();
-		}
-
-		uint32_t idx_chunk = idx / elements_in_chunk;
-		uint32_t idx_element = idx % elements_in_chunk;
-
-		uint32_t validator = uint32_t(id >> 32);
-		if (unlikely(validator_chunks[idx_chunk][idx_element] & 0x80000000)) {
-			if (THREAD_SAFE) {
-				spin_lock.unlock();
-			}
-			ERR_FAIL_MSG("Attempted to free an uninitialized or invalid RID");
-		} else if (unlikely(validator_chunks[idx_chunk][idx_element] != validator)) {
-			if (THREAD_SAFE) {
-				spin_lock.unlock();
-			}
-			ERR_FAIL();
+		for (uint32_t i = 0; i < p_count; i++) {
+			_free_locked(p_rids[i]);
 		}
 
-		chunks[idx_chunk][idx_element].~T();
-		validator_chunks[idx_chunk][idx_element] = 0xFFFFFFFF; // go invalid
-
-		alloc_count--;
-		free_list_chunks[alloc_count / elements_in_chunk][alloc_count % elements_in_chunk] = idx;
-
 		if (THREAD_SAFE) {
 			spin_lock.unlock();
 		}
@@ -361,6 +444,10 @@ public:
 			memfree(free_list_chunks);
 			memfree(validator_chunks);
 		}
+
+		for (void *array : retired_chunk_arrays) {
+			memfree(array);
+		}
 	}
 };
 
@@ -377,6 +464,18 @@ public:
 		return alloc.allocate_rid();
 	}
 
+	// Makes a RID for each of the pointers, taking the lock only once.
+	_FORCE_INLINE_ void make_rids(uint32_t p_count, T *const *p_ptrs, RID *r_rids) {
+		alloc.allocate_rids(p_count, r_rids);
+		for (uint32_t i = 0; i < p_count; i++) {
+			alloc.initialize_rid(r_rids[i], p_ptrs[i]);
+		}
+	}
+
+	_FORCE_INLINE_ void allocate_rids(uint32_t p_count, RID *r_rids) {
+		alloc.allocate_rids(p_count, r_rids);
+	}
+
 	_FORCE_INLINE_ void initialize_rid(RID p_rid, T *p_ptr) {
 		alloc.initialize_rid(p_rid, p_ptr);
 	}
@@ -389,6 +488,12 @@ public:
 		return *ptr;
 	}
 
+	_FORCE_INLINE_ void get_or_null_batch(const RID *p_rids, uint32_t p_count, T **r_ptrs) {
+		for (uint32_t i = 0; i < p_count; i++) {
+			r_ptrs[i] = get_or_null(p_rids[i]);
+		}
+	}
+
 	_FORCE_INLINE_ void replace(const RID &p_rid, T *p_new_ptr) {
 		T **ptr = alloc.get_or_null(p_rid);
 		ERR_FAIL_NULL(ptr);
@@ -403,6 +508,10 @@ public:
 		alloc.free(p_rid);
 	}
 
+	_FORCE_INLINE_ void free_rids(const RID *p_rids, uint32_t p_count) {
+		alloc.free_rids(p_rids, p_count);
+	}
+
 	_FORCE_INLINE_ uint32_t get_rid_count() const {
 		return alloc.get_rid_count();
 	}
@@ -439,6 +548,14 @@ public:
 		return alloc.allocate_rid();
 	}
 
+	_FORCE_INLINE_ void make_rids(uint32_t p_count, RID *r_rids) {
+		alloc.make_rids(p_count, r_rids);
+	}
+
+	_FORCE_INLINE_ void allocate_rids(uint32_t p_count, RID *r_rids) {
+		alloc.allocate_rids(p_count, r_rids);
+	}
+
 	_FORCE_INLINE_ void initialize_rid(RID p_rid) {
 		alloc.initialize_rid(p_rid);
 	}
@@ -451,6 +568,10 @@ public:
 		return alloc.get_or_null(p_rid);
 	}
 
+	_FORCE_INLINE_ void get_or_null_batch(const RID *p_rids, uint32_t p_count, T **r_ptrs) {
+		alloc.get_or_null_batch(p_rids, p_count, r_ptrs);
+	}
+
 	_FORCE_INLINE_ bool owns(const RID &p_rid) const {
 		return alloc.owns(p_rid);
 	}
@@ -459,6 +580,10 @@ public:
 		alloc.free(p_rid);
 	}
 
+	_FORCE_INLINE_ void free_rids(const RID *p_rids, uint32_t p_count) {
+		alloc.free_rids(p_rids, p_count);
+	}
+
 	_FORCE_INLINE_ uint32_t get_rid_count() const {
 		return alloc.get_rid_count();
 	}
@@ -0,0 +1,224 @@
+/**************************************************************************/
+/*  small_vector.h                                                        */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef SMALL_VECTOR_H
+#define SMALL_VECTOR_H
+
+#include "core/error/error_macros.h"
+#include "core/os/memory.h"
+#include "core/templates/vector.h"
+
+#include <initializer_list>
+#include <type_traits>
+
+// Non copy-on-write vector that keeps up to INLINE_CAPACITY elements inside
+// the object itself, so short lists don't allocate at all.
+// When it outgrows the inline storage, memory comes from the heap.
+template <class T, uint32_t INLINE_CAPACITY = 8>
+class SmallVector {
+	static_assert(INLINE_CAPACITY > 0, "SmallVector needs inline storage, use LocalVector instead.");
+
+	uint32_t count = 0;
+	uint32_t capacity = INLINE_CAPACITY;
+	// Heap storage, null while the elements are inline. No pointer to the inline
+	// storage is kept, so the vector itself stays bitwise-relocatable as long as T is.
+	T *allocated_data = nullptr;
+	alignas(T) uint8_t inline_data[sizeof(T) * INLINE_CAPACITY];
+
+	_FORCE_INLINE_ T *_get_data() const {
+		return allocated_data ? allocated_data : (T *)inline_data;
+	}
+
+	void _grow(uint32_t p_capacity) {
+		T *new_data = (T *)memalloc(sizeof(T) * p_capacity);
+		CRASH_COND_MSG(!new_data, "Out of memory");
+		// Elements are moved bitwise, LocalVector and CowData make the same assumption on T.
+		memcpy((void *)new_data, (void *)_get_data(), sizeof(T) * count);
+		if (allocated_data) {
+			memfree(allocated_data);
+		}
+		allocated_data = new_data;
+		capacity = p_capacity;
+	}
+
+public:
+	_FORCE_INLINE_ T *ptr() { return _get_data(); }
+	_FORCE_INLINE_ const T *ptr() const { return _get_data(); }
+
+	_FORCE_INLINE_ uint32_t size() const { return count; }
+	_FORCE_INLINE_ bool is_empty() const { return count == 0; }
+	_FORCE_INLINE_ uint32_t get_capacity() const { return capacity; }
+	// Returns true while the elements still fit in the inline storage.
+	_FORCE_INLINE_ bool is_inline() const { return allocated_data == nullptr; }
+
+	_FORCE_INLINE_ void push_back(T p_elem) {
+		if (unlikely(count == capacity)) {
+			_grow(capacity << 1);
+		}
+		T *data = _get_data();
+		if constexpr (!std::is_trivially_constructible<T>::value) {
+			memnew_placement(&data[count++], T(p_elem));
+		} else {
+			data[count++] = p_elem;
+		}
+	}
+
+	void remove_at(uint32_t p_index) {
+		ERR_FAIL_UNSIGNED_INDEX(p_index, count);
+		T *data = _get_data();
+		count--;
+		for (uint32_t i = p_index; i < count; i++) {
+			data[i] = data[i + 1];
+		}
+		if constexpr (!std::is_trivially_destructible<T>::value) {
+			data[count].~T();
+		}
+	}
+
+	void remove_at_unordered(uint32_t p_index) {
+		ERR_FAIL_UNSIGNED_INDEX(p_index, count);
+		T *data = _get_data();
+		count--;
+		if (count > p_index) {
+			data[p_index] = data[count];
+		}
+		if constexpr (!std::is_trivially_destructible<T>::value) {
+			data[count].~T();
+		}
+	}
+
+	int64_t find(const T &p_val, uint32_t p_from = 0) const {
+		const T *data = _get_data();
+		for (uint32_t i = p_from; i < count; i++) {
+			if (data[i] == p_val) {
+				return int64_t(i);
+			}
+		}
+		return -1;
+	}
+
+	void reserve(uint32_t p_size) {
+		if (p_size > capacity) {
+			_grow(nearest_power_of_2_templated(p_size));
+		}
+	}
+
+	void resize(uint32_t p_size) {
+		if (p_size < count) {
+			if constexpr (!std::is_trivially_destructible<T>::value) {
+				T *data = _get_data();
+				for (uint32_t i = p_size; i < count; i++) {
+					data[i].~T();
+				}
+			}
+			count = p_size;
+		} else if (p_size > count) {
+			reserve(p_size);
+			if constexpr (!std::is_trivially_constructible<T>::value) {
+				T *data = _get_data();
+				for (uint32_t i = count; i < p_size; i++) {
+					memnew_placement(&data[i], T);
+				}
+			}
+			count = p_size;
+		}
+	}
+
+	_FORCE_INLINE_ void clear() { resize(0); }
+
+	// Clears and releases any heap storage, going back to the inline buffer.
+	void reset() {
+		clear();
+		if (allocated_data) {
+			memfree(allocated_data);
+		}
+		allocated_data = nullptr;
+		capacity = INLINE_CAPACITY;
+	}
+
+	_FORCE_INLINE_ const T &operator[](uint32_t p_index) const {
+		CRASH_BAD_UNSIGNED_INDEX(p_index, count);
+		return _get_data()[p_index];
+	}
+	_FORCE_INLINE_ T &operator[](uint32_t p_index) {
+		CRASH_BAD_UNSIGNED_INDEX(p_index, count);
+		return _get_data()[p_index];
+	}
+
+	_FORCE_INLINE_ T *begin() { return _get_data(); }
+	_FORCE_INLINE_ T *end() { return _get_data() + count; }
+	_FORCE_INLINE_ const T *begin() const { return _get_data(); }
+	_FORCE_INLINE_ const T *end() const { return _get_data() + count; }
+
+	operator Vector<T>() const {
+		Vector<T> ret;
+		ret.resize(count);
+		T *w = ret.ptrw();
+		const T *data = _get_data();
+		for (uint32_t i = 0; i < count; i++) {
+			w[i] = data[i];
+		}
+		return ret;
+	}
+
+	void operator=(const SmallVector &p_from) {
+		if (this == &p_from) {
+			return;
+		}
+		resize(p_from.count);
+		T *data = _get_data();
+		const T *from_data = p_from._get_data();
+		for (uint32_t i = 0; i < count; i++) {
+			data[i] = from_data[i];
+		}
+	}
+
+	_FORCE_INLINE_ SmallVector() {}
+	SmallVector(std::initializer_list<T> p_init) {
+		reserve(p_init.size());
+		for (const T &element : p_init) {
+			push_back(element);
+		}
+	}
+	SmallVector(const SmallVector &p_from) {
+		resize(p_from.count);
+		T *data = _get_data();
+		const T *from_data = p_from._get_data();
+		for (uint32_t i = 0; i < count; i++) {
+			data[i] = from_data[i];
+		}
+	}
+
+	_FORCE_INLINE_ ~SmallVector() {
+		reset();
+	}
+};
+
+#endif // SMALL_VECTOR_H
@@ -34,7 +34,9 @@
 #include "core/crypto/crypto_core.h"
 #include "core/extension/gdextension.h"
 #include "core/io/file_access_encrypted.h"
+#include "core/io/file_access_memory.h"
 #include "core/io/file_access_pack.h" // PACK_HEADER_MAGIC, PACK_FORMAT_VERSION
+#include "core/io/pck_packer.h"
 #include "core/io/zip_io.h"
 #include "core/version.h"
 #include "editor/editor_file_system.h"
@@ -196,10 +198,11 @@ Error EditorExportPlatform::_save_pack_file(void *p_userdata, const String &p_pa
 	PackData *pd = (PackData *)p_userdata;
 
 	SavedData sd;
-	sd.path_utf8 = p_path.utf8();
+	sd.path = p_path.simplify_path();
 	sd.ofs = pd->f->get_position();
 	sd.size = p_data.size();
 	sd.encrypted = false;
+	sd.compressed = pd->compress;
 
 	for (int i = 0; i < p_enc_in_filters.size(); ++i) {
 		if (p_path.matchn(p_enc_in_filters[i]) || p_path.replace("res://", "").matchn(p_enc_in_filters[i])) {
@@ -228,7 +231,15 @@ Error EditorExportPlatform::_save_pack_file(void *p_userdata, const String &p_pa
 	}
 
 	// Store file content.
-	ftmp->store_buffer(p_data.ptr(), p_data.size());
+	if (sd.compressed) {
+		Ref<FileAccessMemory> fmem;
+		fmem.instantiate();
+		fmem->open_custom(p_data.ptr(), p_data.size());
+		Error err = PCKPacker::store_compressed(ftmp, fmem, p_data.size());
+		ERR_FAIL_COND_V(err != OK, ERR_SKIP);
+	} else {
+		ftmp->store_buffer(p_data.ptr(), p_data.size());
+	}
 
 	if (fae.is_valid()) {
 		ftmp.unref();
@@ -1518,6 +1529,7 @@ Error EditorExportPlatform::save_pack(const Ref<EditorExportPreset> &p_preset, b
 	pd.ep = &ep;
 	pd.f = ftmp;
 	pd.so_files = p_so_files;
+	pd.compress = GLOBAL_GET("editor/export/compress_pck");
 
 	Error err = export_project_files(p_preset, p_debug, _save_pack_file, &pd, _add_shared_object);
 
@@ -1531,8 +1543,6 @@ Error EditorExportPlatform::save_pack(const Ref<EditorExportPreset> &p_preset, b
 		return err;
 	}
 
-	pd.file_ofs.sort(); //do sort, so we can do binary search later
-
 	Ref<FileAccess> f;
 	int64_t embed_pos = 0;
 	if (!p_embed) {
@@ -1590,7 +1600,22 @@ Error EditorExportPlatform::save_pack(const Ref<EditorExportPreset> &p_preset, b
 		f->store_32(0);
 	}
 
-	f->store_32(pd.file_ofs.size()); //amount of files
+	Vector<PCKPacker::File> files;
+	files.resize(pd.file_ofs.size());
+	for (int i = 0; i < pd.file_ofs.size(); i++) {
+		PCKPacker::File &file = files.write[i];
+		file.path = pd.file_ofs[i].path;
+		file.ofs = pd.file_ofs[i].ofs;
+		file.size = pd.file_ofs[i].size;
+		file.encrypted = pd.file_ofs[i].encrypted;
+		file.compressed = pd.file_ofs[i].compressed;
+		file.md5 = pd.file_ofs[i].md5;
+	}
+	uint32_t file_count = 0;
+	Vector<uint8_t> directory = PCKPacker::make_directory(files, file_count);
+
+	f->store_32(file_count); //amount of files
+	f->store_32(directory.size() - file_count * PACK_INDEX_ENTRY_SIZE); // strings size
 
 	Ref<FileAccessEncrypted> fae;
 	Ref<FileAccess> fhead = f;
@@ -1639,25 +1664,7 @@ Error EditorExportPlatform::save_pack(const Ref<EditorExportPreset> &p_preset, b
 		fhead = fae;
 	}
 
-	for (int i = 0; i < pd.file_ofs.size(); i++) {
-		uint32_t string_len = pd.file_ofs[i].path_utf8.length();
-		uint32_t pad = _get_pad(4, string_len);
-
-		fhead->store_32(string_len + pad);
-		fhead->store_buffer((const uint8_t *)pd.file_ofs[i].path_utf8.get_data(), string_len);
-		for (uint32_t j = 0; j < pad; j++) {
-			fhead->store_8(0);
-		}
-
-		fhead->store_64(pd.file_ofs[i].ofs);
-		fhead->store_64(pd.file_ofs[i].size); // pay attention here, this is where file is
-		fhead->store_buffer(pd.file_ofs[i].md5.ptr(), 16); //also save md5 for file
-		uint32_t flags = 0;
-		if (pd.file_ofs[i].encrypted) {
-			flags |= PACK_FILE_ENCRYPTED;
-		}
-		fhead->store_32(flags);
-	}
+	fhead->store_buffer(directory.ptr(), directory.size());
 
 	if (fae.is_valid()) {
 		fhead.unref();
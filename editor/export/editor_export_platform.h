@@ -74,17 +74,15 @@ private:
 		uint64_t ofs = 0;
 		uint64_t size = 0;
 		bool encrypted = false;
+		bool compressed = false;
 		Vector<uint8_t> md5;
-		CharString path_utf8;
-
-		bool operator<(const SavedData &p_data) const {
-			return path_utf8 < p_data.path_utf8;
-		}
+		String path;
 	};
 
 	struct PackData {
 		Ref<FileAccess> f;
 		Vector<SavedData> file_ofs;
+		bool compress = false;
 		EditorProgress *ep = nullptr;
 		Vector<SharedObject> *so_files = nullptr;
 	};
@@ -273,6 +273,7 @@ void register_editor_types() {
 	GLOBAL_DEF("editor/import/use_multiple_threads", true);
 
 	GLOBAL_DEF("editor/export/convert_text_resources_to_binary", true);
+	GLOBAL_DEF("editor/export/compress_pck", false);
 
 	GLOBAL_DEF("editor/version_control/plugin_name", "");
 	GLOBAL_DEF("editor/version_control/autoload_on_startup", false);
@@ -39,6 +39,7 @@
 #include "servers/navigation_server_3d.h"
 #include "servers/physics_server_2d.h"
 #include "servers/physics_server_3d.h"
+#include "servers/rendering/renderer_scene_occlusion_cull.h"
 #include "servers/rendering_server.h"
 
 Performance *Performance::singleton = nullptr;
@@ -85,6 +86,8 @@ void Performance::_bind_methods() {
 	BIND_ENUM_CONSTANT(NAVIGATION_EDGE_MERGE_COUNT);
 	BIND_ENUM_CONSTANT(NAVIGATION_EDGE_CONNECTION_COUNT);
 	BIND_ENUM_CONSTANT(NAVIGATION_EDGE_FREE_COUNT);
+	BIND_ENUM_CONSTANT(RENDER_OCCLUSION_UPDATE_TIME);
+	BIND_ENUM_CONSTANT(RENDER_OCCLUSION_RAYCAST_TIME);
 	BIND_ENUM_CONSTANT(MONITOR_MAX);
 }
 
@@ -133,6 +136,8 @@ String Performance::get_monitor_name(Monitor p_monitor) const {
 		"navigation/edges_merged",
 		"navigation/edges_connected",
 		"navigation/edges_free",
+		"raster/occlusion_update_time",
+		"raster/occlusion_raycast_time",
 
 	};
 
@@ -207,6 +212,10 @@ double Performance::get_monitor(Monitor p_monitor) const {
 			return NavigationServer3D::get_singleton()->get_process_info(NavigationServer3D::INFO_EDGE_CONNECTION_COUNT);
 		case NAVIGATION_EDGE_FREE_COUNT:
 			return NavigationServer3D::get_singleton()->get_process_info(NavigationServer3D::INFO_EDGE_FREE_COUNT);
+		case RENDER_OCCLUSION_UPDATE_TIME:
+			return RendererSceneOcclusionCull::get_singleton() ? RendererSceneOcclusionCull::get_singleton()->get_update_time() : 0;
+		case RENDER_OCCLUSION_RAYCAST_TIME:
+			return RendererSceneOcclusionCull::get_singleton() ? RendererSceneOcclusionCull::get_singleton()->get_raycast_time() : 0;
 
 		default: {
 		}
@@ -252,6 +261,8 @@ Performance::MonitorType Performance::get_monitor_type(Monitor p_monitor) const
 		MONITOR_TYPE_QUANTITY,
 		MONITOR_TYPE_QUANTITY,
 		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_TIME,
+		MONITOR_TYPE_TIME,
 
 	};
 
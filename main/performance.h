@@ -100,6 +100,8 @@ public:
 		NAVIGATION_EDGE_MERGE_COUNT,
 		NAVIGATION_EDGE_CONNECTION_COUNT,
 		NAVIGATION_EDGE_FREE_COUNT,
+		RENDER_OCCLUSION_UPDATE_TIME,
+		RENDER_OCCLUSION_RAYCAST_TIME,
 		MONITOR_MAX
 	};
 
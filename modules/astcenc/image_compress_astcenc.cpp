@@ -30,11 +30,35 @@
 
 #include "image_compress_astcenc.h"
 
+#include "core/object/worker_thread_pool.h"
+#include "core/os/mutex.h"
 #include "core/os/os.h"
 #include "core/string/print_string.h"
 
 #include <astcenc.h>
 
+struct ASTCCompressionJob {
+	astcenc_context *context = nullptr;
+	astcenc_image *image = nullptr;
+	const astcenc_swizzle *swizzle = nullptr;
+	uint8_t *dest = nullptr;
+	size_t dest_len = 0;
+	BinaryMutex error_mutex;
+	astcenc_error error = ASTCENC_SUCCESS; // First error of any thread.
+};
+
+static void _digest_astc_job(void *p_job, uint32_t p_index) {
+	ASTCCompressionJob *job = static_cast<ASTCCompressionJob *>(p_job);
+	// astcenc distributes the blocks of the image among all calling threads itself.
+	astcenc_error status = astcenc_compress_image(job->context, job->image, job->swizzle, job->dest, job->dest_len, p_index);
+	if (status != ASTCENC_SUCCESS) {
+		MutexLock lock(job->error_mutex);
+		if (job->error == ASTCENC_SUCCESS) {
+			job->error = status;
+		}
+	}
+}
+
 void _compress_astc(Image *r_img, Image::ASTCFormat p_format) {
 	uint64_t start_time = OS::get_singleton()->get_ticks_msec();
 
@@ -115,7 +139,8 @@ void _compress_astc(Image *r_img, Image::ASTCFormat p_format) {
 	// Context allocation.
 
 	astcenc_context *context;
-	const unsigned int thread_count = 1; // Godot compresses multiple images each on a thread, which is more efficient for large amount of images imported.
+	// Each image is split across the worker thread pool, so large textures don't compress on a single core.
+	const unsigned int thread_count = MAX(1, WorkerThreadPool::get_singleton()->get_thread_count());
 	status = astcenc_context_alloc(&config, thread_count, &context);
 	ERR_FAIL_COND_MSG(status != ASTCENC_SUCCESS,
 			vformat("astcenc: Context allocation failed: %s.", astcenc_get_error_string(status)));
@@ -156,10 +181,18 @@ void _compress_astc(Image *r_img, Image::ASTCFormat p_format) {
 			ASTCENC_SWZ_R, ASTCENC_SWZ_G, ASTCENC_SWZ_B, ASTCENC_SWZ_A
 		};
 
-		status = astcenc_compress_image(context, &image, &swizzle, dest_mip_write, comp_len, 0);
+		ASTCCompressionJob job;
+		job.context = context;
+		job.image = &image;
+		job.swizzle = &swizzle;
+		job.dest = dest_mip_write;
+		job.dest_len = comp_len;
 
-		ERR_BREAK_MSG(status != ASTCENC_SUCCESS,
-				vformat("astcenc: ASTC image compression failed: %s.", astcenc_get_error_string(status)));
+		WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_native_group_task(&_digest_astc_job, &job, thread_count, thread_count, true, SNAME("astcenc Compress"));
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+
+		ERR_BREAK_MSG(job.error != ASTCENC_SUCCESS,
+				vformat("astcenc: ASTC image compression failed: %s.", astcenc_get_error_string(job.error)));
 		astcenc_compress_reset(context);
 	}
 
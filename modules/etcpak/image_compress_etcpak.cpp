@@ -30,12 +30,54 @@
 
 #include "image_compress_etcpak.h"
 
+#include "core/object/worker_thread_pool.h"
 #include "core/os/os.h"
 #include "core/string/print_string.h"
 
 #include <ProcessDxtc.hpp>
 #include <ProcessRGB.hpp>
 
+struct EtcpakCompressionTask {
+	const uint32_t *src = nullptr;
+	uint64_t *dest = nullptr;
+	uint32_t blocks = 0;
+	int width = 0;
+};
+
+struct EtcpakCompressionJobQueue {
+	EtcpakType compress_type = EtcpakType::ETCPAK_TYPE_ETC1;
+	const EtcpakCompressionTask *tasks = nullptr;
+};
+
+// Number of 4-pixel block rows handled by a single task. Rows are independent,
+// so mipmaps are split into strips that can be compressed in any order.
+static const int ETCPAK_ROWS_PER_TASK = 8;
+
+static void _digest_etcpak_task(void *p_job_queue, uint32_t p_index) {
+	const EtcpakCompressionJobQueue *job_queue = static_cast<const EtcpakCompressionJobQueue *>(p_job_queue);
+	const EtcpakCompressionTask &task = job_queue->tasks[p_index];
+
+	switch (job_queue->compress_type) {
+		case EtcpakType::ETCPAK_TYPE_ETC1:
+			CompressEtc1RgbDither(task.src, task.dest, task.blocks, task.width);
+			break;
+		case EtcpakType::ETCPAK_TYPE_ETC2:
+			CompressEtc2Rgb(task.src, task.dest, task.blocks, task.width, true);
+			break;
+		case EtcpakType::ETCPAK_TYPE_ETC2_ALPHA:
+		case EtcpakType::ETCPAK_TYPE_ETC2_RA_AS_RG:
+			CompressEtc2Rgba(task.src, task.dest, task.blocks, task.width, true);
+			break;
+		case EtcpakType::ETCPAK_TYPE_DXT1:
+			CompressDxt1Dither(task.src, task.dest, task.blocks, task.width);
+			break;
+		case EtcpakType::ETCPAK_TYPE_DXT5:
+		case EtcpakType::ETCPAK_TYPE_DXT5_RA_AS_RG:
+			CompressDxt5(task.src, task.dest, task.blocks, task.width);
+			break;
+	}
+}
+
 EtcpakType _determine_etc_type(Image::UsedChannels p_channels) {
 	switch (p_channels) {
 		case Image::USED_CHANNELS_L:
@@ -177,7 +219,14 @@ void _compress_etcpak(EtcpakType p_compresstype, Image *r_img) {
 	uint8_t *dest_write = dest_data.ptrw();
 
 	int mip_count = mipmaps ? Image::get_image_required_mipmaps(width, height, target_format) : 0;
-	Vector<uint32_t> padded_src;
+	// Padded mipmaps must stay alive until all tasks have completed.
+	Vector<Vector<uint32_t>> padded_src;
+	padded_src.resize(mip_count + 1);
+	Vector<EtcpakCompressionTask> tasks;
+
+	// ETC2 with alpha and DXT5 output two 64-bit words per block.
+	const bool two_words_per_block = p_compresstype == EtcpakType::ETCPAK_TYPE_ETC2_ALPHA || p_compresstype == EtcpakType::ETCPAK_TYPE_ETC2_RA_AS_RG ||
+			p_compresstype == EtcpakType::ETCPAK_TYPE_DXT5 || p_compresstype == EtcpakType::ETCPAK_TYPE_DXT5_RA_AS_RG;
 
 	for (int i = 0; i < mip_count + 1; i++) {
 		// Get write mip metrics for target image.
@@ -190,7 +239,6 @@ void _compress_etcpak(EtcpakType p_compresstype, Image *r_img) {
 		// Block size. Align stride to multiple of 4 (RGBA8).
 		int mip_w = (orig_mip_w + 3) & ~3;
 		int mip_h = (orig_mip_h + 3) & ~3;
-		const uint32_t blocks = mip_w * mip_h / 16;
 
 		// Get mip data from source image for reading.
 		int src_mip_ofs = r_img->get_mipmap_offset(i);
@@ -198,8 +246,9 @@ void _compress_etcpak(EtcpakType p_compresstype, Image *r_img) {
 
 		// Pad textures to nearest block by smearing.
 		if (mip_w != orig_mip_w || mip_h != orig_mip_h) {
-			padded_src.resize(mip_w * mip_h);
-			uint32_t *ptrw = padded_src.ptrw();
+			Vector<uint32_t> &padded = padded_src.write[i];
+			padded.resize(mip_w * mip_h);
+			uint32_t *ptrw = padded.ptrw();
 			int x = 0, y = 0;
 			for (y = 0; y < orig_mip_h; y++) {
 				for (x = 0; x < orig_mip_w; x++) {
@@ -217,23 +266,32 @@ void _compress_etcpak(EtcpakType p_compresstype, Image *r_img) {
 				}
 			}
 			// Override the src_mip_read pointer to our temporary Vector.
-			src_mip_read = padded_src.ptr();
+			src_mip_read = padded.ptr();
 		}
-		if (p_compresstype == EtcpakType::ETCPAK_TYPE_ETC1) {
-			CompressEtc1RgbDither(src_mip_read, dest_mip_write, blocks, mip_w);
-		} else if (p_compresstype == EtcpakType::ETCPAK_TYPE_ETC2) {
-			CompressEtc2Rgb(src_mip_read, dest_mip_write, blocks, mip_w, true);
-		} else if (p_compresstype == EtcpakType::ETCPAK_TYPE_ETC2_ALPHA || p_compresstype == EtcpakType::ETCPAK_TYPE_ETC2_RA_AS_RG) {
-			CompressEtc2Rgba(src_mip_read, dest_mip_write, blocks, mip_w, true);
-		} else if (p_compresstype == EtcpakType::ETCPAK_TYPE_DXT1) {
-			CompressDxt1Dither(src_mip_read, dest_mip_write, blocks, mip_w);
-		} else if (p_compresstype == EtcpakType::ETCPAK_TYPE_DXT5 || p_compresstype == EtcpakType::ETCPAK_TYPE_DXT5_RA_AS_RG) {
-			CompressDxt5(src_mip_read, dest_mip_write, blocks, mip_w);
-		} else {
-			ERR_FAIL_MSG("etcpak: Invalid or unsupported compression format.");
+
+		// Split the mipmap into strips of block rows.
+		const int blocks_per_row = mip_w / 4;
+		const int block_rows = mip_h / 4;
+		const int words_per_block = two_words_per_block ? 2 : 1;
+		for (int row = 0; row < block_rows; row += ETCPAK_ROWS_PER_TASK) {
+			int rows = MIN(ETCPAK_ROWS_PER_TASK, block_rows - row);
+
+			EtcpakCompressionTask task;
+			task.src = src_mip_read + row * 4 * mip_w;
+			task.dest = dest_mip_write + row * blocks_per_row * words_per_block;
+			task.blocks = rows * blocks_per_row;
+			task.width = mip_w;
+			tasks.push_back(task);
 		}
 	}
 
+	EtcpakCompressionJobQueue job_queue;
+	job_queue.compress_type = p_compresstype;
+	job_queue.tasks = tasks.ptr();
+
+	WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_native_group_task(&_digest_etcpak_task, &job_queue, tasks.size(), -1, true, SNAME("etcpak Compress"));
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+
 	// Replace original image with compressed one.
 	r_img->set_data(width, height, mipmaps, target_format, dest_data);
 
@@ -36,7 +36,41 @@
 
 #include "core/io/file_access.h"
 
+bool AudioStreamPlaybackMP3::can_mix_in_parallel() const {
+	return true; // Only touches its own decoder state.
+}
+
+int AudioStreamPlaybackMP3::_decode_ring_callback(void *p_userdata, AudioFrame *p_buffer, int p_frames) {
+	return ((AudioStreamPlaybackMP3 *)p_userdata)->_decode_internal(p_buffer, p_frames);
+}
+
 int AudioStreamPlaybackMP3::_mix_internal(AudioFrame *p_buffer, int p_frames) {
+	if (!decode_ring.is_initialized()) {
+		return _decode_internal(p_buffer, p_frames);
+	}
+
+	if (!streaming_active.is_set()) {
+		return 0;
+	}
+
+	int mixed = decode_ring.read(p_buffer, p_frames);
+	decode_ring.request_decode();
+	if (mixed == p_frames) {
+		return mixed;
+	}
+
+	for (int i = mixed; i < p_frames; i++) {
+		p_buffer[i] = AudioFrame(0, 0);
+	}
+	if (decode_ring.is_finished()) {
+		streaming_active.clear();
+		return mixed;
+	}
+	// The decoder fell behind. Output silence rather than waiting for it.
+	return p_frames;
+}
+
+int AudioStreamPlaybackMP3::_decode_internal(AudioFrame *p_buffer, int p_frames) {
 	if (!active) {
 		return 0;
 	}
@@ -75,7 +109,7 @@ int AudioStreamPlaybackMP3::_mix_internal(AudioFrame *p_buffer, int p_frames) {
 					}
 				}
 				loop_fade_remaining = 0;
-				seek(mp3_stream->loop_offset);
+				_seek(mp3_stream->loop_offset);
 				loops++;
 			}
 		}
@@ -83,7 +117,7 @@ int AudioStreamPlaybackMP3::_mix_internal(AudioFrame *p_buffer, int p_frames) {
 		else {
 			//EOF
 			if (mp3_stream->loop) {
-				seek(mp3_stream->loop_offset);
+				_seek(mp3_stream->loop_offset);
 				loops++;
 			} else {
 				frames_mixed_this_step = p_frames - todo;
@@ -104,17 +138,29 @@ float AudioStreamPlaybackMP3::get_stream_sampling_rate() {
 }
 
 void AudioStreamPlaybackMP3::start(double p_from_pos) {
-	active = true;
-	seek(p_from_pos);
-	loops = 0;
+	{
+		MutexLock lock(decode_ring.get_decode_mutex());
+		active = true;
+		_seek(p_from_pos);
+		loops = 0;
+		if (decode_ring.is_initialized()) {
+			decode_ring.reset();
+			streaming_active.set();
+		}
+	}
 	begin_resample();
 }
 
 void AudioStreamPlaybackMP3::stop() {
+	MutexLock lock(decode_ring.get_decode_mutex());
 	active = false;
+	streaming_active.clear();
 }
 
 bool AudioStreamPlaybackMP3::is_playing() const {
+	if (decode_ring.is_initialized()) {
+		return streaming_active.is_set();
+	}
 	return active;
 }
 
@@ -123,10 +169,23 @@ int AudioStreamPlaybackMP3::get_loop_count() const {
 }
 
 double AudioStreamPlaybackMP3::get_playback_position() const {
-	return double(frames_mixed) / mp3_stream->sample_rate;
+	uint32_t position = frames_mixed;
+	if (decode_ring.is_initialized()) {
+		// Frames still waiting in the ring have been decoded but not heard yet.
+		position -= MIN(position, decode_ring.get_buffered_frames());
+	}
+	return double(position) / mp3_stream->sample_rate;
 }
 
 void AudioStreamPlaybackMP3::seek(double p_time) {
+	MutexLock lock(decode_ring.get_decode_mutex());
+	_seek(p_time);
+	if (decode_ring.is_initialized()) {
+		decode_ring.reset();
+	}
+}
+
+void AudioStreamPlaybackMP3::_seek(double p_time) {
 	if (!active) {
 		return;
 	}
@@ -144,6 +203,7 @@ void AudioStreamPlaybackMP3::tag_used_streams() {
 }
 
 AudioStreamPlaybackMP3::~AudioStreamPlaybackMP3() {
+	decode_ring.finish();
 	if (mp3d) {
 		mp3dec_ex_close(mp3d);
 		memfree(mp3d);
@@ -153,25 +213,46 @@ AudioStreamPlaybackMP3::~AudioStreamPlaybackMP3() {
 Ref<AudioStreamPlayback> AudioStreamMP3::instantiate_playback() {
 	Ref<AudioStreamPlaybackMP3> mp3s;
 
-	ERR_FAIL_COND_V_MSG(data.is_empty(), mp3s,
+	ERR_FAIL_COND_V_MSG(data.is_empty() && stream_path.is_empty(), mp3s,
 			"This AudioStreamMP3 does not have an audio file assigned "
 			"to it. AudioStreamMP3 should not be created from the "
 			"inspector or with `.new()`. Instead, load an audio file.");
 
 	mp3s.instantiate();
 	mp3s->mp3_stream = Ref<AudioStreamMP3>(this);
+
+	if (!stream_path.is_empty()) {
+		mp3s->stream_file = _open_stream_file(stream_path, &mp3s->stream_io);
+		ERR_FAIL_COND_V_MSG(mp3s->stream_file.is_null(), Ref<AudioStreamPlaybackMP3>(), "Cannot open streamed MP3 file '" + stream_path + "'.");
+	}
+
 	mp3s->mp3d = (mp3dec_ex_t *)memalloc(sizeof(mp3dec_ex_t));
+	memset(mp3s->mp3d, 0, sizeof(mp3dec_ex_t));
+
+	int errorcode;
+	if (mp3s->stream_file.is_valid()) {
+		// The length is already known, so don't scan the whole file again; the seek index is built by the first seek that needs it.
+		errorcode = mp3dec_ex_open_cb(mp3s->mp3d, &mp3s->stream_io, MP3D_SEEK_TO_SAMPLE | MP3D_DO_NOT_SCAN);
+	} else {
+		errorcode = mp3dec_ex_open_buf(mp3s->mp3d, data.ptr(), data_len, MP3D_SEEK_TO_SAMPLE);
+	}
+
+	if (errorcode) {
+		// Frees what the decoder allocated before failing.
+		mp3dec_ex_close(mp3s->mp3d);
+		memfree(mp3s->mp3d);
+		mp3s->mp3d = nullptr;
+		ERR_FAIL_V_MSG(Ref<AudioStreamPlaybackMP3>(), "Failed to open MP3 decoder (error " + itos(errorcode) + ").");
+	}
 
-	int errorcode = mp3dec_ex_open_buf(mp3s->mp3d, data.ptr(), data_len, MP3D_SEEK_TO_SAMPLE);
+	if (mp3s->stream_file.is_valid()) {
+		mp3s->decode_ring.init(&AudioStreamPlaybackMP3::_decode_ring_callback, mp3s.ptr(), AudioStreamPlaybackMP3::DECODE_RING_FRAMES, AudioStreamPlaybackMP3::DECODE_CHUNK_FRAMES);
+	}
 
 	mp3s->frames_mixed = 0;
 	mp3s->active = false;
 	mp3s->loops = 0;
 
-	if (errorcode) {
-		ERR_FAIL_COND_V(errorcode, Ref<AudioStreamPlaybackMP3>());
-	}
-
 	return mp3s;
 }
 
@@ -208,6 +289,71 @@ Vector<uint8_t> AudioStreamMP3::get_data() const {
 	return data;
 }
 
+size_t AudioStreamMP3::_file_read_callback(void *p_buffer, size_t p_size, void *p_user_data) {
+	return ((FileAccess *)p_user_data)->get_buffer((uint8_t *)p_buffer, p_size);
+}
+
+int AudioStreamMP3::_file_seek_callback(uint64_t p_position, void *p_user_data) {
+	FileAccess *f = (FileAccess *)p_user_data;
+	f->seek(p_position);
+	return f->get_position() == p_position ? 0 : -1;
+}
+
+Ref<FileAccess> AudioStreamMP3::_open_stream_file(const String &p_path, mp3dec_io_t *r_io) {
+	Ref<FileAccess> f = FileAccess::open(p_path, FileAccess::READ);
+	if (f.is_null()) {
+		return f;
+	}
+	r_io->read = &AudioStreamMP3::_file_read_callback;
+	r_io->read_data = f.ptr();
+	r_io->seek = &AudioStreamMP3::_file_seek_callback;
+	r_io->seek_data = f.ptr();
+	return f;
+}
+
+void AudioStreamMP3::set_stream_path(const String &p_path) {
+	stream_path = p_path;
+	if (stream_path.is_empty()) {
+		return;
+	}
+
+	mp3dec_io_t io;
+	Ref<FileAccess> f = _open_stream_file(stream_path, &io);
+	ERR_FAIL_COND_MSG(f.is_null(), "Cannot open streamed MP3 file '" + stream_path + "'.");
+
+	// Only the first frames are read, unless the stream has to be scanned to find out its length.
+	mp3dec_ex_t mp3d = {};
+	int err = mp3dec_ex_open_cb(&mp3d, &io, MP3D_SEEK_TO_SAMPLE | MP3D_DO_NOT_SCAN);
+	if (!err && !mp3d.vbr_tag_found && mp3d.info.bitrate_kbps == 0) {
+		// Free format streams have no bitrate in their headers.
+		mp3dec_ex_close(&mp3d);
+		err = mp3dec_ex_open_cb(&mp3d, &io, MP3D_SEEK_TO_SAMPLE);
+	}
+	if (err || mp3d.info.hz == 0) {
+		mp3dec_ex_close(&mp3d);
+		ERR_FAIL_MSG("Failed to decode mp3 file. Make sure it is a valid mp3 audio file.");
+	}
+
+	channels = mp3d.info.channels;
+	sample_rate = mp3d.info.hz;
+	if (mp3d.vbr_tag_found || mp3d.indexes_built) {
+		length = float(mp3d.samples) / (sample_rate * float(channels));
+	} else {
+		// Exact for constant bitrate streams, an estimate for variable bitrate ones without a VBR tag.
+		length = float(f->get_length() - mp3d.start_offset) * 8 / (mp3d.info.bitrate_kbps * 1000.0f);
+	}
+
+	mp3dec_ex_close(&mp3d);
+
+	// Nothing is read from memory anymore.
+	clear_data();
+	data_len = 0;
+}
+
+String AudioStreamMP3::get_stream_path() const {
+	return stream_path;
+}
+
 void AudioStreamMP3::set_loop(bool p_enable) {
 	loop = p_enable;
 }
@@ -266,6 +412,9 @@ void AudioStreamMP3::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_data", "data"), &AudioStreamMP3::set_data);
 	ClassDB::bind_method(D_METHOD("get_data"), &AudioStreamMP3::get_data);
 
+	ClassDB::bind_method(D_METHOD("set_stream_path", "path"), &AudioStreamMP3::set_stream_path);
+	ClassDB::bind_method(D_METHOD("get_stream_path"), &AudioStreamMP3::get_stream_path);
+
 	ClassDB::bind_method(D_METHOD("set_loop", "enable"), &AudioStreamMP3::set_loop);
 	ClassDB::bind_method(D_METHOD("has_loop"), &AudioStreamMP3::has_loop);
 
@@ -282,6 +431,7 @@ void AudioStreamMP3::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_bar_beats"), &AudioStreamMP3::get_bar_beats);
 
 	ADD_PROPERTY(PropertyInfo(Variant::PACKED_BYTE_ARRAY, "data", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NO_EDITOR), "set_data", "get_data");
+	ADD_PROPERTY(PropertyInfo(Variant::STRING, "stream_path", PROPERTY_HINT_FILE, "*.mp3"), "set_stream_path", "get_stream_path");
 	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "bpm", PROPERTY_HINT_RANGE, "0,400,0.01,or_greater"), "set_bpm", "get_bpm");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "beat_count", PROPERTY_HINT_RANGE, "0,512,1,or_greater"), "set_beat_count", "get_beat_count");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "bar_beats", PROPERTY_HINT_RANGE, "2,32,1,or_greater"), "set_bar_beats", "get_bar_beats");
@@ -31,7 +31,9 @@
 #ifndef AUDIO_STREAM_MP3_H
 #define AUDIO_STREAM_MP3_H
 
+#include "core/io/file_access.h"
 #include "core/io/resource_loader.h"
+#include "servers/audio/audio_decode_ring.h"
 #include "servers/audio/audio_stream.h"
 
 #include <minimp3_ex.h>
@@ -56,6 +58,21 @@ class AudioStreamPlaybackMP3 : public AudioStreamPlaybackResampled {
 
 	Ref<AudioStreamMP3> mp3_stream;
 
+	// Streams read from disk are decoded ahead on a worker thread, so the mix thread never waits on file access.
+	enum {
+		DECODE_RING_FRAMES = 32768,
+		DECODE_CHUNK_FRAMES = 4096,
+	};
+	Ref<FileAccess> stream_file;
+	mp3dec_io_t stream_io;
+	AudioDecodeRing decode_ring;
+	SafeFlag streaming_active; // Shared by the main and mix threads.
+
+	static int _decode_ring_callback(void *p_userdata, AudioFrame *p_buffer, int p_frames);
+
+	int _decode_internal(AudioFrame *p_buffer, int p_frames);
+	void _seek(double p_time);
+
 protected:
 	virtual int _mix_internal(AudioFrame *p_buffer, int p_frames) override;
 	virtual float get_stream_sampling_rate() override;
@@ -72,6 +89,8 @@ public:
 
 	virtual void tag_used_streams() override;
 
+	virtual bool can_mix_in_parallel() const override;
+
 	AudioStreamPlaybackMP3() {}
 	~AudioStreamPlaybackMP3();
 };
@@ -86,6 +105,9 @@ class AudioStreamMP3 : public AudioStream {
 	PackedByteArray data;
 	uint32_t data_len = 0;
 
+	// When set, the compressed data is read from this file while playing instead of being kept in memory.
+	String stream_path;
+
 	float sample_rate = 1.0;
 	int channels = 1;
 	float length = 0.0;
@@ -93,6 +115,10 @@ class AudioStreamMP3 : public AudioStream {
 	float loop_offset = 0.0;
 	void clear_data();
 
+	static size_t _file_read_callback(void *p_buffer, size_t p_size, void *p_user_data);
+	static int _file_seek_callback(uint64_t p_position, void *p_user_data);
+	static Ref<FileAccess> _open_stream_file(const String &p_path, mp3dec_io_t *r_io);
+
 	double bpm = 0;
 	int beat_count = 0;
 	int bar_beats = 4;
@@ -122,6 +148,9 @@ public:
 	void set_data(const Vector<uint8_t> &p_data);
 	Vector<uint8_t> get_data() const;
 
+	void set_stream_path(const String &p_path);
+	String get_stream_path() const;
+
 	virtual double get_length() const override;
 
 	virtual bool is_monophonic() const override;
@@ -30,6 +30,7 @@
 
 #include "resource_importer_mp3.h"
 
+#include "core/io/dir_access.h"
 #include "core/io/file_access.h"
 #include "core/io/resource_saver.h"
 #include "scene/resources/texture.h"
@@ -80,6 +81,7 @@ void ResourceImporterMP3::get_import_options(const String &p_path, List<ImportOp
 	r_options->push_back(ImportOption(PropertyInfo(Variant::FLOAT, "bpm", PROPERTY_HINT_RANGE, "0,400,0.01,or_greater"), 0));
 	r_options->push_back(ImportOption(PropertyInfo(Variant::INT, "beat_count", PROPERTY_HINT_RANGE, "0,512,or_greater"), 0));
 	r_options->push_back(ImportOption(PropertyInfo(Variant::INT, "bar_beats", PROPERTY_HINT_RANGE, "2,32,or_greater"), 4));
+	r_options->push_back(ImportOption(PropertyInfo(Variant::BOOL, "stream_from_disk"), false));
 }
 
 #ifdef TOOLS_ENABLED
@@ -121,8 +123,25 @@ Error ResourceImporterMP3::import(const String &p_source_file, const String &p_s
 	double bpm = p_options["bpm"];
 	float beat_count = p_options["beat_count"];
 	float bar_beats = p_options["bar_beats"];
+	bool stream_from_disk = p_options["stream_from_disk"];
 
-	Ref<AudioStreamMP3> mp3_stream = import_mp3(p_source_file);
+	Ref<AudioStreamMP3> mp3_stream;
+	if (stream_from_disk) {
+		// Keep the compressed data next to the imported resource, so it is exported with it and can be read while playing.
+		String stream_path = p_save_path + ".mp3";
+		Error err = DirAccess::copy_absolute(p_source_file, stream_path);
+		ERR_FAIL_COND_V_MSG(err != OK, err, "Cannot copy '" + p_source_file + "' for streaming.");
+		if (r_gen_files) {
+			r_gen_files->push_back(stream_path);
+		}
+		mp3_stream.instantiate();
+		mp3_stream->set_stream_path(stream_path);
+		if (mp3_stream->get_length() == 0) {
+			return ERR_CANT_OPEN;
+		}
+	} else {
+		mp3_stream = import_mp3(p_source_file);
+	}
 	if (mp3_stream.is_null()) {
 		return ERR_CANT_OPEN;
 	}
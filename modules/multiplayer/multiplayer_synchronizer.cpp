@@ -252,6 +252,9 @@ void MultiplayerSynchronizer::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_delta_interval", "milliseconds"), &MultiplayerSynchronizer::set_delta_interval);
 	ClassDB::bind_method(D_METHOD("get_delta_interval"), &MultiplayerSynchronizer::get_delta_interval);
 
+	ClassDB::bind_method(D_METHOD("set_replication_priority", "priority"), &MultiplayerSynchronizer::set_replication_priority);
+	ClassDB::bind_method(D_METHOD("get_replication_priority"), &MultiplayerSynchronizer::get_replication_priority);
+
 	ClassDB::bind_method(D_METHOD("set_replication_config", "config"), &MultiplayerSynchronizer::set_replication_config);
 	ClassDB::bind_method(D_METHOD("get_replication_config"), &MultiplayerSynchronizer::get_replication_config);
 
@@ -270,6 +273,7 @@ void MultiplayerSynchronizer::_bind_methods() {
 	ADD_PROPERTY(PropertyInfo(Variant::NODE_PATH, "root_path"), "set_root_path", "get_root_path");
 	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "replication_interval", PROPERTY_HINT_RANGE, "0,5,0.001,suffix:s"), "set_replication_interval", "get_replication_interval");
 	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "delta_interval", PROPERTY_HINT_RANGE, "0,5,0.001,suffix:s"), "set_delta_interval", "get_delta_interval");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "replication_priority", PROPERTY_HINT_RANGE, "0,10,0.01,or_greater"), "set_replication_priority", "get_replication_priority");
 	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "replication_config", PROPERTY_HINT_RESOURCE_TYPE, "SceneReplicationConfig", PROPERTY_USAGE_NO_EDITOR), "set_replication_config", "get_replication_config");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "visibility_update_mode", PROPERTY_HINT_ENUM, "Idle,Physics,None"), "set_visibility_update_mode", "get_visibility_update_mode");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "public_visibility"), "set_visibility_public", "is_visibility_public");
@@ -327,6 +331,15 @@ double MultiplayerSynchronizer::get_delta_interval() const {
 	return double(delta_interval_usec) / 1000.0 / 1000.0;
 }
 
+void MultiplayerSynchronizer::set_replication_priority(real_t p_priority) {
+	ERR_FAIL_COND_MSG(p_priority < 0, "Priority must be greater or equal to 0.");
+	replication_priority = p_priority;
+}
+
+real_t MultiplayerSynchronizer::get_replication_priority() const {
+	return replication_priority;
+}
+
 void MultiplayerSynchronizer::set_replication_config(Ref<SceneReplicationConfig> p_config) {
 	replication_config = p_config;
 }
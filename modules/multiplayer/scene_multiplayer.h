@@ -201,6 +201,15 @@ public:
 	void set_max_delta_packet_size(int p_size);
 	int get_max_delta_packet_size() const;
 
+	void set_interest_radius(real_t p_radius);
+	real_t get_interest_radius() const;
+
+	void set_max_sync_bandwidth(int p_bytes_per_second);
+	int get_max_sync_bandwidth() const;
+
+	void set_peer_interest_origin(int p_peer, const Vector3 &p_origin);
+	void clear_peer_interest_origin(int p_peer);
+
 	SceneMultiplayer();
 	~SceneMultiplayer();
 };
@@ -56,6 +56,11 @@ bool SceneReplicationConfig::_set(const StringName &p_name, const Variant &p_val
 			property_set_replication_mode(prop.name, mode);
 			return true;
 		}
+		if (what == "quantization") {
+			ERR_FAIL_COND_V(p_value.get_type() != Variant::FLOAT && p_value.get_type() != Variant::INT, false);
+			property_set_quantization(prop.name, p_value);
+			return true;
+		}
 		ERR_FAIL_COND_V(p_value.get_type() != Variant::BOOL, false);
 		if (what == "spawn") {
 			property_set_spawn(prop.name, p_value);
@@ -90,6 +95,9 @@ bool SceneReplicationConfig::_get(const StringName &p_name, Variant &r_ret) cons
 		} else if (what == "replication_mode") {
 			r_ret = prop.mode;
 			return true;
+		} else if (what == "quantization") {
+			r_ret = prop.quantization;
+			return true;
 		}
 	}
 	return false;
@@ -100,6 +108,10 @@ void SceneReplicationConfig::_get_property_list(List<PropertyInfo> *p_list) cons
 		p_list->push_back(PropertyInfo(Variant::STRING, "properties/" + itos(i) + "/path", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NO_EDITOR | PROPERTY_USAGE_INTERNAL));
 		p_list->push_back(PropertyInfo(Variant::STRING, "properties/" + itos(i) + "/spawn", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NO_EDITOR | PROPERTY_USAGE_INTERNAL));
 		p_list->push_back(PropertyInfo(Variant::INT, "properties/" + itos(i) + "/replication_mode", PROPERTY_HINT_ENUM, "Never,Always,On Change", PROPERTY_USAGE_NO_EDITOR | PROPERTY_USAGE_INTERNAL));
+		// Only stored when set, to keep existing resources unchanged.
+		if (properties[i].quantization > 0) {
+			p_list->push_back(PropertyInfo(Variant::FLOAT, "properties/" + itos(i) + "/quantization", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NO_EDITOR | PROPERTY_USAGE_INTERNAL));
+		}
 	}
 }
 
@@ -216,12 +228,30 @@ void SceneReplicationConfig::property_set_replication_mode(const NodePath &p_pat
 	dirty = true;
 }
 
+real_t SceneReplicationConfig::property_get_quantization(const NodePath &p_path) {
+	List<ReplicationProperty>::Element *E = properties.find(p_path);
+	ERR_FAIL_COND_V(!E, 0);
+	return E->get().quantization;
+}
+
+void SceneReplicationConfig::property_set_quantization(const NodePath &p_path, real_t p_step) {
+	List<ReplicationProperty>::Element *E = properties.find(p_path);
+	ERR_FAIL_COND(!E);
+	ERR_FAIL_COND_MSG(p_step < 0, "Quantization step can't be negative.");
+	if (E->get().quantization == p_step) {
+		return;
+	}
+	E->get().quantization = p_step;
+	dirty = true;
+}
+
 void SceneReplicationConfig::_update() {
 	if (!dirty) {
 		return;
 	}
 	dirty = false;
 	sync_props.clear();
+	sync_quantization_steps.clear();
 	spawn_props.clear();
 	watch_props.clear();
 	for (const ReplicationProperty &prop : properties) {
@@ -231,6 +261,7 @@ void SceneReplicationConfig::_update() {
 		switch (prop.mode) {
 			case REPLICATION_MODE_ALWAYS:
 				sync_props.push_back(prop.name);
+				sync_quantization_steps.push_back(prop.quantization);
 				break;
 			case REPLICATION_MODE_ON_CHANGE:
 				watch_props.push_back(prop.name);
@@ -255,6 +286,13 @@ const List<NodePath> &SceneReplicationConfig::get_sync_properties() {
 	return sync_props;
 }
 
+const Vector<real_t> &SceneReplicationConfig::get_sync_quantization_steps() {
+	if (dirty) {
+		_update();
+	}
+	return sync_quantization_steps;
+}
+
 const List<NodePath> &SceneReplicationConfig::get_watch_properties() {
 	if (dirty) {
 		_update();
@@ -272,6 +310,8 @@ void SceneReplicationConfig::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("property_set_spawn", "path", "enabled"), &SceneReplicationConfig::property_set_spawn);
 	ClassDB::bind_method(D_METHOD("property_get_replication_mode", "path"), &SceneReplicationConfig::property_get_replication_mode);
 	ClassDB::bind_method(D_METHOD("property_set_replication_mode", "path", "mode"), &SceneReplicationConfig::property_set_replication_mode);
+	ClassDB::bind_method(D_METHOD("property_get_quantization", "path"), &SceneReplicationConfig::property_get_quantization);
+	ClassDB::bind_method(D_METHOD("property_set_quantization", "path", "step"), &SceneReplicationConfig::property_set_quantization);
 
 	BIND_ENUM_CONSTANT(REPLICATION_MODE_NEVER);
 	BIND_ENUM_CONSTANT(REPLICATION_MODE_ALWAYS);
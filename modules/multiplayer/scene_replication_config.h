@@ -51,6 +51,7 @@ private:
 		NodePath name;
 		bool spawn = true;
 		ReplicationMode mode = REPLICATION_MODE_ALWAYS;
+		real_t quantization = 0;
 
 		bool operator==(const ReplicationProperty &p_to) {
 			return name == p_to.name;
@@ -66,6 +67,7 @@ private:
 	List<ReplicationProperty> properties;
 	List<NodePath> spawn_props;
 	List<NodePath> sync_props;
+	Vector<real_t> sync_quantization_steps;
 	List<NodePath> watch_props;
 	bool dirty = false;
 
@@ -98,8 +100,12 @@ public:
 	ReplicationMode property_get_replication_mode(const NodePath &p_path);
 	void property_set_replication_mode(const NodePath &p_path, ReplicationMode p_mode);
 
+	real_t property_get_quantization(const NodePath &p_path);
+	void property_set_quantization(const NodePath &p_path, real_t p_step);
+
 	const List<NodePath> &get_spawn_properties();
 	const List<NodePath> &get_sync_properties();
+	const Vector<real_t> &get_sync_quantization_steps();
 	const List<NodePath> &get_watch_properties();
 
 	SceneReplicationConfig() {}
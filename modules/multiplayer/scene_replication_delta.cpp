@@ -0,0 +1,375 @@
+/**************************************************************************/
+/*  scene_replication_delta.cpp                                           */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "scene_replication_delta.h"
+
+#include "core/io/marshalls.h"
+#include "scene/main/multiplayer_api.h"
+
+// Sync states are sent either in full, or as the properties which changed since a baseline.
+enum SyncStateMode {
+	SYNC_STATE_FULL,
+	SYNC_STATE_DELTA,
+};
+
+// How a property with a quantization step is encoded.
+enum QuantizedValueMode {
+	QUANTIZED_ABSOLUTE, // Variant type, then each component as a multiple of the step.
+	QUANTIZED_DELTA, // Each component as the difference with the baseline, in steps.
+	QUANTIZED_NONE, // Not a quantizable type, regular Variant encoding.
+};
+
+static _FORCE_INLINE_ uint64_t _zigzag_encode(int64_t p_value) {
+	return (uint64_t(p_value) << 1) ^ uint64_t(p_value >> 63);
+}
+
+static _FORCE_INLINE_ int64_t _zigzag_decode(uint64_t p_value) {
+	return int64_t(p_value >> 1) ^ -int64_t(p_value & 1);
+}
+
+static void _write_varint(LocalVector<uint8_t> &r_buffer, uint64_t p_value) {
+	while (p_value >= 0x80) {
+		r_buffer.push_back(uint8_t(p_value) | 0x80);
+		p_value >>= 7;
+	}
+	r_buffer.push_back(uint8_t(p_value));
+}
+
+static Error _read_varint(const uint8_t *p_buffer, int p_buffer_len, int &r_ofs, uint64_t &r_value) {
+	r_value = 0;
+	for (int shift = 0; shift < 64; shift += 7) {
+		ERR_FAIL_COND_V(r_ofs >= p_buffer_len, ERR_INVALID_DATA);
+		uint8_t byte = p_buffer[r_ofs++];
+		r_value |= uint64_t(byte & 0x7F) << shift;
+		if (!(byte & 0x80)) {
+			return OK;
+		}
+	}
+	ERR_FAIL_V(ERR_INVALID_DATA);
+}
+
+static Error _write_variant(LocalVector<uint8_t> &r_buffer, const Variant &p_value) {
+	int size = 0;
+	Error err = MultiplayerAPI::encode_and_compress_variant(p_value, nullptr, size, false);
+	ERR_FAIL_COND_V(err != OK, err);
+	uint32_t ofs = r_buffer.size();
+	r_buffer.resize(ofs + size);
+	return MultiplayerAPI::encode_and_compress_variant(p_value, &r_buffer[ofs], size, false);
+}
+
+// Returns the number of components of quantizable types, 0 otherwise.
+static int _get_component_count(Variant::Type p_type) {
+	switch (p_type) {
+		case Variant::FLOAT:
+			return 1;
+		case Variant::VECTOR2:
+			return 2;
+		case Variant::VECTOR3:
+			return 3;
+		case Variant::VECTOR4:
+		case Variant::QUATERNION:
+			return 4;
+		default:
+			return 0;
+	}
+}
+
+static int _get_components(const Variant &p_value, double *r_components) {
+	switch (p_value.get_type()) {
+		case Variant::FLOAT: {
+			r_components[0] = p_value;
+			return 1;
+		}
+		case Variant::VECTOR2: {
+			Vector2 v = p_value;
+			r_components[0] = v.x;
+			r_components[1] = v.y;
+			return 2;
+		}
+		case Variant::VECTOR3: {
+			Vector3 v = p_value;
+			r_components[0] = v.x;
+			r_components[1] = v.y;
+			r_components[2] = v.z;
+			return 3;
+		}
+		case Variant::VECTOR4: {
+			Vector4 v = p_value;
+			r_components[0] = v.x;
+			r_components[1] = v.y;
+			r_components[2] = v.z;
+			r_components[3] = v.w;
+			return 4;
+		}
+		case Variant::QUATERNION: {
+			Quaternion q = p_value;
+			r_components[0] = q.x;
+			r_components[1] = q.y;
+			r_components[2] = q.z;
+			r_components[3] = q.w;
+			return 4;
+		}
+		default: {
+			return 0;
+		}
+	}
+}
+
+static Variant _make_from_components(Variant::Type p_type, const double *p_components) {
+	switch (p_type) {
+		case Variant::FLOAT:
+			return p_components[0];
+		case Variant::VECTOR2:
+			return Vector2(p_components[0], p_components[1]);
+		case Variant::VECTOR3:
+			return Vector3(p_components[0], p_components[1], p_components[2]);
+		case Variant::VECTOR4:
+			return Vector4(p_components[0], p_components[1], p_components[2], p_components[3]);
+		case Variant::QUATERNION:
+			return Quaternion(p_components[0], p_components[1], p_components[2], p_components[3]);
+		default:
+			ERR_FAIL_V(Variant());
+	}
+}
+
+// Larger step counts can't be told apart as doubles anyway. Clamping keeps both them and the
+// deltas between them within int64, even for huge values or tiny steps.
+static const int64_t QUANTIZED_MAX = int64_t(1) << 53;
+
+static _FORCE_INLINE_ int64_t _quantize(double p_component, real_t p_step) {
+	double steps = Math::round(p_component / p_step);
+	if (Math::is_nan(steps)) {
+		return 0;
+	}
+	return int64_t(CLAMP(steps, -double(QUANTIZED_MAX), double(QUANTIZED_MAX)));
+}
+
+// Rounds the value to the step, so both sides store the same baseline.
+static Variant _quantize_value(const Variant &p_value, real_t p_step) {
+	double components[4];
+	int count = _get_components(p_value, components);
+	if (!count) {
+		return p_value;
+	}
+	for (int i = 0; i < count; i++) {
+		components[i] = _quantize(components[i], p_step) * double(p_step);
+	}
+	return _make_from_components(p_value.get_type(), components);
+}
+
+static Error _write_quantized(LocalVector<uint8_t> &r_buffer, const Variant &p_value, const Variant *p_baseline, real_t p_step) {
+	double components[4];
+	int count = _get_components(p_value, components);
+	if (!count) {
+		r_buffer.push_back(QUANTIZED_NONE);
+		return _write_variant(r_buffer, p_value);
+	}
+	double baseline[4];
+	if (p_baseline && p_baseline->get_type() == p_value.get_type()) {
+		_get_components(*p_baseline, baseline);
+		r_buffer.push_back(QUANTIZED_DELTA);
+		for (int i = 0; i < count; i++) {
+			_write_varint(r_buffer, _zigzag_encode(_quantize(components[i], p_step) - _quantize(baseline[i], p_step)));
+		}
+	} else {
+		r_buffer.push_back(QUANTIZED_ABSOLUTE);
+		r_buffer.push_back(uint8_t(p_value.get_type()));
+		for (int i = 0; i < count; i++) {
+			_write_varint(r_buffer, _zigzag_encode(_quantize(components[i], p_step)));
+		}
+	}
+	return OK;
+}
+
+static Error _read_quantized(const uint8_t *p_buffer, int p_buffer_len, int &r_ofs, const Variant *p_baseline, real_t p_step, Variant &r_value) {
+	ERR_FAIL_COND_V(r_ofs >= p_buffer_len, ERR_INVALID_DATA);
+	uint8_t mode = p_buffer[r_ofs++];
+	if (mode == QUANTIZED_NONE) {
+		int used = 0;
+		Error err = MultiplayerAPI::decode_and_decompress_variant(r_value, &p_buffer[r_ofs], p_buffer_len - r_ofs, &used, false);
+		ERR_FAIL_COND_V(err != OK, err);
+		r_ofs += used;
+		return OK;
+	}
+
+	Variant::Type type;
+	double baseline[4] = {};
+	if (mode == QUANTIZED_DELTA) {
+		ERR_FAIL_NULL_V(p_baseline, ERR_INVALID_DATA);
+		type = p_baseline->get_type();
+		ERR_FAIL_COND_V(!_get_components(*p_baseline, baseline), ERR_INVALID_DATA);
+	} else {
+		ERR_FAIL_COND_V(mode != QUANTIZED_ABSOLUTE || r_ofs >= p_buffer_len, ERR_INVALID_DATA);
+		type = Variant::Type(p_buffer[r_ofs++]);
+	}
+
+	int count = _get_component_count(type);
+	ERR_FAIL_COND_V(!count, ERR_INVALID_DATA);
+	double components[4];
+	for (int i = 0; i < count; i++) {
+		uint64_t encoded = 0;
+		Error err = _read_varint(p_buffer, p_buffer_len, r_ofs, encoded);
+		ERR_FAIL_COND_V(err != OK, err);
+		int64_t steps = _zigzag_decode(encoded);
+		ERR_FAIL_COND_V(steps < -2 * QUANTIZED_MAX || steps > 2 * QUANTIZED_MAX, ERR_INVALID_DATA);
+		if (mode == QUANTIZED_DELTA) {
+			steps += _quantize(baseline[i], p_step);
+		}
+		components[i] = steps * double(p_step);
+	}
+	r_value = _make_from_components(type, components);
+	return OK;
+}
+
+Error SceneReplicationDelta::encode_state(const Baseline &p_baseline, uint16_t p_time, const Vector<real_t> &p_steps, Vector<Variant> &p_state, LocalVector<uint8_t> &r_buffer) {
+	ERR_FAIL_COND_V(p_steps.size() != p_state.size(), ERR_BUG);
+	const int count = p_state.size();
+	Variant *state = p_state.ptrw();
+	for (int i = 0; i < count; i++) {
+		if (p_steps[i] > 0) {
+			state[i] = _quantize_value(state[i], p_steps[i]);
+		}
+	}
+
+	// The peer only keeps a limited history, fall back to a full state when the baseline may be gone.
+	const Variant *base = nullptr;
+	if (p_baseline.has_acked && p_baseline.acked.state.size() == count && uint16_t(p_time - p_baseline.acked.time) < HISTORY_SIZE) {
+		base = p_baseline.acked.state.ptr();
+	}
+
+	r_buffer.clear();
+	uint32_t mask_ofs = 0;
+	if (base) {
+		r_buffer.resize(1 + 2 + (count + 7) / 8);
+		r_buffer[0] = SYNC_STATE_DELTA;
+		encode_uint16(p_baseline.acked.time, &r_buffer[1]);
+		mask_ofs = 3;
+		memset(&r_buffer[mask_ofs], 0, (count + 7) / 8);
+	} else {
+		r_buffer.push_back(SYNC_STATE_FULL);
+	}
+
+	for (int i = 0; i < count; i++) {
+		if (base) {
+			if (base[i] == state[i]) {
+				continue; // Unchanged since the baseline.
+			}
+			r_buffer[mask_ofs + i / 8] |= 1 << (i % 8);
+		}
+		Error err;
+		if (p_steps[i] > 0) {
+			err = _write_quantized(r_buffer, state[i], base ? &base[i] : nullptr, p_steps[i]);
+		} else {
+			err = _write_variant(r_buffer, state[i]);
+		}
+		ERR_FAIL_COND_V(err != OK, err);
+	}
+	return OK;
+}
+
+void SceneReplicationDelta::add_sent_state(Baseline &r_baseline, uint16_t p_time, const Vector<Variant> &p_state) {
+	Snapshot snapshot;
+	snapshot.time = p_time;
+	snapshot.state = p_state;
+	r_baseline.pending.push_back(snapshot);
+	if (r_baseline.pending.size() > HISTORY_SIZE) {
+		r_baseline.pending.remove_at(0);
+	}
+}
+
+void SceneReplicationDelta::acknowledge_state(Baseline &r_baseline, uint16_t p_time) {
+	for (uint32_t i = 0; i < r_baseline.pending.size(); i++) {
+		if (r_baseline.pending[i].time != p_time) {
+			continue;
+		}
+		r_baseline.acked = r_baseline.pending[i];
+		r_baseline.has_acked = true;
+		// Older states can't become a better baseline anymore.
+		for (uint32_t j = 0; j <= i; j++) {
+			r_baseline.pending.remove_at(0);
+		}
+		return;
+	}
+}
+
+Error SceneReplicationDelta::decode_state(LocalVector<Snapshot> &r_history, uint16_t p_time, const Vector<real_t> &p_steps, const uint8_t *p_buffer, int p_buffer_len, Vector<Variant> &r_state) {
+	ERR_FAIL_COND_V(p_buffer_len < 1, ERR_INVALID_DATA);
+	const int count = p_steps.size();
+
+	int ofs = 1;
+	const Variant *base = nullptr;
+	const uint8_t *mask = nullptr;
+	if (p_buffer[0] == SYNC_STATE_DELTA) {
+		ERR_FAIL_COND_V(p_buffer_len < 3 + (count + 7) / 8, ERR_INVALID_DATA);
+		uint16_t base_time = decode_uint16(&p_buffer[1]);
+		for (const Snapshot &snapshot : r_history) {
+			if (snapshot.time == base_time) {
+				base = snapshot.state.ptr();
+				ERR_FAIL_COND_V(snapshot.state.size() != count, ERR_INVALID_DATA);
+				break;
+			}
+		}
+		if (!base) {
+			return ERR_UNAVAILABLE; // Baseline no longer known, wait for a full state.
+		}
+		mask = &p_buffer[3];
+		ofs = 3 + (count + 7) / 8;
+	} else {
+		ERR_FAIL_COND_V(p_buffer[0] != SYNC_STATE_FULL, ERR_INVALID_DATA);
+	}
+
+	r_state.resize(count);
+	Variant *state = r_state.ptrw();
+	for (int i = 0; i < count; i++) {
+		if (mask && !(mask[i / 8] & (1 << (i % 8)))) {
+			state[i] = base[i];
+			continue;
+		}
+		if (p_steps[i] > 0) {
+			Error err = _read_quantized(p_buffer, p_buffer_len, ofs, base ? &base[i] : nullptr, p_steps[i], state[i]);
+			ERR_FAIL_COND_V(err != OK, err);
+		} else {
+			int used = 0;
+			Error err = MultiplayerAPI::decode_and_decompress_variant(state[i], &p_buffer[ofs], p_buffer_len - ofs, &used, false);
+			ERR_FAIL_COND_V(err != OK, err);
+			ofs += used;
+		}
+	}
+	ERR_FAIL_COND_V(ofs != p_buffer_len, ERR_INVALID_DATA);
+
+	Snapshot snapshot;
+	snapshot.time = p_time;
+	snapshot.state = r_state;
+	r_history.push_back(snapshot);
+	if (r_history.size() > HISTORY_SIZE) {
+		r_history.remove_at(0);
+	}
+	return OK;
+}
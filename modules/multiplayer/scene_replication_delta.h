@@ -0,0 +1,67 @@
+/**************************************************************************/
+/*  scene_replication_delta.h                                             */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef SCENE_REPLICATION_DELTA_H
+#define SCENE_REPLICATION_DELTA_H
+
+#include "core/templates/local_vector.h"
+#include "core/templates/vector.h"
+#include "core/variant/variant.h"
+
+// Encodes synchronizer states either in full, or as the properties which changed since a state the peer acknowledged.
+class SceneReplicationDelta {
+public:
+	enum {
+		// How many sync states are remembered per synchronizer to be used as baselines for deltas.
+		HISTORY_SIZE = 32,
+	};
+
+	struct Snapshot {
+		uint16_t time = 0;
+		Vector<Variant> state;
+	};
+
+	// The states of one synchronizer sent to one peer.
+	struct Baseline {
+		LocalVector<Snapshot> pending; // Sent, but not acknowledged yet.
+		Snapshot acked;
+		bool has_acked = false;
+	};
+
+	// Rounds p_state to the quantization steps, then encodes it against the acknowledged state when the peer still has it.
+	static Error encode_state(const Baseline &p_baseline, uint16_t p_time, const Vector<real_t> &p_steps, Vector<Variant> &p_state, LocalVector<uint8_t> &r_buffer);
+	// Only states which were actually sent may become baselines.
+	static void add_sent_state(Baseline &r_baseline, uint16_t p_time, const Vector<Variant> &p_state);
+	static void acknowledge_state(Baseline &r_baseline, uint16_t p_time);
+	// Returns ERR_UNAVAILABLE if the state is a delta against a baseline which is no longer in r_history.
+	static Error decode_state(LocalVector<Snapshot> &r_history, uint16_t p_time, const Vector<real_t> &p_steps, const uint8_t *p_buffer, int p_buffer_len, Vector<Variant> &r_state);
+};
+
+#endif // SCENE_REPLICATION_DELTA_H
@@ -34,9 +34,14 @@
 
 #include "core/debugger/engine_debugger.h"
 #include "core/io/marshalls.h"
+#include "scene/2d/node_2d.h"
 #include "scene/main/node.h"
 #include "scene/scene_string_names.h"
 
+#ifndef _3D_DISABLED
+#include "scene/3d/node_3d.h"
+#endif
+
 #define MAKE_ROOM(m_amount)             \
 	if (packet_cache.size() < m_amount) \
 		packet_cache.resize(m_amount);
@@ -144,14 +149,153 @@ void SceneReplicationInterface::on_network_process() {
 
 	// Process syncs.
 	uint64_t usec = OS::get_singleton()->get_ticks_usec();
+	// Refill the per-peer bandwidth budgets (token bucket), never accumulating more than a tenth of a second worth of data.
+	uint64_t elapsed = last_network_process_usec ? MIN(usec - last_network_process_usec, uint64_t(1000000)) : 0;
+	last_network_process_usec = usec;
+	if (interest_radius > 0) {
+		_update_interest_grid();
+	}
+	LocalVector<ObjectID> to_sync;
 	for (KeyValue<int, PeerInfo> &E : peers_info) {
-		const HashSet<ObjectID> to_sync = E.value.sync_nodes;
-		if (to_sync.is_empty()) {
+		PeerInfo &info = E.value;
+		if (info.sync_nodes.is_empty()) {
 			continue; // Nothing to sync
 		}
-		uint16_t sync_net_time = ++E.value.last_sent_sync;
+		if (max_sync_bandwidth > 0) {
+			const int64_t cap = MAX(int64_t(sync_mtu) + 8, int64_t(max_sync_bandwidth) / 10);
+			info.sync_budget = MIN(info.sync_budget + int64_t(elapsed * max_sync_bandwidth / 1000000), cap);
+		}
+		_schedule_sync(info, usec, to_sync);
+		uint16_t sync_net_time = ++info.last_sent_sync;
 		_send_sync(E.key, to_sync, sync_net_time, usec);
-		_send_delta(E.key, to_sync, usec, E.value.last_watch_usecs);
+		_send_delta(E.key, info.sync_nodes, usec, info.last_watch_usecs);
+	}
+}
+
+bool SceneReplicationInterface::_get_sync_position(MultiplayerSynchronizer *p_sync, Vector3 &r_position) {
+	Node *root = p_sync->get_root_node();
+	if (!root || !root->is_inside_tree()) {
+		return false;
+	}
+#ifndef _3D_DISABLED
+	Node3D *node_3d = Object::cast_to<Node3D>(root);
+	if (node_3d) {
+		r_position = node_3d->get_global_position();
+		return true;
+	}
+#endif
+	Node2D *node_2d = Object::cast_to<Node2D>(root);
+	if (node_2d) {
+		const Vector2 pos = node_2d->get_global_position();
+		r_position = Vector3(pos.x, pos.y, 0);
+		return true;
+	}
+	return false;
+}
+
+void SceneReplicationInterface::_update_interest_grid() {
+	// Keep the cell vectors of occupied cells around to avoid reallocating them every frame.
+	for (KeyValue<Vector3i, LocalVector<ObjectID>> &E : interest_grid) {
+		E.value.clear();
+	}
+	interest_unbounded.clear();
+	for (const ObjectID &oid : sync_nodes) {
+		MultiplayerSynchronizer *sync = get_id_as<MultiplayerSynchronizer>(oid);
+		ERR_CONTINUE(!sync);
+		if (!_has_authority(sync)) {
+			continue;
+		}
+		Vector3 pos;
+		if (!_get_sync_position(sync, pos)) {
+			interest_unbounded.push_back(oid);
+			continue;
+		}
+		interest_grid[Vector3i((pos / interest_radius).floor())].push_back(oid);
+	}
+	// Drop the cells nobody is in anymore, so the grid doesn't keep every cell ever visited.
+	LocalVector<Vector3i> empty_cells;
+	for (const KeyValue<Vector3i, LocalVector<ObjectID>> &E : interest_grid) {
+		if (E.value.is_empty()) {
+			empty_cells.push_back(E.key);
+		}
+	}
+	for (const Vector3i &cell : empty_cells) {
+		interest_grid.erase(cell);
+	}
+}
+
+void SceneReplicationInterface::_schedule_sync(PeerInfo &p_info, uint64_t p_usec, LocalVector<ObjectID> &r_synchronizers) {
+	r_synchronizers.clear();
+	const bool use_interest = interest_radius > 0 && p_info.has_interest_origin;
+	if (!use_interest && max_sync_bandwidth <= 0) {
+		// No scheduling, all visible synchronizers are candidates.
+		for (const ObjectID &oid : p_info.sync_nodes) {
+			r_synchronizers.push_back(oid);
+		}
+		return;
+	}
+
+	sync_candidates.clear();
+	if (use_interest) {
+		// Only consider synchronizers in the cells around the peer's interest origin.
+		const Vector3i cell = Vector3i((p_info.interest_origin / interest_radius).floor());
+		for (int x = -1; x <= 1; x++) {
+			for (int y = -1; y <= 1; y++) {
+				for (int z = -1; z <= 1; z++) {
+					const LocalVector<ObjectID> *cell_syncs = interest_grid.getptr(cell + Vector3i(x, y, z));
+					if (!cell_syncs) {
+						continue;
+					}
+					for (const ObjectID &oid : *cell_syncs) {
+						if (p_info.sync_nodes.has(oid)) {
+							sync_candidates.push_back(SyncCandidate{ oid, 0 });
+						}
+					}
+				}
+			}
+		}
+		for (const ObjectID &oid : interest_unbounded) {
+			if (p_info.sync_nodes.has(oid)) {
+				sync_candidates.push_back(SyncCandidate{ oid, 0 });
+			}
+		}
+	} else {
+		for (const ObjectID &oid : p_info.sync_nodes) {
+			sync_candidates.push_back(SyncCandidate{ oid, 0 });
+		}
+	}
+
+	// Score the due synchronizers by priority, staleness, and distance.
+	uint32_t due = 0;
+	for (uint32_t i = 0; i < sync_candidates.size(); i++) {
+		const ObjectID oid = sync_candidates[i].id;
+		MultiplayerSynchronizer *sync = get_id_as<MultiplayerSynchronizer>(oid);
+		ERR_CONTINUE(!sync);
+		const uint64_t interval = uint64_t(sync->get_replication_interval() * 1000 * 1000);
+		const uint64_t *last_usec = p_info.last_sync_usecs.getptr(oid);
+		const uint64_t since = last_usec ? p_usec - *last_usec : p_usec;
+		if (last_usec && since < interval) {
+			continue; // Too soon.
+		}
+		real_t score = sync->get_replication_priority() * real_t(since) / real_t(MAX(interval, uint64_t(1000)));
+		if (use_interest) {
+			Vector3 pos;
+			if (_get_sync_position(sync, pos)) {
+				const real_t dist = pos.distance_to(p_info.interest_origin);
+				if (dist > interest_radius) {
+					continue; // Out of the peer's area of interest.
+				}
+				score /= 1 + dist / interest_radius;
+			}
+		}
+		sync_candidates[due++] = SyncCandidate{ oid, score };
+	}
+	sync_candidates.resize(due);
+	if (max_sync_bandwidth > 0) {
+		sync_candidates.sort(); // Highest score first, so the budget is spent on what matters most.
+	}
+	for (const SyncCandidate &candidate : sync_candidates) {
+		r_synchronizers.push_back(candidate.id);
 	}
 }
 
@@ -286,8 +430,11 @@ Error SceneReplicationInterface::on_replication_stop(Object *p_obj, Variant p_co
 	for (KeyValue<int, PeerInfo> &E : peers_info) {
 		E.value.sync_nodes.erase(sid);
 		E.value.last_watch_usecs.erase(sid);
+		E.value.last_sync_usecs.erase(sid);
 		if (sync->get_net_id()) {
 			E.value.recv_sync_ids.erase(sync->get_net_id());
+			E.value.sync_baselines.erase(sync->get_net_id());
+			E.value.recv_sync_snapshots.erase(sync->get_net_id());
 		}
 	}
 	return OK;
@@ -364,6 +511,8 @@ Error SceneReplicationInterface::_update_sync_visibility(int p_peer, Multiplayer
 			} else {
 				E.value.sync_nodes.erase(sid);
 				E.value.last_watch_usecs.erase(sid);
+				E.value.last_sync_usecs.erase(sid);
+				E.value.sync_baselines.erase(p_sync->get_net_id());
 			}
 		}
 		return OK;
@@ -377,6 +526,8 @@ Error SceneReplicationInterface::_update_sync_visibility(int p_peer, Multiplayer
 		} else {
 			peers_info[p_peer].sync_nodes.erase(sid);
 			peers_info[p_peer].last_watch_usecs.erase(sid);
+			peers_info[p_peer].last_sync_usecs.erase(sid);
+			peers_info[p_peer].sync_baselines.erase(p_sync->get_net_id());
 		}
 		return OK;
 	}
@@ -799,18 +950,21 @@ Error SceneReplicationInterface::on_delta_receive(int p_from, const uint8_t *p_b
 	return OK;
 }
 
-void SceneReplicationInterface::_send_sync(int p_peer, const HashSet<ObjectID> p_synchronizers, uint16_t p_sync_net_time, uint64_t p_usec) {
+void SceneReplicationInterface::_send_sync(int p_peer, const LocalVector<ObjectID> &p_synchronizers, uint16_t p_sync_net_time, uint64_t p_usec) {
 	MAKE_ROOM(/* header */ 3 + /* element */ 4 + 4 + sync_mtu);
 	uint8_t *ptr = packet_cache.ptrw();
 	ptr[0] = SceneMultiplayer::NETWORK_COMMAND_SYNC;
 	int ofs = 1;
 	ofs += encode_uint16(p_sync_net_time, &ptr[1]);
+	PeerInfo &info = peers_info[p_peer];
+	// When scheduling, synchronizers are already filtered by their per-peer interval.
+	const bool scheduled = max_sync_bandwidth > 0 || (interest_radius > 0 && info.has_interest_origin);
 	// Can only send updates for already notified nodes.
 	// This is a lazy implementation, we could optimize much more here with by grouping by replication config.
 	for (const ObjectID &oid : p_synchronizers) {
 		MultiplayerSynchronizer *sync = get_id_as<MultiplayerSynchronizer>(oid);
 		ERR_CONTINUE(!sync || !sync->get_replication_config_ptr() || !_has_authority(sync));
-		if (!sync->update_outbound_sync_time(p_usec)) {
+		if (!scheduled && !sync->update_outbound_sync_time(p_usec)) {
 			continue; // nothing to sync.
 		}
 
@@ -827,10 +981,22 @@ void SceneReplicationInterface::_send_sync(int p_peer, const HashSet<ObjectID> p
 		const List<NodePath> props = sync->get_replication_config_ptr()->get_sync_properties();
 		Error err = MultiplayerSynchronizer::get_state(props, node, vars, varp);
 		ERR_CONTINUE_MSG(err != OK, "Unable to retrieve sync state.");
-		err = MultiplayerAPI::encode_and_compress_variants(varp.ptrw(), varp.size(), nullptr, size);
+		SceneReplicationDelta::Baseline &baseline = info.sync_baselines[net_id];
+		err = SceneReplicationDelta::encode_state(baseline, p_sync_net_time, sync->get_replication_config_ptr()->get_sync_quantization_steps(), vars, sync_state_cache);
 		ERR_CONTINUE_MSG(err != OK, "Unable to encode sync state.");
-		// TODO Handle single state above MTU.
+		size = sync_state_cache.size();
+		// Dropped states are never recorded as sent, so they can't become a baseline.
 		ERR_CONTINUE_MSG(size > sync_mtu, vformat("Node states bigger than MTU will not be sent (%d > %d): %s", size, sync_mtu, node->get_path()));
+		if (max_sync_bandwidth > 0) {
+			if (info.sync_budget < 4 + 4 + size) {
+				// Out of budget, lower priority states will be sent in a later frame.
+				break;
+			}
+			info.sync_budget -= 4 + 4 + size;
+		}
+		if (scheduled) {
+			info.last_sync_usecs[oid] = p_usec;
+		}
 		if (ofs + 4 + 4 + size > sync_mtu) {
 			// Send what we got, and reset write.
 			_send_raw(packet_cache.ptr(), ofs, p_peer, false);
@@ -839,8 +1005,9 @@ void SceneReplicationInterface::_send_sync(int p_peer, const HashSet<ObjectID> p
 		if (size) {
 			ofs += encode_uint32(sync->get_net_id(), &ptr[ofs]);
 			ofs += encode_uint32(size, &ptr[ofs]);
-			MultiplayerAPI::encode_and_compress_variants(varp.ptrw(), varp.size(), &ptr[ofs], size);
+			memcpy(&ptr[ofs], sync_state_cache.ptr(), size);
 			ofs += size;
+			SceneReplicationDelta::add_sent_state(baseline, p_sync_net_time, vars);
 		}
 #ifdef DEBUG_ENABLED
 		_profile_node_data("sync_out", oid, size);
@@ -852,13 +1019,46 @@ void SceneReplicationInterface::_send_sync(int p_peer, const HashSet<ObjectID> p
 	}
 }
 
+void SceneReplicationInterface::_send_sync_ack(int p_peer, uint16_t p_sync_net_time, const LocalVector<uint32_t> &p_net_ids) {
+	MAKE_ROOM(/* header */ 3 + /* elements */ 4 * (int)p_net_ids.size());
+	uint8_t *ptr = packet_cache.ptrw();
+	ptr[0] = SceneMultiplayer::NETWORK_COMMAND_SYNC | (1 << SceneMultiplayer::CMD_FLAG_1_SHIFT);
+	int ofs = 1;
+	ofs += encode_uint16(p_sync_net_time, &ptr[ofs]);
+	for (const uint32_t &net_id : p_net_ids) {
+		ofs += encode_uint32(net_id, &ptr[ofs]);
+	}
+	_send_raw(ptr, ofs, p_peer, false);
+}
+
+Error SceneReplicationInterface::on_sync_ack_receive(int p_from, const uint8_t *p_buffer, int p_buffer_len) {
+	ERR_FAIL_COND_V_MSG(p_buffer_len < 3 || (p_buffer_len - 3) % 4, ERR_INVALID_DATA, "Invalid sync acknowledgement received");
+	ERR_FAIL_COND_V(!peers_info.has(p_from), ERR_INVALID_PARAMETER);
+	PeerInfo &info = peers_info[p_from];
+	uint16_t time = decode_uint16(&p_buffer[1]);
+	for (int ofs = 3; ofs < p_buffer_len; ofs += 4) {
+		SceneReplicationDelta::Baseline *baseline = info.sync_baselines.getptr(decode_uint32(&p_buffer[ofs]));
+		if (baseline) {
+			SceneReplicationDelta::acknowledge_state(*baseline, time);
+		}
+	}
+	return OK;
+}
+
 Error SceneReplicationInterface::on_sync_receive(int p_from, const uint8_t *p_buffer, int p_buffer_len) {
+	ERR_FAIL_COND_V_MSG(p_buffer_len < 1, ERR_INVALID_DATA, "Invalid sync packet received");
+	if (p_buffer[0] & (1 << SceneMultiplayer::CMD_FLAG_1_SHIFT)) {
+		return on_sync_ack_receive(p_from, p_buffer, p_buffer_len);
+	}
 	ERR_FAIL_COND_V_MSG(p_buffer_len < 11, ERR_INVALID_DATA, "Invalid sync packet received");
 	bool is_delta = (p_buffer[0] & (1 << SceneMultiplayer::CMD_FLAG_0_SHIFT)) != 0;
 	if (is_delta) {
 		return on_delta_receive(p_from, p_buffer, p_buffer_len);
 	}
 	uint16_t time = decode_uint16(&p_buffer[1]);
+	ERR_FAIL_COND_V(!peers_info.has(p_from), ERR_INVALID_PARAMETER);
+	PeerInfo &info = peers_info[p_from];
+	LocalVector<uint32_t> acked_net_ids;
 	int ofs = 3;
 	while (ofs + 8 < p_buffer_len) {
 		uint32_t net_id = decode_uint32(&p_buffer[ofs]);
@@ -885,18 +1085,25 @@ Error SceneReplicationInterface::on_sync_receive(int p_from, const uint8_t *p_bu
 		}
 		const List<NodePath> props = sync->get_replication_config_ptr()->get_sync_properties();
 		Vector<Variant> vars;
-		vars.resize(props.size());
-		int consumed;
-		Error err = MultiplayerAPI::decode_and_decompress_variants(vars, &p_buffer[ofs], size, consumed);
+		Error err = SceneReplicationDelta::decode_state(info.recv_sync_snapshots[net_id], time, sync->get_replication_config_ptr()->get_sync_quantization_steps(), &p_buffer[ofs], size, vars);
+		if (err == ERR_UNAVAILABLE) {
+			// Delta against a state we no longer have, the authority will send a full one.
+			ofs += size;
+			continue;
+		}
 		ERR_FAIL_COND_V(err, err);
 		err = MultiplayerSynchronizer::set_state(props, node, vars);
 		ERR_FAIL_COND_V(err, err);
 		ofs += size;
+		acked_net_ids.push_back(net_id);
 		sync->emit_signal(SNAME("synchronized"));
 #ifdef DEBUG_ENABLED
 		_profile_node_data("sync_in", sync->get_instance_id(), size);
 #endif
 	}
+	if (!acked_net_ids.is_empty()) {
+		_send_sync_ack(p_from, time, acked_net_ids);
+	}
 	return OK;
 }
 
@@ -917,3 +1124,37 @@ void SceneReplicationInterface::set_max_delta_packet_size(int p_size) {
 int SceneReplicationInterface::get_max_delta_packet_size() const {
 	return delta_mtu;
 }
+
+void SceneReplicationInterface::set_interest_radius(real_t p_radius) {
+	ERR_FAIL_COND_MSG(p_radius < 0, "Interest radius must be greater or equal to 0 (where 0 means disabled).");
+	interest_radius = p_radius;
+	if (interest_radius <= 0) {
+		interest_grid.clear();
+		interest_unbounded.clear();
+	}
+}
+
+real_t SceneReplicationInterface::get_interest_radius() const {
+	return interest_radius;
+}
+
+void SceneReplicationInterface::set_max_sync_bandwidth(int p_bytes_per_second) {
+	ERR_FAIL_COND_MSG(p_bytes_per_second < 0, "Sync bandwidth must be greater or equal to 0 (where 0 means unlimited).");
+	max_sync_bandwidth = p_bytes_per_second;
+}
+
+int SceneReplicationInterface::get_max_sync_bandwidth() const {
+	return max_sync_bandwidth;
+}
+
+void SceneReplicationInterface::set_peer_interest_origin(int p_peer, const Vector3 &p_origin) {
+	ERR_FAIL_COND(!peers_info.has(p_peer));
+	PeerInfo &info = peers_info[p_peer];
+	info.has_interest_origin = true;
+	info.interest_origin = p_origin;
+}
+
+void SceneReplicationInterface::clear_peer_interest_origin(int p_peer) {
+	ERR_FAIL_COND(!peers_info.has(p_peer));
+	peers_info[p_peer].has_interest_origin = false;
+}
@@ -33,8 +33,10 @@
 
 #include "multiplayer_spawner.h"
 #include "multiplayer_synchronizer.h"
+#include "scene_replication_delta.h"
 
 #include "core/object/ref_counted.h"
+#include "core/templates/local_vector.h"
 
 class SceneMultiplayer;
 class SceneCacheInterface;
@@ -67,6 +69,21 @@ private:
 		HashMap<uint32_t, ObjectID> recv_sync_ids;
 		HashMap<uint32_t, ObjectID> recv_nodes;
 		uint16_t last_sent_sync = 0;
+		// Sync states sent to this peer and received from it, by synchronizer net ID.
+		HashMap<uint32_t, SceneReplicationDelta::Baseline> sync_baselines;
+		HashMap<uint32_t, LocalVector<SceneReplicationDelta::Snapshot>> recv_sync_snapshots;
+		// Interest management and bandwidth scheduling.
+		bool has_interest_origin = false;
+		Vector3 interest_origin;
+		HashMap<ObjectID, uint64_t> last_sync_usecs;
+		int64_t sync_budget = 0;
+	};
+
+	struct SyncCandidate {
+		ObjectID id;
+		real_t score = 0;
+
+		bool operator<(const SyncCandidate &p_other) const { return score > p_other.score; }
 	};
 
 	// Replication state.
@@ -90,8 +107,17 @@ private:
 	SceneMultiplayer *multiplayer = nullptr;
 	SceneCacheInterface *multiplayer_cache = nullptr;
 	PackedByteArray packet_cache;
+	LocalVector<uint8_t> sync_state_cache;
 	int sync_mtu = 1350; // Highly dependent on underlying protocol.
 	int delta_mtu = 65535;
+	real_t interest_radius = 0; // 0 means no interest management.
+	int max_sync_bandwidth = 0; // Bytes per second, per peer. 0 means unlimited.
+	uint64_t last_network_process_usec = 0;
+
+	// Spatial hash of the synchronizers, rebuilt every network frame when interest management is enabled.
+	HashMap<Vector3i, LocalVector<ObjectID>> interest_grid;
+	LocalVector<ObjectID> interest_unbounded; // Synchronizers with no spatial root.
+	LocalVector<SyncCandidate> sync_candidates; // Scratch buffer for scheduling.
 
 	TrackedNode &_track(const ObjectID &p_id);
 	void _untrack(const ObjectID &p_id);
@@ -101,8 +127,12 @@ private:
 	bool _verify_synchronizer(int p_peer, MultiplayerSynchronizer *p_sync, uint32_t &r_net_id);
 	MultiplayerSynchronizer *_find_synchronizer(int p_peer, uint32_t p_net_ida);
 
-	void _send_sync(int p_peer, const HashSet<ObjectID> p_synchronizers, uint16_t p_sync_net_time, uint64_t p_usec);
+	static bool _get_sync_position(MultiplayerSynchronizer *p_sync, Vector3 &r_position);
+	void _update_interest_grid();
+	void _schedule_sync(PeerInfo &p_info, uint64_t p_usec, LocalVector<ObjectID> &r_synchronizers);
+	void _send_sync(int p_peer, const LocalVector<ObjectID> &p_synchronizers, uint16_t p_sync_net_time, uint64_t p_usec);
 	void _send_delta(int p_peer, const HashSet<ObjectID> p_synchronizers, uint64_t p_usec, const HashMap<ObjectID, uint64_t> p_last_watch_usecs);
+	void _send_sync_ack(int p_peer, uint16_t p_sync_net_time, const LocalVector<uint32_t> &p_net_ids);
 	Error _make_spawn_packet(Node *p_node, MultiplayerSpawner *p_spawner, int &r_len);
 	Error _make_despawn_packet(Node *p_node, int &r_len);
 	Error _send_raw(const uint8_t *p_buffer, int p_size, int p_peer, bool p_reliable);
@@ -137,6 +167,7 @@ public:
 	Error on_despawn_receive(int p_from, const uint8_t *p_buffer, int p_buffer_len);
 	Error on_sync_receive(int p_from, const uint8_t *p_buffer, int p_buffer_len);
 	Error on_delta_receive(int p_from, const uint8_t *p_buffer, int p_buffer_len);
+	Error on_sync_ack_receive(int p_from, const uint8_t *p_buffer, int p_buffer_len);
 
 	bool is_rpc_visible(const ObjectID &p_oid, int p_peer) const;
 
@@ -146,6 +177,15 @@ public:
 	void set_max_delta_packet_size(int p_size);
 	int get_max_delta_packet_size() const;
 
+	void set_interest_radius(real_t p_radius);
+	real_t get_interest_radius() const;
+
+	void set_max_sync_bandwidth(int p_bytes_per_second);
+	int get_max_sync_bandwidth() const;
+
+	void set_peer_interest_origin(int p_peer, const Vector3 &p_origin);
+	void clear_peer_interest_origin(int p_peer);
+
 	SceneReplicationInterface(SceneMultiplayer *p_multiplayer, SceneCacheInterface *p_cache) {
 		multiplayer = p_multiplayer;
 		multiplayer_cache = p_cache;
@@ -0,0 +1,158 @@
+/**************************************************************************/
+/*  test_scene_replication_delta.h                                        */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_SCENE_REPLICATION_DELTA_H
+#define TEST_SCENE_REPLICATION_DELTA_H
+
+#include "../scene_replication_delta.h"
+
+#include "tests/test_macros.h"
+
+namespace TestSceneReplicationDelta {
+
+static Vector<Variant> make_state(real_t p_x, const Vector3 &p_position, const String &p_name) {
+	Vector<Variant> state;
+	state.push_back(p_x);
+	state.push_back(p_position);
+	state.push_back(p_name);
+	return state;
+}
+
+static Vector<real_t> make_steps() {
+	Vector<real_t> steps;
+	steps.push_back(0.5);
+	steps.push_back(0.01);
+	steps.push_back(0);
+	return steps;
+}
+
+TEST_CASE("[SceneReplicationDelta] Full state round trip") {
+	SceneReplicationDelta::Baseline baseline;
+	LocalVector<SceneReplicationDelta::Snapshot> history;
+	LocalVector<uint8_t> buffer;
+	const Vector<real_t> steps = make_steps();
+
+	Vector<Variant> sent = make_state(1.3, Vector3(1.234, -5.678, 100.001), "player");
+	CHECK(SceneReplicationDelta::encode_state(baseline, 0, steps, sent, buffer) == OK);
+	// The sent state is quantized in place, so both sides agree on the baseline.
+	CHECK(double(sent[0]) == doctest::Approx(1.5));
+	CHECK(Vector3(sent[1]).is_equal_approx(Vector3(1.23, -5.68, 100.0)));
+
+	Vector<Variant> received;
+	CHECK(SceneReplicationDelta::decode_state(history, 0, steps, buffer.ptr(), buffer.size(), received) == OK);
+	CHECK(received == sent);
+	CHECK(history.size() == 1);
+}
+
+TEST_CASE("[SceneReplicationDelta] Delta against an acknowledged state") {
+	SceneReplicationDelta::Baseline baseline;
+	LocalVector<SceneReplicationDelta::Snapshot> history;
+	LocalVector<uint8_t> buffer;
+	const Vector<real_t> steps = make_steps();
+
+	Vector<Variant> first = make_state(2, Vector3(10, 20, 30), "a rather long player name");
+	CHECK(SceneReplicationDelta::encode_state(baseline, 1, steps, first, buffer) == OK);
+	const uint32_t full_size = buffer.size();
+	SceneReplicationDelta::add_sent_state(baseline, 1, first);
+	Vector<Variant> received;
+	CHECK(SceneReplicationDelta::decode_state(history, 1, steps, buffer.ptr(), buffer.size(), received) == OK);
+	SceneReplicationDelta::acknowledge_state(baseline, 1);
+	CHECK(baseline.has_acked);
+	CHECK(baseline.pending.is_empty());
+
+	// Only the position moved.
+	Vector<Variant> second = make_state(2, Vector3(10.5, 20, 29.75), "a rather long player name");
+	CHECK(SceneReplicationDelta::encode_state(baseline, 2, steps, second, buffer) == OK);
+	CHECK(buffer.size() < full_size);
+	CHECK(SceneReplicationDelta::decode_state(history, 2, steps, buffer.ptr(), buffer.size(), received) == OK);
+	CHECK(received == second);
+
+	// Nothing changed.
+	CHECK(SceneReplicationDelta::encode_state(baseline, 3, steps, first, buffer) == OK);
+	CHECK(SceneReplicationDelta::decode_state(history, 3, steps, buffer.ptr(), buffer.size(), received) == OK);
+	CHECK(received == first);
+}
+
+TEST_CASE("[SceneReplicationDelta] Unsent and unknown baselines") {
+	SceneReplicationDelta::Baseline baseline;
+	LocalVector<uint8_t> buffer;
+	const Vector<real_t> steps = make_steps();
+
+	Vector<Variant> state = make_state(1, Vector3(), "name");
+	CHECK(SceneReplicationDelta::encode_state(baseline, 1, steps, state, buffer) == OK);
+	// A state which was encoded but never sent can't be acknowledged.
+	SceneReplicationDelta::acknowledge_state(baseline, 1);
+	CHECK_FALSE(baseline.has_acked);
+
+	SceneReplicationDelta::add_sent_state(baseline, 1, state);
+	SceneReplicationDelta::acknowledge_state(baseline, 1);
+	CHECK(baseline.has_acked);
+
+	// The receiver lost the baseline, it has to wait for a full state.
+	state = make_state(3, Vector3(1, 2, 3), "name");
+	CHECK(SceneReplicationDelta::encode_state(baseline, 2, steps, state, buffer) == OK);
+	LocalVector<SceneReplicationDelta::Snapshot> empty_history;
+	Vector<Variant> received;
+	CHECK(SceneReplicationDelta::decode_state(empty_history, 2, steps, buffer.ptr(), buffer.size(), received) == ERR_UNAVAILABLE);
+
+	// Too old for the receiver to still remember it, a full state is sent instead.
+	CHECK(SceneReplicationDelta::encode_state(baseline, 1 + SceneReplicationDelta::HISTORY_SIZE, steps, state, buffer) == OK);
+	CHECK(SceneReplicationDelta::decode_state(empty_history, 1 + SceneReplicationDelta::HISTORY_SIZE, steps, buffer.ptr(), buffer.size(), received) == OK);
+	CHECK(received == state);
+}
+
+TEST_CASE("[SceneReplicationDelta] Huge values and tiny steps") {
+	SceneReplicationDelta::Baseline baseline;
+	LocalVector<SceneReplicationDelta::Snapshot> history;
+	LocalVector<uint8_t> buffer;
+	Vector<real_t> steps;
+	steps.push_back(1e-6);
+
+	Vector<Variant> first;
+	first.push_back(-1e30);
+	CHECK(SceneReplicationDelta::encode_state(baseline, 1, steps, first, buffer) == OK);
+	SceneReplicationDelta::add_sent_state(baseline, 1, first);
+	Vector<Variant> received;
+	CHECK(SceneReplicationDelta::decode_state(history, 1, steps, buffer.ptr(), buffer.size(), received) == OK);
+	CHECK(received == first);
+	SceneReplicationDelta::acknowledge_state(baseline, 1);
+
+	// The delta between both extremes must not overflow.
+	Vector<Variant> second;
+	second.push_back(1e30);
+	CHECK(SceneReplicationDelta::encode_state(baseline, 2, steps, second, buffer) == OK);
+	CHECK(double(second[0]) > 0);
+	CHECK(SceneReplicationDelta::decode_state(history, 2, steps, buffer.ptr(), buffer.size(), received) == OK);
+	CHECK(received == second);
+}
+
+} // namespace TestSceneReplicationDelta
+
+#endif // TEST_SCENE_REPLICATION_DELTA_H
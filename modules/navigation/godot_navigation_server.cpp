@@ -1095,6 +1095,8 @@ void GodotNavigationServer::sync() {
 }
 
 void GodotNavigationServer::process(real_t p_delta_time) {
+	MemoryTagScope memory_tag(Memory::TAG_NAVIGATION);
+
 	flush_queries();
 
 	if (!active) {
@@ -37,6 +37,7 @@
 
 #include "core/config/project_settings.h"
 #include "core/object/worker_thread_pool.h"
+#include "core/templates/small_vector.h"
 
 #include <Obstacle2d.h>
 
@@ -837,16 +838,16 @@ void NavMap::sync() {
 
 		_new_pm_polygon_count = polygons.size();
 
-		// Group all edges per key.
-		HashMap<gd::EdgeKey, Vector<gd::Edge::Connection>, gd::EdgeKey> connections;
+		// Group all edges per key. An edge is shared by at most two polygons, so connections are kept inline.
+		HashMap<gd::EdgeKey, SmallVector<gd::Edge::Connection, 2>, gd::EdgeKey> connections;
 		for (gd::Polygon &poly : polygons) {
 			for (uint32_t p = 0; p < poly.points.size(); p++) {
 				int next_point = (p + 1) % poly.points.size();
 				gd::EdgeKey ek(poly.points[p].key, poly.points[next_point].key);
 
-				HashMap<gd::EdgeKey, Vector<gd::Edge::Connection>, gd::EdgeKey>::Iterator connection = connections.find(ek);
+				HashMap<gd::EdgeKey, SmallVector<gd::Edge::Connection, 2>, gd::EdgeKey>::Iterator connection = connections.find(ek);
 				if (!connection) {
-					connections[ek] = Vector<gd::Edge::Connection>();
+					connections[ek] = SmallVector<gd::Edge::Connection, 2>();
 					_new_pm_edge_count += 1;
 				}
 				if (connections[ek].size() <= 1) {
@@ -865,11 +866,11 @@ void NavMap::sync() {
 		}
 
 		Vector<gd::Edge::Connection> free_edges;
-		for (KeyValue<gd::EdgeKey, Vector<gd::Edge::Connection>> &E : connections) {
+		for (KeyValue<gd::EdgeKey, SmallVector<gd::Edge::Connection, 2>> &E : connections) {
 			if (E.value.size() == 2) {
 				// Connect edge that are shared in different polygons.
-				gd::Edge::Connection &c1 = E.value.write[0];
-				gd::Edge::Connection &c2 = E.value.write[1];
+				gd::Edge::Connection &c1 = E.value[0];
+				gd::Edge::Connection &c2 = E.value[1];
 				c1.polygon->edges[c1.edge].connections.push_back(c2);
 				c2.polygon->edges[c2.edge].connections.push_back(c1);
 				// Note: The pathway_start/end are full for those connection and do not need to be modified.
@@ -42,6 +42,12 @@ void OggPacketSequence::push_page(int64_t p_granule_pos, const Vector<PackedByte
 	data_version++;
 }
 
+void OggPacketSequence::push_page_file_offset(int64_t p_granule_pos, uint64_t p_file_offset) {
+	page_granule_positions.push_back(p_granule_pos);
+	page_file_offsets.push_back(p_file_offset);
+	data_version++;
+}
+
 void OggPacketSequence::set_packet_data(const TypedArray<Array> &p_data) {
 	data_version++; // Update the data version so old playbacks know that they can't rely on us anymore.
 	page_data.clear();
@@ -84,6 +90,43 @@ PackedInt64Array OggPacketSequence::get_packet_granule_positions() const {
 	return ret;
 }
 
+void OggPacketSequence::set_stream_path(const String &p_path) {
+	data_version++; // Update the data version so old playbacks know that they can't rely on us anymore.
+	stream_path = p_path;
+}
+
+String OggPacketSequence::get_stream_path() const {
+	return stream_path;
+}
+
+void OggPacketSequence::set_page_file_offsets(const PackedInt64Array &p_offsets) {
+	data_version++; // Update the data version so old playbacks know that they can't rely on us anymore.
+	page_file_offsets.clear();
+	for (int page_idx = 0; page_idx < p_offsets.size(); page_idx++) {
+		page_file_offsets.push_back(p_offsets[page_idx]);
+	}
+}
+
+PackedInt64Array OggPacketSequence::get_page_file_offsets() const {
+	PackedInt64Array ret;
+	for (uint64_t offset : page_file_offsets) {
+		ret.push_back(offset);
+	}
+	return ret;
+}
+
+int64_t OggPacketSequence::_get_page_count() const {
+	return is_streamed() ? page_file_offsets.size() : page_data.size();
+}
+
+bool OggPacketSequence::_page_has_packets(int64_t p_page) const {
+	if (is_streamed()) {
+		// Pages that no packet ends on have a granule position of -1.
+		return int64_t(page_granule_positions[p_page]) != -1;
+	}
+	return page_data[p_page].size() > 0;
+}
+
 void OggPacketSequence::set_sampling_rate(float p_sampling_rate) {
 	sampling_rate = p_sampling_rate;
 }
@@ -123,6 +166,12 @@ void OggPacketSequence::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_packet_granule_positions", "granule_positions"), &OggPacketSequence::set_packet_granule_positions);
 	ClassDB::bind_method(D_METHOD("get_packet_granule_positions"), &OggPacketSequence::get_packet_granule_positions);
 
+	ClassDB::bind_method(D_METHOD("set_stream_path", "path"), &OggPacketSequence::set_stream_path);
+	ClassDB::bind_method(D_METHOD("get_stream_path"), &OggPacketSequence::get_stream_path);
+
+	ClassDB::bind_method(D_METHOD("set_page_file_offsets", "offsets"), &OggPacketSequence::set_page_file_offsets);
+	ClassDB::bind_method(D_METHOD("get_page_file_offsets"), &OggPacketSequence::get_page_file_offsets);
+
 	ClassDB::bind_method(D_METHOD("set_sampling_rate", "sampling_rate"), &OggPacketSequence::set_sampling_rate);
 	ClassDB::bind_method(D_METHOD("get_sampling_rate"), &OggPacketSequence::get_sampling_rate);
 
@@ -130,11 +179,108 @@ void OggPacketSequence::_bind_methods() {
 
 	ADD_PROPERTY(PropertyInfo(Variant::ARRAY, "packet_data", PROPERTY_HINT_ARRAY_TYPE, "PackedByteArray", PROPERTY_USAGE_NO_EDITOR), "set_packet_data", "get_packet_data");
 	ADD_PROPERTY(PropertyInfo(Variant::PACKED_INT64_ARRAY, "granule_positions", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NO_EDITOR), "set_packet_granule_positions", "get_packet_granule_positions");
+	ADD_PROPERTY(PropertyInfo(Variant::STRING, "stream_path", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NO_EDITOR), "set_stream_path", "get_stream_path");
+	ADD_PROPERTY(PropertyInfo(Variant::PACKED_INT64_ARRAY, "page_file_offsets", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NO_EDITOR), "set_page_file_offsets", "get_page_file_offsets");
 	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "sampling_rate", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NO_EDITOR), "set_sampling_rate", "get_sampling_rate");
 }
 
+bool OggPacketSequencePlayback::_stream_read_page(bool p_new_serial) const {
+	ogg_page page;
+	while (true) {
+		int ret = ogg_sync_pageout(&sync_state, &page);
+		if (ret == 1) {
+			if (p_new_serial) {
+				// Pages are only ever read from a known offset first, so this one belongs to our logical stream.
+				ogg_stream_reset_serialno(&stream_state, ogg_page_serialno(&page));
+			} else if (ogg_page_serialno(&page) != stream_state.serialno) {
+				continue;
+			}
+			return ogg_stream_pagein(&stream_state, &page) == 0;
+		}
+		if (ret == 0) {
+			// Need more data.
+			char *sync_buf = ogg_sync_buffer(&sync_state, STREAM_READ_SIZE);
+			uint64_t read = stream_file->get_buffer((uint8_t *)sync_buf, STREAM_READ_SIZE);
+			if (read == 0) {
+				return false;
+			}
+			ogg_sync_wrote(&sync_state, read);
+		}
+		// A negative result means bytes were skipped while resynchronizing, just keep going.
+	}
+}
+
+bool OggPacketSequencePlayback::_stream_load_page(int64_t p_page) const {
+	if (!stream_initialized) {
+		stream_file = FileAccess::open(ogg_packet_sequence->stream_path, FileAccess::READ);
+		ERR_FAIL_COND_V_MSG(stream_file.is_null(), false, "Cannot open streamed Ogg file '" + ogg_packet_sequence->stream_path + "'.");
+		ogg_sync_init(&sync_state);
+		ogg_stream_init(&stream_state, 0);
+		stream_initialized = true;
+	}
+
+	if (stream_page >= 0 && p_page == stream_page + 1) {
+		// Sequential reads continue from whatever is already buffered.
+		if (!_stream_read_page(false)) {
+			return false;
+		}
+		stream_page = p_page;
+		return true;
+	}
+
+	// Start one page early, so a packet continued from the previous page is complete; its own packets are dropped.
+	int64_t first_page = MAX(p_page - 1, 0);
+	ogg_sync_reset(&sync_state);
+	stream_file->seek(ogg_packet_sequence->page_file_offsets[first_page]);
+	stream_page = -1;
+
+	if (!_stream_read_page(true)) {
+		return false;
+	}
+	if (first_page < p_page) {
+		ogg_packet discarded;
+		while (ogg_stream_packetout(&stream_state, &discarded) != 0) {
+		}
+		if (!_stream_read_page(false)) {
+			return false;
+		}
+	}
+	stream_page = p_page;
+	return true;
+}
+
+bool OggPacketSequencePlayback::_stream_next_packet(ogg_packet **p_packet) const {
+	if (stream_page != page_cursor && !_stream_load_page(page_cursor)) {
+		return false;
+	}
+
+	while (true) {
+		int ret = ogg_stream_packetout(&stream_state, packet);
+		if (ret == 1) {
+			packet->packetno = packetno++;
+			*p_packet = packet;
+			return true;
+		}
+		if (ret == 0) {
+			// Every packet ending on this page was handed out, move on to the next one.
+			if (page_cursor + 1 >= ogg_packet_sequence->_get_page_count()) {
+				return false;
+			}
+			page_cursor++;
+			if (!_stream_load_page(page_cursor)) {
+				return false;
+			}
+		}
+		// A negative result marks a gap in the data; skip it.
+	}
+}
+
 bool OggPacketSequencePlayback::next_ogg_packet(ogg_packet **p_packet) const {
 	ERR_FAIL_COND_V(data_version != ogg_packet_sequence->data_version, false);
+	if (ogg_packet_sequence->is_streamed()) {
+		ERR_FAIL_COND_V(ogg_packet_sequence->page_file_offsets.is_empty(), false);
+		return _stream_next_packet(p_packet);
+	}
 	ERR_FAIL_COND_V(ogg_packet_sequence->page_data.is_empty(), false);
 	ERR_FAIL_COND_V(ogg_packet_sequence->page_granule_positions.is_empty(), false);
 	ERR_FAIL_COND_V(page_cursor >= ogg_packet_sequence->page_data.size(), false);
@@ -177,7 +323,7 @@ uint32_t OggPacketSequencePlayback::seek_page_internal(int64_t granule, uint32_t
 	uint32_t bisection_page = -1;
 	// Don't include before_page_inclusive because that always succeeds and will cause infinite recursion later.
 	for (uint32_t test_page = actual_middle_page; test_page < before_page_inclusive; test_page++) {
-		if (ogg_packet_sequence->page_data[test_page].size() > 0) {
+		if (ogg_packet_sequence->_page_has_packets(test_page)) {
 			bisection_page = test_page;
 			break;
 		}
@@ -185,7 +331,7 @@ uint32_t OggPacketSequencePlayback::seek_page_internal(int64_t granule, uint32_t
 	// Check if we have to go backwards.
 	if (bisection_page == (unsigned int)-1) {
 		for (uint32_t test_page = actual_middle_page; test_page >= after_page_inclusive; test_page--) {
-			if (ogg_packet_sequence->page_data[test_page].size() > 0) {
+			if (ogg_packet_sequence->_page_has_packets(test_page)) {
 				bisection_page = test_page;
 				break;
 			}
@@ -204,13 +350,14 @@ uint32_t OggPacketSequencePlayback::seek_page_internal(int64_t granule, uint32_t
 }
 
 bool OggPacketSequencePlayback::seek_page(int64_t p_granule_pos) {
-	int correct_page = seek_page_internal(p_granule_pos, 0, ogg_packet_sequence->page_data.size() - 1);
+	int correct_page = seek_page_internal(p_granule_pos, 0, ogg_packet_sequence->_get_page_count() - 1);
 	if (correct_page == -1) {
 		return false;
 	}
 
 	packet_cursor = 0;
 	page_cursor = correct_page;
+	stream_page = -1;
 
 	// Don't pretend subsequent packets are contiguous with previous ones.
 	packetno = 0;
@@ -223,9 +370,10 @@ int64_t OggPacketSequencePlayback::get_page_number() const {
 }
 
 bool OggPacketSequencePlayback::set_page_number(int64_t p_page_number) {
-	if (p_page_number >= 0 && p_page_number < ogg_packet_sequence->page_data.size()) {
+	if (p_page_number >= 0 && p_page_number < ogg_packet_sequence->_get_page_count()) {
 		page_cursor = p_page_number;
 		packet_cursor = 0;
+		stream_page = -1;
 		packetno = 0;
 		return true;
 	}
@@ -237,5 +385,9 @@ OggPacketSequencePlayback::OggPacketSequencePlayback() {
 }
 
 OggPacketSequencePlayback::~OggPacketSequencePlayback() {
+	if (stream_initialized) {
+		ogg_stream_clear(&stream_state);
+		ogg_sync_clear(&sync_state);
+	}
 	delete packet;
 }
@@ -31,6 +31,7 @@
 #ifndef OGG_PACKET_SEQUENCE_H
 #define OGG_PACKET_SEQUENCE_H
 
+#include "core/io/file_access.h"
 #include "core/io/resource.h"
 #include "core/variant/typed_array.h"
 #include "core/variant/variant.h"
@@ -50,6 +51,11 @@ class OggPacketSequence : public Resource {
 	// List of the granule position for each page.
 	Vector<uint64_t> page_granule_positions;
 
+	// When streamed, packets are read from this file on demand instead of being kept in page_data.
+	String stream_path;
+	// Byte offset of each page in the streamed file.
+	Vector<uint64_t> page_file_offsets;
+
 	// The page after the current last page. Similar semantics to an end() iterator.
 	int64_t end_page = 0;
 
@@ -58,6 +64,9 @@ class OggPacketSequence : public Resource {
 	float sampling_rate = 0;
 	float length = 0;
 
+	int64_t _get_page_count() const;
+	bool _page_has_packets(int64_t p_page) const;
+
 protected:
 	static void _bind_methods();
 
@@ -66,12 +75,22 @@ public:
 	// This should be called for each page, even for pages that no packets ended on.
 	void push_page(int64_t p_granule_pos, const Vector<PackedByteArray> &p_data);
 
+	// Pushes the location of a page in the streamed file, instead of its packets.
+	void push_page_file_offset(int64_t p_granule_pos, uint64_t p_file_offset);
+
 	void set_packet_data(const TypedArray<Array> &p_data);
 	TypedArray<Array> get_packet_data() const;
 
 	void set_packet_granule_positions(const PackedInt64Array &p_granule_positions);
 	PackedInt64Array get_packet_granule_positions() const;
 
+	void set_stream_path(const String &p_path);
+	String get_stream_path() const;
+	bool is_streamed() const { return !stream_path.is_empty(); }
+
+	void set_page_file_offsets(const PackedInt64Array &p_offsets);
+	PackedInt64Array get_page_file_offsets() const;
+
 	// Sets a sampling rate associated with this object. OggPacketSequence doesn't understand codecs,
 	// so this value is naively stored as a convenience.
 	void set_sampling_rate(float p_sampling_rate);
@@ -107,6 +126,20 @@ class OggPacketSequencePlayback : public RefCounted {
 
 	mutable int64_t packetno = 0;
 
+	// Streamed sequences keep the page at page_cursor in stream_state and hand out its packets from there.
+	enum {
+		STREAM_READ_SIZE = 4096,
+	};
+	mutable Ref<FileAccess> stream_file;
+	mutable ogg_sync_state sync_state;
+	mutable ogg_stream_state stream_state;
+	mutable bool stream_initialized = false;
+	mutable int64_t stream_page = -1;
+
+	bool _stream_read_page(bool p_new_serial) const;
+	bool _stream_load_page(int64_t p_page) const;
+	bool _stream_next_packet(ogg_packet **p_packet) const;
+
 	// Recursive bisection search for the correct page.
 	uint32_t seek_page_internal(int64_t granule, uint32_t after_page_inclusive, uint32_t before_page_inclusive);
 
@@ -51,6 +51,9 @@ void RaycastOcclusionCull::RaycastHZBuffer::clear() {
 	camera_ray_masks.clear();
 	camera_rays_tile_count = 0;
 	tile_grid_size = Size2i();
+
+	history_depth.clear();
+	history_valid = false;
 }
 
 void RaycastOcclusionCull::RaycastHZBuffer::resize(const Size2i &p_size) {
@@ -78,6 +81,98 @@ void RaycastOcclusionCull::RaycastHZBuffer::resize(const Size2i &p_size) {
 
 	camera_ray_masks.resize(camera_rays_tile_count * TILE_RAYS);
 	memset(camera_ray_masks.ptr(), ~0, camera_rays_tile_count * TILE_RAYS * sizeof(uint32_t));
+
+	history_valid = false;
+}
+
+void RaycastOcclusionCull::RaycastHZBuffer::reproject_depth(const Transform3D &p_cam_transform, const Projection &p_cam_projection, bool p_cam_orthogonal, uint64_t p_scenario_version) {
+	ERR_FAIL_COND(is_empty());
+
+	bool can_reproject = history_valid && history_scenario_version == p_scenario_version && history_cam_orthogonal == p_cam_orthogonal && history_cam_projection == p_cam_projection;
+	if (!can_reproject) {
+		// Trace everything.
+		memset(camera_ray_masks.ptr(), ~0, camera_rays_tile_count * TILE_RAYS * sizeof(uint32_t));
+		return;
+	}
+
+	const Size2i &buffer_size = sizes[0];
+	float *depth = mips[0];
+
+	for (int i = 0; i < buffer_size.x * buffer_size.y; i++) {
+		depth[i] = FLT_MAX; // Marks pixels no reprojected sample landed on.
+	}
+
+	// Last frame's pixels are unprojected at the near plane, then pushed to their stored depth.
+	Projection inv_history_projection = history_cam_projection.inverse();
+	Vector3 view_corner = inv_history_projection.xform(Vector3(-1.0f, -1.0f, -1.0f));
+	Vector3 view_u_interp = inv_history_projection.xform(Vector3(1.0f, -1.0f, -1.0f)) - view_corner;
+	Vector3 view_v_interp = inv_history_projection.xform(Vector3(-1.0f, 1.0f, -1.0f)) - view_corner;
+
+	Transform3D history_to_view = p_cam_transform.affine_inverse() * history_cam_transform;
+	float z_near = p_cam_projection.get_z_near();
+
+	for (int y = 0; y < buffer_size.y; y++) {
+		for (int x = 0; x < buffer_size.x; x++) {
+			float d = history_depth[y * buffer_size.x + x];
+
+			float u = (float(x) + 0.5f) / buffer_size.x;
+			float v = (float(y) + 0.5f) / buffer_size.y;
+			Vector3 view = view_corner + u * view_u_interp + v * view_v_interp;
+			if (p_cam_orthogonal) {
+				view.z = -d;
+			} else {
+				view *= d / -view.z;
+			}
+
+			Vector3 current_view = history_to_view.xform(view);
+			if (current_view.z > -z_near) {
+				continue;
+			}
+
+			Plane projected = p_cam_projection.xform4(Plane(current_view, 1.0));
+			float w = projected.d;
+			int px = Math::floor((projected.normal.x / w * 0.5f + 0.5f) * buffer_size.x);
+			int py = Math::floor((projected.normal.y / w * 0.5f + 0.5f) * buffer_size.y);
+			if (px < 0 || px >= buffer_size.x || py < 0 || py >= buffer_size.y) {
+				continue;
+			}
+
+			float &dst = depth[py * buffer_size.x + px];
+			dst = MIN(dst, -current_view.z);
+		}
+	}
+
+	// Retrace a rotating subset of tiles, plus every tile with disoccluded pixels.
+	frame_index++;
+	for (uint32_t i = 0; i < camera_rays_tile_count; i++) {
+		bool retrace = (i + frame_index) % REPROJECTION_RETRACE_INTERVAL == 0;
+
+		int tile_x = (i % tile_grid_size.x) * TILE_SIZE;
+		int tile_y = (i / tile_grid_size.x) * TILE_SIZE;
+		for (int j = 0; j < TILE_RAYS && !retrace; j++) {
+			int x = tile_x + j % TILE_SIZE;
+			int y = tile_y + j / TILE_SIZE;
+			if (x < buffer_size.x && y < buffer_size.y && depth[y * buffer_size.x + x] == FLT_MAX) {
+				retrace = true;
+			}
+		}
+
+		memset(&camera_ray_masks[i * TILE_RAYS], retrace ? ~0 : 0, TILE_RAYS * sizeof(uint32_t));
+	}
+}
+
+void RaycastOcclusionCull::RaycastHZBuffer::store_depth_history(const Transform3D &p_cam_transform, const Projection &p_cam_projection, bool p_cam_orthogonal, uint64_t p_scenario_version) {
+	ERR_FAIL_COND(is_empty());
+
+	const Size2i &buffer_size = sizes[0];
+	history_depth.resize(buffer_size.x * buffer_size.y);
+	memcpy(history_depth.ptr(), mips[0], history_depth.size() * sizeof(float));
+
+	history_cam_transform = p_cam_transform;
+	history_cam_projection = p_cam_projection;
+	history_cam_orthogonal = p_cam_orthogonal;
+	history_scenario_version = p_scenario_version;
+	history_valid = true;
 }
 
 void RaycastOcclusionCull::RaycastHZBuffer::update_camera_rays(const Transform3D &p_cam_transform, const Projection &p_cam_projection, bool p_cam_orthogonal) {
@@ -124,6 +219,10 @@ void RaycastOcclusionCull::RaycastHZBuffer::_generate_camera_rays(const CameraRa
 	const Size2i &buffer_size = sizes[0];
 
 	for (int i = p_from; i < p_to; i++) {
+		if (camera_ray_masks[i * TILE_RAYS] == 0) {
+			continue; // Reprojected, won't be traced.
+		}
+
 		CameraRayTile &tile = camera_rays[i];
 		int tile_x = (i % tile_grid_size.x) * TILE_SIZE;
 		int tile_y = (i / tile_grid_size.x) * TILE_SIZE;
@@ -181,6 +280,9 @@ void RaycastOcclusionCull::RaycastHZBuffer::sort_rays(const Vector3 &p_camera_di
 					}
 					int k = tile_i * TILE_SIZE + tile_j;
 					int tile_index = i * tile_grid_size.x + j;
+					if (camera_ray_masks[tile_index * TILE_RAYS + k] == 0) {
+						continue; // Keep the reprojected depth.
+					}
 					float d = camera_rays[tile_index].ray.tfar[k];
 
 					if (!p_orthogonal) {
@@ -297,18 +399,23 @@ void RaycastOcclusionCull::scenario_set_instance(RID p_scenario, RID p_instance,
 
 	if (instance.xform != p_xform) {
 		scenario.instances[p_instance].xform = p_xform;
+		instance.moved = instance.committed;
 		changed = true;
 	}
 
 	if (instance.enabled != p_enabled) {
 		instance.enabled = p_enabled;
-		scenario.dirty = true; // The scenario needs a scene re-build, but the instance doesn't need update
+		// The scenario needs a scene re-build, but the instance doesn't need update
+		if (instance.dynamic) {
+			scenario.dynamic_dirty = true;
+		} else {
+			scenario.static_dirty = true;
+		}
 	}
 
 	if (changed && !scenario.dirty_instances.has(p_instance)) {
 		scenario.dirty_instances.insert(p_instance);
 		scenario.dirty_instances_array.push_back(p_instance);
-		scenario.dirty = true;
 	}
 }
 
@@ -403,6 +510,11 @@ void RaycastOcclusionCull::Scenario::free() {
 			ebr_scene[i] = nullptr;
 		}
 	}
+
+	if (ebr_dynamic_scene) {
+		rtcReleaseScene(ebr_dynamic_scene);
+		ebr_dynamic_scene = nullptr;
+	}
 }
 
 void RaycastOcclusionCull::Scenario::_commit_scene(void *p_ud) {
@@ -423,17 +535,66 @@ void RaycastOcclusionCull::Scenario::update() {
 		if (commit_done) {
 			commit_thread->wait_to_finish();
 			current_scene_idx = 1 - current_scene_idx;
+			version++;
 		} else {
+			// The static scene is still being committed, but moving occluders can't wait for it.
+			_update_moving_instances();
 			return;
 		}
 	}
 
-	if (!dirty && removed_instances.is_empty() && dirty_instances_array.is_empty()) {
+	update_count++;
+
+	// Occluders which stopped moving are merged back into the static scene.
+	LocalVector<RID> static_again;
+	for (const RID &rid : dynamic_instances) {
+		const OccluderInstance *occ_inst = instances.getptr(rid);
+		if (occ_inst && update_count - occ_inst->last_moved_update > DYNAMIC_OCCLUDER_UPDATES) {
+			static_again.push_back(rid);
+		}
+	}
+	for (const RID &rid : static_again) {
+		instances[rid].dynamic = false;
+		dynamic_instances.erase(rid);
+		static_dirty = true;
+		dynamic_dirty = true;
+	}
+
+	if (!static_dirty && !dynamic_dirty && removed_instances.is_empty() && dirty_instances_array.is_empty()) {
 		return;
 	}
 
-	for (const RID &scenario : removed_instances) {
-		instances.erase(scenario);
+	for (const RID &rid : removed_instances) {
+		const OccluderInstance *occ_inst = instances.getptr(rid);
+		if (occ_inst && occ_inst->dynamic) {
+			dynamic_instances.erase(rid);
+			dynamic_dirty = true;
+		} else {
+			static_dirty = true;
+		}
+		instances.erase(rid);
+	}
+
+	for (const RID &rid : dirty_instances_array) {
+		OccluderInstance *occ_inst = instances.getptr(rid);
+		if (!occ_inst) {
+			continue;
+		}
+		if (occ_inst->moved) {
+			occ_inst->moved = false;
+			occ_inst->last_moved_update = update_count;
+			if (!occ_inst->dynamic) {
+				// Started moving, take it out of the static scene.
+				occ_inst->dynamic = true;
+				dynamic_instances.insert(rid);
+				static_dirty = true;
+			}
+		}
+		if (occ_inst->dynamic) {
+			dynamic_dirty = true;
+		} else {
+			static_dirty = true;
+		}
 	}
 
 	if (dirty_instances_array.size() / WorkerThreadPool::get_singleton()->get_thread_count() > 128) {
@@ -456,21 +617,85 @@ void RaycastOcclusionCull::Scenario::update() {
 		raycast_singleton->_init_embree();
 	}
 
-	int next_scene_idx = 1 - current_scene_idx;
-	RTCScene &next_scene = ebr_scene[next_scene_idx];
+	if (dynamic_dirty) {
+		_update_dynamic_scene();
+	}
+
+	if (static_dirty) {
+		int next_scene_idx = 1 - current_scene_idx;
+		RTCScene &next_scene = ebr_scene[next_scene_idx];
+
+		if (next_scene) {
+			rtcReleaseScene(next_scene);
+		}
+
+		next_scene = _create_scene(false);
 
-	if (next_scene) {
-		rtcReleaseScene(next_scene);
+		static_dirty = false;
+		commit_done = false;
+		commit_thread->start(&Scenario::_commit_scene, this);
 	}
+}
 
-	next_scene = rtcNewScene(raycast_singleton->ebr_device);
-	rtcSetSceneBuildQuality(next_scene, RTCBuildQuality(raycast_singleton->build_quality));
+void RaycastOcclusionCull::Scenario::_update_dynamic_scene() {
+	// Few occluders, so it's cheaper to rebuild and commit right away than to wait for a thread.
+	if (ebr_dynamic_scene) {
+		rtcReleaseScene(ebr_dynamic_scene);
+		ebr_dynamic_scene = nullptr;
+	}
+	if (!dynamic_instances.is_empty()) {
+		ebr_dynamic_scene = _create_scene(true);
+		rtcCommitScene(ebr_dynamic_scene);
+	}
+	dynamic_dirty = false;
+	version++;
+}
+
+void RaycastOcclusionCull::Scenario::_update_moving_instances() {
+	// Called while the static scene is committed in a thread. Only dynamic occluders which keep their
+	// vertex count are updated: the others, and all removals, may reallocate buffers a static scene
+	// still uses, so they wait for the next full update.
+	LocalVector<RID> moving;
+	for (uint32_t i = 0; i < dirty_instances_array.size();) {
+		const RID rid = dirty_instances_array[i];
+		OccluderInstance *occ_inst = instances.getptr(rid);
+		const Occluder *occ = occ_inst ? raycast_singleton->occluder_owner.get_or_null(occ_inst->occluder) : nullptr;
+		if (occ && occ_inst->dynamic && !occ_inst->removed && occ_inst->xformed_vertices.size() == uint32_t(occ->vertices.size() + 1) && occ_inst->indices.size() == uint32_t(occ->indices.size())) {
+			if (occ_inst->moved) {
+				occ_inst->moved = false;
+				occ_inst->last_moved_update = update_count;
+			}
+			moving.push_back(rid);
+			dirty_instances.erase(rid);
+			dirty_instances_array.remove_at_unordered(i);
+		} else {
+			i++;
+		}
+	}
+
+	for (uint32_t i = 0; i < moving.size(); i++) {
+		_update_dirty_instance(i, moving.ptr());
+	}
 
-	for (const KeyValue<RID, OccluderInstance> &E : instances) {
-		const OccluderInstance *occ_inst = &E.value;
+	if (!moving.is_empty() || dynamic_dirty) {
+		_update_dynamic_scene();
+	}
+}
+
+RTCScene RaycastOcclusionCull::Scenario::_create_scene(bool p_dynamic) {
+	RTCScene scene = rtcNewScene(raycast_singleton->ebr_device);
+	if (p_dynamic) {
+		rtcSetSceneFlags(scene, RTC_SCENE_FLAG_DYNAMIC);
+		rtcSetSceneBuildQuality(scene, RTC_BUILD_QUALITY_LOW);
+	} else {
+		rtcSetSceneBuildQuality(scene, RTCBuildQuality(raycast_singleton->build_quality));
+	}
+
+	for (KeyValue<RID, OccluderInstance> &E : instances) {
+		OccluderInstance *occ_inst = &E.value;
 		const Occluder *occ = raycast_singleton->occluder_owner.get_or_null(occ_inst->occluder);
 
-		if (!occ || !occ_inst->enabled) {
+		if (!occ || !occ_inst->enabled || occ_inst->removed || occ_inst->dynamic != p_dynamic) {
 			continue;
 		}
 
@@ -478,13 +703,12 @@ void RaycastOcclusionCull::Scenario::update() {
 		rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_VERTEX, 0, RTC_FORMAT_FLOAT3, occ_inst->xformed_vertices.ptr(), 0, sizeof(Vector3), occ_inst->xformed_vertices.size());
 		rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_INDEX, 0, RTC_FORMAT_UINT3, occ_inst->indices.ptr(), 0, sizeof(uint32_t) * 3, occ_inst->indices.size() / 3);
 		rtcCommitGeometry(geom);
-		rtcAttachGeometry(next_scene, geom);
+		rtcAttachGeometry(scene, geom);
 		rtcReleaseGeometry(geom);
+		occ_inst->committed = true;
 	}
 
-	dirty = false;
-	commit_done = false;
-	commit_thread->start(&Scenario::_commit_scene, this);
+	return scene;
 }
 
 void RaycastOcclusionCull::Scenario::_raycast(uint32_t p_idx, const RaycastThreadData *p_raycast_data) const {
@@ -492,7 +716,13 @@ void RaycastOcclusionCull::Scenario::_raycast(uint32_t p_idx, const RaycastThrea
 	rtcInitIntersectContext(&ctx);
 	ctx.flags = RTC_INTERSECT_CONTEXT_FLAG_COHERENT;
 
-	rtcIntersect16((const int *)&p_raycast_data->masks[p_idx * TILE_RAYS], ebr_scene[current_scene_idx], &ctx, &p_raycast_data->rays[p_idx]);
+	// Hits against the static scene shorten the rays, so the dynamic scene only reports closer hits.
+	if (ebr_scene[current_scene_idx]) {
+		rtcIntersect16((const int *)&p_raycast_data->masks[p_idx * TILE_RAYS], ebr_scene[current_scene_idx], &ctx, &p_raycast_data->rays[p_idx]);
+	}
+	if (ebr_dynamic_scene) {
+		rtcIntersect16((const int *)&p_raycast_data->masks[p_idx * TILE_RAYS], ebr_dynamic_scene, &ctx, &p_raycast_data->rays[p_idx]);
+	}
 }
 
 void RaycastOcclusionCull::Scenario::raycast(CameraRayTile *r_rays, const uint32_t *p_valid_masks, uint32_t p_tile_count) const {
@@ -501,7 +731,7 @@ void RaycastOcclusionCull::Scenario::raycast(CameraRayTile *r_rays, const uint32
 		return; // Embree is initialized on demand when there is some scenario with occluders in it.
 	}
 
-	if (ebr_scene[current_scene_idx] == nullptr) {
+	if (ebr_scene[current_scene_idx] == nullptr && ebr_dynamic_scene == nullptr) {
 		return;
 	}
 
@@ -548,13 +778,26 @@ void RaycastOcclusionCull::buffer_update(RID p_buffer, const Transform3D &p_cam_
 	}
 
 	Scenario &scenario = scenarios[buffer.scenario_rid];
+	uint64_t start_usec = OS::get_singleton()->get_ticks_usec();
 	scenario.update();
+	uint64_t update_usec = OS::get_singleton()->get_ticks_usec();
+
+	if (temporal_reprojection) {
+		buffer.reproject_depth(p_cam_transform, p_cam_projection, p_cam_orthogonal, scenario.version);
+	}
 
 	buffer.update_camera_rays(p_cam_transform, p_cam_projection, p_cam_orthogonal);
 
 	scenario.raycast(buffer.camera_rays, buffer.camera_ray_masks.ptr(), buffer.camera_rays_tile_count);
 	buffer.sort_rays(-p_cam_transform.basis.get_column(2), p_cam_orthogonal);
 	buffer.update_mips();
+
+	if (temporal_reprojection) {
+		buffer.store_depth_history(p_cam_transform, p_cam_projection, p_cam_orthogonal, scenario.version);
+	}
+
+	update_time_usec.set(update_usec - start_usec);
+	raycast_time_usec.set(OS::get_singleton()->get_ticks_usec() - update_usec);
 }
 
 RaycastOcclusionCull::HZBuffer *RaycastOcclusionCull::buffer_get_ptr(RID p_buffer) {
@@ -579,7 +822,8 @@ void RaycastOcclusionCull::set_build_quality(RS::ViewportOcclusionCullingBuildQu
 	build_quality = p_quality;
 
 	for (KeyValue<RID, Scenario> &K : scenarios) {
-		K.value.dirty = true;
+		K.value.static_dirty = true;
+		K.value.dynamic_dirty = true;
 	}
 }
 
@@ -597,6 +841,7 @@ RaycastOcclusionCull::RaycastOcclusionCull() {
 	raycast_singleton = this;
 	int default_quality = GLOBAL_GET("rendering/occlusion_culling/bvh_build_quality");
 	build_quality = RS::ViewportOcclusionCullingBuildQuality(default_quality);
+	temporal_reprojection = GLOBAL_GET("rendering/occlusion_culling/temporal_reprojection");
 }
 
 RaycastOcclusionCull::~RaycastOcclusionCull() {
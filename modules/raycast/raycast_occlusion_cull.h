@@ -50,6 +50,15 @@ public:
 	private:
 		Size2i tile_grid_size;
 
+		// Last frame's depth, used to reproject instead of tracing every ray.
+		LocalVector<float> history_depth;
+		Transform3D history_cam_transform;
+		Projection history_cam_projection;
+		bool history_cam_orthogonal = false;
+		bool history_valid = false;
+		uint64_t history_scenario_version = 0;
+		uint32_t frame_index = 0;
+
 		struct CameraRayThreadData {
 			int thread_count;
 			float z_near;
@@ -75,6 +84,8 @@ public:
 
 		virtual void clear() override;
 		virtual void resize(const Size2i &p_size) override;
+		void reproject_depth(const Transform3D &p_cam_transform, const Projection &p_cam_projection, bool p_cam_orthogonal, uint64_t p_scenario_version);
+		void store_depth_history(const Transform3D &p_cam_transform, const Projection &p_cam_projection, bool p_cam_orthogonal, uint64_t p_scenario_version);
 		void sort_rays(const Vector3 &p_camera_dir, bool p_orthogonal);
 		void update_camera_rays(const Transform3D &p_cam_transform, const Projection &p_cam_projection, bool p_cam_orthogonal);
 
@@ -113,6 +124,10 @@ private:
 		Transform3D xform;
 		bool enabled = true;
 		bool removed = false;
+		bool committed = false; // Was part of a built scene, so transform changes mean it's moving.
+		bool moved = false;
+		bool dynamic = false;
+		uint64_t last_moved_update = 0;
 	};
 
 	struct Scenario {
@@ -131,11 +146,20 @@ private:
 
 		Thread *commit_thread = nullptr;
 		bool commit_done = true;
-		bool dirty = false;
+		bool static_dirty = false;
+		bool dynamic_dirty = false;
 
+		// Static occluders, double buffered so the next scene can be committed in a thread.
 		RTCScene ebr_scene[2] = { nullptr, nullptr };
 		int current_scene_idx = 0;
 
+		// Occluders which moved recently (doors, platforms...) are kept in a separate small scene,
+		// which can be rebuilt every update without touching the static one.
+		RTCScene ebr_dynamic_scene = nullptr;
+		HashSet<RID> dynamic_instances;
+		uint64_t update_count = 0;
+		uint64_t version = 0; // Bumped whenever the traced geometry changes.
+
 		HashMap<RID, OccluderInstance> instances;
 		HashSet<RID> dirty_instances; // To avoid duplicates
 		LocalVector<RID> dirty_instances_array; // To iterate and split into threads
@@ -146,6 +170,9 @@ private:
 		void _transform_vertices_thread(uint32_t p_thread, TransformThreadData *p_data);
 		void _transform_vertices_range(const Vector3 *p_read, Vector3 *p_write, const Transform3D &p_xform, int p_from, int p_to);
 		static void _commit_scene(void *p_ud);
+		RTCScene _create_scene(bool p_dynamic);
+		void _update_dynamic_scene();
+		void _update_moving_instances();
 		void free();
 		void update();
 
@@ -157,12 +184,15 @@ private:
 
 	static const int TILE_SIZE = 4;
 	static const int TILE_RAYS = TILE_SIZE * TILE_SIZE;
+	static const int REPROJECTION_RETRACE_INTERVAL = 4; // With temporal reprojection, each tile is retraced at least once every this many frames.
+	static const int DYNAMIC_OCCLUDER_UPDATES = 120; // Updates without moving before a dynamic occluder becomes static again.
 
 	RTCDevice ebr_device = nullptr;
 	RID_PtrOwner<Occluder> occluder_owner;
 	HashMap<RID, Scenario> scenarios;
 	HashMap<RID, RaycastHZBuffer> buffers;
 	RS::ViewportOcclusionCullingBuildQuality build_quality;
+	bool temporal_reprojection = false;
 
 	void _init_embree();
 
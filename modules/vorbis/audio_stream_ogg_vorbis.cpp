@@ -36,7 +36,41 @@
 #include "modules/vorbis/resource_importer_ogg_vorbis.h"
 #include <ogg/ogg.h>
 
+bool AudioStreamPlaybackOggVorbis::can_mix_in_parallel() const {
+	return true; // Only touches its own decoder state.
+}
+
+int AudioStreamPlaybackOggVorbis::_decode_ring_callback(void *p_userdata, AudioFrame *p_buffer, int p_frames) {
+	return ((AudioStreamPlaybackOggVorbis *)p_userdata)->_decode_internal(p_buffer, p_frames);
+}
+
 int AudioStreamPlaybackOggVorbis::_mix_internal(AudioFrame *p_buffer, int p_frames) {
+	if (!decode_ring.is_initialized()) {
+		return _decode_internal(p_buffer, p_frames);
+	}
+
+	if (!streaming_active.is_set()) {
+		return 0;
+	}
+
+	int mixed = decode_ring.read(p_buffer, p_frames);
+	decode_ring.request_decode();
+	if (mixed == p_frames) {
+		return mixed;
+	}
+
+	for (int i = mixed; i < p_frames; i++) {
+		p_buffer[i] = AudioFrame(0, 0);
+	}
+	if (decode_ring.is_finished()) {
+		streaming_active.clear();
+		return mixed;
+	}
+	// The decoder fell behind. Output silence rather than waiting for it.
+	return p_frames;
+}
+
+int AudioStreamPlaybackOggVorbis::_decode_internal(AudioFrame *p_buffer, int p_frames) {
 	ERR_FAIL_COND_V(!ready, 0);
 
 	if (!active) {
@@ -115,7 +149,7 @@ int AudioStreamPlaybackOggVorbis::_mix_internal(AudioFrame *p_buffer, int p_fram
 					loop_fade_remaining = 0;
 				}
 
-				seek(vorbis_stream->loop_offset);
+				_seek(vorbis_stream->loop_offset);
 				loops++;
 				// We still have buffer to fill, start from this element in the next iteration.
 				continue;
@@ -128,7 +162,7 @@ int AudioStreamPlaybackOggVorbis::_mix_internal(AudioFrame *p_buffer, int p_fram
 			if (vorbis_stream->loop && is_not_empty) {
 				//loop
 
-				seek(vorbis_stream->loop_offset);
+				_seek(vorbis_stream->loop_offset);
 				loops++;
 				// We still have buffer to fill, start from this element in the next iteration.
 
@@ -230,18 +264,30 @@ bool AudioStreamPlaybackOggVorbis::_alloc_vorbis() {
 
 void AudioStreamPlaybackOggVorbis::start(double p_from_pos) {
 	ERR_FAIL_COND(!ready);
-	loop_fade_remaining = FADE_SIZE;
-	active = true;
-	seek(p_from_pos);
-	loops = 0;
+	{
+		MutexLock lock(decode_ring.get_decode_mutex());
+		loop_fade_remaining = FADE_SIZE;
+		active = true;
+		_seek(p_from_pos);
+		loops = 0;
+		if (decode_ring.is_initialized()) {
+			decode_ring.reset();
+			streaming_active.set();
+		}
+	}
 	begin_resample();
 }
 
 void AudioStreamPlaybackOggVorbis::stop() {
+	MutexLock lock(decode_ring.get_decode_mutex());
 	active = false;
+	streaming_active.clear();
 }
 
 bool AudioStreamPlaybackOggVorbis::is_playing() const {
+	if (decode_ring.is_initialized()) {
+		return streaming_active.is_set();
+	}
 	return active;
 }
 
@@ -250,7 +296,12 @@ int AudioStreamPlaybackOggVorbis::get_loop_count() const {
 }
 
 double AudioStreamPlaybackOggVorbis::get_playback_position() const {
-	return double(frames_mixed) / (double)vorbis_data->get_sampling_rate();
+	uint32_t position = frames_mixed;
+	if (decode_ring.is_initialized()) {
+		// Frames still waiting in the ring have been decoded but not heard yet.
+		position -= MIN(position, decode_ring.get_buffered_frames());
+	}
+	return double(position) / (double)vorbis_data->get_sampling_rate();
 }
 
 void AudioStreamPlaybackOggVorbis::tag_used_streams() {
@@ -258,6 +309,14 @@ void AudioStreamPlaybackOggVorbis::tag_used_streams() {
 }
 
 void AudioStreamPlaybackOggVorbis::seek(double p_time) {
+	MutexLock lock(decode_ring.get_decode_mutex());
+	_seek(p_time);
+	if (decode_ring.is_initialized()) {
+		decode_ring.reset();
+	}
+}
+
+void AudioStreamPlaybackOggVorbis::_seek(double p_time) {
 	ERR_FAIL_COND(!ready);
 	ERR_FAIL_COND(vorbis_stream.is_null());
 	if (!active) {
@@ -357,6 +416,7 @@ void AudioStreamPlaybackOggVorbis::seek(double p_time) {
 }
 
 AudioStreamPlaybackOggVorbis::~AudioStreamPlaybackOggVorbis() {
+	decode_ring.finish();
 	if (block_is_allocated) {
 		vorbis_block_clear(&block);
 	}
@@ -382,6 +442,9 @@ Ref<AudioStreamPlayback> AudioStreamOggVorbis::instantiate_playback() {
 	ovs->frames_mixed = 0;
 	ovs->active = false;
 	ovs->loops = 0;
+	if (packet_sequence->is_streamed()) {
+		ovs->decode_ring.init(&AudioStreamPlaybackOggVorbis::_decode_ring_callback, ovs.ptr(), AudioStreamPlaybackOggVorbis::DECODE_RING_FRAMES, AudioStreamPlaybackOggVorbis::DECODE_CHUNK_FRAMES);
+	}
 	if (ovs->_alloc_vorbis()) {
 		return ovs;
 	}
@@ -33,6 +33,7 @@
 
 #include "core/variant/variant.h"
 #include "modules/ogg/ogg_packet_sequence.h"
+#include "servers/audio/audio_decode_ring.h"
 #include "servers/audio/audio_stream.h"
 
 #include <vorbis/codec.h>
@@ -73,6 +74,19 @@ class AudioStreamPlaybackOggVorbis : public AudioStreamPlaybackResampled {
 	Ref<OggPacketSequencePlayback> vorbis_data_playback;
 	Ref<AudioStreamOggVorbis> vorbis_stream;
 
+	// Sequences streamed from disk are decoded ahead on a worker thread, so the mix thread never waits on file access.
+	enum {
+		DECODE_RING_FRAMES = 32768,
+		DECODE_CHUNK_FRAMES = 4096,
+	};
+	AudioDecodeRing decode_ring;
+	SafeFlag streaming_active; // Shared by the main and mix threads.
+
+	static int _decode_ring_callback(void *p_userdata, AudioFrame *p_buffer, int p_frames);
+
+	int _decode_internal(AudioFrame *p_buffer, int p_frames);
+	void _seek(double p_time);
+
 	int _mix_frames(AudioFrame *p_buffer, int p_frames);
 	int _mix_frames_vorbis(AudioFrame *p_buffer, int p_frames);
 
@@ -95,6 +109,8 @@ public:
 
 	virtual void tag_used_streams() override;
 
+	virtual bool can_mix_in_parallel() const override;
+
 	AudioStreamPlaybackOggVorbis() {}
 	~AudioStreamPlaybackOggVorbis();
 };
@@ -30,6 +30,7 @@
 
 #include "resource_importer_ogg_vorbis.h"
 
+#include "core/io/dir_access.h"
 #include "core/io/file_access.h"
 #include "core/io/resource_saver.h"
 #include "scene/resources/texture.h"
@@ -79,6 +80,7 @@ void ResourceImporterOggVorbis::get_import_options(const String &p_path, List<Im
 	r_options->push_back(ImportOption(PropertyInfo(Variant::FLOAT, "bpm", PROPERTY_HINT_RANGE, "0,400,0.01,or_greater"), 0));
 	r_options->push_back(ImportOption(PropertyInfo(Variant::INT, "beat_count", PROPERTY_HINT_RANGE, "0,512,or_greater"), 0));
 	r_options->push_back(ImportOption(PropertyInfo(Variant::INT, "bar_beats", PROPERTY_HINT_RANGE, "2,32,or_greater"), 4));
+	r_options->push_back(ImportOption(PropertyInfo(Variant::BOOL, "stream_from_disk"), false));
 }
 
 #ifdef TOOLS_ENABLED
@@ -101,8 +103,21 @@ Error ResourceImporterOggVorbis::import(const String &p_source_file, const Strin
 	double bpm = p_options["bpm"];
 	int beat_count = p_options["beat_count"];
 	int bar_beats = p_options["bar_beats"];
+	bool stream_from_disk = p_options["stream_from_disk"];
 
-	Ref<AudioStreamOggVorbis> ogg_vorbis_stream = load_from_file(p_source_file);
+	Ref<AudioStreamOggVorbis> ogg_vorbis_stream;
+	if (stream_from_disk) {
+		// Keep the compressed data next to the imported resource, so it is exported with it and can be read while playing.
+		String stream_path = p_save_path + ".ogg";
+		Error err = DirAccess::copy_absolute(p_source_file, stream_path);
+		ERR_FAIL_COND_V_MSG(err != OK, err, "Cannot copy '" + p_source_file + "' for streaming.");
+		if (r_gen_files) {
+			r_gen_files->push_back(stream_path);
+		}
+		ogg_vorbis_stream = load_streamed_from_file(stream_path);
+	} else {
+		ogg_vorbis_stream = load_from_file(p_source_file);
+	}
 	if (ogg_vorbis_stream.is_null()) {
 		return ERR_CANT_OPEN;
 	}
@@ -247,3 +262,76 @@ Ref<AudioStreamOggVorbis> ResourceImporterOggVorbis::load_from_file(const String
 	ERR_FAIL_COND_V_MSG(file_data.is_empty(), Ref<AudioStreamOggVorbis>(), "Cannot open file '" + p_path + "'.");
 	return load_from_buffer(file_data);
 }
+
+Ref<AudioStreamOggVorbis> ResourceImporterOggVorbis::load_streamed_from_file(const String &p_path) {
+	Ref<FileAccess> f = FileAccess::open(p_path, FileAccess::READ);
+	ERR_FAIL_COND_V_MSG(f.is_null(), Ref<AudioStreamOggVorbis>(), "Cannot open file '" + p_path + "'.");
+
+	Ref<OggPacketSequence> ogg_packet_sequence;
+	ogg_packet_sequence.instantiate();
+
+	ogg_sync_state sync_state;
+	ogg_page page;
+	ogg_sync_init(&sync_state);
+
+	// Offset in the file of the next byte the sync state will look at.
+	uint64_t offset = 0;
+	bool found_stream = false;
+	int serial = 0;
+
+	while (true) {
+		long page_size = ogg_sync_pageseek(&sync_state, &page);
+		if (page_size == 0) {
+			char *sync_buf = ogg_sync_buffer(&sync_state, OGG_SYNC_BUFFER_SIZE);
+			uint64_t read = f->get_buffer((uint8_t *)sync_buf, OGG_SYNC_BUFFER_SIZE);
+			if (read == 0) {
+				break;
+			}
+			ogg_sync_wrote(&sync_state, read);
+			continue;
+		}
+		if (page_size < 0) {
+			// Skipped bytes that weren't part of a page.
+			offset += -page_size;
+			continue;
+		}
+
+		uint64_t page_offset = offset;
+		offset += page_size;
+
+		if (!found_stream) {
+			if (!ogg_page_bos(&page)) {
+				continue;
+			}
+			// Only index the first logical stream that starts with a Vorbis header.
+			ogg_stream_state stream_state;
+			ogg_packet packet;
+			ogg_stream_init(&stream_state, ogg_page_serialno(&page));
+			ogg_stream_pagein(&stream_state, &page);
+			found_stream = ogg_stream_packetout(&stream_state, &packet) == 1 && vorbis_synthesis_idheader(&packet);
+			ogg_stream_clear(&stream_state);
+			if (!found_stream) {
+				print_verbose("Found a non-vorbis-header packet in a header position");
+				continue;
+			}
+			serial = ogg_page_serialno(&page);
+		}
+
+		if (ogg_page_serialno(&page) == serial) {
+			ogg_packet_sequence->push_page_file_offset(ogg_page_granulepos(&page), page_offset);
+		}
+	}
+	ogg_sync_clear(&sync_state);
+
+	if (ogg_packet_sequence->get_packet_granule_positions().is_empty()) {
+		ERR_FAIL_V_MSG(Ref<AudioStreamOggVorbis>(), "Ogg Vorbis decoding failed. Check that your data is a valid Ogg Vorbis audio stream.");
+	}
+
+	ogg_packet_sequence->set_stream_path(p_path);
+
+	Ref<AudioStreamOggVorbis> ogg_vorbis_stream;
+	ogg_vorbis_stream.instantiate();
+	ogg_vorbis_stream->set_packet_sequence(ogg_packet_sequence);
+
+	return ogg_vorbis_stream;
+}
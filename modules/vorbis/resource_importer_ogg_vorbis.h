@@ -53,6 +53,8 @@ public:
 
 	static Ref<AudioStreamOggVorbis> load_from_file(const String &p_path);
 	static Ref<AudioStreamOggVorbis> load_from_buffer(const Vector<uint8_t> &file_data);
+	// Only indexes the pages of the file; packets are read from it while playing.
+	static Ref<AudioStreamOggVorbis> load_streamed_from_file(const String &p_path);
 	virtual void get_recognized_extensions(List<String> *p_extensions) const override;
 	virtual String get_save_extension() const override;
 	virtual String get_resource_type() const override;
@@ -221,6 +221,10 @@ void AudioStreamPlaybackWAV::do_resample(const Depth *p_src, AudioFrame *p_dst,
 	}
 }
 
+bool AudioStreamPlaybackWAV::can_mix_in_parallel() const {
+	return true;
+}
+
 int AudioStreamPlaybackWAV::mix(AudioFrame *p_buffer, float p_rate_scale, int p_frames) {
 	if (!base->data || !active) {
 		for (int i = 0; i < p_frames; i++) {
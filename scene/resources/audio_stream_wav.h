@@ -74,6 +74,7 @@ public:
 	virtual void seek(double p_time) override;
 
 	virtual int mix(AudioFrame *p_buffer, float p_rate_scale, int p_frames) override;
+	virtual bool can_mix_in_parallel() const override;
 
 	virtual void tag_used_streams() override;
 
@@ -0,0 +1,160 @@
+/**************************************************************************/
+/*  audio_decode_ring.cpp                                                 */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "audio_decode_ring.h"
+
+#include "core/error/error_macros.h"
+
+void AudioDecodeRing::_decode_task(void *p_userdata) {
+	AudioDecodeRing *ring = (AudioDecodeRing *)p_userdata;
+	// Decode a chunk at a time, so seeks and stops from the main thread only wait for one chunk.
+	while (true) {
+		MutexLock lock(ring->decode_mutex);
+		if (ring->ended.is_set() || ring->_get_free_frames() == 0) {
+			break;
+		}
+		ring->_fill(ring->chunk_frames);
+	}
+}
+
+uint32_t AudioDecodeRing::_get_free_frames() const {
+	uint32_t from = read_pos.get();
+	uint32_t flushed = flush_pos.get();
+	if (int32_t(flushed - from) > 0) {
+		// The reader has not caught up with the last flush yet, but everything before it is already discarded.
+		from = flushed;
+	}
+	return frames.size() - (write_pos.get() - from);
+}
+
+void AudioDecodeRing::_fill(uint32_t p_max_frames) {
+	uint32_t todo = MIN(p_max_frames, _get_free_frames());
+
+	while (todo > 0 && !ended.is_set()) {
+		uint32_t pos = write_pos.get();
+		uint32_t offset = pos & frames_mask;
+		// Decode straight into the ring, in runs that do not wrap around.
+		uint32_t to_decode = MIN(MIN(todo, chunk_frames), frames.size() - offset);
+
+		int decoded = decode_func(decode_userdata, &frames[offset], to_decode);
+		decoded = CLAMP(decoded, 0, (int)to_decode);
+
+		write_pos.set(pos + decoded);
+		if ((uint32_t)decoded < to_decode) {
+			ended.set();
+		}
+		todo -= decoded;
+	}
+}
+
+void AudioDecodeRing::init(DecodeFunc p_func, void *p_userdata, uint32_t p_capacity, uint32_t p_chunk_frames) {
+	ERR_FAIL_COND(!p_func);
+	ERR_FAIL_COND_MSG(p_capacity == 0 || (p_capacity & (p_capacity - 1)) != 0, "Decode ring capacity must be a power of two.");
+	ERR_FAIL_COND(p_chunk_frames == 0 || p_chunk_frames > p_capacity);
+
+	finish();
+
+	frames.resize(p_capacity);
+	frames_mask = p_capacity - 1;
+	chunk_frames = p_chunk_frames;
+	decode_func = p_func;
+	decode_userdata = p_userdata;
+
+	write_pos.set(0);
+	read_pos.set(0);
+	flush_pos.set(0);
+	flush_version_seen = flush_version.get();
+	ended.clear();
+}
+
+void AudioDecodeRing::reset() {
+	ERR_FAIL_COND(!is_initialized());
+
+	ended.clear();
+	flush_pos.set(write_pos.get());
+	flush_version.increment();
+
+	_fill(chunk_frames);
+}
+
+int AudioDecodeRing::read(AudioFrame *p_buffer, int p_frames) {
+	uint32_t version = flush_version.get();
+	if (version != flush_version_seen) {
+		flush_version_seen = version;
+		read_pos.set(flush_pos.get());
+	}
+
+	uint32_t pos = read_pos.get();
+	uint32_t to_read = MIN((uint32_t)p_frames, write_pos.get() - pos);
+
+	uint32_t offset = pos & frames_mask;
+	uint32_t first = MIN(to_read, frames.size() - offset);
+	memcpy(p_buffer, &frames[offset], first * sizeof(AudioFrame));
+	memcpy(p_buffer + first, frames.ptr(), (to_read - first) * sizeof(AudioFrame));
+
+	read_pos.set(pos + to_read);
+	return to_read;
+}
+
+void AudioDecodeRing::request_decode() {
+	if (decode_task != WorkerThreadPool::INVALID_TASK_ID) {
+		if (!WorkerThreadPool::get_singleton()->is_task_completed(decode_task)) {
+			return;
+		}
+		WorkerThreadPool::get_singleton()->wait_for_task_completion(decode_task);
+		decode_task = WorkerThreadPool::INVALID_TASK_ID;
+	}
+
+	if (ended.is_set() || _get_free_frames() < chunk_frames) {
+		return;
+	}
+
+	decode_task = WorkerThreadPool::get_singleton()->add_native_task(&AudioDecodeRing::_decode_task, this, false, "Decode audio stream ahead");
+}
+
+bool AudioDecodeRing::is_finished() const {
+	// Check the flag first: everything decoded before it was set is visible by then.
+	return ended.is_set() && write_pos.get() == read_pos.get();
+}
+
+uint32_t AudioDecodeRing::get_buffered_frames() const {
+	return frames.size() - _get_free_frames();
+}
+
+void AudioDecodeRing::finish() {
+	if (decode_task != WorkerThreadPool::INVALID_TASK_ID) {
+		WorkerThreadPool::get_singleton()->wait_for_task_completion(decode_task);
+		decode_task = WorkerThreadPool::INVALID_TASK_ID;
+	}
+}
+
+AudioDecodeRing::~AudioDecodeRing() {
+	finish();
+}
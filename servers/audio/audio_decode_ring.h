@@ -0,0 +1,98 @@
+/**************************************************************************/
+/*  audio_decode_ring.h                                                   */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef AUDIO_DECODE_RING_H
+#define AUDIO_DECODE_RING_H
+
+#include "core/math/audio_frame.h"
+#include "core/object/worker_thread_pool.h"
+#include "core/os/mutex.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/safe_refcount.h"
+
+// Decodes a playback ahead of the mixer on the WorkerThreadPool.
+// The mix thread is the only reader and the decode task the only writer, so frames are exchanged without locks;
+// the decode mutex only serializes the decoder itself against seeks coming from the main thread, and is released
+// between chunks.
+class AudioDecodeRing {
+public:
+	// Decodes up to p_frames into p_buffer and returns how many were written. Returning less than requested ends the stream.
+	typedef int (*DecodeFunc)(void *p_userdata, AudioFrame *p_buffer, int p_frames);
+
+private:
+	LocalVector<AudioFrame> frames;
+	uint32_t frames_mask = 0;
+	uint32_t chunk_frames = 0;
+
+	DecodeFunc decode_func = nullptr;
+	void *decode_userdata = nullptr;
+
+	Mutex decode_mutex;
+
+	SafeNumeric<uint32_t> write_pos;
+	SafeNumeric<uint32_t> read_pos;
+	SafeFlag ended;
+
+	// A flush moves the reader to flush_pos the next time it reads, discarding frames decoded before a seek.
+	SafeNumeric<uint32_t> flush_pos;
+	SafeNumeric<uint32_t> flush_version;
+	uint32_t flush_version_seen = 0;
+
+	WorkerThreadPool::TaskID decode_task = WorkerThreadPool::INVALID_TASK_ID;
+
+	static void _decode_task(void *p_userdata);
+	uint32_t _get_free_frames() const;
+	void _fill(uint32_t p_max_frames);
+
+public:
+	void init(DecodeFunc p_func, void *p_userdata, uint32_t p_capacity, uint32_t p_chunk_frames);
+	bool is_initialized() const { return decode_func != nullptr; }
+
+	// Must be held while touching the decoder from outside the decode callback.
+	Mutex &get_decode_mutex() { return decode_mutex; }
+
+	// Discards everything decoded so far and decodes the first chunk right away, so playback can begin without a gap.
+	// Call with the decode mutex held, after repositioning the decoder.
+	void reset();
+
+	// Mix thread only.
+	int read(AudioFrame *p_buffer, int p_frames);
+	void request_decode();
+	bool is_finished() const;
+
+	uint32_t get_buffered_frames() const;
+
+	// Waits for a pending decode task. Must be called before the decoder is destroyed.
+	void finish();
+
+	~AudioDecodeRing();
+};
+
+#endif // AUDIO_DECODE_RING_H
@@ -39,6 +39,11 @@ bool AudioEffectInstance::process_silence() const {
 	return ret;
 }
 
+bool AudioEffectInstance::can_process_in_parallel() const {
+	// Script and extension effects may access anything, built-in ones only touch their own state.
+	return get_script_instance() == nullptr && _get_extension() == nullptr;
+}
+
 void AudioEffectInstance::_bind_methods() {
 	GDVIRTUAL_BIND(_process, "src_buffer", "dst_buffer", "frame_count");
 	GDVIRTUAL_BIND(_process_silence);
@@ -47,6 +47,7 @@ protected:
 public:
 	virtual void process(const AudioFrame *p_src_frames, AudioFrame *p_dst_frames, int p_frame_count);
 	virtual bool process_silence() const;
+	virtual bool can_process_in_parallel() const; // Whether buses using this effect can be processed on worker threads.
 };
 
 class AudioEffect : public Resource {
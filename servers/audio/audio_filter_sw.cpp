@@ -30,6 +30,8 @@
 
 #include "audio_filter_sw.h"
 
+#include "servers/audio/audio_simd.h"
+
 void AudioFilterSW::set_mode(Mode p_mode) {
 	mode = p_mode;
 }
@@ -222,6 +224,83 @@ void AudioFilterSW::Processor::set_filter(AudioFilterSW *p_filter, bool p_clear_
 	filter = p_filter;
 }
 
+void AudioFilterSW::Processor::process_stereo(Processor *p_l, Processor *p_r, AudioFrame *p_frames, int p_amount, bool p_interpolate) {
+	if (!p_l->filter || !p_r->filter) {
+		return;
+	}
+
+#ifdef AUDIO_SIMD_SSE
+	// Left and right go in the two low lanes, the operation order matches process_one().
+#define PAIR(m_field) _mm_setr_ps(p_l->m_field, p_r->m_field, 0.0f, 0.0f)
+	__m128 b0 = PAIR(coeffs.b0);
+	__m128 b1 = PAIR(coeffs.b1);
+	__m128 b2 = PAIR(coeffs.b2);
+	__m128 a1 = PAIR(coeffs.a1);
+	__m128 a2 = PAIR(coeffs.a2);
+	const __m128 incr_b0 = PAIR(incr_coeffs.b0);
+	const __m128 incr_b1 = PAIR(incr_coeffs.b1);
+	const __m128 incr_b2 = PAIR(incr_coeffs.b2);
+	const __m128 incr_a1 = PAIR(incr_coeffs.a1);
+	const __m128 incr_a2 = PAIR(incr_coeffs.a2);
+	__m128 ha1 = PAIR(ha1);
+	__m128 ha2 = PAIR(ha2);
+	__m128 hb1 = PAIR(hb1);
+	__m128 hb2 = PAIR(hb2);
+#undef PAIR
+
+	for (int i = 0; i < p_amount; i++) {
+		__m128 pre = _mm_castpd_ps(_mm_load_sd((const double *)&p_frames[i]));
+		__m128 sample = _mm_mul_ps(pre, b0);
+		sample = _mm_add_ps(sample, _mm_mul_ps(hb1, b1));
+		sample = _mm_add_ps(sample, _mm_mul_ps(hb2, b2));
+		sample = _mm_add_ps(sample, _mm_mul_ps(ha1, a1));
+		sample = _mm_add_ps(sample, _mm_mul_ps(ha2, a2));
+		_mm_store_sd((double *)&p_frames[i], _mm_castps_pd(sample));
+
+		ha2 = ha1;
+		hb2 = hb1;
+		hb1 = pre;
+		ha1 = sample;
+
+		if (p_interpolate) {
+			b0 = _mm_add_ps(b0, incr_b0);
+			b1 = _mm_add_ps(b1, incr_b1);
+			b2 = _mm_add_ps(b2, incr_b2);
+			a1 = _mm_add_ps(a1, incr_a1);
+			a2 = _mm_add_ps(a2, incr_a2);
+		}
+	}
+
+	float lanes[4];
+#define STORE_PAIR(m_field, m_reg)  \
+	_mm_storeu_ps(lanes, m_reg);    \
+	p_l->m_field = lanes[0];        \
+	p_r->m_field = lanes[1];
+	STORE_PAIR(coeffs.b0, b0);
+	STORE_PAIR(coeffs.b1, b1);
+	STORE_PAIR(coeffs.b2, b2);
+	STORE_PAIR(coeffs.a1, a1);
+	STORE_PAIR(coeffs.a2, a2);
+	STORE_PAIR(ha1, ha1);
+	STORE_PAIR(ha2, ha2);
+	STORE_PAIR(hb1, hb1);
+	STORE_PAIR(hb2, hb2);
+#undef STORE_PAIR
+#else
+	if (p_interpolate) {
+		for (int i = 0; i < p_amount; i++) {
+			p_l->process_one_interp(p_frames[i].l);
+			p_r->process_one_interp(p_frames[i].r);
+		}
+	} else {
+		for (int i = 0; i < p_amount; i++) {
+			p_l->process_one(p_frames[i].l);
+			p_r->process_one(p_frames[i].r);
+		}
+	}
+#endif
+}
+
 void AudioFilterSW::Processor::update_coeffs(int p_interp_buffer_len) {
 	if (!filter) {
 		return;
@@ -31,6 +31,7 @@
 #ifndef AUDIO_FILTER_SW_H
 #define AUDIO_FILTER_SW_H
 
+#include "core/math/audio_frame.h"
 #include "core/math/math_funcs.h"
 
 class AudioFilterSW {
@@ -71,6 +72,9 @@ public:
 		_ALWAYS_INLINE_ void process_one(float &p_sample);
 		_ALWAYS_INLINE_ void process_one_interp(float &p_sample);
 
+		// Filters the left channel with p_l and the right one with p_r, running both in the same SIMD register when available.
+		static void process_stereo(Processor *p_l, Processor *p_r, AudioFrame *p_frames, int p_amount, bool p_interpolate = false);
+
 		Processor();
 	};
 
@@ -0,0 +1,243 @@
+/**************************************************************************/
+/*  audio_resampler.cpp                                                   */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "audio_resampler.h"
+
+#include "core/math/math_funcs.h"
+#include "servers/audio/audio_simd.h"
+
+AudioResampler::Quality AudioResampler::quality = AudioResampler::QUALITY_CUBIC;
+LocalVector<float> AudioResampler::sinc_tables[AudioResampler::QUALITY_MAX][AudioResampler::CUTOFF_STEPS];
+
+static int _get_quality_taps(AudioResampler::Quality p_quality) {
+	switch (p_quality) {
+		case AudioResampler::QUALITY_SINC_8:
+			return 8;
+		case AudioResampler::QUALITY_SINC_16:
+			return 16;
+		default:
+			return 4;
+	}
+}
+
+// Zeroth order modified Bessel function of the first kind, for the Kaiser window.
+static double _bessel_i0(double p_x) {
+	double sum = 1.0;
+	double term = 1.0;
+	for (int k = 1; k < 32; k++) {
+		term *= (p_x / (2.0 * k)) * (p_x / (2.0 * k));
+		sum += term;
+	}
+	return sum;
+}
+
+// Highest source read speed (in source frames per output frame) each cutoff step is used for.
+static const double cutoff_step_speeds[] = { 1.0, 1.25, 1.6, 2.0 };
+
+void AudioResampler::_build_sinc_tables(Quality p_quality) {
+	const int taps = _get_quality_taps(p_quality);
+	// Stay below Nyquist, so the transition band of the window doesn't fold back.
+	const double passband = 0.9;
+	// Kaiser window shape; a good balance between passband flatness and rejection for such short filters.
+	const double beta = 7.0;
+
+	for (int step = 0; step < CUTOFF_STEPS; step++) {
+		const double cutoff = passband / cutoff_step_speeds[step];
+		LocalVector<float> &table = sinc_tables[p_quality][step];
+		table.resize((PHASE_COUNT + 1) * taps * 2);
+
+		for (int phase = 0; phase <= PHASE_COUNT; phase++) {
+			const double mu = double(phase) / PHASE_COUNT;
+			double coefs[MAX_HISTORY];
+			double sum = 0.0;
+			for (int i = 0; i < taps; i++) {
+				// The interpolated position lies between taps (taps / 2 - 1) and (taps / 2).
+				const double x = i - (taps / 2 - 1) - mu;
+				const double t = x / (taps / 2);
+				const double window = _bessel_i0(beta * Math::sqrt(MAX(0.0, 1.0 - t * t))) / _bessel_i0(beta);
+				const double arg = Math_PI * cutoff * x;
+				const double sinc = Math::is_zero_approx(arg) ? 1.0 : Math::sin(arg) / arg;
+				coefs[i] = cutoff * sinc * window;
+				sum += coefs[i];
+			}
+			// Normalize every phase, so constant signals pass through unchanged.
+			float *row = &table[phase * taps * 2];
+			for (int i = 0; i < taps; i++) {
+				row[i * 2 + 0] = coefs[i] / sum;
+				row[i * 2 + 1] = coefs[i] / sum;
+			}
+		}
+	}
+}
+
+int AudioResampler::_get_cutoff_step(uint64_t p_increment) {
+	for (int step = 0; step < CUTOFF_STEPS - 1; step++) {
+		if (p_increment <= uint64_t(cutoff_step_speeds[step] * FP_LEN)) {
+			return step;
+		}
+	}
+	return CUTOFF_STEPS - 1;
+}
+
+void AudioResampler::_resample_cubic(const AudioFrame *p_src, AudioFrame *p_dst, int p_frames, uint64_t p_offset, uint64_t p_increment) {
+	int i = 0;
+
+#ifdef AUDIO_SIMD_SSE
+	// Two outputs per register: the low half holds the first one, the high half the second one.
+	// Operations are done in the same order as the scalar version below, so both give the same results.
+	const __m128 two = _mm_set1_ps(2.0f);
+	const __m128 three = _mm_set1_ps(3.0f);
+	const __m128 four = _mm_set1_ps(4.0f);
+	const __m128 five = _mm_set1_ps(5.0f);
+	const __m128 half = _mm_set1_ps(0.5f);
+
+	for (; i + 1 < p_frames; i += 2) {
+		const uint64_t offset_a = p_offset + i * p_increment;
+		const uint64_t offset_b = offset_a + p_increment;
+		const __m64 *a = (const __m64 *)(p_src + (offset_a >> FP_BITS) - 3);
+		const __m64 *b = (const __m64 *)(p_src + (offset_b >> FP_BITS) - 3);
+
+		const __m128 y0 = _mm_loadh_pi(_mm_loadl_pi(_mm_setzero_ps(), a + 0), b + 0);
+		const __m128 y1 = _mm_loadh_pi(_mm_loadl_pi(_mm_setzero_ps(), a + 1), b + 1);
+		const __m128 y2 = _mm_loadh_pi(_mm_loadl_pi(_mm_setzero_ps(), a + 2), b + 2);
+		const __m128 y3 = _mm_loadh_pi(_mm_loadl_pi(_mm_setzero_ps(), a + 3), b + 3);
+
+		const float mu_a = (offset_a & FP_MASK) / float(FP_LEN);
+		const float mu_b = (offset_b & FP_MASK) / float(FP_LEN);
+		const __m128 mu = _mm_set_ps(mu_b, mu_b, mu_a, mu_a);
+		const __m128 mu2 = _mm_mul_ps(mu, mu);
+
+		const __m128 a0 = _mm_sub_ps(_mm_add_ps(_mm_sub_ps(_mm_mul_ps(y1, three), _mm_mul_ps(y2, three)), y3), y0);
+		const __m128 a1 = _mm_sub_ps(_mm_add_ps(_mm_sub_ps(_mm_mul_ps(y0, two), _mm_mul_ps(y1, five)), _mm_mul_ps(y2, four)), y3);
+		const __m128 a2 = _mm_sub_ps(y2, y0);
+		const __m128 a3 = _mm_mul_ps(y1, two);
+
+		__m128 result = _mm_mul_ps(_mm_mul_ps(a0, mu), mu2);
+		result = _mm_add_ps(result, _mm_mul_ps(a1, mu2));
+		result = _mm_add_ps(result, _mm_mul_ps(a2, mu));
+		result = _mm_mul_ps(_mm_add_ps(result, a3), half);
+
+		_mm_storel_pi((__m64 *)&p_dst[i], result);
+		_mm_storeh_pi((__m64 *)&p_dst[i + 1], result);
+	}
+#endif
+
+	for (; i < p_frames; i++) {
+		const uint64_t offset = p_offset + i * p_increment;
+		const AudioFrame *y = p_src + (offset >> FP_BITS) - 3;
+		// Standard cubic interpolation (great quality/performance ratio).
+		float mu = (offset & FP_MASK) / float(FP_LEN);
+		AudioFrame y0 = y[0];
+		AudioFrame y1 = y[1];
+		AudioFrame y2 = y[2];
+		AudioFrame y3 = y[3];
+
+		float mu2 = mu * mu;
+		AudioFrame a0 = 3 * y1 - 3 * y2 + y3 - y0;
+		AudioFrame a1 = 2 * y0 - 5 * y1 + 4 * y2 - y3;
+		AudioFrame a2 = y2 - y0;
+		AudioFrame a3 = 2 * y1;
+
+		p_dst[i] = (a0 * mu * mu2 + a1 * mu2 + a2 * mu + a3) / 2;
+	}
+}
+
+template <int TAPS>
+void AudioResampler::_resample_sinc(const AudioFrame *p_src, AudioFrame *p_dst, int p_frames, uint64_t p_offset, uint64_t p_increment) {
+	const Quality table_quality = TAPS == 8 ? QUALITY_SINC_8 : QUALITY_SINC_16;
+	const float *table = sinc_tables[table_quality][_get_cutoff_step(p_increment)].ptr();
+	const int row_size = TAPS * 2;
+	const int blend_bits = FP_BITS - PHASE_BITS;
+
+	for (int i = 0; i < p_frames; i++) {
+		const uint64_t offset = p_offset + i * p_increment;
+		const float *src = (const float *)(p_src + (offset >> FP_BITS) - (TAPS - 1));
+		const uint32_t fraction = offset & FP_MASK;
+		// Interpolate between the two nearest precomputed phases.
+		const float *row = table + (fraction >> blend_bits) * row_size;
+		const float blend = (fraction & ((1 << blend_bits) - 1)) / float(1 << blend_bits);
+
+#ifdef AUDIO_SIMD_SSE
+		const __m128 blend4 = _mm_set1_ps(blend);
+		__m128 acc = _mm_setzero_ps();
+		for (int j = 0; j < row_size; j += 4) {
+			const __m128 c0 = _mm_loadu_ps(row + j);
+			const __m128 c1 = _mm_loadu_ps(row + row_size + j);
+			const __m128 coef = _mm_add_ps(c0, _mm_mul_ps(blend4, _mm_sub_ps(c1, c0)));
+			acc = _mm_add_ps(acc, _mm_mul_ps(coef, _mm_loadu_ps(src + j)));
+		}
+		// Two frames were accumulated side by side, fold them together.
+		acc = _mm_add_ps(acc, _mm_movehl_ps(acc, acc));
+		_mm_storel_pi((__m64 *)&p_dst[i], acc);
+#else
+		float l = 0.0f;
+		float r = 0.0f;
+		for (int j = 0; j < row_size; j += 2) {
+			const float coef = row[j] + blend * (row[row_size + j] - row[j]);
+			l += coef * src[j + 0];
+			r += coef * src[j + 1];
+		}
+		p_dst[i] = AudioFrame(l, r);
+#endif
+	}
+}
+
+void AudioResampler::set_quality(Quality p_quality) {
+	ERR_FAIL_INDEX(p_quality, QUALITY_MAX);
+	if (p_quality != QUALITY_CUBIC && sinc_tables[p_quality][0].is_empty()) {
+		_build_sinc_tables(p_quality);
+	}
+	quality = p_quality;
+}
+
+int AudioResampler::get_history(Quality p_quality) {
+	return _get_quality_taps(p_quality) - 1;
+}
+
+void AudioResampler::resample(Quality p_quality, const AudioFrame *p_src, AudioFrame *p_dst, int p_frames, uint64_t p_offset, uint64_t p_increment) {
+	switch (p_quality) {
+		case QUALITY_SINC_8: {
+			if (!sinc_tables[QUALITY_SINC_8][0].is_empty()) {
+				_resample_sinc<8>(p_src, p_dst, p_frames, p_offset, p_increment);
+				return;
+			}
+		} break;
+		case QUALITY_SINC_16: {
+			if (!sinc_tables[QUALITY_SINC_16][0].is_empty()) {
+				_resample_sinc<16>(p_src, p_dst, p_frames, p_offset, p_increment);
+				return;
+			}
+		} break;
+		default: {
+		}
+	}
+	// Also used when the tables for a sinc quality were never built.
+	_resample_cubic(p_src, p_dst, p_frames, p_offset, p_increment);
+}
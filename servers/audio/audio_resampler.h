@@ -0,0 +1,87 @@
+/**************************************************************************/
+/*  audio_resampler.h                                                     */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef AUDIO_RESAMPLER_H
+#define AUDIO_RESAMPLER_H
+
+#include "core/math/audio_frame.h"
+#include "core/templates/local_vector.h"
+
+// Interpolation kernels used by AudioStreamPlaybackResampled.
+// Source positions are 16.16 fixed point. The output at position p is computed from the source frames ending at
+// floor(p), so callers must keep get_history() frames of history before the first source frame.
+class AudioResampler {
+public:
+	enum Quality {
+		QUALITY_CUBIC,
+		QUALITY_SINC_8,
+		QUALITY_SINC_16,
+		QUALITY_MAX
+	};
+
+	enum {
+		FP_BITS = 16,
+		FP_LEN = (1 << FP_BITS),
+		FP_MASK = FP_LEN - 1,
+		MAX_HISTORY = 16,
+	};
+
+private:
+	enum {
+		PHASE_BITS = 8,
+		PHASE_COUNT = (1 << PHASE_BITS),
+		// Cutoffs are lowered in steps when the source is read faster than the output rate, so pitching up doesn't alias.
+		CUTOFF_STEPS = 4,
+	};
+
+	static Quality quality;
+	// Per sinc quality and cutoff step: (PHASE_COUNT + 1) rows of taps, each coefficient stored twice to multiply whole frames.
+	static LocalVector<float> sinc_tables[QUALITY_MAX][CUTOFF_STEPS];
+
+	static void _build_sinc_tables(Quality p_quality);
+	static int _get_cutoff_step(uint64_t p_increment);
+
+	static void _resample_cubic(const AudioFrame *p_src, AudioFrame *p_dst, int p_frames, uint64_t p_offset, uint64_t p_increment);
+	template <int TAPS>
+	static void _resample_sinc(const AudioFrame *p_src, AudioFrame *p_dst, int p_frames, uint64_t p_offset, uint64_t p_increment);
+
+public:
+	// Also builds the tables the quality needs, so call it before mixing with a given quality.
+	static void set_quality(Quality p_quality);
+	static Quality get_quality() { return quality; }
+
+	// Frames of history needed before the first source frame for the given quality.
+	static int get_history(Quality p_quality);
+
+	// Writes p_frames frames to p_dst, reading p_src from position p_offset onwards in p_increment steps.
+	static void resample(Quality p_quality, const AudioFrame *p_src, AudioFrame *p_dst, int p_frames, uint64_t p_offset, uint64_t p_increment);
+};
+
+#endif // AUDIO_RESAMPLER_H
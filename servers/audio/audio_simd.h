@@ -0,0 +1,158 @@
+/**************************************************************************/
+/*  audio_simd.h                                                          */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef AUDIO_SIMD_H
+#define AUDIO_SIMD_H
+
+#include "core/math/audio_frame.h"
+#include "core/math/math_funcs.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define AUDIO_SIMD_SSE
+#include <emmintrin.h>
+#endif
+
+// Buffer kernels used by the mixer and the built-in effects.
+// AudioFrame buffers are treated as interleaved float pairs, so two frames fit in a register.
+
+#ifdef AUDIO_SIMD_SSE
+// Same as undenormalize(), for four samples at once.
+_ALWAYS_INLINE_ __m128 audio_simd_undenormalize(__m128 p_samples) {
+	__m128i exponent = _mm_and_si128(_mm_castps_si128(p_samples), _mm_set1_epi32(0x7f800000));
+	__m128i denormal = _mm_cmplt_epi32(exponent, _mm_set1_epi32(0x08000000));
+	return _mm_andnot_ps(_mm_castsi128_ps(denormal), p_samples);
+}
+#endif
+
+// Multiplies p_src by a volume ramping linearly from p_vol_start to p_vol_final, then either accumulates into or writes to r_dst.
+inline void audio_simd_mix_ramp(AudioFrame *r_dst, const AudioFrame *p_src, const AudioFrame &p_vol_start, const AudioFrame &p_vol_final, uint32_t p_frames, bool p_accumulate) {
+	if (p_frames == 0) {
+		return;
+	}
+	const float inv_frames = 1.0f / p_frames;
+	uint32_t i = 0;
+
+#ifdef AUDIO_SIMD_SSE
+	float *dst = (float *)r_dst;
+	const float *src = (const float *)p_src;
+	const __m128 vol_start = _mm_setr_ps(p_vol_start.l, p_vol_start.r, p_vol_start.l, p_vol_start.r);
+	const __m128 vol_delta = _mm_sub_ps(_mm_setr_ps(p_vol_final.l, p_vol_final.r, p_vol_final.l, p_vol_final.r), vol_start);
+	const __m128 step = _mm_set1_ps(2.0f);
+	const __m128 scale = _mm_set1_ps(inv_frames);
+	__m128 frame_idx = _mm_setr_ps(0.0f, 0.0f, 1.0f, 1.0f);
+
+	for (; i + 2 <= p_frames; i += 2) {
+		__m128 vol = _mm_add_ps(vol_start, _mm_mul_ps(vol_delta, _mm_mul_ps(frame_idx, scale)));
+		__m128 mixed = _mm_mul_ps(vol, _mm_loadu_ps(&src[i * 2]));
+		if (p_accumulate) {
+			mixed = _mm_add_ps(mixed, _mm_loadu_ps(&dst[i * 2]));
+		}
+		_mm_storeu_ps(&dst[i * 2], mixed);
+		frame_idx = _mm_add_ps(frame_idx, step);
+	}
+#endif
+
+	for (; i < p_frames; i++) {
+		AudioFrame mixed = p_vol_start.lerp(p_vol_final, i * inv_frames) * p_src[i];
+		if (p_accumulate) {
+			r_dst[i] += mixed;
+		} else {
+			r_dst[i] = mixed;
+		}
+	}
+}
+
+// Accumulates p_src into r_dst.
+inline void audio_simd_mix(AudioFrame *r_dst, const AudioFrame *p_src, uint32_t p_frames) {
+	uint32_t i = 0;
+
+#ifdef AUDIO_SIMD_SSE
+	float *dst = (float *)r_dst;
+	const float *src = (const float *)p_src;
+	for (; i + 2 <= p_frames; i += 2) {
+		_mm_storeu_ps(&dst[i * 2], _mm_add_ps(_mm_loadu_ps(&dst[i * 2]), _mm_loadu_ps(&src[i * 2])));
+	}
+#endif
+
+	for (; i < p_frames; i++) {
+		r_dst[i] += p_src[i];
+	}
+}
+
+// Multiplies every frame by p_gains[frame].
+inline void audio_simd_apply_gains(AudioFrame *r_dst, const AudioFrame *p_src, const float *p_gains, uint32_t p_frames) {
+	uint32_t i = 0;
+
+#ifdef AUDIO_SIMD_SSE
+	float *dst = (float *)r_dst;
+	const float *src = (const float *)p_src;
+	for (; i + 2 <= p_frames; i += 2) {
+		__m128 gains = _mm_castpd_ps(_mm_load_sd((const double *)&p_gains[i]));
+		gains = _mm_unpacklo_ps(gains, gains);
+		_mm_storeu_ps(&dst[i * 2], _mm_mul_ps(_mm_loadu_ps(&src[i * 2]), gains));
+	}
+#endif
+
+	for (; i < p_frames; i++) {
+		r_dst[i] = p_src[i] * p_gains[i];
+	}
+}
+
+// Multiplies every frame by p_volume and returns the absolute peak of the result.
+inline AudioFrame audio_simd_scale_peak(AudioFrame *r_frames, float p_volume, uint32_t p_frames) {
+	AudioFrame peak = AudioFrame(0, 0);
+	uint32_t i = 0;
+
+#ifdef AUDIO_SIMD_SSE
+	float *frames = (float *)r_frames;
+	const __m128 volume = _mm_set1_ps(p_volume);
+	const __m128 abs_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+	__m128 peak4 = _mm_setzero_ps();
+	for (; i + 2 <= p_frames; i += 2) {
+		__m128 scaled = _mm_mul_ps(_mm_loadu_ps(&frames[i * 2]), volume);
+		_mm_storeu_ps(&frames[i * 2], scaled);
+		peak4 = _mm_max_ps(peak4, _mm_and_ps(scaled, abs_mask));
+	}
+	peak4 = _mm_max_ps(peak4, _mm_movehl_ps(peak4, peak4));
+	float peak_lr[4];
+	_mm_storeu_ps(peak_lr, peak4);
+	peak = AudioFrame(peak_lr[0], peak_lr[1]);
+#endif
+
+	for (; i < p_frames; i++) {
+		r_frames[i] *= p_volume;
+		peak.l = MAX(peak.l, Math::abs(r_frames[i].l));
+		peak.r = MAX(peak.r, Math::abs(r_frames[i].r));
+	}
+
+	return peak;
+}
+
+#endif // AUDIO_SIMD_H
@@ -32,6 +32,7 @@
 
 #include "core/config/project_settings.h"
 #include "core/os/os.h"
+#include "servers/audio/audio_resampler.h"
 
 void AudioStreamPlayback::start(double p_from_pos) {
 	if (GDVIRTUAL_CALL(_start, p_from_pos)) {
@@ -76,6 +77,10 @@ int AudioStreamPlayback::mix(AudioFrame *p_buffer, float p_rate_scale, int p_fra
 	return ret;
 }
 
+bool AudioStreamPlayback::can_mix_in_parallel() const {
+	return false;
+}
+
 void AudioStreamPlayback::tag_used_streams() {
 	GDVIRTUAL_CALL(_tag_used_streams);
 }
@@ -93,13 +98,12 @@ void AudioStreamPlayback::_bind_methods() {
 //////////////////////////////
 
 void AudioStreamPlaybackResampled::begin_resample() {
-	//clear cubic interpolation history
-	internal_buffer[0] = AudioFrame(0.0, 0.0);
-	internal_buffer[1] = AudioFrame(0.0, 0.0);
-	internal_buffer[2] = AudioFrame(0.0, 0.0);
-	internal_buffer[3] = AudioFrame(0.0, 0.0);
+	//clear interpolation history
+	for (int i = 0; i < RESAMPLE_HISTORY; i++) {
+		internal_buffer[i] = AudioFrame(0.0, 0.0);
+	}
 	//mix buffer
-	_mix_internal(internal_buffer + 4, INTERNAL_BUFFER_LEN);
+	_mix_internal(internal_buffer + RESAMPLE_HISTORY, INTERNAL_BUFFER_LEN);
 	mix_offset = 0;
 }
 
@@ -127,40 +131,41 @@ int AudioStreamPlaybackResampled::mix(AudioFrame *p_buffer, float p_rate_scale,
 
 	uint64_t mix_increment = uint64_t(((get_stream_sampling_rate() * p_rate_scale * playback_speed_scale) / double(target_rate)) * double(FP_LEN));
 
+	const AudioResampler::Quality quality = AudioResampler::get_quality();
+	const AudioFrame *source = internal_buffer + RESAMPLE_HISTORY;
+
 	int mixed_frames_total = -1;
 
-	int i;
-	for (i = 0; i < p_frames; i++) {
-		uint32_t idx = CUBIC_INTERP_HISTORY + uint32_t(mix_offset >> FP_BITS);
-		//standard cubic interpolation (great quality/performance ratio)
-		//this used to be moved to a LUT for greater performance, but nowadays CPU speed is generally faster than memory.
-		float mu = (mix_offset & FP_MASK) / float(FP_LEN);
-		AudioFrame y0 = internal_buffer[idx - 3];
-		AudioFrame y1 = internal_buffer[idx - 2];
-		AudioFrame y2 = internal_buffer[idx - 1];
-		AudioFrame y3 = internal_buffer[idx - 0];
-
-		if (idx >= internal_buffer_end && mixed_frames_total == -1) {
-			// The internal buffer ends somewhere in this range, and we haven't yet recorded the number of good frames we have.
-			mixed_frames_total = i;
+	int i = 0;
+	while (i < p_frames) {
+		// Resample everything up to the point where the internal buffer needs to be refilled in one go.
+		int frames = p_frames - i;
+		if (mix_increment > 0) {
+			uint64_t to_buffer_end = (uint64_t(INTERNAL_BUFFER_LEN) << FP_BITS) - mix_offset;
+			frames = MIN(uint64_t(frames), (to_buffer_end + mix_increment - 1) / mix_increment);
 		}
 
-		float mu2 = mu * mu;
-		AudioFrame a0 = 3 * y1 - 3 * y2 + y3 - y0;
-		AudioFrame a1 = 2 * y0 - 5 * y1 + 4 * y2 - y3;
-		AudioFrame a2 = y2 - y0;
-		AudioFrame a3 = 2 * y1;
-
-		p_buffer[i] = (a0 * mu * mu2 + a1 * mu2 + a2 * mu + a3) / 2;
+		if (mixed_frames_total == -1 && internal_buffer_end != (unsigned int)-1) {
+			// The internal buffer ends somewhere in this range, record the number of good frames we have.
+			uint64_t end_offset = internal_buffer_end > CUBIC_INTERP_HISTORY ? uint64_t(internal_buffer_end - CUBIC_INTERP_HISTORY) << FP_BITS : 0;
+			uint64_t good_frames = 0;
+			if (end_offset > mix_offset) {
+				good_frames = mix_increment > 0 ? (end_offset - mix_offset + mix_increment - 1) / mix_increment : frames;
+			}
+			if (good_frames < uint64_t(frames)) {
+				mixed_frames_total = i + good_frames;
+			}
+		}
 
-		mix_offset += mix_increment;
+		AudioResampler::resample(quality, source, p_buffer + i, frames, mix_offset, mix_increment);
+		mix_offset += mix_increment * frames;
+		i += frames;
 
 		while ((mix_offset >> FP_BITS) >= INTERNAL_BUFFER_LEN) {
-			internal_buffer[0] = internal_buffer[INTERNAL_BUFFER_LEN + 0];
-			internal_buffer[1] = internal_buffer[INTERNAL_BUFFER_LEN + 1];
-			internal_buffer[2] = internal_buffer[INTERNAL_BUFFER_LEN + 2];
-			internal_buffer[3] = internal_buffer[INTERNAL_BUFFER_LEN + 3];
-			int mixed_frames = _mix_internal(internal_buffer + 4, INTERNAL_BUFFER_LEN);
+			for (int j = 0; j < RESAMPLE_HISTORY; j++) {
+				internal_buffer[j] = internal_buffer[INTERNAL_BUFFER_LEN + j];
+			}
+			int mixed_frames = _mix_internal(internal_buffer + RESAMPLE_HISTORY, INTERNAL_BUFFER_LEN);
 			if (mixed_frames != INTERNAL_BUFFER_LEN) {
 				// internal_buffer[mixed_frames] is the first frame of silence.
 				internal_buffer_end = mixed_frames;
@@ -171,7 +176,7 @@ int AudioStreamPlaybackResampled::mix(AudioFrame *p_buffer, float p_rate_scale,
 			mix_offset -= (INTERNAL_BUFFER_LEN << FP_BITS);
 		}
 	}
-	if (mixed_frames_total == -1 && i == p_frames) {
+	if (mixed_frames_total == -1) {
 		mixed_frames_total = p_frames;
 	}
 	return mixed_frames_total;
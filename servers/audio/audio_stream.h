@@ -67,6 +67,7 @@ public:
 	virtual void tag_used_streams();
 
 	virtual int mix(AudioFrame *p_buffer, float p_rate_scale, int p_frames);
+	virtual bool can_mix_in_parallel() const; // Whether mix() can run on a worker thread, alongside other playbacks.
 };
 
 class AudioStreamPlaybackResampled : public AudioStreamPlayback {
@@ -77,10 +78,11 @@ class AudioStreamPlaybackResampled : public AudioStreamPlayback {
 		FP_LEN = (1 << FP_BITS),
 		FP_MASK = FP_LEN - 1,
 		INTERNAL_BUFFER_LEN = 128, // 128 warrants 3ms positional jitter at much at 44100hz
-		CUBIC_INTERP_HISTORY = 4
+		CUBIC_INTERP_HISTORY = 4,
+		RESAMPLE_HISTORY = 16, // Enough for the longest AudioResampler kernel.
 	};
 
-	AudioFrame internal_buffer[INTERNAL_BUFFER_LEN + CUBIC_INTERP_HISTORY];
+	AudioFrame internal_buffer[INTERNAL_BUFFER_LEN + RESAMPLE_HISTORY];
 	unsigned int internal_buffer_end = -1;
 	uint64_t mix_offset = 0;
 
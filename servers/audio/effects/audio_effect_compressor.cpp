@@ -29,6 +29,7 @@
 /**************************************************************************/
 
 #include "audio_effect_compressor.h"
+#include "servers/audio/audio_simd.h"
 #include "servers/audio_server.h"
 
 void AudioEffectCompressorInstance::process(const AudioFrame *p_src_frames, AudioFrame *p_dst_frames, int p_frame_count) {
@@ -49,6 +50,10 @@ void AudioEffectCompressorInstance::process(const AudioFrame *p_src_frames, Audi
 
 	const AudioFrame *src = p_src_frames;
 
+	if (frame_gains.size() < (uint32_t)p_frame_count) {
+		frame_gains.resize(p_frame_count);
+	}
+
 	if (base->sidechain != StringName() && current_channel != -1) {
 		int bus = AudioServer::get_singleton()->thread_find_bus_index(base->sidechain);
 		if (bus >= 0) {
@@ -64,10 +69,9 @@ void AudioEffectCompressorInstance::process(const AudioFrame *p_src_frames, Audi
 
 		float peak = MAX(s.l, s.r);
 
-		float overdb = 2.08136898f * Math::linear_to_db(peak / threshold);
-
-		if (overdb < 0.0) { //we only care about what goes over to compress
-			overdb = 0.0;
+		float overdb = 0.0; //we only care about what goes over to compress
+		if (peak > threshold) {
+			overdb = 2.08136898f * Math::linear_to_db(peak / threshold);
 		}
 
 		if (overdb - rundb > 5) { // diffeence is too large
@@ -108,8 +112,14 @@ void AudioEffectCompressorInstance::process(const AudioFrame *p_src_frames, Audi
 			}
 		}
 
-		p_dst_frames[i] = p_src_frames[i] * grv * makeup * mix + p_src_frames[i] * (1.0 - mix);
+		frame_gains[i] = grv * makeup * mix + (1.0 - mix);
 	}
+
+	audio_simd_apply_gains(p_dst_frames, p_src_frames, frame_gains.ptr(), p_frame_count);
+}
+
+bool AudioEffectCompressorInstance::can_process_in_parallel() const {
+	return base->sidechain == StringName(); // The sidechain reads another bus.
 }
 
 Ref<AudioEffectInstance> AudioEffectCompressor::instantiate() {
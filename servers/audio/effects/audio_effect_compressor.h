@@ -31,6 +31,7 @@
 #ifndef AUDIO_EFFECT_COMPRESSOR_H
 #define AUDIO_EFFECT_COMPRESSOR_H
 
+#include "core/templates/local_vector.h"
 #include "servers/audio/audio_effect.h"
 
 class AudioEffectCompressor;
@@ -42,10 +43,12 @@ class AudioEffectCompressorInstance : public AudioEffectInstance {
 
 	float rundb, averatio, runratio, runmax, maxover, gr_meter;
 	int current_channel;
+	LocalVector<float> frame_gains; // Computed per frame, then applied to the whole buffer at once.
 
 public:
 	void set_current_channel(int p_channel) { current_channel = p_channel; }
 	virtual void process(const AudioFrame *p_src_frames, AudioFrame *p_dst_frames, int p_frame_count) override;
+	virtual bool can_process_in_parallel() const override;
 };
 
 class AudioEffectCompressor : public AudioEffect {
@@ -32,6 +32,7 @@
 
 #include "core/error/error_macros.h"
 #include "core/math/math_funcs.h"
+#include "servers/audio/audio_simd.h"
 
 #include <math.h>
 
@@ -68,6 +69,70 @@ EQ::BandProcess::BandProcess() {
 	history.b1 = history.b2 = history.b3 = 0;
 }
 
+void EQ::process_bands(BandProcess *p_bands, const float *p_gains, int p_band_count, const float *p_src, float *r_dst, int p_amount, int p_stride) {
+	for (int i = 0; i < p_amount; i++) {
+		r_dst[i * p_stride] = 0;
+	}
+
+	int band_idx = 0;
+
+#ifdef AUDIO_SIMD_SSE
+	// Bands only share their input, so four of them can run side by side.
+	for (; band_idx + 4 <= p_band_count; band_idx += 4) {
+		BandProcess *bp = &p_bands[band_idx];
+#define LANES(m_field) _mm_setr_ps(bp[0].m_field, bp[1].m_field, bp[2].m_field, bp[3].m_field)
+		const __m128 c1 = LANES(c1);
+		const __m128 c2 = LANES(c2);
+		const __m128 c3 = LANES(c3);
+		__m128 a1 = LANES(history.a1);
+		__m128 a2 = LANES(history.a2);
+		__m128 a3 = LANES(history.a3);
+		__m128 b1 = LANES(history.b1);
+		__m128 b2 = LANES(history.b2);
+		__m128 b3 = LANES(history.b3);
+#undef LANES
+		const __m128 gains = _mm_loadu_ps(&p_gains[band_idx]);
+
+		for (int i = 0; i < p_amount; i++) {
+			a1 = _mm_set1_ps(p_src[i * p_stride]);
+			b1 = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(c1, _mm_sub_ps(a1, a3)), _mm_mul_ps(c3, b2)), _mm_mul_ps(c2, b3));
+
+			a3 = a2;
+			a2 = a1;
+			b3 = b2;
+			b2 = b1;
+
+			__m128 out = _mm_mul_ps(b1, gains);
+			out = _mm_add_ps(out, _mm_movehl_ps(out, out));
+			out = _mm_add_ss(out, _mm_shuffle_ps(out, out, _MM_SHUFFLE(1, 1, 1, 1)));
+			r_dst[i * p_stride] += _mm_cvtss_f32(out);
+		}
+
+		float lanes[4];
+#define STORE_LANES(m_field, m_reg) \
+	_mm_storeu_ps(lanes, m_reg);      \
+	for (int j = 0; j < 4; j++) {     \
+		bp[j].m_field = lanes[j];     \
+	}
+		STORE_LANES(history.a1, a1);
+		STORE_LANES(history.a2, a2);
+		STORE_LANES(history.a3, a3);
+		STORE_LANES(history.b1, b1);
+		STORE_LANES(history.b2, b2);
+		STORE_LANES(history.b3, b3);
+#undef STORE_LANES
+	}
+#endif
+
+	for (; band_idx < p_band_count; band_idx++) {
+		for (int i = 0; i < p_amount; i++) {
+			float sample = p_src[i * p_stride];
+			p_bands[band_idx].process_one(sample);
+			r_dst[i * p_stride] += sample * p_gains[band_idx];
+		}
+	}
+}
+
 void EQ::recalculate_band_coefficients() {
 #define BAND_LOG(m_f) (log((m_f)) / log(2.))
 
@@ -80,6 +80,9 @@ public:
 	BandProcess get_band_processor(int p_band) const;
 	float get_band_frequency(int p_band);
 
+	// Runs p_src through every band and writes the gain-weighted sum to r_dst.
+	static void process_bands(BandProcess *p_bands, const float *p_gains, int p_band_count, const float *p_src, float *r_dst, int p_amount, int p_stride = 1);
+
 	EQ();
 	~EQ();
 };
@@ -31,6 +31,7 @@
 #include "reverb_filter.h"
 
 #include "core/math/math_funcs.h"
+#include "servers/audio/audio_simd.h"
 
 #include <math.h>
 
@@ -106,17 +107,16 @@ void Reverb::process(float *p_src, float *p_dst, int p_frames) {
 		Comb &c = comb[i];
 
 		int size_limit = c.size - lrintf((float)c.extra_spread_frames * (1.0 - params.extra_spread));
-		for (int j = 0; j < p_frames; j++) {
+		for (int j = 0; j < p_frames;) {
 			if (c.pos >= size_limit) { //reset this now just in case
 				c.pos = 0;
 			}
 
-			float out = undenormalize(c.buffer[c.pos] * c.feedback);
-			out = out * (1.0 - c.damp) + c.damp_h * c.damp; //lowpass
-			c.damp_h = out;
-			c.buffer[c.pos] = input_buffer[j] + out;
-			p_dst[j] += out;
-			c.pos++;
+			// Until the position wraps, every slot is read before being overwritten, so the run can be vectorized.
+			int run = MIN(p_frames - j, size_limit - c.pos);
+			_process_comb_run(c, &input_buffer[j], &p_dst[j], run);
+			c.pos += run;
+			j += run;
 		}
 	}
 
@@ -157,25 +157,87 @@ void Reverb::process(float *p_src, float *p_dst, int p_frames) {
 		AllPass &a = allpass[i];
 		int size_limit = a.size - lrintf((float)a.extra_spread_frames * (1.0 - params.extra_spread));
 
-		for (int j = 0; j < p_frames; j++) {
+		for (int j = 0; j < p_frames;) {
 			if (a.pos >= size_limit) {
 				a.pos = 0;
 			}
 
-			float aux = a.buffer[a.pos];
-			a.buffer[a.pos] = undenormalize(allpass_feedback * aux + p_dst[j]);
-			p_dst[j] = aux - allpass_feedback * a.buffer[a.pos];
-			a.pos++;
+			int run = MIN(p_frames - j, size_limit - a.pos);
+			float *buffer = &a.buffer[a.pos];
+			float *dst = &p_dst[j];
+			int k = 0;
+#ifdef AUDIO_SIMD_SSE
+			const __m128 feedback = _mm_set1_ps(allpass_feedback);
+			for (; k + 4 <= run; k += 4) {
+				__m128 aux = _mm_loadu_ps(&buffer[k]);
+				__m128 stored = audio_simd_undenormalize(_mm_add_ps(_mm_mul_ps(feedback, aux), _mm_loadu_ps(&dst[k])));
+				_mm_storeu_ps(&buffer[k], stored);
+				_mm_storeu_ps(&dst[k], _mm_sub_ps(aux, _mm_mul_ps(feedback, stored)));
+			}
+#endif
+			for (; k < run; k++) {
+				float aux = buffer[k];
+				buffer[k] = undenormalize(allpass_feedback * aux + dst[k]);
+				dst[k] = aux - allpass_feedback * buffer[k];
+			}
+
+			a.pos += run;
+			j += run;
 		}
 	}
 
 	static const float wet_scale = 0.6;
 
-	for (int i = 0; i < p_frames; i++) {
+	int i = 0;
+#ifdef AUDIO_SIMD_SSE
+	const __m128 wet = _mm_set1_ps(params.wet);
+	const __m128 wet_scale4 = _mm_set1_ps(wet_scale);
+	const __m128 dry = _mm_set1_ps(params.dry);
+	for (; i + 4 <= p_frames; i += 4) {
+		__m128 mixed = _mm_mul_ps(_mm_mul_ps(_mm_loadu_ps(&p_dst[i]), wet), wet_scale4);
+		_mm_storeu_ps(&p_dst[i], _mm_add_ps(mixed, _mm_mul_ps(_mm_loadu_ps(&p_src[i]), dry)));
+	}
+#endif
+	for (; i < p_frames; i++) {
 		p_dst[i] = p_dst[i] * params.wet * wet_scale + p_src[i] * params.dry;
 	}
 }
 
+void Reverb::_process_comb_run(Comb &p_comb, const float *p_input, float *r_dst, int p_frames) {
+	float *buffer = &p_comb.buffer[p_comb.pos];
+
+	int i = 0;
+#ifdef AUDIO_SIMD_SSE
+	const __m128 feedback = _mm_set1_ps(p_comb.feedback);
+	for (; i + 4 <= p_frames; i += 4) {
+		_mm_storeu_ps(&comb_buffer[i], audio_simd_undenormalize(_mm_mul_ps(_mm_loadu_ps(&buffer[i]), feedback)));
+	}
+#endif
+	for (; i < p_frames; i++) {
+		comb_buffer[i] = undenormalize(buffer[i] * p_comb.feedback);
+	}
+
+	// The lowpass is recursive, so it stays scalar.
+	for (i = 0; i < p_frames; i++) {
+		float out = comb_buffer[i] * (1.0 - p_comb.damp) + p_comb.damp_h * p_comb.damp;
+		p_comb.damp_h = out;
+		comb_buffer[i] = out;
+	}
+
+	i = 0;
+#ifdef AUDIO_SIMD_SSE
+	for (; i + 4 <= p_frames; i += 4) {
+		__m128 out = _mm_loadu_ps(&comb_buffer[i]);
+		_mm_storeu_ps(&buffer[i], _mm_add_ps(_mm_loadu_ps(&p_input[i]), out));
+		_mm_storeu_ps(&r_dst[i], _mm_add_ps(_mm_loadu_ps(&r_dst[i]), out));
+	}
+#endif
+	for (; i < p_frames; i++) {
+		buffer[i] = p_input[i] + comb_buffer[i];
+		r_dst[i] += comb_buffer[i];
+	}
+}
+
 void Reverb::set_room_size(float p_size) {
 	params.room_size = p_size;
 	update_parameters();
@@ -330,6 +392,7 @@ Reverb::Reverb() {
 	params.hpf = 0;
 
 	input_buffer = memnew_arr(float, INPUT_BUFFER_MAX_SIZE);
+	comb_buffer = memnew_arr(float, INPUT_BUFFER_MAX_SIZE);
 
 	configure_buffers();
 	update_parameters();
@@ -337,5 +400,6 @@ Reverb::Reverb() {
 
 Reverb::~Reverb() {
 	memdelete_arr(input_buffer);
+	memdelete_arr(comb_buffer);
 	clear_buffers();
 }
@@ -76,6 +76,7 @@ private:
 	Comb comb[MAX_COMBS];
 	AllPass allpass[MAX_ALLPASS];
 	float *input_buffer = nullptr;
+	float *comb_buffer = nullptr; // Output of the comb being processed.
 	float *echo_buffer = nullptr;
 	int echo_buffer_size = 0;
 	int echo_buffer_pos = 0;
@@ -99,6 +100,7 @@ private:
 	void configure_buffers();
 	void update_parameters();
 	void clear_buffers();
+	void _process_comb_run(Comb &p_comb, const float *p_input, float *r_dst, int p_frames);
 
 public:
 	void set_room_size(float p_size);
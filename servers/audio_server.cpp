@@ -36,12 +36,15 @@
 #include "core/io/file_access.h"
 #include "core/io/resource_loader.h"
 #include "core/math/audio_frame.h"
+#include "core/object/worker_thread_pool.h"
 #include "core/os/os.h"
 #include "core/string/string_name.h"
 #include "core/templates/pair.h"
 #include "scene/resources/audio_stream_wav.h"
 #include "scene/scene_string_names.h"
 #include "servers/audio/audio_driver_dummy.h"
+#include "servers/audio/audio_resampler.h"
+#include "servers/audio/audio_simd.h"
 #include "servers/audio/effects/audio_effect_compressor.h"
 
 #include <cstring>
@@ -243,6 +246,8 @@ AudioDriver *AudioDriverManager::get_driver(int p_driver) {
 //////////////////////////////////////////////
 
 void AudioServer::_driver_process(int p_frames, int32_t *p_buffer) {
+	MemoryTagScope memory_tag(Memory::TAG_AUDIO);
+
 	mix_count++;
 	int todo = p_frames;
 
@@ -305,7 +310,7 @@ void AudioServer::_driver_process(int p_frames, int32_t *p_buffer) {
 }
 
 void AudioServer::_mix_step() {
-	bool solo_mode = false;
+	solo_mode = false;
 
 	for (int i = 0; i < buses.size(); i++) {
 		Bus *bus = buses[i];
@@ -345,47 +350,55 @@ void AudioServer::_mix_step() {
 		ci->callback(ci->userdata);
 	}
 
+	// Take the playbacks to mix once, so every one of them is decoded and mixed even if the list
+	// changes meanwhile. Paused streams are no-ops, don't even mix audio from the stream playback.
+	active_playbacks.clear();
 	for (AudioStreamPlaybackListNode *playback : playback_list) {
-		// Paused streams are no-ops. Don't even mix audio from the stream playback.
-		if (playback->state.load() == AudioStreamPlaybackListNode::PAUSED) {
-			continue;
+		if (playback->state.load() != AudioStreamPlaybackListNode::PAUSED) {
+			active_playbacks.push_back(playback);
 		}
+	}
 
-		bool fading_out = playback->state.load() == AudioStreamPlaybackListNode::FADE_OUT_TO_DELETION || playback->state.load() == AudioStreamPlaybackListNode::FADE_OUT_TO_PAUSE;
+	// Decode all playbacks first. The ones that allow it are spread over worker threads,
+	// while the others are decoded here in the meantime.
+	parallel_playbacks.clear();
+	serial_playbacks.clear();
+	for (AudioStreamPlaybackListNode *playback : active_playbacks) {
+		if (parallel_mixing && playback->stream_playback->can_mix_in_parallel()) {
+			parallel_playbacks.push_back(playback);
+		} else {
+			serial_playbacks.push_back(playback);
+		}
+	}
+	WorkerThreadPool::GroupID decode_task = -1;
+	if (parallel_playbacks.size() > 1) {
+		// High priority, the mix has to be done before the driver runs out of audio.
+		decode_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &AudioServer::_mix_playback_threaded, parallel_playbacks.ptr(), parallel_playbacks.size(), -1, true, SNAME("AudioServerMixPlaybacks"));
+	} else if (parallel_playbacks.size() == 1) {
+		serial_playbacks.push_back(parallel_playbacks[0]);
+	}
 
-		AudioFrame *buf = mix_buffer.ptrw();
+	for (AudioStreamPlaybackListNode *playback : serial_playbacks) {
+		_mix_playback(playback);
+	}
 
-		// Copy the lookeahead buffer into the mix buffer.
-		for (int i = 0; i < LOOKAHEAD_BUFFER_SIZE; i++) {
-			buf[i] = playback->lookahead[i];
-		}
+	if (decode_task != -1) {
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(decode_task);
+	}
 
-		// Mix the audio stream
-		unsigned int mixed_frames = playback->stream_playback->mix(&buf[LOOKAHEAD_BUFFER_SIZE], playback->pitch_scale.get(), buffer_size);
+	for (AudioStreamPlaybackListNode *playback : active_playbacks) {
+		bool fading_out = playback->state.load() == AudioStreamPlaybackListNode::FADE_OUT_TO_DELETION || playback->state.load() == AudioStreamPlaybackListNode::FADE_OUT_TO_PAUSE;
+
+		AudioFrame *buf = playback->mix_buffer.ptr();
 
 		if (tag_used_audio_streams && playback->stream_playback->is_playing()) {
 			playback->stream_playback->tag_used_streams();
 		}
 
-		if (mixed_frames != buffer_size) {
-			// We know we have at least the size of our lookahead buffer for fade-out purposes.
-
-			float fadeout_base = 0.94;
-			float fadeout_coefficient = 1;
-			static_assert(LOOKAHEAD_BUFFER_SIZE == 64, "Update fadeout_base and comment here if you change LOOKAHEAD_BUFFER_SIZE.");
-			// 0.94 ^ 64 = 0.01906. There might still be a pop but it'll be way better than if we didn't do this.
-			for (unsigned int idx = mixed_frames; idx < buffer_size; idx++) {
-				fadeout_coefficient *= fadeout_base;
-				buf[idx] *= fadeout_coefficient;
-			}
+		if (playback->mix_ended) {
 			AudioStreamPlaybackListNode::PlaybackState new_state;
 			new_state = AudioStreamPlaybackListNode::AWAITING_DELETION;
 			playback->state.store(new_state);
-		} else {
-			// Move the last little bit of what we just mixed into our lookahead buffer.
-			for (int i = 0; i < LOOKAHEAD_BUFFER_SIZE; i++) {
-				playback->lookahead[i] = buf[buffer_size + i];
-			}
 		}
 
 		AudioStreamPlaybackBusDetails *ptr = playback->bus_details.load();
@@ -483,131 +496,210 @@ void AudioServer::_mix_step() {
 		}
 	}
 
+	// Buses only send to buses with a lower index, so they can be sorted in waves where every bus
+	// only depends on buses of earlier waves. Buses within a wave are independent from each other.
+	// Effects which can't run in parallel (like sidechains reading other buses) keep the serial order.
+	bool parallel = parallel_mixing;
+	for (int i = 0; parallel && i < buses.size(); i++) {
+		for (int k = 0; parallel && k < buses[i]->channels.size(); k++) {
+			for (const Ref<AudioEffectInstance> &effect_instance : buses[i]->channels[k].effect_instances) {
+				if (effect_instance.is_valid() && !effect_instance->can_process_in_parallel()) {
+					parallel = false;
+					break;
+				}
+			}
+		}
+	}
+
+	bus_sends.resize(buses.size());
+	bus_waves.resize(buses.size());
+	for (int i = 0; i < buses.size(); i++) {
+		bus_waves[i] = parallel ? 0 : buses.size() - 1 - i; // One bus per wave when serial.
+	}
+
 	for (int i = buses.size() - 1; i >= 0; i--) {
-		//go bus by bus
 		Bus *bus = buses[i];
+		int send = -1;
 
-		for (int k = 0; k < bus->channels.size(); k++) {
-			if (bus->channels[k].active && !bus->channels[k].used) {
-				//buffer was not used, but it's still active, so it must be cleaned
-				AudioFrame *buf = bus->channels.write[k].buffer.ptrw();
-
-				for (uint32_t j = 0; j < buffer_size; j++) {
-					buf[j] = AudioFrame(0, 0);
+		if (i > 0) {
+			//everything has a send save for master bus
+			if (!bus_map.has(bus->send)) {
+				send = 0;
+			} else {
+				send = bus_map[bus->send]->index_cache;
+				if (send >= bus->index_cache) { //invalid, send to master
+					send = 0;
 				}
 			}
+			if (parallel) {
+				bus_waves[send] = MAX(bus_waves[send], bus_waves[i] + 1);
+			}
 		}
 
-		//process effects
-		if (!bus->bypass) {
-			for (int j = 0; j < bus->effects.size(); j++) {
-				if (!bus->effects[j].enabled) {
-					continue;
-				}
+		bus_sends[i] = send;
+	}
 
-#ifdef DEBUG_ENABLED
-				uint64_t ticks = OS::get_singleton()->get_ticks_usec();
-#endif
+	bus_order.clear();
+	for (int wave = 0; bus_order.size() < (uint32_t)buses.size(); wave++) {
+		uint32_t wave_start = bus_order.size();
+		for (int i = buses.size() - 1; i >= 0; i--) {
+			if (bus_waves[i] == wave) {
+				bus_order.push_back(i);
+			}
+		}
 
-				for (int k = 0; k < bus->channels.size(); k++) {
-					if (!(bus->channels[k].active || bus->channels[k].effect_instances[j]->process_silence())) {
-						continue;
-					}
-					bus->channels.write[k].effect_instances.write[j]->process(bus->channels[k].buffer.ptr(), temp_buffer.write[k].ptrw(), buffer_size);
-				}
+		uint32_t wave_size = bus_order.size() - wave_start;
+		if (wave_size > 1) {
+			WorkerThreadPool::GroupID bus_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &AudioServer::_process_bus_threaded, (const int *)&bus_order[wave_start], wave_size, -1, true, SNAME("AudioServerProcessBuses"));
+			WorkerThreadPool::get_singleton()->wait_for_group_task_completion(bus_task);
+		} else {
+			for (uint32_t j = wave_start; j < bus_order.size(); j++) {
+				_process_bus(bus_order[j]);
+			}
+		}
 
-				//swap buffers, so internal buffer always has the right data
-				for (int k = 0; k < bus->channels.size(); k++) {
-					if (!(buses[i]->channels[k].active || bus->channels[k].effect_instances[j]->process_silence())) {
-						continue;
-					}
-					SWAP(bus->channels.write[k].buffer, temp_buffer.write[k]);
+		//process send
+		for (uint32_t j = wave_start; j < bus_order.size(); j++) {
+			int i = bus_order[j];
+			if (bus_sends[i] == -1) {
+				continue;
+			}
+
+			Bus *bus = buses[i];
+			for (int k = 0; k < bus->channels.size(); k++) {
+				if (!bus->channels[k].active) {
+					continue;
 				}
 
-#ifdef DEBUG_ENABLED
-				bus->effects.write[j].prof_time += OS::get_singleton()->get_ticks_usec() - ticks;
-#endif
+				//if not master bus, send
+				AudioFrame *target_buf = thread_get_channel_mix_buffer(bus_sends[i], k);
+				audio_simd_mix(target_buf, bus->channels[k].buffer.ptr(), buffer_size);
 			}
 		}
+	}
 
-		//process send
+	mix_frames += buffer_size;
+	to_mix = buffer_size;
+}
 
-		Bus *send = nullptr;
+void AudioServer::_mix_playback(AudioStreamPlaybackListNode *p_playback) {
+	AudioFrame *buf = p_playback->mix_buffer.ptr();
 
-		if (i > 0) {
-			//everything has a send save for master bus
-			if (!bus_map.has(bus->send)) {
-				send = buses[0];
-			} else {
-				send = bus_map[bus->send];
-				if (send->index_cache >= bus->index_cache) { //invalid, send to master
-					send = buses[0];
-				}
-			}
+	// Copy the lookeahead buffer into the mix buffer.
+	for (int i = 0; i < LOOKAHEAD_BUFFER_SIZE; i++) {
+		buf[i] = p_playback->lookahead[i];
+	}
+
+	// Mix the audio stream
+	unsigned int mixed_frames = p_playback->stream_playback->mix(&buf[LOOKAHEAD_BUFFER_SIZE], p_playback->pitch_scale.get(), buffer_size);
+	p_playback->mix_ended = mixed_frames != buffer_size;
+
+	if (p_playback->mix_ended) {
+		// We know we have at least the size of our lookahead buffer for fade-out purposes.
+
+		float fadeout_base = 0.94;
+		float fadeout_coefficient = 1;
+		static_assert(LOOKAHEAD_BUFFER_SIZE == 64, "Update fadeout_base and comment here if you change LOOKAHEAD_BUFFER_SIZE.");
+		// 0.94 ^ 64 = 0.01906. There might still be a pop but it'll be way better than if we didn't do this.
+		for (unsigned int idx = mixed_frames; idx < buffer_size; idx++) {
+			fadeout_coefficient *= fadeout_base;
+			buf[idx] *= fadeout_coefficient;
+		}
+	} else {
+		// Move the last little bit of what we just mixed into our lookahead buffer.
+		for (int i = 0; i < LOOKAHEAD_BUFFER_SIZE; i++) {
+			p_playback->lookahead[i] = buf[buffer_size + i];
 		}
+	}
+}
 
-		for (int k = 0; k < bus->channels.size(); k++) {
-			if (!bus->channels[k].active) {
-				bus->channels.write[k].peak_volume = AudioFrame(AUDIO_MIN_PEAK_DB, AUDIO_MIN_PEAK_DB);
-				continue;
-			}
+void AudioServer::_mix_playback_threaded(uint32_t p_index, AudioStreamPlaybackListNode **p_playbacks) {
+	_mix_playback(p_playbacks[p_index]);
+}
+
+void AudioServer::_process_bus(int p_bus) {
+	Bus *bus = buses[p_bus];
 
+	for (int k = 0; k < bus->channels.size(); k++) {
+		if (bus->channels[k].active && !bus->channels[k].used) {
+			//buffer was not used, but it's still active, so it must be cleaned
 			AudioFrame *buf = bus->channels.write[k].buffer.ptrw();
+			memset(buf, 0, buffer_size * sizeof(AudioFrame));
+		}
+	}
 
-			AudioFrame peak = AudioFrame(0, 0);
+	//process effects
+	if (!bus->bypass) {
+		for (int j = 0; j < bus->effects.size(); j++) {
+			if (!bus->effects[j].enabled) {
+				continue;
+			}
 
-			float volume = Math::db_to_linear(bus->volume_db);
+#ifdef DEBUG_ENABLED
+			uint64_t ticks = OS::get_singleton()->get_ticks_usec();
+#endif
 
-			if (solo_mode) {
-				if (!bus->soloed) {
-					volume = 0.0;
-				}
-			} else {
-				if (bus->mute) {
-					volume = 0.0;
+			for (int k = 0; k < bus->channels.size(); k++) {
+				if (!(bus->channels[k].active || bus->channels[k].effect_instances[j]->process_silence())) {
+					continue;
 				}
+				bus->channels.write[k].effect_instances.write[j]->process(bus->channels[k].buffer.ptr(), bus->channels.write[k].temp_buffer.ptrw(), buffer_size);
 			}
 
-			//apply volume and compute peak
-			for (uint32_t j = 0; j < buffer_size; j++) {
-				buf[j] *= volume;
-
-				float l = ABS(buf[j].l);
-				if (l > peak.l) {
-					peak.l = l;
-				}
-				float r = ABS(buf[j].r);
-				if (r > peak.r) {
-					peak.r = r;
+			//swap buffers, so internal buffer always has the right data
+			for (int k = 0; k < bus->channels.size(); k++) {
+				if (!(bus->channels[k].active || bus->channels[k].effect_instances[j]->process_silence())) {
+					continue;
 				}
+				SWAP(bus->channels.write[k].buffer, bus->channels.write[k].temp_buffer);
 			}
 
-			bus->channels.write[k].peak_volume = AudioFrame(Math::linear_to_db(peak.l + AUDIO_PEAK_OFFSET), Math::linear_to_db(peak.r + AUDIO_PEAK_OFFSET));
+#ifdef DEBUG_ENABLED
+			bus->effects.write[j].prof_time += OS::get_singleton()->get_ticks_usec() - ticks;
+#endif
+		}
+	}
 
-			if (!bus->channels[k].used) {
-				//see if any audio is contained, because channel was not used
+	for (int k = 0; k < bus->channels.size(); k++) {
+		if (!bus->channels[k].active) {
+			bus->channels.write[k].peak_volume = AudioFrame(AUDIO_MIN_PEAK_DB, AUDIO_MIN_PEAK_DB);
+			continue;
+		}
 
-				if (MAX(peak.r, peak.l) > Math::db_to_linear(channel_disable_threshold_db)) {
-					bus->channels.write[k].last_mix_with_audio = mix_frames;
-				} else if (mix_frames - bus->channels[k].last_mix_with_audio > channel_disable_frames) {
-					bus->channels.write[k].active = false;
-					continue; //went inactive, don't mix.
-				}
+		AudioFrame *buf = bus->channels.write[k].buffer.ptrw();
+
+		float volume = Math::db_to_linear(bus->volume_db);
+
+		if (solo_mode) {
+			if (!bus->soloed) {
+				volume = 0.0;
+			}
+		} else {
+			if (bus->mute) {
+				volume = 0.0;
 			}
+		}
 
-			if (send) {
-				//if not master bus, send
-				AudioFrame *target_buf = thread_get_channel_mix_buffer(send->index_cache, k);
+		//apply volume and compute peak
+		AudioFrame peak = audio_simd_scale_peak(buf, volume, buffer_size);
 
-				for (uint32_t j = 0; j < buffer_size; j++) {
-					target_buf[j] += buf[j];
-				}
+		bus->channels.write[k].peak_volume = AudioFrame(Math::linear_to_db(peak.l + AUDIO_PEAK_OFFSET), Math::linear_to_db(peak.r + AUDIO_PEAK_OFFSET));
+
+		if (!bus->channels[k].used) {
+			//see if any audio is contained, because channel was not used
+
+			if (MAX(peak.r, peak.l) > Math::db_to_linear(channel_disable_threshold_db)) {
+				bus->channels.write[k].last_mix_with_audio = mix_frames;
+			} else if (mix_frames - bus->channels[k].last_mix_with_audio > channel_disable_frames) {
+				bus->channels.write[k].active = false;
+				continue; //went inactive, don't mix.
 			}
 		}
 	}
+}
 
-	mix_frames += buffer_size;
-	to_mix = buffer_size;
+void AudioServer::_process_bus_threaded(uint32_t p_index, const int *p_buses) {
+	_process_bus(p_buses[p_index]);
 }
 
 void AudioServer::_mix_step_for_channel(AudioFrame *p_out_buf, AudioFrame *p_source_buf, AudioFrame p_vol_start, AudioFrame p_vol_final, float p_attenuation_filter_cutoff_hz, float p_highshelf_gain, AudioFilterSW::Processor *p_processor_l, AudioFilterSW::Processor *p_processor_r) {
@@ -629,22 +721,15 @@ void AudioServer::_mix_step_for_channel(AudioFrame *p_out_buf, AudioFrame *p_sou
 		p_processor_r->set_filter(&filter, /* clear_history= */ is_just_started);
 		p_processor_r->update_coeffs(buffer_size);
 
-		for (unsigned int frame_idx = 0; frame_idx < buffer_size; frame_idx++) {
-			// Make this buffer size invariant if buffer_size ever becomes a project setting.
-			float lerp_param = (float)frame_idx / buffer_size;
-			AudioFrame vol = p_vol_final * lerp_param + (1 - lerp_param) * p_vol_start;
-			AudioFrame mixed = vol * p_source_buf[frame_idx];
-			p_processor_l->process_one_interp(mixed.l);
-			p_processor_r->process_one_interp(mixed.r);
-			p_out_buf[frame_idx] += mixed;
-		}
+		// Make this buffer size invariant if buffer_size ever becomes a project setting.
+		AudioFrame *filtered = filter_buffer.ptrw();
+		audio_simd_mix_ramp(filtered, p_source_buf, p_vol_start, p_vol_final, buffer_size, false);
+		AudioFilterSW::Processor::process_stereo(p_processor_l, p_processor_r, filtered, buffer_size, true);
+		audio_simd_mix(p_out_buf, filtered, buffer_size);
 
 	} else {
-		for (unsigned int frame_idx = 0; frame_idx < buffer_size; frame_idx++) {
-			// Make this buffer size invariant if buffer_size ever becomes a project setting.
-			float lerp_param = (float)frame_idx / buffer_size;
-			p_out_buf[frame_idx] += (p_vol_final * lerp_param + (1 - lerp_param) * p_vol_start) * p_source_buf[frame_idx];
-		}
+		// Make this buffer size invariant if buffer_size ever becomes a project setting.
+		audio_simd_mix_ramp(p_out_buf, p_source_buf, p_vol_start, p_vol_final, buffer_size, true);
 	}
 }
 
@@ -739,6 +824,7 @@ void AudioServer::set_bus_count(int p_count) {
 		buses.write[i]->channels.resize(channel_count);
 		for (int j = 0; j < channel_count; j++) {
 			buses.write[i]->channels.write[j].buffer.resize(buffer_size);
+			buses.write[i]->channels.write[j].temp_buffer.resize(buffer_size);
 		}
 		buses[i]->name = attempt;
 		buses[i]->solo = false;
@@ -808,6 +894,7 @@ void AudioServer::add_bus(int p_at_pos) {
 	bus->channels.resize(channel_count);
 	for (int j = 0; j < channel_count; j++) {
 		bus->channels.write[j].buffer.resize(buffer_size);
+		bus->channels.write[j].temp_buffer.resize(buffer_size);
 	}
 	bus->name = attempt;
 	bus->solo = false;
@@ -1133,6 +1220,7 @@ void AudioServer::start_playback_stream(Ref<AudioStreamPlayback> p_playback, Has
 	AudioStreamPlaybackListNode *playback_node = new AudioStreamPlaybackListNode();
 	playback_node->stream_playback = p_playback;
 	playback_node->stream_playback->start(p_start_time);
+	playback_node->mix_buffer.resize(buffer_size + LOOKAHEAD_BUFFER_SIZE);
 
 	AudioStreamPlaybackBusDetails *new_bus_details = new AudioStreamPlaybackBusDetails();
 	int idx = 0;
@@ -1339,17 +1427,13 @@ void AudioServer::notify_listener_changed() {
 
 void AudioServer::init_channels_and_buffers() {
 	channel_count = get_channel_count();
-	temp_buffer.resize(channel_count);
-	mix_buffer.resize(buffer_size + LOOKAHEAD_BUFFER_SIZE);
-
-	for (int i = 0; i < temp_buffer.size(); i++) {
-		temp_buffer.write[i].resize(buffer_size);
-	}
+	filter_buffer.resize(buffer_size);
 
 	for (int i = 0; i < buses.size(); i++) {
 		buses[i]->channels.resize(channel_count);
 		for (int j = 0; j < channel_count; j++) {
 			buses.write[i]->channels.write[j].buffer.resize(buffer_size);
+			buses.write[i]->channels.write[j].temp_buffer.resize(buffer_size);
 		}
 		_update_bus_effects(i);
 	}
@@ -1359,6 +1443,8 @@ void AudioServer::init() {
 	channel_disable_threshold_db = GLOBAL_DEF_RST("audio/buses/channel_disable_threshold_db", -60.0);
 	channel_disable_frames = float(GLOBAL_DEF_RST(PropertyInfo(Variant::FLOAT, "audio/buses/channel_disable_time", PROPERTY_HINT_RANGE, "0,5,0.01,or_greater"), 2.0)) * get_mix_rate();
 	buffer_size = 512; //hardcoded for now
+	parallel_mixing = GLOBAL_DEF_RST("audio/general/parallel_mixing", false);
+	AudioResampler::set_quality(AudioResampler::Quality(int(GLOBAL_DEF_RST(PropertyInfo(Variant::INT, "audio/general/resampler_quality", PROPERTY_HINT_ENUM, "Cubic,Sinc (8 Taps),Sinc (16 Taps)"), 0))));
 
 	init_channels_and_buffers();
 
@@ -1614,6 +1700,7 @@ void AudioServer::set_bus_layout(const Ref<AudioBusLayout> &p_bus_layout) {
 		buses[i]->channels.resize(channel_count);
 		for (int j = 0; j < channel_count; j++) {
 			buses.write[i]->channels.write[j].buffer.resize(buffer_size);
+			buses.write[i]->channels.write[j].temp_buffer.resize(buffer_size);
 		}
 		_update_bus_effects(i);
 	}
@@ -34,6 +34,7 @@
 #include "core/math/audio_frame.h"
 #include "core/object/class_db.h"
 #include "core/os/os.h"
+#include "core/templates/local_vector.h"
 #include "core/templates/safe_list.h"
 #include "core/variant/variant.h"
 #include "servers/audio/audio_effect.h"
@@ -195,6 +196,7 @@ private:
 	float playback_speed_scale = 1.0f;
 
 	bool tag_used_audio_streams = false;
+	bool parallel_mixing = false;
 
 	struct Bus {
 		StringName name;
@@ -210,6 +212,7 @@ private:
 			bool active = false;
 			AudioFrame peak_volume = AudioFrame(AUDIO_MIN_PEAK_DB, AUDIO_MIN_PEAK_DB);
 			Vector<AudioFrame> buffer;
+			Vector<AudioFrame> temp_buffer; // Effects write here, then it's swapped with the buffer.
 			Vector<Ref<AudioEffectInstance>> effect_instances;
 			uint64_t last_mix_with_audio = 0;
 			Channel() {}
@@ -261,6 +264,9 @@ private:
 		AudioStreamPlaybackBusDetails *prev_bus_details = nullptr;
 		// The next few samples are stored here so we have some time to fade audio out if it ends abruptly at the beginning of the next mix.
 		AudioFrame lookahead[LOOKAHEAD_BUFFER_SIZE];
+		// Frames decoded for the current mix step, which may happen on a worker thread.
+		LocalVector<AudioFrame> mix_buffer;
+		bool mix_ended = false;
 	};
 
 	SafeList<AudioStreamPlaybackListNode *> playback_list;
@@ -269,8 +275,7 @@ private:
 	// TODO document if this is necessary.
 	SafeList<AudioStreamPlaybackBusDetails *> bus_details_graveyard_frame_old;
 
-	Vector<Vector<AudioFrame>> temp_buffer; //temp_buffer for each level
-	Vector<AudioFrame> mix_buffer;
+	Vector<AudioFrame> filter_buffer; // Ramped playback before the attenuation filter is applied.
 	Vector<Bus *> buses;
 	HashMap<StringName, Bus *> bus_map;
 
@@ -280,7 +285,20 @@ private:
 
 	void init_channels_and_buffers();
 
+	// Scratch lists for the mix step, kept around to avoid allocating on the audio thread.
+	LocalVector<AudioStreamPlaybackListNode *> active_playbacks;
+	LocalVector<AudioStreamPlaybackListNode *> parallel_playbacks;
+	LocalVector<AudioStreamPlaybackListNode *> serial_playbacks;
+	LocalVector<int> bus_sends;
+	LocalVector<int> bus_waves;
+	LocalVector<int> bus_order;
+	bool solo_mode = false;
+
 	void _mix_step();
+	void _mix_playback(AudioStreamPlaybackListNode *p_playback);
+	void _mix_playback_threaded(uint32_t p_index, AudioStreamPlaybackListNode **p_playbacks);
+	void _process_bus(int p_bus);
+	void _process_bus_threaded(uint32_t p_index, const int *p_buses);
 	void _mix_step_for_channel(AudioFrame *p_out_buf, AudioFrame *p_source_buf, AudioFrame p_vol_start, AudioFrame p_vol_final, float p_attenuation_filter_cutoff_hz, float p_highshelf_gain, AudioFilterSW::Processor *p_processor_l, AudioFilterSW::Processor *p_processor_r);
 
 	// Should only be called on the main thread.
@@ -137,6 +137,7 @@ void GodotBody2D::set_active(bool p_active) {
 	active = p_active;
 
 	if (active) {
+		set_sleeping_island(0);
 		if (mode == PhysicsServer2D::BODY_MODE_STATIC) {
 			// Static bodies can't be active.
 			active = false;
@@ -148,6 +149,22 @@ void GodotBody2D::set_active(bool p_active) {
 	}
 }
 
+void GodotBody2D::set_sleeping_island(uint64_t p_island) {
+	if (sleeping_island == p_island) {
+		return;
+	}
+
+	if (get_space()) {
+		if (sleeping_island) {
+			get_space()->sleeping_island_remove_body(sleeping_island);
+		}
+		if (p_island) {
+			get_space()->sleeping_island_add_body(p_island);
+		}
+	}
+	sleeping_island = p_island;
+}
+
 void GodotBody2D::set_param(PhysicsServer2D::BodyParameter p_param, const Variant &p_value) {
 	switch (p_param) {
 		case PhysicsServer2D::BODY_PARAM_BOUNCE: {
@@ -261,6 +278,7 @@ void GodotBody2D::set_mode(PhysicsServer2D::BodyMode p_mode) {
 			_inv_inertia = 0;
 			_set_static(p_mode == PhysicsServer2D::BODY_MODE_STATIC);
 			set_active(p_mode == PhysicsServer2D::BODY_MODE_KINEMATIC && contacts.size());
+			set_sleeping_island(0);
 			linear_velocity = Vector2();
 			angular_velocity = 0;
 			if (mode == PhysicsServer2D::BODY_MODE_KINEMATIC && prev != mode) {
@@ -391,6 +409,7 @@ Variant GodotBody2D::get_state(PhysicsServer2D::BodyState p_state) const {
 void GodotBody2D::set_space(GodotSpace2D *p_space) {
 	if (get_space()) {
 		wakeup_neighbours();
+		set_sleeping_island(0);
 
 		if (mass_properties_update_list.in_list()) {
 			get_space()->body_remove_from_mass_properties_update_list(&mass_properties_update_list);
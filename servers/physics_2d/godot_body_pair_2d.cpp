@@ -38,6 +38,11 @@
 #define MIN_VELOCITY 0.001
 #define MAX_BIAS_ROTATION (Math_PI / 8)
 
+// How far, relative to the contact recycle radius, and how much (in radians) B can move relative to A
+// before the contacts are searched again.
+#define CONTACT_REUSE_MAX_DISTANCE 0.1
+#define CONTACT_REUSE_MAX_ROTATION 0.01
+
 void GodotBodyPair2D::_add_contact(const Vector2 &p_point_A, const Vector2 &p_point_B, void *p_self) {
 	GodotBodyPair2D *self = static_cast<GodotBodyPair2D *>(p_self);
 
@@ -161,6 +166,44 @@ void GodotBodyPair2D::_validate_contacts() {
 	}
 }
 
+// Contacts are stored relative to each body, so while the bodies barely move relative to each other
+// (like in resting stacks), the ones found by the last collision test are still valid and the
+// narrowphase can be skipped. Drift is measured from the last test, so it can't accumulate.
+// Contact normals are in world space, so the pair must not have rotated as a whole either.
+bool GodotBodyPair2D::_can_reuse_contacts(const Transform2D &p_xform_A, const Transform2D &p_xform_AB, const GodotShape2D *p_shape_A, const GodotShape2D *p_shape_B, const Vector2 &p_motion_A, const Vector2 &p_motion_B) const {
+	if (!collided || oneway_disabled || contact_count == 0) {
+		return false;
+	}
+
+	// Casting shapes need a new test every step.
+	if (p_motion_A != Vector2() || p_motion_B != Vector2()) {
+		return false;
+	}
+
+	if (p_shape_A->get_version() != solved_version_A || p_shape_B->get_version() != solved_version_B) {
+		return false;
+	}
+
+	const real_t max_distance = space->get_contact_recycle_radius() * CONTACT_REUSE_MAX_DISTANCE;
+	if (p_xform_AB.columns[2].distance_squared_to(solved_xform_AB.columns[2]) > max_distance * max_distance) {
+		return false;
+	}
+
+	for (int i = 0; i < 2; i++) {
+		const real_t max_difference = solved_xform_AB.columns[i].length() * CONTACT_REUSE_MAX_ROTATION;
+		if (p_xform_AB.columns[i].distance_squared_to(solved_xform_AB.columns[i]) > max_difference * max_difference) {
+			return false;
+		}
+		// With the relative rotation bounded, bounding the rotation of A also bounds the rotation of B.
+		const real_t max_difference_A = solved_xform_A.columns[i].length() * CONTACT_REUSE_MAX_ROTATION;
+		if (p_xform_A.columns[i].distance_squared_to(solved_xform_A.columns[i]) > max_difference_A * max_difference_A) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
 // _test_ccd prevents tunneling by slowing down a high velocity body that is about to collide so that next frame it will be at an appropriate location to collide (i.e. slight overlap)
 // Warning: the way velocity is adjusted down to cause a collision means the momentum will be weaker than it should for a bounce!
 // Process: only proceed if body A's motion is high relative to its size.
@@ -291,10 +334,23 @@ bool GodotBodyPair2D::setup(real_t p_step) {
 		motion_B = B->get_motion();
 	}
 
+	Transform2D xform_AB = xform_A.affine_inverse() * xform_B;
+	if (_can_reuse_contacts(xform_A, xform_AB, shape_A_ptr, shape_B_ptr, motion_A, motion_B)) {
+		for (int i = 0; i < contact_count; i++) {
+			contacts[i].used = true;
+		}
+		return true;
+	}
+
 	bool prev_collided = collided;
 
 	collided = GodotCollisionSolver2D::solve(shape_A_ptr, xform_A, motion_A, shape_B_ptr, xform_B, motion_B, _add_contact, this, &sep_axis);
-	if (!collided) {
+	if (collided) {
+		solved_xform_A = xform_A;
+		solved_xform_AB = xform_AB;
+		solved_version_A = shape_A_ptr->get_version();
+		solved_version_B = shape_B_ptr->get_version();
+	} else {
 		oneway_disabled = false;
 
 		if (A->get_continuous_collision_detection_mode() == PhysicsServer2D::CCD_MODE_CAST_RAY && collide_A) {
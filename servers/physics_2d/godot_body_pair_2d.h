@@ -84,6 +84,13 @@ class GodotBodyPair2D : public GodotConstraint2D {
 	bool oneway_disabled = false;
 	bool report_contacts_only = false;
 
+	// State of the last collision test, to tell whether its contacts can be kept as they are.
+	Transform2D solved_xform_A;
+	Transform2D solved_xform_AB;
+	uint32_t solved_version_A = 0;
+	uint32_t solved_version_B = 0;
+
+	bool _can_reuse_contacts(const Transform2D &p_xform_A, const Transform2D &p_xform_AB, const GodotShape2D *p_shape_A, const GodotShape2D *p_shape_B, const Vector2 &p_motion_A, const Vector2 &p_motion_B) const;
 	bool _test_ccd(real_t p_step, GodotBody2D *p_A, int p_shape_A, const Transform2D &p_xform_A, GodotBody2D *p_B, int p_shape_B, const Transform2D &p_xform_B);
 	void _validate_contacts();
 	static void _add_contact(const Vector2 &p_point_A, const Vector2 &p_point_B, void *p_self);
@@ -58,6 +58,8 @@ public:
 	virtual int get_subindex(ID p_id) const = 0;
 
 	virtual int cull_segment(const Vector2 &p_from, const Vector2 &p_to, GodotCollisionObject2D **p_results, int p_max_results, int *p_result_indices = nullptr) = 0;
+	// Culls p_count segments at once. Results of segment n start at p_results[n * p_max_results], and their amount is written to r_result_counts[n].
+	virtual void cull_segments(const Vector2 *p_from, const Vector2 *p_to, int p_count, GodotCollisionObject2D **p_results, int *r_result_counts, int p_max_results, int *p_result_indices = nullptr) = 0;
 	virtual int cull_aabb(const Rect2 &p_aabb, GodotCollisionObject2D **p_results, int p_max_results, int *p_result_indices = nullptr) = 0;
 
 	virtual void set_pair_callback(PairCallback p_pair_callback, void *p_userdata) = 0;
@@ -77,6 +77,10 @@ int GodotBroadPhase2DBVH::cull_segment(const Vector2 &p_from, const Vector2 &p_t
 	return bvh.cull_segment(p_from, p_to, p_results, p_max_results, nullptr, 0xFFFFFFFF, p_result_indices);
 }
 
+void GodotBroadPhase2DBVH::cull_segments(const Vector2 *p_from, const Vector2 *p_to, int p_count, GodotCollisionObject2D **p_results, int *r_result_counts, int p_max_results, int *p_result_indices) {
+	bvh.cull_segments(p_from, p_to, p_count, p_results, r_result_counts, p_max_results, nullptr, 0xFFFFFFFF, p_result_indices);
+}
+
 int GodotBroadPhase2DBVH::cull_aabb(const Rect2 &p_aabb, GodotCollisionObject2D **p_results, int p_max_results, int *p_result_indices) {
 	return bvh.cull_aabb(p_aabb, p_results, p_max_results, nullptr, 0xFFFFFFFF, p_result_indices);
 }
@@ -1288,6 +1288,8 @@ void GodotPhysicsServer2D::init() {
 }
 
 void GodotPhysicsServer2D::step(real_t p_step) {
+	MemoryTagScope memory_tag(Memory::TAG_PHYSICS);
+
 	if (!active) {
 		return;
 	}
@@ -1295,11 +1297,15 @@ void GodotPhysicsServer2D::step(real_t p_step) {
 	_update_shapes();
 
 	island_count = 0;
+	active_island_count = 0;
+	sleeping_island_count = 0;
 	active_objects = 0;
 	collision_pairs = 0;
 	for (const GodotSpace2D *E : active_spaces) {
 		stepper->step(const_cast<GodotSpace2D *>(E), p_step);
 		island_count += E->get_island_count();
+		active_island_count += E->get_active_island_count();
+		sleeping_island_count += E->get_sleeping_island_count();
 		active_objects += E->get_active_objects();
 		collision_pairs += E->get_collision_pairs();
 	}
@@ -1385,6 +1391,12 @@ int GodotPhysicsServer2D::get_process_info(ProcessInfo p_info) {
 		case INFO_ISLAND_COUNT: {
 			return island_count;
 		} break;
+		case INFO_ACTIVE_ISLAND_COUNT: {
+			return active_island_count;
+		} break;
+		case INFO_SLEEPING_ISLAND_COUNT: {
+			return sleeping_island_count;
+		} break;
 	}
 
 	return 0;
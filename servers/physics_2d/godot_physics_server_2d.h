@@ -48,6 +48,8 @@ class GodotPhysicsServer2D : public PhysicsServer2D {
 	bool doing_sync = false;
 
 	int island_count = 0;
+	int active_island_count = 0;
+	int sleeping_island_count = 0;
 	int active_objects = 0;
 	int collision_pairs = 0;
 
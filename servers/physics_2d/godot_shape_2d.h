@@ -47,6 +47,7 @@ class GodotShape2D {
 	RID self;
 	Rect2 aabb;
 	bool configured = false;
+	uint32_t version = 0;
 	real_t custom_bias = 0.0;
 
 	HashMap<GodotShapeOwner2D *, int> owners;
@@ -66,6 +67,8 @@ public:
 
 	_FORCE_INLINE_ Rect2 get_aabb() const { return aabb; }
 	_FORCE_INLINE_ bool is_configured() const { return configured; }
+	// Changes every time the shape data is set, so cached collision results can be invalidated.
+	_FORCE_INLINE_ uint32_t get_version() const { return version; }
 
 	virtual bool allows_one_way_collision() const { return true; }
 
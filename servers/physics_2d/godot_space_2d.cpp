@@ -33,6 +33,7 @@
 #include "godot_collision_solver_2d.h"
 #include "godot_physics_server_2d.h"
 
+#include "core/object/worker_thread_pool.h"
 #include "core/os/os.h"
 #include "core/templates/pair.h"
 
@@ -114,37 +115,31 @@ int GodotPhysicsDirectSpaceState2D::intersect_point(const PointParameters &p_par
 	return cc;
 }
 
-bool GodotPhysicsDirectSpaceState2D::intersect_ray(const RayParameters &p_parameters, RayResult &r_result) {
-	ERR_FAIL_COND_V(space->locked, false);
-
+bool GodotPhysicsDirectSpaceState2D::_intersect_ray(const RayParameters &p_parameters, const Vector2 &p_from, const Vector2 &p_to, GodotCollisionObject2D *const *p_objects, const int *p_subindices, int p_amount, RayResult &r_result) {
 	Vector2 begin, end;
 	Vector2 normal;
-	begin = p_parameters.from;
-	end = p_parameters.to;
+	begin = p_from;
+	end = p_to;
 	normal = (end - begin).normalized();
 
-	int amount = space->broadphase->cull_segment(begin, end, space->intersection_query_results, GodotSpace2D::INTERSECTION_QUERY_MAX, space->intersection_query_subindex_results);
-
-	//todo, create another array that references results, compute AABBs and check closest point to ray origin, sort, and stop evaluating results when beyond first collision
-
 	bool collided = false;
 	Vector2 res_point, res_normal;
 	int res_shape = -1;
 	const GodotCollisionObject2D *res_obj = nullptr;
 	real_t min_d = 1e10;
 
-	for (int i = 0; i < amount; i++) {
-		if (!_can_collide_with(space->intersection_query_results[i], p_parameters.collision_mask, p_parameters.collide_with_bodies, p_parameters.collide_with_areas)) {
+	for (int i = 0; i < p_amount; i++) {
+		if (!_can_collide_with(p_objects[i], p_parameters.collision_mask, p_parameters.collide_with_bodies, p_parameters.collide_with_areas)) {
 			continue;
 		}
 
-		if (p_parameters.exclude.has(space->intersection_query_results[i]->get_self())) {
+		if (p_parameters.exclude.has(p_objects[i]->get_self())) {
 			continue;
 		}
 
-		const GodotCollisionObject2D *col_obj = space->intersection_query_results[i];
+		const GodotCollisionObject2D *col_obj = p_objects[i];
 
-		int shape_idx = space->intersection_query_subindex_results[i];
+		int shape_idx = p_subindices[i];
 		Transform2D inv_xform = col_obj->get_shape_inv_transform(shape_idx) * col_obj->get_inv_transform();
 
 		Vector2 local_from = inv_xform.xform(begin);
@@ -204,19 +199,22 @@ bool GodotPhysicsDirectSpaceState2D::intersect_ray(const RayParameters &p_parame
 	return true;
 }
 
-int GodotPhysicsDirectSpaceState2D::intersect_shape(const ShapeParameters &p_parameters, ShapeResult *r_results, int p_result_max) {
-	if (p_result_max <= 0) {
-		return 0;
-	}
+bool GodotPhysicsDirectSpaceState2D::intersect_ray(const RayParameters &p_parameters, RayResult &r_result) {
+	ERR_FAIL_COND_V(space->locked, false);
 
-	GodotShape2D *shape = GodotPhysicsServer2D::godot_singleton->shape_owner.get_or_null(p_parameters.shape_rid);
-	ERR_FAIL_NULL_V(shape, 0);
+	int amount = space->broadphase->cull_segment(p_parameters.from, p_parameters.to, space->intersection_query_results, GodotSpace2D::INTERSECTION_QUERY_MAX, space->intersection_query_subindex_results);
 
-	Rect2 aabb = p_parameters.transform.xform(shape->get_aabb());
+	//todo, create another array that references results, compute AABBs and check closest point to ray origin, sort, and stop evaluating results when beyond first collision
+
+	return _intersect_ray(p_parameters, p_parameters.from, p_parameters.to, space->intersection_query_results, space->intersection_query_subindex_results, amount, r_result);
+}
+
+int GodotPhysicsDirectSpaceState2D::_intersect_shape(GodotShape2D *p_shape, const ShapeParameters &p_parameters, const Transform2D &p_transform, GodotCollisionObject2D **r_objects, int *r_subindices, ShapeResult *r_results, int p_result_max) {
+	Rect2 aabb = p_transform.xform(p_shape->get_aabb());
 	aabb = aabb.merge(Rect2(aabb.position + p_parameters.motion, aabb.size)); //motion
 	aabb = aabb.grow(p_parameters.margin);
 
-	int amount = space->broadphase->cull_aabb(aabb, space->intersection_query_results, GodotSpace2D::INTERSECTION_QUERY_MAX, space->intersection_query_subindex_results);
+	int amount = space->broadphase->cull_aabb(aabb, r_objects, GodotSpace2D::INTERSECTION_QUERY_MAX, r_subindices);
 
 	int cc = 0;
 
@@ -225,18 +223,18 @@ int GodotPhysicsDirectSpaceState2D::intersect_shape(const ShapeParameters &p_par
 			break;
 		}
 
-		if (!_can_collide_with(space->intersection_query_results[i], p_parameters.collision_mask, p_parameters.collide_with_bodies, p_parameters.collide_with_areas)) {
+		if (!_can_collide_with(r_objects[i], p_parameters.collision_mask, p_parameters.collide_with_bodies, p_parameters.collide_with_areas)) {
 			continue;
 		}
 
-		if (p_parameters.exclude.has(space->intersection_query_results[i]->get_self())) {
+		if (p_parameters.exclude.has(r_objects[i]->get_self())) {
 			continue;
 		}
 
-		const GodotCollisionObject2D *col_obj = space->intersection_query_results[i];
-		int shape_idx = space->intersection_query_subindex_results[i];
+		const GodotCollisionObject2D *col_obj = r_objects[i];
+		int shape_idx = r_subindices[i];
 
-		if (!GodotCollisionSolver2D::solve(shape, p_parameters.transform, p_parameters.motion, col_obj->get_shape(shape_idx), col_obj->get_transform() * col_obj->get_shape_transform(shape_idx), Vector2(), nullptr, nullptr, nullptr, p_parameters.margin)) {
+		if (!GodotCollisionSolver2D::solve(p_shape, p_transform, p_parameters.motion, col_obj->get_shape(shape_idx), col_obj->get_transform() * col_obj->get_shape_transform(shape_idx), Vector2(), nullptr, nullptr, nullptr, p_parameters.margin)) {
 			continue;
 		}
 
@@ -253,39 +251,47 @@ int GodotPhysicsDirectSpaceState2D::intersect_shape(const ShapeParameters &p_par
 	return cc;
 }
 
-bool GodotPhysicsDirectSpaceState2D::cast_motion(const ShapeParameters &p_parameters, real_t &p_closest_safe, real_t &p_closest_unsafe) {
+int GodotPhysicsDirectSpaceState2D::intersect_shape(const ShapeParameters &p_parameters, ShapeResult *r_results, int p_result_max) {
+	if (p_result_max <= 0) {
+		return 0;
+	}
+
 	GodotShape2D *shape = GodotPhysicsServer2D::godot_singleton->shape_owner.get_or_null(p_parameters.shape_rid);
-	ERR_FAIL_NULL_V(shape, false);
+	ERR_FAIL_NULL_V(shape, 0);
 
-	Rect2 aabb = p_parameters.transform.xform(shape->get_aabb());
+	return _intersect_shape(shape, p_parameters, p_parameters.transform, space->intersection_query_results, space->intersection_query_subindex_results, r_results, p_result_max);
+}
+
+void GodotPhysicsDirectSpaceState2D::_cast_motion(GodotShape2D *p_shape, const ShapeParameters &p_parameters, const Transform2D &p_transform, GodotCollisionObject2D **r_objects, int *r_subindices, real_t &p_closest_safe, real_t &p_closest_unsafe) {
+	Rect2 aabb = p_transform.xform(p_shape->get_aabb());
 	aabb = aabb.merge(Rect2(aabb.position + p_parameters.motion, aabb.size)); //motion
 	aabb = aabb.grow(p_parameters.margin);
 
-	int amount = space->broadphase->cull_aabb(aabb, space->intersection_query_results, GodotSpace2D::INTERSECTION_QUERY_MAX, space->intersection_query_subindex_results);
+	int amount = space->broadphase->cull_aabb(aabb, r_objects, GodotSpace2D::INTERSECTION_QUERY_MAX, r_subindices);
 
 	real_t best_safe = 1;
 	real_t best_unsafe = 1;
 
 	for (int i = 0; i < amount; i++) {
-		if (!_can_collide_with(space->intersection_query_results[i], p_parameters.collision_mask, p_parameters.collide_with_bodies, p_parameters.collide_with_areas)) {
+		if (!_can_collide_with(r_objects[i], p_parameters.collision_mask, p_parameters.collide_with_bodies, p_parameters.collide_with_areas)) {
 			continue;
 		}
 
-		if (p_parameters.exclude.has(space->intersection_query_results[i]->get_self())) {
+		if (p_parameters.exclude.has(r_objects[i]->get_self())) {
 			continue; //ignore excluded
 		}
 
-		const GodotCollisionObject2D *col_obj = space->intersection_query_results[i];
-		int shape_idx = space->intersection_query_subindex_results[i];
+		const GodotCollisionObject2D *col_obj = r_objects[i];
+		int shape_idx = r_subindices[i];
 
 		Transform2D col_obj_xform = col_obj->get_transform() * col_obj->get_shape_transform(shape_idx);
 		//test initial overlap, does it collide if going all the way?
-		if (!GodotCollisionSolver2D::solve(shape, p_parameters.transform, p_parameters.motion, col_obj->get_shape(shape_idx), col_obj_xform, Vector2(), nullptr, nullptr, nullptr, p_parameters.margin)) {
+		if (!GodotCollisionSolver2D::solve(p_shape, p_transform, p_parameters.motion, col_obj->get_shape(shape_idx), col_obj_xform, Vector2(), nullptr, nullptr, nullptr, p_parameters.margin)) {
 			continue;
 		}
 
 		//test initial overlap, ignore objects it's inside of.
-		if (GodotCollisionSolver2D::solve(shape, p_parameters.transform, Vector2(), col_obj->get_shape(shape_idx), col_obj_xform, Vector2(), nullptr, nullptr, nullptr, p_parameters.margin)) {
+		if (GodotCollisionSolver2D::solve(p_shape, p_transform, Vector2(), col_obj->get_shape(shape_idx), col_obj_xform, Vector2(), nullptr, nullptr, nullptr, p_parameters.margin)) {
 			continue;
 		}
 
@@ -299,7 +305,7 @@ bool GodotPhysicsDirectSpaceState2D::cast_motion(const ShapeParameters &p_parame
 			real_t fraction = low + (hi - low) * fraction_coeff;
 
 			Vector2 sep = mnormal; //important optimization for this to work fast enough
-			bool collided = GodotCollisionSolver2D::solve(shape, p_parameters.transform, p_parameters.motion * fraction, col_obj->get_shape(shape_idx), col_obj_xform, Vector2(), nullptr, nullptr, &sep, p_parameters.margin);
+			bool collided = GodotCollisionSolver2D::solve(p_shape, p_transform, p_parameters.motion * fraction, col_obj->get_shape(shape_idx), col_obj_xform, Vector2(), nullptr, nullptr, &sep, p_parameters.margin);
 
 			if (collided) {
 				hi = fraction;
@@ -332,6 +338,13 @@ bool GodotPhysicsDirectSpaceState2D::cast_motion(const ShapeParameters &p_parame
 
 	p_closest_safe = best_safe;
 	p_closest_unsafe = best_unsafe;
+}
+
+bool GodotPhysicsDirectSpaceState2D::cast_motion(const ShapeParameters &p_parameters, real_t &p_closest_safe, real_t &p_closest_unsafe) {
+	GodotShape2D *shape = GodotPhysicsServer2D::godot_singleton->shape_owner.get_or_null(p_parameters.shape_rid);
+	ERR_FAIL_NULL_V(shape, false);
+
+	_cast_motion(shape, p_parameters, p_parameters.transform, space->intersection_query_results, space->intersection_query_subindex_results, p_closest_safe, p_closest_unsafe);
 
 	return true;
 }
@@ -500,6 +513,135 @@ bool GodotPhysicsDirectSpaceState2D::rest_info(const ShapeParameters &p_paramete
 	return true;
 }
 
+void GodotPhysicsDirectSpaceState2D::_run_batch(void (GodotPhysicsDirectSpaceState2D::*p_task)(uint32_t, void *), void *p_batch, int p_count, const StringName &p_name) {
+	const int task_count = (p_count + GodotSpace2D::BATCH_QUERY_TASK_SIZE - 1) / GodotSpace2D::BATCH_QUERY_TASK_SIZE;
+	if (task_count > 1) {
+		WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, p_task, p_batch, task_count, -1, true, p_name);
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+	} else if (task_count == 1) {
+		(this->*p_task)(0, p_batch);
+	}
+}
+
+void GodotPhysicsDirectSpaceState2D::_intersect_rays_task(uint32_t p_task_index, void *p_batch) {
+	const RayBatch &batch = *static_cast<RayBatch *>(p_batch);
+	const int begin = p_task_index * GodotSpace2D::BATCH_QUERY_TASK_SIZE;
+	const int end = MIN(begin + GodotSpace2D::BATCH_QUERY_TASK_SIZE, batch.count);
+
+	LocalVector<GodotCollisionObject2D *> objects;
+	LocalVector<int> subindices;
+	objects.resize(GodotSpace2D::RAY_PACKET_SIZE * GodotSpace2D::RAY_PACKET_QUERY_MAX);
+	subindices.resize(GodotSpace2D::RAY_PACKET_SIZE * GodotSpace2D::RAY_PACKET_QUERY_MAX);
+	int amounts[GodotSpace2D::RAY_PACKET_SIZE];
+	LocalVector<GodotCollisionObject2D *> overflow_objects;
+	LocalVector<int> overflow_subindices;
+
+	for (int packet = begin; packet < end; packet += GodotSpace2D::RAY_PACKET_SIZE) {
+		const int packet_size = MIN(int(GodotSpace2D::RAY_PACKET_SIZE), end - packet);
+		// Rays cast together usually start close to each other, so they visit mostly the same broadphase nodes.
+		space->broadphase->cull_segments(batch.from + packet, batch.to + packet, packet_size, objects.ptr(), amounts, GodotSpace2D::RAY_PACKET_QUERY_MAX, subindices.ptr());
+
+		for (int i = 0; i < packet_size; i++) {
+			const Vector2 &from = batch.from[packet + i];
+			const Vector2 &to = batch.to[packet + i];
+			if (amounts[i] < GodotSpace2D::RAY_PACKET_QUERY_MAX) {
+				const int offset = i * GodotSpace2D::RAY_PACKET_QUERY_MAX;
+				batch.hits[packet + i] = _intersect_ray(*batch.parameters, from, to, objects.ptr() + offset, subindices.ptr() + offset, amounts[i], batch.results[packet + i]);
+				continue;
+			}
+			// The packet ran out of room for this ray and may have missed its closest hit, cull it on its own like intersect_ray() does.
+			if (overflow_objects.is_empty()) {
+				overflow_objects.resize(GodotSpace2D::INTERSECTION_QUERY_MAX);
+				overflow_subindices.resize(GodotSpace2D::INTERSECTION_QUERY_MAX);
+			}
+			const int amount = space->broadphase->cull_segment(from, to, overflow_objects.ptr(), GodotSpace2D::INTERSECTION_QUERY_MAX, overflow_subindices.ptr());
+			batch.hits[packet + i] = _intersect_ray(*batch.parameters, from, to, overflow_objects.ptr(), overflow_subindices.ptr(), amount, batch.results[packet + i]);
+		}
+	}
+}
+
+void GodotPhysicsDirectSpaceState2D::_intersect_shapes_task(uint32_t p_task_index, void *p_batch) {
+	const ShapeBatch &batch = *static_cast<ShapeBatch *>(p_batch);
+	const int begin = p_task_index * GodotSpace2D::BATCH_QUERY_TASK_SIZE;
+	const int end = MIN(begin + GodotSpace2D::BATCH_QUERY_TASK_SIZE, batch.count);
+
+	LocalVector<GodotCollisionObject2D *> objects;
+	LocalVector<int> subindices;
+	objects.resize(GodotSpace2D::INTERSECTION_QUERY_MAX);
+	subindices.resize(GodotSpace2D::INTERSECTION_QUERY_MAX);
+
+	for (int i = begin; i < end; i++) {
+		batch.result_counts[i] = _intersect_shape(batch.shape, *batch.parameters, batch.transforms[i], objects.ptr(), subindices.ptr(), batch.results + i * batch.result_max, batch.result_max);
+	}
+}
+
+void GodotPhysicsDirectSpaceState2D::_cast_motions_task(uint32_t p_task_index, void *p_batch) {
+	const ShapeBatch &batch = *static_cast<ShapeBatch *>(p_batch);
+	const int begin = p_task_index * GodotSpace2D::BATCH_QUERY_TASK_SIZE;
+	const int end = MIN(begin + GodotSpace2D::BATCH_QUERY_TASK_SIZE, batch.count);
+
+	LocalVector<GodotCollisionObject2D *> objects;
+	LocalVector<int> subindices;
+	objects.resize(GodotSpace2D::INTERSECTION_QUERY_MAX);
+	subindices.resize(GodotSpace2D::INTERSECTION_QUERY_MAX);
+
+	for (int i = begin; i < end; i++) {
+		_cast_motion(batch.shape, *batch.parameters, batch.transforms[i], objects.ptr(), subindices.ptr(), batch.closest_safe[i], batch.closest_unsafe[i]);
+	}
+}
+
+void GodotPhysicsDirectSpaceState2D::intersect_rays(const RayParameters &p_parameters, const Vector2 *p_from, const Vector2 *p_to, int p_count, RayResult *r_results, bool *r_hits) {
+	ERR_FAIL_COND(space->locked);
+
+	RayBatch batch;
+	batch.parameters = &p_parameters;
+	batch.from = p_from;
+	batch.to = p_to;
+	batch.count = p_count;
+	batch.results = r_results;
+	batch.hits = r_hits;
+
+	_run_batch(&GodotPhysicsDirectSpaceState2D::_intersect_rays_task, &batch, p_count, SNAME("Physics2DIntersectRays"));
+}
+
+void GodotPhysicsDirectSpaceState2D::intersect_shapes(const ShapeParameters &p_parameters, const Transform2D *p_transforms, int p_count, ShapeResult *r_results, int *r_result_counts, int p_result_max) {
+	ERR_FAIL_COND(space->locked);
+	ERR_FAIL_COND(p_result_max <= 0);
+
+	GodotShape2D *shape = GodotPhysicsServer2D::godot_singleton->shape_owner.get_or_null(p_parameters.shape_rid);
+	ERR_FAIL_NULL(shape);
+
+	ShapeBatch batch;
+	batch.shape = shape;
+	batch.parameters = &p_parameters;
+	batch.transforms = p_transforms;
+	batch.count = p_count;
+	batch.results = r_results;
+	batch.result_counts = r_result_counts;
+	batch.result_max = p_result_max;
+
+	_run_batch(&GodotPhysicsDirectSpaceState2D::_intersect_shapes_task, &batch, p_count, SNAME("Physics2DIntersectShapes"));
+}
+
+bool GodotPhysicsDirectSpaceState2D::cast_motions(const ShapeParameters &p_parameters, const Transform2D *p_transforms, int p_count, real_t *r_closest_safe, real_t *r_closest_unsafe) {
+	ERR_FAIL_COND_V(space->locked, false);
+
+	GodotShape2D *shape = GodotPhysicsServer2D::godot_singleton->shape_owner.get_or_null(p_parameters.shape_rid);
+	ERR_FAIL_NULL_V(shape, false);
+
+	ShapeBatch batch;
+	batch.shape = shape;
+	batch.parameters = &p_parameters;
+	batch.transforms = p_transforms;
+	batch.count = p_count;
+	batch.closest_safe = r_closest_safe;
+	batch.closest_unsafe = r_closest_unsafe;
+
+	_run_batch(&GodotPhysicsDirectSpaceState2D::_cast_motions_task, &batch, p_count, SNAME("Physics2DCastMotions"));
+
+	return true;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 int GodotSpace2D::_cull_aabb_for_body(GodotBody2D *p_body, const Rect2 &p_aabb) {
@@ -1070,6 +1212,20 @@ void GodotSpace2D::body_remove_from_mass_properties_update_list(SelfList<GodotBo
 	mass_properties_update_list.remove(p_body);
 }
 
+void GodotSpace2D::sleeping_island_add_body(uint64_t p_island) {
+	sleeping_islands[p_island]++;
+}
+
+void GodotSpace2D::sleeping_island_remove_body(uint64_t p_island) {
+	uint32_t *body_count = sleeping_islands.getptr(p_island);
+	ERR_FAIL_NULL(body_count);
+	(*body_count)--;
+	if (*body_count == 0) {
+		// The last body woke up or left.
+		sleeping_islands.erase(p_island);
+	}
+}
+
 GodotBroadPhase2D *GodotSpace2D::get_broadphase() {
 	return broadphase;
 }
@@ -45,6 +45,38 @@
 class GodotPhysicsDirectSpaceState2D : public PhysicsDirectSpaceState2D {
 	GDCLASS(GodotPhysicsDirectSpaceState2D, PhysicsDirectSpaceState2D);
 
+	struct RayBatch {
+		const RayParameters *parameters = nullptr;
+		const Vector2 *from = nullptr;
+		const Vector2 *to = nullptr;
+		int count = 0;
+		RayResult *results = nullptr;
+		bool *hits = nullptr;
+	};
+
+	struct ShapeBatch {
+		GodotShape2D *shape = nullptr;
+		const ShapeParameters *parameters = nullptr;
+		const Transform2D *transforms = nullptr;
+		int count = 0;
+		ShapeResult *results = nullptr;
+		int *result_counts = nullptr;
+		int result_max = 0;
+		real_t *closest_safe = nullptr;
+		real_t *closest_unsafe = nullptr;
+	};
+
+	// The query implementations take the broadphase results as arguments, or the buffers to cull into,
+	// so batched queries can run on several threads without sharing the space's buffers.
+	bool _intersect_ray(const RayParameters &p_parameters, const Vector2 &p_from, const Vector2 &p_to, GodotCollisionObject2D *const *p_objects, const int *p_subindices, int p_amount, RayResult &r_result);
+	int _intersect_shape(GodotShape2D *p_shape, const ShapeParameters &p_parameters, const Transform2D &p_transform, GodotCollisionObject2D **r_objects, int *r_subindices, ShapeResult *r_results, int p_result_max);
+	void _cast_motion(GodotShape2D *p_shape, const ShapeParameters &p_parameters, const Transform2D &p_transform, GodotCollisionObject2D **r_objects, int *r_subindices, real_t &p_closest_safe, real_t &p_closest_unsafe);
+
+	void _run_batch(void (GodotPhysicsDirectSpaceState2D::*p_task)(uint32_t, void *), void *p_batch, int p_count, const StringName &p_name);
+	void _intersect_rays_task(uint32_t p_task_index, void *p_batch);
+	void _intersect_shapes_task(uint32_t p_task_index, void *p_batch);
+	void _cast_motions_task(uint32_t p_task_index, void *p_batch);
+
 public:
 	GodotSpace2D *space = nullptr;
 
@@ -55,6 +87,10 @@ public:
 	virtual bool collide_shape(const ShapeParameters &p_parameters, Vector2 *r_results, int p_result_max, int &r_result_count) override;
 	virtual bool rest_info(const ShapeParameters &p_parameters, ShapeRestInfo *r_info) override;
 
+	virtual void intersect_rays(const RayParameters &p_parameters, const Vector2 *p_from, const Vector2 *p_to, int p_count, RayResult *r_results, bool *r_hits) override;
+	virtual void intersect_shapes(const ShapeParameters &p_parameters, const Transform2D *p_transforms, int p_count, ShapeResult *r_results, int *r_result_counts, int p_result_max) override;
+	virtual bool cast_motions(const ShapeParameters &p_parameters, const Transform2D *p_transforms, int p_count, real_t *r_closest_safe, real_t *r_closest_unsafe) override;
+
 	GodotPhysicsDirectSpaceState2D() {}
 };
 
@@ -105,7 +141,13 @@ private:
 	real_t constraint_bias = 0.0;
 
 	enum {
-		INTERSECTION_QUERY_MAX = 2048
+		INTERSECTION_QUERY_MAX = 2048,
+		// Batched rays are culled in packets, keeping fewer results per ray so the buffers for a packet stay small.
+		// Rays which fill their share are culled again on their own, with INTERSECTION_QUERY_MAX results.
+		RAY_PACKET_SIZE = 32,
+		RAY_PACKET_QUERY_MAX = 256,
+		// Batches are split in tasks of this many queries for the worker threads (a multiple of RAY_PACKET_SIZE).
+		BATCH_QUERY_TASK_SIZE = 64,
 	};
 
 	GodotCollisionObject2D *intersection_query_results[INTERSECTION_QUERY_MAX];
@@ -120,9 +162,14 @@ private:
 	real_t last_step = 0.001;
 
 	int island_count = 0;
+	int active_island_count = 0;
 	int active_objects = 0;
 	int collision_pairs = 0;
 
+	// Bodies still asleep in each island put to sleep by the solver.
+	HashMap<uint64_t, uint32_t> sleeping_islands;
+	uint64_t last_sleeping_island = 0;
+
 	int _cull_aabb_for_body(GodotBody2D *p_body, const Rect2 &p_aabb);
 
 	Vector<Vector2> contact_debug;
@@ -146,6 +193,10 @@ public:
 	void area_remove_from_moved_list(SelfList<GodotArea2D> *p_area);
 	const SelfList<GodotArea2D>::List &get_moved_area_list() const;
 
+	uint64_t sleeping_island_create() { return ++last_sleeping_island; }
+	void sleeping_island_add_body(uint64_t p_island);
+	void sleeping_island_remove_body(uint64_t p_island);
+
 	void body_add_to_state_query_list(SelfList<GodotBody2D> *p_body);
 	void body_remove_from_state_query_list(SelfList<GodotBody2D> *p_body);
 
@@ -185,6 +236,11 @@ public:
 	void set_island_count(int p_island_count) { island_count = p_island_count; }
 	int get_island_count() const { return island_count; }
 
+	void set_active_island_count(int p_active_island_count) { active_island_count = p_active_island_count; }
+	int get_active_island_count() const { return active_island_count; }
+
+	int get_sleeping_island_count() const { return sleeping_islands.size(); }
+
 	void set_active_objects(int p_active_objects) { active_objects = p_active_objects; }
 	int get_active_objects() const { return active_objects; }
 
@@ -40,34 +40,43 @@
 #define CONSTRAINT_COUNT_RESERVE 1024
 
 void GodotStep2D::_populate_island(GodotBody2D *p_body, LocalVector<GodotBody2D *> &p_body_island, LocalVector<GodotConstraint2D *> &p_constraint_island) {
+	// Bodies are visited with an explicit stack, large piles would need a very deep recursion.
 	p_body->set_island_step(_step);
+	island_stack.clear();
+	island_stack.push_back(p_body);
 
-	if (p_body->get_mode() > PhysicsServer2D::BODY_MODE_KINEMATIC) {
-		// Only rigid bodies are tested for activation.
-		p_body_island.push_back(p_body);
-	}
+	while (!island_stack.is_empty()) {
+		GodotBody2D *body = island_stack[island_stack.size() - 1];
+		island_stack.resize(island_stack.size() - 1);
 
-	for (const Pair<GodotConstraint2D *, int> &E : p_body->get_constraint_list()) {
-		GodotConstraint2D *constraint = const_cast<GodotConstraint2D *>(E.first);
-		if (constraint->get_island_step() == _step) {
-			continue; // Already processed.
+		if (body->get_mode() > PhysicsServer2D::BODY_MODE_KINEMATIC) {
+			// Only rigid bodies are tested for activation.
+			p_body_island.push_back(body);
 		}
-		constraint->set_island_step(_step);
-		p_constraint_island.push_back(constraint);
-		all_constraints.push_back(constraint);
 
-		for (int i = 0; i < constraint->get_body_count(); i++) {
-			if (i == E.second) {
-				continue;
-			}
-			GodotBody2D *other_body = constraint->get_body_ptr()[i];
-			if (other_body->get_island_step() == _step) {
+		for (const Pair<GodotConstraint2D *, int> &E : body->get_constraint_list()) {
+			GodotConstraint2D *constraint = const_cast<GodotConstraint2D *>(E.first);
+			if (constraint->get_island_step() == _step) {
 				continue; // Already processed.
 			}
-			if (other_body->get_mode() == PhysicsServer2D::BODY_MODE_STATIC) {
-				continue; // Static bodies don't connect islands.
+			constraint->set_island_step(_step);
+			p_constraint_island.push_back(constraint);
+			all_constraints.push_back(constraint);
+
+			for (int i = 0; i < constraint->get_body_count(); i++) {
+				if (i == E.second) {
+					continue;
+				}
+				GodotBody2D *other_body = constraint->get_body_ptr()[i];
+				if (other_body->get_island_step() == _step) {
+					continue; // Already processed.
+				}
+				if (other_body->get_mode() == PhysicsServer2D::BODY_MODE_STATIC) {
+					continue; // Static bodies don't connect islands.
+				}
+				other_body->set_island_step(_step);
+				island_stack.push_back(other_body);
 			}
-			_populate_island(other_body, p_body_island, p_constraint_island);
 		}
 	}
 }
@@ -101,7 +110,7 @@ void GodotStep2D::_solve_island(uint32_t p_island_index, void *p_userdata) const
 	}
 }
 
-void GodotStep2D::_check_suspend(LocalVector<GodotBody2D *> &p_body_island) const {
+void GodotStep2D::_check_suspend(GodotSpace2D *p_space, LocalVector<GodotBody2D *> &p_body_island) const {
 	bool can_sleep = true;
 
 	uint32_t body_count = p_body_island.size();
@@ -114,6 +123,9 @@ void GodotStep2D::_check_suspend(LocalVector<GodotBody2D *> &p_body_island) cons
 	}
 
 	// Put all to sleep or wake up everyone.
+	// Sleeping islands aren't visited again until one of their bodies wakes up, so they are counted
+	// by tagging their bodies.
+	const uint64_t sleeping_island = can_sleep ? p_space->sleeping_island_create() : 0;
 	for (uint32_t body_index = 0; body_index < body_count; ++body_index) {
 		GodotBody2D *body = p_body_island[body_index];
 
@@ -122,6 +134,7 @@ void GodotStep2D::_check_suspend(LocalVector<GodotBody2D *> &p_body_island) cons
 		if (active == can_sleep) {
 			body->set_active(!can_sleep);
 		}
+		body->set_sleeping_island(sleeping_island);
 	}
 }
 
@@ -230,6 +243,7 @@ void GodotStep2D::step(GodotSpace2D *p_space, real_t p_delta) {
 	}
 
 	p_space->set_island_count((int)island_count);
+	p_space->set_active_island_count((int)body_island_count);
 
 	{ //profile
 		profile_endtime = OS::get_singleton()->get_ticks_usec();
@@ -281,7 +295,7 @@ void GodotStep2D::step(GodotSpace2D *p_space, real_t p_delta) {
 	/* SLEEP / WAKE UP ISLANDS */
 
 	for (uint32_t island_index = 0; island_index < body_island_count; ++island_index) {
-		_check_suspend(body_islands[island_index]);
+		_check_suspend(p_space, body_islands[island_index]);
 	}
 
 	{ //profile
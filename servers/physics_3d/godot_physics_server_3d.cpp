@@ -1630,6 +1630,7 @@ void GodotPhysicsServer3D::init() {
 
 void GodotPhysicsServer3D::step(real_t p_step) {
 #ifndef _3D_DISABLED
+	MemoryTagScope memory_tag(Memory::TAG_PHYSICS);
 
 	if (!active) {
 		return;
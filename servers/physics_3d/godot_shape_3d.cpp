@@ -1769,41 +1769,6 @@ _FORCE_INLINE_ bool _heightmap_cell_cull_segment(_HeightmapSegmentCullParams &p_
 	return false;
 }
 
-_FORCE_INLINE_ bool _heightmap_chunk_cull_segment(_HeightmapSegmentCullParams &p_params, const _HeightmapGridCullState &p_state) {
-	const GodotHeightMapShape3D::Range &chunk = p_params.heightmap->_get_bounds_chunk(p_state.x, p_state.z);
-
-	Vector3 enter_pos;
-	Vector3 exit_pos;
-
-	if (p_state.length_flat > CMP_EPSILON) {
-		real_t flat_to_3d = p_state.length / p_state.length_flat;
-		real_t enter_param = p_state.prev_dist * flat_to_3d;
-		real_t exit_param = p_state.dist * flat_to_3d;
-		enter_pos = p_params.from + p_params.dir * enter_param;
-		exit_pos = p_params.from + p_params.dir * exit_param;
-	} else {
-		// Consider the ray vertical.
-		// (though we shouldn't reach this often because there is an early check up-front)
-		enter_pos = p_params.from;
-		exit_pos = p_params.to;
-	}
-
-	// Transform positions to heightmap space.
-	enter_pos *= GodotHeightMapShape3D::BOUNDS_CHUNK_SIZE;
-	exit_pos *= GodotHeightMapShape3D::BOUNDS_CHUNK_SIZE;
-
-	// We did enter the flat projection of the AABB,
-	// but we have to check if we intersect it on the vertical axis.
-	if ((enter_pos.y > chunk.max) && (exit_pos.y > chunk.max)) {
-		return false;
-	}
-	if ((enter_pos.y < chunk.min) && (exit_pos.y < chunk.min)) {
-		return false;
-	}
-
-	return p_params.heightmap->_intersect_grid_segment(_heightmap_cell_cull_segment, enter_pos, exit_pos, p_params.heightmap->width, p_params.heightmap->depth, p_params.heightmap->local_origin, p_params.result, p_params.normal);
-}
-
 template <typename ProcessFunction>
 bool GodotHeightMapShape3D::_intersect_grid_segment(ProcessFunction &p_process, const Vector3 &p_begin, const Vector3 &p_end, int p_width, int p_depth, const Vector3 &offset, Vector3 &r_point, Vector3 &r_normal) const {
 	Vector3 delta = (p_end - p_begin);
@@ -1945,6 +1910,97 @@ bool GodotHeightMapShape3D::_intersect_grid_segment(ProcessFunction &p_process,
 	return false;
 }
 
+bool GodotHeightMapShape3D::_clip_bounds_segment(int p_level, int p_x, int p_z, const Vector3 &p_local_begin, const Vector3 &p_delta, real_t &r_enter, real_t &r_exit) const {
+	// Cells covered by the region, in heightmap space.
+	const int region_size = BOUNDS_CHUNK_SIZE << p_level;
+	const real_t region_min[2] = { real_t(p_x * region_size), real_t(p_z * region_size) };
+	const real_t region_max[2] = { region_min[0] + region_size, region_min[1] + region_size };
+	const real_t begin[2] = { p_local_begin.x, p_local_begin.z };
+	const real_t delta[2] = { p_delta.x, p_delta.z };
+
+	// Clip the flat projection of the segment against the region.
+	for (int i = 0; i < 2; i++) {
+		if (Math::abs(delta[i]) < CMP_EPSILON) {
+			if (begin[i] < region_min[i] || begin[i] > region_max[i]) {
+				return false;
+			}
+			continue;
+		}
+		real_t enter = (region_min[i] - begin[i]) / delta[i];
+		real_t exit = (region_max[i] - begin[i]) / delta[i];
+		if (enter > exit) {
+			SWAP(enter, exit);
+		}
+		r_enter = MAX(r_enter, enter);
+		r_exit = MIN(r_exit, exit);
+		if (r_enter > r_exit) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool GodotHeightMapShape3D::_intersect_bounds_segment(int p_level, int p_x, int p_z, const Vector3 &p_begin, const Vector3 &p_end, real_t p_enter, real_t p_exit, Vector3 &r_point, Vector3 &r_normal) const {
+	const Vector3 delta = p_end - p_begin;
+	const Vector3 local_begin = p_begin + local_origin;
+
+	// We did enter the flat projection of the region,
+	// but we have to check if we intersect it on the vertical axis.
+	const Range &range = _get_bounds(p_level, p_x, p_z);
+	const real_t enter_y = local_begin.y + delta.y * p_enter;
+	const real_t exit_y = local_begin.y + delta.y * p_exit;
+	if ((enter_y > range.max) && (exit_y > range.max)) {
+		return false;
+	}
+	if ((enter_y < range.min) && (exit_y < range.min)) {
+		return false;
+	}
+
+	if (p_level == 0) {
+		// Run the cell raycast on the part of the segment inside this chunk.
+		return _intersect_grid_segment(_heightmap_cell_cull_segment, p_begin + delta * p_enter, p_begin + delta * p_exit, width, depth, local_origin, r_point, r_normal);
+	}
+
+	// Split the segment where it crosses the middle lines of the region,
+	// so the children are visited in the order the segment goes through them
+	// and the first hit found is also the closest one.
+	const int child_size = BOUNDS_CHUNK_SIZE << (p_level - 1);
+	const real_t mid_x = (p_x * 2 + 1) * child_size;
+	const real_t mid_z = (p_z * 2 + 1) * child_size;
+
+	real_t splits[4];
+	int split_count = 0;
+	splits[split_count++] = p_enter;
+	real_t cross_x = (Math::abs(delta.x) < CMP_EPSILON) ? p_exit : (mid_x - local_begin.x) / delta.x;
+	real_t cross_z = (Math::abs(delta.z) < CMP_EPSILON) ? p_exit : (mid_z - local_begin.z) / delta.z;
+	if (cross_x > cross_z) {
+		SWAP(cross_x, cross_z);
+	}
+	if ((cross_x > p_enter) && (cross_x < p_exit)) {
+		splits[split_count++] = cross_x;
+	}
+	if ((cross_z > p_enter) && (cross_z < p_exit)) {
+		splits[split_count++] = cross_z;
+	}
+	splits[split_count++] = p_exit;
+
+	const BoundsLevel &child_level = bounds_levels[p_level - 1];
+	for (int i = 0; i < split_count - 1; i++) {
+		const real_t param = 0.5 * (splits[i] + splits[i + 1]);
+		const int x = p_x * 2 + ((local_begin.x + delta.x * param) < mid_x ? 0 : 1);
+		const int z = p_z * 2 + ((local_begin.z + delta.z * param) < mid_z ? 0 : 1);
+		if ((x >= child_level.width) || (z >= child_level.depth)) {
+			continue;
+		}
+		if (_intersect_bounds_segment(p_level - 1, x, z, p_begin, p_end, splits[i], splits[i + 1], r_point, r_normal)) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
 bool GodotHeightMapShape3D::intersect_segment(const Vector3 &p_begin, const Vector3 &p_end, Vector3 &r_point, Vector3 &r_normal, int &r_face_index, bool p_hit_back_faces) const {
 	if (heights.is_empty()) {
 		return false;
@@ -1981,7 +2037,7 @@ bool GodotHeightMapShape3D::intersect_segment(const Vector3 &p_begin, const Vect
 			r_normal = params.normal;
 			return true;
 		}
-	} else if (bounds_grid.is_empty()) {
+	} else if (bounds_levels.size() < 2) {
 		// Process all cells intersecting the flat projection of the ray.
 		return _intersect_grid_segment(_heightmap_cell_cull_segment, p_begin, p_end, width, depth, local_origin, r_point, r_normal);
 	} else {
@@ -1991,11 +2047,31 @@ bool GodotHeightMapShape3D::intersect_segment(const Vector3 &p_begin, const Vect
 			// Don't use chunks, the ray is too short in the plane.
 			return _intersect_grid_segment(_heightmap_cell_cull_segment, p_begin, p_end, width, depth, local_origin, r_point, r_normal);
 		} else {
-			// The ray is long, run raycast on a higher-level grid.
-			Vector3 bounds_from = p_begin / BOUNDS_CHUNK_SIZE;
-			Vector3 bounds_to = p_end / BOUNDS_CHUNK_SIZE;
-			Vector3 bounds_offset = local_origin / BOUNDS_CHUNK_SIZE;
-			return _intersect_grid_segment(_heightmap_chunk_cull_segment, bounds_from, bounds_to, bounds_grid_width, bounds_grid_depth, bounds_offset, r_point, r_normal);
+			// The ray is long, walk down the min/max pyramid and skip every region it passes above or below.
+			const int top_level = bounds_levels.size() - 1;
+			real_t enter = 0.0;
+			real_t exit = 1.0;
+			if (!_clip_bounds_segment(top_level, 0, 0, local_begin, ray_diff, enter, exit)) {
+				return false;
+			}
+
+			// Start from the smallest region containing the whole segment.
+			const Vector3 clipped_begin = local_begin + ray_diff * enter;
+			const Vector3 clipped_end = local_begin + ray_diff * exit;
+			const BoundsLevel &chunks = bounds_levels[0];
+			const int chunk_x[2] = {
+				CLAMP(int(MIN(clipped_begin.x, clipped_end.x)) / BOUNDS_CHUNK_SIZE, 0, chunks.width - 1),
+				CLAMP(int(MAX(clipped_begin.x, clipped_end.x)) / BOUNDS_CHUNK_SIZE, 0, chunks.width - 1)
+			};
+			const int chunk_z[2] = {
+				CLAMP(int(MIN(clipped_begin.z, clipped_end.z)) / BOUNDS_CHUNK_SIZE, 0, chunks.depth - 1),
+				CLAMP(int(MAX(clipped_begin.z, clipped_end.z)) / BOUNDS_CHUNK_SIZE, 0, chunks.depth - 1)
+			};
+			int level = 0;
+			while ((level < top_level) && (((chunk_x[0] >> level) != (chunk_x[1] >> level)) || ((chunk_z[0] >> level) != (chunk_z[1] >> level)))) {
+				level++;
+			}
+			return _intersect_bounds_segment(level, chunk_x[0] >> level, chunk_z[0] >> level, p_begin, p_end, enter, exit, r_point, r_normal);
 		}
 	}
 
@@ -2051,30 +2127,103 @@ void GodotHeightMapShape3D::cull(const AABB &p_local_aabb, QueryCallback p_callb
 	int start_z = MAX(0, aabb_min[2]);
 	int end_z = MIN(depth - 1, aabb_max[2]);
 
+	if ((start_x >= end_x) || (start_z >= end_z)) {
+		return;
+	}
+
 	GodotFaceShape3D face;
 	face.backface_collision = !p_invert_backface_collision;
 	face.invert_backface_collision = p_invert_backface_collision;
 
+	// Small aabbs don't need to walk down the whole pyramid,
+	// start from the first level where at most 2x2 regions cover them.
+	const int cell_range[4] = { start_x, end_x, start_z, end_z };
+	const int top_level = bounds_levels.size() - 1;
+	int level = 0;
+	while (level < top_level) {
+		const int region_size = BOUNDS_CHUNK_SIZE << level;
+		if (((end_x - 1) / region_size - start_x / region_size < 2) && ((end_z - 1) / region_size - start_z / region_size < 2)) {
+			break;
+		}
+		level++;
+	}
+
+	const int region_size = BOUNDS_CHUNK_SIZE << level;
+	for (int z = start_z / region_size; z <= (end_z - 1) / region_size; z++) {
+		for (int x = start_x / region_size; x <= (end_x - 1) / region_size; x++) {
+			if (_cull_bounds(level, x, z, p_local_aabb, cell_range, face, p_callback, p_userdata)) {
+				return;
+			}
+		}
+	}
+}
+
+_FORCE_INLINE_ static bool _heightmap_face_intersects_aabb(const GodotFaceShape3D &p_face, const AABB &p_aabb) {
+	for (int i = 0; i < 3; i++) {
+		const real_t face_min = MIN(p_face.vertex[0][i], MIN(p_face.vertex[1][i], p_face.vertex[2][i]));
+		const real_t face_max = MAX(p_face.vertex[0][i], MAX(p_face.vertex[1][i], p_face.vertex[2][i]));
+		if ((face_max < p_aabb.position[i]) || (face_min > p_aabb.position[i] + p_aabb.size[i])) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool GodotHeightMapShape3D::_cull_bounds(int p_level, int p_x, int p_z, const AABB &p_local_aabb, const int *p_cell_range, GodotFaceShape3D &p_face, QueryCallback p_callback, void *p_userdata) const {
+	const int region_size = BOUNDS_CHUNK_SIZE << p_level;
+	const int start_x = MAX(p_x * region_size, p_cell_range[0]);
+	const int end_x = MIN((p_x + 1) * region_size, p_cell_range[1]);
+	const int start_z = MAX(p_z * region_size, p_cell_range[2]);
+	const int end_z = MIN((p_z + 1) * region_size, p_cell_range[3]);
+	if ((start_x >= end_x) || (start_z >= end_z)) {
+		return false;
+	}
+
+	// Skip the whole region when the aabb is above or below it.
+	const Range &range = _get_bounds(p_level, p_x, p_z);
+	if ((range.max < p_local_aabb.position.y) || (range.min > p_local_aabb.position.y + p_local_aabb.size.y)) {
+		return false;
+	}
+
+	if (p_level > 0) {
+		const BoundsLevel &child_level = bounds_levels[p_level - 1];
+		for (int z = p_z * 2; z < MIN(p_z * 2 + 2, child_level.depth); z++) {
+			for (int x = p_x * 2; x < MIN(p_x * 2 + 2, child_level.width); x++) {
+				if (_cull_bounds(p_level - 1, x, z, p_local_aabb, p_cell_range, p_face, p_callback, p_userdata)) {
+					return true;
+				}
+			}
+		}
+		return false;
+	}
+
+	// Only report the triangles which can touch the aabb, so the narrow phase doesn't test the others.
 	for (int z = start_z; z < end_z; z++) {
 		for (int x = start_x; x < end_x; x++) {
 			// First triangle.
-			_get_point(x, z, face.vertex[0]);
-			_get_point(x + 1, z, face.vertex[1]);
-			_get_point(x, z + 1, face.vertex[2]);
-			face.normal = Plane(face.vertex[0], face.vertex[1], face.vertex[2]).normal;
-			if (p_callback(p_userdata, &face)) {
-				return;
+			_get_point(x, z, p_face.vertex[0]);
+			_get_point(x + 1, z, p_face.vertex[1]);
+			_get_point(x, z + 1, p_face.vertex[2]);
+			if (_heightmap_face_intersects_aabb(p_face, p_local_aabb)) {
+				p_face.normal = Plane(p_face.vertex[0], p_face.vertex[1], p_face.vertex[2]).normal;
+				if (p_callback(p_userdata, &p_face)) {
+					return true;
+				}
 			}
 
 			// Second triangle.
-			face.vertex[0] = face.vertex[1];
-			_get_point(x + 1, z + 1, face.vertex[1]);
-			face.normal = Plane(face.vertex[0], face.vertex[1], face.vertex[2]).normal;
-			if (p_callback(p_userdata, &face)) {
-				return;
+			p_face.vertex[0] = p_face.vertex[1];
+			_get_point(x + 1, z + 1, p_face.vertex[1]);
+			if (_heightmap_face_intersects_aabb(p_face, p_local_aabb)) {
+				p_face.normal = Plane(p_face.vertex[0], p_face.vertex[1], p_face.vertex[2]).normal;
+				if (p_callback(p_userdata, &p_face)) {
+					return true;
+				}
 			}
 		}
 	}
+
+	return false;
 }
 
 Vector3 GodotHeightMapShape3D::get_moment_of_inertia(real_t p_mass) const {
@@ -2088,33 +2237,40 @@ Vector3 GodotHeightMapShape3D::get_moment_of_inertia(real_t p_mass) const {
 }
 
 void GodotHeightMapShape3D::_build_accelerator() {
-	bounds_grid.clear();
+	bounds_levels.clear();
 
-	bounds_grid_width = width / BOUNDS_CHUNK_SIZE;
-	bounds_grid_depth = depth / BOUNDS_CHUNK_SIZE;
+	if (heights.is_empty()) {
+		return;
+	}
+
+	int chunks_width = width / BOUNDS_CHUNK_SIZE;
+	int chunks_depth = depth / BOUNDS_CHUNK_SIZE;
 
 	if (width % BOUNDS_CHUNK_SIZE > 0) {
-		++bounds_grid_width; // In case terrain size isn't dividable by chunk size.
+		++chunks_width; // In case terrain size isn't dividable by chunk size.
 	}
 
 	if (depth % BOUNDS_CHUNK_SIZE > 0) {
-		++bounds_grid_depth;
+		++chunks_depth;
 	}
 
-	uint32_t bound_grid_size = (uint32_t)(bounds_grid_width * bounds_grid_depth);
-
-	if (bound_grid_size < 2) {
-		// Grid is empty or just one chunk.
-		return;
+	// Each level halves the previous one, until a single region covers the whole map.
+	uint32_t level_count = 1;
+	while ((chunks_width > (1 << (level_count - 1))) || (chunks_depth > (1 << (level_count - 1)))) {
+		++level_count;
 	}
+	bounds_levels.resize(level_count);
 
-	bounds_grid.resize(bound_grid_size);
+	BoundsLevel &chunks = bounds_levels[0];
+	chunks.width = chunks_width;
+	chunks.depth = chunks_depth;
+	chunks.ranges.resize((uint32_t)(chunks.width * chunks.depth));
 
 	// Compute min and max height for all chunks.
-	for (int cz = 0; cz < bounds_grid_depth; ++cz) {
+	for (int cz = 0; cz < chunks.depth; ++cz) {
 		int z0 = cz * BOUNDS_CHUNK_SIZE;
 
-		for (int cx = 0; cx < bounds_grid_width; ++cx) {
+		for (int cx = 0; cx < chunks.width; ++cx) {
 			int x0 = cx * BOUNDS_CHUNK_SIZE;
 
 			Range r;
@@ -2151,7 +2307,30 @@ void GodotHeightMapShape3D::_build_accelerator() {
 				}
 			}
 
-			bounds_grid[cx + cz * bounds_grid_width] = r;
+			chunks.ranges[cx + cz * chunks.width] = r;
+		}
+	}
+
+	// Merge 2x2 regions of each level into the next one.
+	for (uint32_t i = 1; i < level_count; ++i) {
+		const BoundsLevel &prev = bounds_levels[i - 1];
+		BoundsLevel &level = bounds_levels[i];
+		level.width = (prev.width + 1) / 2;
+		level.depth = (prev.depth + 1) / 2;
+		level.ranges.resize((uint32_t)(level.width * level.depth));
+
+		for (int z = 0; z < level.depth; ++z) {
+			for (int x = 0; x < level.width; ++x) {
+				Range r = prev.ranges[(z * 2) * prev.width + (x * 2)];
+				for (int pz = z * 2; pz < MIN(z * 2 + 2, prev.depth); ++pz) {
+					for (int px = x * 2; px < MIN(x * 2 + 2, prev.width); ++px) {
+						const Range &prev_range = prev.ranges[pz * prev.width + px];
+						r.min = MIN(r.min, prev_range.min);
+						r.max = MAX(r.max, prev_range.max);
+					}
+				}
+				level.ranges[z * level.width + x] = r;
+			}
 		}
 	}
 }
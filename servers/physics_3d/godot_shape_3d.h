@@ -394,14 +394,20 @@ struct GodotHeightMapShape3D : public GodotConcaveShape3D {
 		real_t min = 0.0;
 		real_t max = 0.0;
 	};
-	LocalVector<Range> bounds_grid;
-	int bounds_grid_width = 0;
-	int bounds_grid_depth = 0;
+	// Min/max pyramid: level 0 holds chunks of BOUNDS_CHUNK_SIZE cells,
+	// each following level merges 2x2 regions of the previous one, up to a single region.
+	struct BoundsLevel {
+		LocalVector<Range> ranges;
+		int width = 0;
+		int depth = 0;
+	};
+	LocalVector<BoundsLevel> bounds_levels;
 
 	static const int BOUNDS_CHUNK_SIZE = 16;
 
-	_FORCE_INLINE_ const Range &_get_bounds_chunk(int p_x, int p_z) const {
-		return bounds_grid[(p_z * bounds_grid_width) + p_x];
+	_FORCE_INLINE_ const Range &_get_bounds(int p_level, int p_x, int p_z) const {
+		const BoundsLevel &level = bounds_levels[p_level];
+		return level.ranges[(p_z * level.width) + p_x];
 	}
 
 	_FORCE_INLINE_ real_t _get_height(int p_x, int p_z) const {
@@ -418,6 +424,10 @@ struct GodotHeightMapShape3D : public GodotConcaveShape3D {
 
 	void _build_accelerator();
 
+	bool _clip_bounds_segment(int p_level, int p_x, int p_z, const Vector3 &p_local_begin, const Vector3 &p_delta, real_t &r_enter, real_t &r_exit) const;
+	bool _intersect_bounds_segment(int p_level, int p_x, int p_z, const Vector3 &p_begin, const Vector3 &p_end, real_t p_enter, real_t p_exit, Vector3 &r_point, Vector3 &r_normal) const;
+	bool _cull_bounds(int p_level, int p_x, int p_z, const AABB &p_local_aabb, const int *p_cell_range, GodotFaceShape3D &p_face, QueryCallback p_callback, void *p_userdata) const;
+
 	template <typename ProcessFunction>
 	bool _intersect_grid_segment(ProcessFunction &p_process, const Vector3 &p_begin, const Vector3 &p_end, int p_width, int p_depth, const Vector3 &offset, Vector3 &r_point, Vector3 &r_normal) const;
 
@@ -33,9 +33,25 @@
 #include "godot_space_3d.h"
 
 #include "core/math/geometry_3d.h"
+#include "core/object/worker_thread_pool.h"
 #include "core/templates/rb_map.h"
 #include "servers/rendering_server.h"
 
+#if !defined(REAL_T_IS_DOUBLE) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define SOFT_BODY_SIMD_SSE
+#include <emmintrin.h>
+
+// Vector3 members are loaded with the next 4 bytes in the last lane, which is never stored back.
+static _ALWAYS_INLINE_ __m128 _load_vector3(const Vector3 &p_vector) {
+	return _mm_loadu_ps(&p_vector.x);
+}
+
+static _ALWAYS_INLINE_ void _store_vector3(Vector3 &r_vector, __m128 p_value) {
+	_mm_storel_pi((__m64 *)&r_vector.x, p_value);
+	_mm_store_ss(&r_vector.z, _mm_movehl_ps(p_value, p_value));
+}
+#endif
+
 // Based on Bullet soft body.
 
 /*
@@ -186,20 +202,16 @@ void GodotSoftBody3D::update_normals_and_centroids() {
 	}
 }
 
-void GodotSoftBody3D::update_bounds() {
+// Returns true if some nodes moved out of the previous bounds.
+bool GodotSoftBody3D::compute_bounds() {
 	AABB prev_bounds = bounds;
 	prev_bounds.grow_by(collision_margin);
 
 	bounds = AABB();
 
-	const uint32_t nodes_count = nodes.size();
-	if (nodes_count == 0) {
-		deinitialize_shape();
-		return;
-	}
-
 	bool first = true;
 	bool moved = false;
+	const uint32_t nodes_count = nodes.size();
 	for (uint32_t node_index = 0; node_index < nodes_count; ++node_index) {
 		const Node &node = nodes[node_index];
 		if (!prev_bounds.has_point(node.x)) {
@@ -213,6 +225,18 @@ void GodotSoftBody3D::update_bounds() {
 		}
 	}
 
+	return moved;
+}
+
+void GodotSoftBody3D::update_bounds() {
+	if (nodes.is_empty()) {
+		bounds = AABB();
+		deinitialize_shape();
+		return;
+	}
+
+	bool moved = compute_bounds();
+
 	if (get_space()) {
 		initialize_shape(moved);
 	}
@@ -577,6 +601,7 @@ bool GodotSoftBody3D::create_from_trimesh(const Vector<int> &p_indices, const Ve
 
 	generate_bending_constraints(2);
 	reoptimize_link_order();
+	build_link_batches();
 
 	update_constants();
 	update_normals_and_centroids();
@@ -821,6 +846,43 @@ void GodotSoftBody3D::reoptimize_link_order() {
 	memdelete_arr(link_buffer);
 }
 
+void GodotSoftBody3D::build_link_batches() {
+	link_batch_offsets.clear();
+
+	// Each batch takes the remaining links that don't share a node with the links already in it.
+	// Links keep their order inside a batch, so the optimized order is mostly kept.
+	LocalVector<Link> remaining = links;
+	links.clear();
+
+	LocalVector<uint32_t> node_batches;
+	node_batches.resize(nodes.size());
+	for (uint32_t &node_batch : node_batches) {
+		node_batch = 0;
+	}
+
+	uint32_t batch = 0;
+	while (!remaining.is_empty()) {
+		batch++;
+		link_batch_offsets.push_back(links.size());
+
+		uint32_t remaining_count = 0;
+		for (const Link &link : remaining) {
+			uint32_t &batch_a = node_batches[link.n[0]->index];
+			uint32_t &batch_b = node_batches[link.n[1]->index];
+			if (batch_a != batch && batch_b != batch) {
+				batch_a = batch;
+				batch_b = batch;
+				links.push_back(link);
+			} else {
+				remaining[remaining_count++] = link;
+			}
+		}
+		remaining.resize(remaining_count);
+	}
+
+	link_batch_offsets.push_back(links.size());
+}
+
 void GodotSoftBody3D::append_link(uint32_t p_node1, uint32_t p_node2) {
 	if (p_node1 == p_node2) {
 		return;
@@ -1029,6 +1091,21 @@ void GodotSoftBody3D::predict_motion(real_t p_delta) {
 	real_t clamp_delta_v = max_displacement * inv_delta;
 
 	// Integrate.
+#ifdef SOFT_BODY_SIMD_SSE
+	const __m128 delta = _mm_set1_ps(p_delta);
+	const __m128 clamp_max = _mm_set1_ps(clamp_delta_v);
+	const __m128 clamp_min = _mm_set1_ps(-clamp_delta_v);
+	for (Node &node : nodes) {
+		const __m128 x = _load_vector3(node.x);
+		_store_vector3(node.q, x);
+		__m128 delta_v = _mm_mul_ps(_mm_mul_ps(_load_vector3(node.f), _mm_set1_ps(node.im)), delta);
+		delta_v = _mm_min_ps(_mm_max_ps(delta_v, clamp_min), clamp_max);
+		const __m128 v = _mm_add_ps(_load_vector3(node.v), delta_v);
+		_store_vector3(node.v, v);
+		_store_vector3(node.x, _mm_add_ps(x, _mm_mul_ps(v, delta)));
+		node.f = Vector3();
+	}
+#else
 	for (Node &node : nodes) {
 		node.q = node.x;
 		Vector3 delta_v = node.f * node.im * p_delta;
@@ -1039,9 +1116,10 @@ void GodotSoftBody3D::predict_motion(real_t p_delta) {
 		node.x += node.v * p_delta;
 		node.f = Vector3();
 	}
+#endif
 
-	// Bounds and tree update.
-	update_bounds();
+	// Bounds update, the shape is updated later in update_shape().
+	bounds_moved = compute_bounds();
 
 	// Node tree update.
 	for (const Node &node : nodes) {
@@ -1062,6 +1140,15 @@ void GodotSoftBody3D::predict_motion(real_t p_delta) {
 	face_tree.optimize_incremental(1);
 }
 
+void GodotSoftBody3D::update_shape() {
+	if (nodes.is_empty()) {
+		deinitialize_shape();
+	} else if (get_space()) {
+		initialize_shape(bounds_moved);
+	}
+	bounds_moved = false;
+}
+
 void GodotSoftBody3D::solve_constraints(real_t p_delta) {
 	const real_t inv_delta = 1.0 / p_delta;
 
@@ -1071,9 +1158,16 @@ void GodotSoftBody3D::solve_constraints(real_t p_delta) {
 	}
 
 	// Solve velocities.
+#ifdef SOFT_BODY_SIMD_SSE
+	const __m128 delta = _mm_set1_ps(p_delta);
+	for (Node &node : nodes) {
+		_store_vector3(node.x, _mm_add_ps(_load_vector3(node.q), _mm_mul_ps(_load_vector3(node.v), delta)));
+	}
+#else
 	for (Node &node : nodes) {
 		node.x = node.q + node.v * p_delta;
 	}
+#endif
 
 	// Solve positions.
 	for (int isolve = 0; isolve < iteration_count; ++isolve) {
@@ -1081,6 +1175,18 @@ void GodotSoftBody3D::solve_constraints(real_t p_delta) {
 		solve_links(1.0, ti);
 	}
 	const real_t vc = (1.0 - damping_coefficient) * inv_delta;
+#ifdef SOFT_BODY_SIMD_SSE
+	const __m128 velocity_scale = _mm_set1_ps(vc);
+	for (Node &node : nodes) {
+		const __m128 x = _mm_add_ps(_load_vector3(node.x), _mm_mul_ps(_load_vector3(node.bv), delta));
+		node.bv = Vector3();
+
+		_store_vector3(node.v, _mm_mul_ps(_mm_sub_ps(x, _load_vector3(node.q)), velocity_scale));
+
+		_store_vector3(node.x, x);
+		_store_vector3(node.q, x);
+	}
+#else
 	for (Node &node : nodes) {
 		node.x += node.bv * p_delta;
 		node.bv = Vector3();
@@ -1089,12 +1195,39 @@ void GodotSoftBody3D::solve_constraints(real_t p_delta) {
 
 		node.q = node.x;
 	}
+#endif
 
 	update_normals_and_centroids();
 }
 
 void GodotSoftBody3D::solve_links(real_t kst, real_t ti) {
-	for (Link &link : links) {
+	const bool parallel = has_parallel_links();
+
+	for (uint32_t batch = 0; batch + 1 < link_batch_offsets.size(); batch++) {
+		LinkBatchTask task;
+		task.begin = link_batch_offsets[batch];
+		task.end = link_batch_offsets[batch + 1];
+		task.kst = kst;
+
+		const uint32_t task_count = (task.end - task.begin + LINK_TASK_SIZE - 1) / LINK_TASK_SIZE;
+		if (parallel && task_count > 1) {
+			WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &GodotSoftBody3D::_solve_link_batch_task, &task, task_count, -1, true, SNAME("SoftBody3DSolveLinks"));
+			WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+		} else {
+			solve_link_range(task.begin, task.end, kst);
+		}
+	}
+}
+
+void GodotSoftBody3D::_solve_link_batch_task(uint32_t p_task_index, void *p_batch) {
+	const LinkBatchTask &task = *static_cast<LinkBatchTask *>(p_batch);
+	const uint32_t begin = task.begin + p_task_index * LINK_TASK_SIZE;
+	solve_link_range(begin, MIN(begin + LINK_TASK_SIZE, task.end), task.kst);
+}
+
+void GodotSoftBody3D::solve_link_range(uint32_t p_begin, uint32_t p_end, real_t kst) {
+	for (uint32_t link_index = p_begin; link_index < p_end; link_index++) {
+		Link &link = links[link_index];
 		if (link.c0 > 0) {
 			Node &node_a = *link.n[0];
 			Node &node_b = *link.n[1];
@@ -1216,6 +1349,7 @@ void GodotSoftBody3D::destroy() {
 
 	nodes.clear();
 	links.clear();
+	link_batch_offsets.clear();
 	faces.clear();
 
 	bounds = AABB();
@@ -78,16 +78,34 @@ class GodotSoftBody3D : public GodotCollisionObject3D {
 		uint32_t index = 0;
 	};
 
+	enum {
+		// Soft bodies with fewer links solve them on a single thread.
+		PARALLEL_LINK_MIN = 8192,
+		// Links solved by each task, when a batch is spread over the worker threads.
+		LINK_TASK_SIZE = 1024,
+	};
+
+	struct LinkBatchTask {
+		uint32_t begin = 0;
+		uint32_t end = 0;
+		real_t kst = 0.0;
+	};
+
 	LocalVector<Node> nodes;
 	LocalVector<Link> links;
 	LocalVector<Face> faces;
 
+	// Links are sorted in batches where no two links share a node, so each batch can be solved in parallel.
+	// Holds the first link of each batch, followed by the link count.
+	LocalVector<uint32_t> link_batch_offsets;
+
 	DynamicBVH node_tree;
 	DynamicBVH face_tree;
 
 	LocalVector<uint32_t> map_visual_to_physics;
 
 	AABB bounds;
+	bool bounds_moved = false;
 
 	real_t collision_margin = 0.05;
 
@@ -201,9 +219,15 @@ public:
 	void set_drag_coefficient(real_t p_val);
 	_FORCE_INLINE_ real_t get_drag_coefficient() const { return drag_coefficient; }
 
+	// Only modify this soft body, so different soft bodies can be processed on different threads.
+	// The broadphase is then updated by update_shape(), which isn't thread safe.
 	void predict_motion(real_t p_delta);
+	void update_shape();
 	void solve_constraints(real_t p_delta);
 
+	// Such soft bodies solve their link batches on the worker threads, so they must be solved from the physics thread.
+	_FORCE_INLINE_ bool has_parallel_links() const { return links.size() >= PARALLEL_LINK_MIN; }
+
 	_FORCE_INLINE_ uint32_t get_node_index(void *p_node) const { return static_cast<Node *>(p_node)->index; }
 	_FORCE_INLINE_ uint32_t get_face_index(void *p_face) const { return static_cast<Face *>(p_face)->index; }
 
@@ -219,6 +243,7 @@ protected:
 
 private:
 	void update_normals_and_centroids();
+	bool compute_bounds();
 	void update_bounds();
 	void update_constants();
 	void update_area();
@@ -234,10 +259,13 @@ private:
 	bool create_from_trimesh(const Vector<int> &p_indices, const Vector<Vector3> &p_vertices);
 	void generate_bending_constraints(int p_distance);
 	void reoptimize_link_order();
+	void build_link_batches();
 	void append_link(uint32_t p_node1, uint32_t p_node2);
 	void append_face(uint32_t p_node1, uint32_t p_node2, uint32_t p_node3);
 
 	void solve_links(real_t kst, real_t ti);
+	void solve_link_range(uint32_t p_begin, uint32_t p_end, real_t kst);
+	void _solve_link_batch_task(uint32_t p_task_index, void *p_batch);
 
 	void initialize_face_tree();
 	void update_face_tree(real_t p_delta);
@@ -34,6 +34,7 @@
 #include "godot_physics_server_3d.h"
 
 #include "core/config/project_settings.h"
+#include "core/object/worker_thread_pool.h"
 
 #define TEST_MOTION_MARGIN_MIN_VALUE 0.0001
 #define TEST_MOTION_MIN_CONTACT_DEPTH_FACTOR 0.05
@@ -105,19 +106,13 @@ int GodotPhysicsDirectSpaceState3D::intersect_point(const PointParameters &p_par
 	return cc;
 }
 
-bool GodotPhysicsDirectSpaceState3D::intersect_ray(const RayParameters &p_parameters, RayResult &r_result) {
-	ERR_FAIL_COND_V(space->locked, false);
-
+bool GodotPhysicsDirectSpaceState3D::_intersect_ray(const RayParameters &p_parameters, const Vector3 &p_from, const Vector3 &p_to, GodotCollisionObject3D *const *p_objects, const int *p_subindices, int p_amount, RayResult &r_result) {
 	Vector3 begin, end;
 	Vector3 normal;
-	begin = p_parameters.from;
-	end = p_parameters.to;
+	begin = p_from;
+	end = p_to;
 	normal = (end - begin).normalized();
 
-	int amount = space->broadphase->cull_segment(begin, end, space->intersection_query_results, GodotSpace3D::INTERSECTION_QUERY_MAX, space->intersection_query_subindex_results);
-
-	//todo, create another array that references results, compute AABBs and check closest point to ray origin, sort, and stop evaluating results when beyond first collision
-
 	bool collided = false;
 	Vector3 res_point, res_normal;
 	int res_face_index = -1;
@@ -125,22 +120,22 @@ bool GodotPhysicsDirectSpaceState3D::intersect_ray(const RayParameters &p_parame
 	const GodotCollisionObject3D *res_obj = nullptr;
 	real_t min_d = 1e10;
 
-	for (int i = 0; i < amount; i++) {
-		if (!_can_collide_with(space->intersection_query_results[i], p_parameters.collision_mask, p_parameters.collide_with_bodies, p_parameters.collide_with_areas)) {
+	for (int i = 0; i < p_amount; i++) {
+		if (!_can_collide_with(p_objects[i], p_parameters.collision_mask, p_parameters.collide_with_bodies, p_parameters.collide_with_areas)) {
 			continue;
 		}
 
-		if (p_parameters.pick_ray && !(space->intersection_query_results[i]->is_ray_pickable())) {
+		if (p_parameters.pick_ray && !(p_objects[i]->is_ray_pickable())) {
 			continue;
 		}
 
-		if (p_parameters.exclude.has(space->intersection_query_results[i]->get_self())) {
+		if (p_parameters.exclude.has(p_objects[i]->get_self())) {
 			continue;
 		}
 
-		const GodotCollisionObject3D *col_obj = space->intersection_query_results[i];
+		const GodotCollisionObject3D *col_obj = p_objects[i];
 
-		int shape_idx = space->intersection_query_subindex_results[i];
+		int shape_idx = p_subindices[i];
 		Transform3D inv_xform = col_obj->get_shape_inv_transform(shape_idx) * col_obj->get_inv_transform();
 
 		Vector3 local_from = inv_xform.xform(begin);
@@ -205,17 +200,20 @@ bool GodotPhysicsDirectSpaceState3D::intersect_ray(const RayParameters &p_parame
 	return true;
 }
 
-int GodotPhysicsDirectSpaceState3D::intersect_shape(const ShapeParameters &p_parameters, ShapeResult *r_results, int p_result_max) {
-	if (p_result_max <= 0) {
-		return 0;
-	}
+bool GodotPhysicsDirectSpaceState3D::intersect_ray(const RayParameters &p_parameters, RayResult &r_result) {
+	ERR_FAIL_COND_V(space->locked, false);
 
-	GodotShape3D *shape = GodotPhysicsServer3D::godot_singleton->shape_owner.get_or_null(p_parameters.shape_rid);
-	ERR_FAIL_NULL_V(shape, 0);
+	int amount = space->broadphase->cull_segment(p_parameters.from, p_parameters.to, space->intersection_query_results, GodotSpace3D::INTERSECTION_QUERY_MAX, space->intersection_query_subindex_results);
 
-	AABB aabb = p_parameters.transform.xform(shape->get_aabb());
+	//todo, create another array that references results, compute AABBs and check closest point to ray origin, sort, and stop evaluating results when beyond first collision
 
-	int amount = space->broadphase->cull_aabb(aabb, space->intersection_query_results, GodotSpace3D::INTERSECTION_QUERY_MAX, space->intersection_query_subindex_results);
+	return _intersect_ray(p_parameters, p_parameters.from, p_parameters.to, space->intersection_query_results, space->intersection_query_subindex_results, amount, r_result);
+}
+
+int GodotPhysicsDirectSpaceState3D::_intersect_shape(GodotShape3D *p_shape, const ShapeParameters &p_parameters, const Transform3D &p_transform, GodotCollisionObject3D **r_objects, int *r_subindices, ShapeResult *r_results, int p_result_max) {
+	AABB aabb = p_transform.xform(p_shape->get_aabb());
+
+	int amount = space->broadphase->cull_aabb(aabb, r_objects, GodotSpace3D::INTERSECTION_QUERY_MAX, r_subindices);
 
 	int cc = 0;
 
@@ -226,20 +224,20 @@ int GodotPhysicsDirectSpaceState3D::intersect_shape(const ShapeParameters &p_par
 			break;
 		}
 
-		if (!_can_collide_with(space->intersection_query_results[i], p_parameters.collision_mask, p_parameters.collide_with_bodies, p_parameters.collide_with_areas)) {
+		if (!_can_collide_with(r_objects[i], p_parameters.collision_mask, p_parameters.collide_with_bodies, p_parameters.collide_with_areas)) {
 			continue;
 		}
 
 		//area can't be picked by ray (default)
 
-		if (p_parameters.exclude.has(space->intersection_query_results[i]->get_self())) {
+		if (p_parameters.exclude.has(r_objects[i]->get_self())) {
 			continue;
 		}
 
-		const GodotCollisionObject3D *col_obj = space->intersection_query_results[i];
-		int shape_idx = space->intersection_query_subindex_results[i];
+		const GodotCollisionObject3D *col_obj = r_objects[i];
+		int shape_idx = r_subindices[i];
 
-		if (!GodotCollisionSolver3D::solve_static(shape, p_parameters.transform, col_obj->get_shape(shape_idx), col_obj->get_transform() * col_obj->get_shape_transform(shape_idx), nullptr, nullptr, nullptr, p_parameters.margin, 0)) {
+		if (!GodotCollisionSolver3D::solve_static(p_shape, p_transform, col_obj->get_shape(shape_idx), col_obj->get_transform() * col_obj->get_shape_transform(shape_idx), nullptr, nullptr, nullptr, p_parameters.margin, 0)) {
 			continue;
 		}
 
@@ -260,22 +258,30 @@ int GodotPhysicsDirectSpaceState3D::intersect_shape(const ShapeParameters &p_par
 	return cc;
 }
 
-bool GodotPhysicsDirectSpaceState3D::cast_motion(const ShapeParameters &p_parameters, real_t &p_closest_safe, real_t &p_closest_unsafe, ShapeRestInfo *r_info) {
+int GodotPhysicsDirectSpaceState3D::intersect_shape(const ShapeParameters &p_parameters, ShapeResult *r_results, int p_result_max) {
+	if (p_result_max <= 0) {
+		return 0;
+	}
+
 	GodotShape3D *shape = GodotPhysicsServer3D::godot_singleton->shape_owner.get_or_null(p_parameters.shape_rid);
-	ERR_FAIL_NULL_V(shape, false);
+	ERR_FAIL_NULL_V(shape, 0);
 
-	AABB aabb = p_parameters.transform.xform(shape->get_aabb());
+	return _intersect_shape(shape, p_parameters, p_parameters.transform, space->intersection_query_results, space->intersection_query_subindex_results, r_results, p_result_max);
+}
+
+void GodotPhysicsDirectSpaceState3D::_cast_motion(GodotShape3D *p_shape, const ShapeParameters &p_parameters, const Transform3D &p_transform, GodotCollisionObject3D **r_objects, int *r_subindices, real_t &p_closest_safe, real_t &p_closest_unsafe, ShapeRestInfo *r_info) {
+	AABB aabb = p_transform.xform(p_shape->get_aabb());
 	aabb = aabb.merge(AABB(aabb.position + p_parameters.motion, aabb.size)); //motion
 	aabb = aabb.grow(p_parameters.margin);
 
-	int amount = space->broadphase->cull_aabb(aabb, space->intersection_query_results, GodotSpace3D::INTERSECTION_QUERY_MAX, space->intersection_query_subindex_results);
+	int amount = space->broadphase->cull_aabb(aabb, r_objects, GodotSpace3D::INTERSECTION_QUERY_MAX, r_subindices);
 
 	real_t best_safe = 1;
 	real_t best_unsafe = 1;
 
-	Transform3D xform_inv = p_parameters.transform.affine_inverse();
+	Transform3D xform_inv = p_transform.affine_inverse();
 	GodotMotionShape3D mshape;
-	mshape.shape = shape;
+	mshape.shape = p_shape;
 	mshape.motion = xform_inv.basis.xform(p_parameters.motion);
 
 	bool best_first = true;
@@ -285,30 +291,30 @@ bool GodotPhysicsDirectSpaceState3D::cast_motion(const ShapeParameters &p_parame
 	Vector3 closest_A, closest_B;
 
 	for (int i = 0; i < amount; i++) {
-		if (!_can_collide_with(space->intersection_query_results[i], p_parameters.collision_mask, p_parameters.collide_with_bodies, p_parameters.collide_with_areas)) {
+		if (!_can_collide_with(r_objects[i], p_parameters.collision_mask, p_parameters.collide_with_bodies, p_parameters.collide_with_areas)) {
 			continue;
 		}
 
-		if (p_parameters.exclude.has(space->intersection_query_results[i]->get_self())) {
+		if (p_parameters.exclude.has(r_objects[i]->get_self())) {
 			continue; //ignore excluded
 		}
 
-		const GodotCollisionObject3D *col_obj = space->intersection_query_results[i];
-		int shape_idx = space->intersection_query_subindex_results[i];
+		const GodotCollisionObject3D *col_obj = r_objects[i];
+		int shape_idx = r_subindices[i];
 
 		Vector3 point_A, point_B;
 		Vector3 sep_axis = motion_normal;
 
 		Transform3D col_obj_xform = col_obj->get_transform() * col_obj->get_shape_transform(shape_idx);
 		//test initial overlap, does it collide if going all the way?
-		if (GodotCollisionSolver3D::solve_distance(&mshape, p_parameters.transform, col_obj->get_shape(shape_idx), col_obj_xform, point_A, point_B, aabb, &sep_axis)) {
+		if (GodotCollisionSolver3D::solve_distance(&mshape, p_transform, col_obj->get_shape(shape_idx), col_obj_xform, point_A, point_B, aabb, &sep_axis)) {
 			continue;
 		}
 
 		//test initial overlap, ignore objects it's inside of.
 		sep_axis = motion_normal;
 
-		if (!GodotCollisionSolver3D::solve_distance(shape, p_parameters.transform, col_obj->get_shape(shape_idx), col_obj_xform, point_A, point_B, aabb, &sep_axis)) {
+		if (!GodotCollisionSolver3D::solve_distance(p_shape, p_transform, col_obj->get_shape(shape_idx), col_obj_xform, point_A, point_B, aabb, &sep_axis)) {
 			continue;
 		}
 
@@ -323,7 +329,7 @@ bool GodotPhysicsDirectSpaceState3D::cast_motion(const ShapeParameters &p_parame
 
 			Vector3 lA, lB;
 			Vector3 sep = motion_normal; //important optimization for this to work fast enough
-			bool collided = !GodotCollisionSolver3D::solve_distance(&mshape, p_parameters.transform, col_obj->get_shape(shape_idx), col_obj_xform, lA, lB, aabb, &sep);
+			bool collided = !GodotCollisionSolver3D::solve_distance(&mshape, p_transform, col_obj->get_shape(shape_idx), col_obj_xform, lA, lB, aabb, &sep);
 
 			if (collided) {
 				hi = fraction;
@@ -375,6 +381,13 @@ bool GodotPhysicsDirectSpaceState3D::cast_motion(const ShapeParameters &p_parame
 
 	p_closest_safe = best_safe;
 	p_closest_unsafe = best_unsafe;
+}
+
+bool GodotPhysicsDirectSpaceState3D::cast_motion(const ShapeParameters &p_parameters, real_t &p_closest_safe, real_t &p_closest_unsafe, ShapeRestInfo *r_info) {
+	GodotShape3D *shape = GodotPhysicsServer3D::godot_singleton->shape_owner.get_or_null(p_parameters.shape_rid);
+	ERR_FAIL_NULL_V(shape, false);
+
+	_cast_motion(shape, p_parameters, p_parameters.transform, space->intersection_query_results, space->intersection_query_subindex_results, p_closest_safe, p_closest_unsafe, r_info);
 
 	return true;
 }
@@ -609,6 +622,135 @@ Vector3 GodotPhysicsDirectSpaceState3D::get_closest_point_to_object_volume(RID p
 	}
 }
 
+void GodotPhysicsDirectSpaceState3D::_run_batch(void (GodotPhysicsDirectSpaceState3D::*p_task)(uint32_t, void *), void *p_batch, int p_count, const StringName &p_name) {
+	const int task_count = (p_count + GodotSpace3D::BATCH_QUERY_TASK_SIZE - 1) / GodotSpace3D::BATCH_QUERY_TASK_SIZE;
+	if (task_count > 1) {
+		WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, p_task, p_batch, task_count, -1, true, p_name);
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+	} else if (task_count == 1) {
+		(this->*p_task)(0, p_batch);
+	}
+}
+
+void GodotPhysicsDirectSpaceState3D::_intersect_rays_task(uint32_t p_task_index, void *p_batch) {
+	const RayBatch &batch = *static_cast<RayBatch *>(p_batch);
+	const int begin = p_task_index * GodotSpace3D::BATCH_QUERY_TASK_SIZE;
+	const int end = MIN(begin + GodotSpace3D::BATCH_QUERY_TASK_SIZE, batch.count);
+
+	LocalVector<GodotCollisionObject3D *> objects;
+	LocalVector<int> subindices;
+	objects.resize(GodotSpace3D::RAY_PACKET_SIZE * GodotSpace3D::RAY_PACKET_QUERY_MAX);
+	subindices.resize(GodotSpace3D::RAY_PACKET_SIZE * GodotSpace3D::RAY_PACKET_QUERY_MAX);
+	int amounts[GodotSpace3D::RAY_PACKET_SIZE];
+	LocalVector<GodotCollisionObject3D *> overflow_objects;
+	LocalVector<int> overflow_subindices;
+
+	for (int packet = begin; packet < end; packet += GodotSpace3D::RAY_PACKET_SIZE) {
+		const int packet_size = MIN(int(GodotSpace3D::RAY_PACKET_SIZE), end - packet);
+		// Rays cast together usually start close to each other, so they visit mostly the same broadphase nodes.
+		space->broadphase->cull_segments(batch.from + packet, batch.to + packet, packet_size, objects.ptr(), amounts, GodotSpace3D::RAY_PACKET_QUERY_MAX, subindices.ptr());
+
+		for (int i = 0; i < packet_size; i++) {
+			const Vector3 &from = batch.from[packet + i];
+			const Vector3 &to = batch.to[packet + i];
+			if (amounts[i] < GodotSpace3D::RAY_PACKET_QUERY_MAX) {
+				const int offset = i * GodotSpace3D::RAY_PACKET_QUERY_MAX;
+				batch.hits[packet + i] = _intersect_ray(*batch.parameters, from, to, objects.ptr() + offset, subindices.ptr() + offset, amounts[i], batch.results[packet + i]);
+				continue;
+			}
+			// The packet ran out of room for this ray and may have missed its closest hit, cull it on its own like intersect_ray() does.
+			if (overflow_objects.is_empty()) {
+				overflow_objects.resize(GodotSpace3D::INTERSECTION_QUERY_MAX);
+				overflow_subindices.resize(GodotSpace3D::INTERSECTION_QUERY_MAX);
+			}
+			const int amount = space->broadphase->cull_segment(from, to, overflow_objects.ptr(), GodotSpace3D::INTERSECTION_QUERY_MAX, overflow_subindices.ptr());
+			batch.hits[packet + i] = _intersect_ray(*batch.parameters, from, to, overflow_objects.ptr(), overflow_subindices.ptr(), amount, batch.results[packet + i]);
+		}
+	}
+}
+
+void GodotPhysicsDirectSpaceState3D::_intersect_shapes_task(uint32_t p_task_index, void *p_batch) {
+	const ShapeBatch &batch = *static_cast<ShapeBatch *>(p_batch);
+	const int begin = p_task_index * GodotSpace3D::BATCH_QUERY_TASK_SIZE;
+	const int end = MIN(begin + GodotSpace3D::BATCH_QUERY_TASK_SIZE, batch.count);
+
+	LocalVector<GodotCollisionObject3D *> objects;
+	LocalVector<int> subindices;
+	objects.resize(GodotSpace3D::INTERSECTION_QUERY_MAX);
+	subindices.resize(GodotSpace3D::INTERSECTION_QUERY_MAX);
+
+	for (int i = begin; i < end; i++) {
+		batch.result_counts[i] = _intersect_shape(batch.shape, *batch.parameters, batch.transforms[i], objects.ptr(), subindices.ptr(), batch.results + i * batch.result_max, batch.result_max);
+	}
+}
+
+void GodotPhysicsDirectSpaceState3D::_cast_motions_task(uint32_t p_task_index, void *p_batch) {
+	const ShapeBatch &batch = *static_cast<ShapeBatch *>(p_batch);
+	const int begin = p_task_index * GodotSpace3D::BATCH_QUERY_TASK_SIZE;
+	const int end = MIN(begin + GodotSpace3D::BATCH_QUERY_TASK_SIZE, batch.count);
+
+	LocalVector<GodotCollisionObject3D *> objects;
+	LocalVector<int> subindices;
+	objects.resize(GodotSpace3D::INTERSECTION_QUERY_MAX);
+	subindices.resize(GodotSpace3D::INTERSECTION_QUERY_MAX);
+
+	for (int i = begin; i < end; i++) {
+		_cast_motion(batch.shape, *batch.parameters, batch.transforms[i], objects.ptr(), subindices.ptr(), batch.closest_safe[i], batch.closest_unsafe[i], nullptr);
+	}
+}
+
+void GodotPhysicsDirectSpaceState3D::intersect_rays(const RayParameters &p_parameters, const Vector3 *p_from, const Vector3 *p_to, int p_count, RayResult *r_results, bool *r_hits) {
+	ERR_FAIL_COND(space->locked);
+
+	RayBatch batch;
+	batch.parameters = &p_parameters;
+	batch.from = p_from;
+	batch.to = p_to;
+	batch.count = p_count;
+	batch.results = r_results;
+	batch.hits = r_hits;
+
+	_run_batch(&GodotPhysicsDirectSpaceState3D::_intersect_rays_task, &batch, p_count, SNAME("Physics3DIntersectRays"));
+}
+
+void GodotPhysicsDirectSpaceState3D::intersect_shapes(const ShapeParameters &p_parameters, const Transform3D *p_transforms, int p_count, ShapeResult *r_results, int *r_result_counts, int p_result_max) {
+	ERR_FAIL_COND(space->locked);
+	ERR_FAIL_COND(p_result_max <= 0);
+
+	GodotShape3D *shape = GodotPhysicsServer3D::godot_singleton->shape_owner.get_or_null(p_parameters.shape_rid);
+	ERR_FAIL_NULL(shape);
+
+	ShapeBatch batch;
+	batch.shape = shape;
+	batch.parameters = &p_parameters;
+	batch.transforms = p_transforms;
+	batch.count = p_count;
+	batch.results = r_results;
+	batch.result_counts = r_result_counts;
+	batch.result_max = p_result_max;
+
+	_run_batch(&GodotPhysicsDirectSpaceState3D::_intersect_shapes_task, &batch, p_count, SNAME("Physics3DIntersectShapes"));
+}
+
+bool GodotPhysicsDirectSpaceState3D::cast_motions(const ShapeParameters &p_parameters, const Transform3D *p_transforms, int p_count, real_t *r_closest_safe, real_t *r_closest_unsafe) {
+	ERR_FAIL_COND_V(space->locked, false);
+
+	GodotShape3D *shape = GodotPhysicsServer3D::godot_singleton->shape_owner.get_or_null(p_parameters.shape_rid);
+	ERR_FAIL_NULL_V(shape, false);
+
+	ShapeBatch batch;
+	batch.shape = shape;
+	batch.parameters = &p_parameters;
+	batch.transforms = p_transforms;
+	batch.count = p_count;
+	batch.closest_safe = r_closest_safe;
+	batch.closest_unsafe = r_closest_unsafe;
+
+	_run_batch(&GodotPhysicsDirectSpaceState3D::_cast_motions_task, &batch, p_count, SNAME("Physics3DCastMotions"));
+
+	return true;
+}
+
 GodotPhysicsDirectSpaceState3D::GodotPhysicsDirectSpaceState3D() {
 	space = nullptr;
 }
@@ -46,6 +46,38 @@
 class GodotPhysicsDirectSpaceState3D : public PhysicsDirectSpaceState3D {
 	GDCLASS(GodotPhysicsDirectSpaceState3D, PhysicsDirectSpaceState3D);
 
+	struct RayBatch {
+		const RayParameters *parameters = nullptr;
+		const Vector3 *from = nullptr;
+		const Vector3 *to = nullptr;
+		int count = 0;
+		RayResult *results = nullptr;
+		bool *hits = nullptr;
+	};
+
+	struct ShapeBatch {
+		GodotShape3D *shape = nullptr;
+		const ShapeParameters *parameters = nullptr;
+		const Transform3D *transforms = nullptr;
+		int count = 0;
+		ShapeResult *results = nullptr;
+		int *result_counts = nullptr;
+		int result_max = 0;
+		real_t *closest_safe = nullptr;
+		real_t *closest_unsafe = nullptr;
+	};
+
+	// The query implementations take the broadphase results as arguments, or the buffers to cull into,
+	// so batched queries can run on several threads without sharing the space's buffers.
+	bool _intersect_ray(const RayParameters &p_parameters, const Vector3 &p_from, const Vector3 &p_to, GodotCollisionObject3D *const *p_objects, const int *p_subindices, int p_amount, RayResult &r_result);
+	int _intersect_shape(GodotShape3D *p_shape, const ShapeParameters &p_parameters, const Transform3D &p_transform, GodotCollisionObject3D **r_objects, int *r_subindices, ShapeResult *r_results, int p_result_max);
+	void _cast_motion(GodotShape3D *p_shape, const ShapeParameters &p_parameters, const Transform3D &p_transform, GodotCollisionObject3D **r_objects, int *r_subindices, real_t &p_closest_safe, real_t &p_closest_unsafe, ShapeRestInfo *r_info);
+
+	void _run_batch(void (GodotPhysicsDirectSpaceState3D::*p_task)(uint32_t, void *), void *p_batch, int p_count, const StringName &p_name);
+	void _intersect_rays_task(uint32_t p_task_index, void *p_batch);
+	void _intersect_shapes_task(uint32_t p_task_index, void *p_batch);
+	void _cast_motions_task(uint32_t p_task_index, void *p_batch);
+
 public:
 	GodotSpace3D *space = nullptr;
 
@@ -57,6 +89,10 @@ public:
 	virtual bool rest_info(const ShapeParameters &p_parameters, ShapeRestInfo *r_info) override;
 	virtual Vector3 get_closest_point_to_object_volume(RID p_object, const Vector3 p_point) const override;
 
+	virtual void intersect_rays(const RayParameters &p_parameters, const Vector3 *p_from, const Vector3 *p_to, int p_count, RayResult *r_results, bool *r_hits) override;
+	virtual void intersect_shapes(const ShapeParameters &p_parameters, const Transform3D *p_transforms, int p_count, ShapeResult *r_results, int *r_result_counts, int p_result_max) override;
+	virtual bool cast_motions(const ShapeParameters &p_parameters, const Transform3D *p_transforms, int p_count, real_t *r_closest_safe, real_t *r_closest_unsafe) override;
+
 	GodotPhysicsDirectSpaceState3D();
 };
 
@@ -101,7 +137,13 @@ private:
 	real_t contact_bias = 0.0;
 
 	enum {
-		INTERSECTION_QUERY_MAX = 2048
+		INTERSECTION_QUERY_MAX = 2048,
+		// Batched rays are culled in packets, keeping fewer results per ray so the buffers for a packet stay small.
+		// Rays which fill their share are culled again on their own, with INTERSECTION_QUERY_MAX results.
+		RAY_PACKET_SIZE = 32,
+		RAY_PACKET_QUERY_MAX = 256,
+		// Batches are split in tasks of this many queries for the worker threads (a multiple of RAY_PACKET_SIZE).
+		BATCH_QUERY_TASK_SIZE = 64,
 	};
 
 	GodotCollisionObject3D *intersection_query_results[INTERSECTION_QUERY_MAX];
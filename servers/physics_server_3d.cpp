@@ -474,6 +474,153 @@ Dictionary PhysicsDirectSpaceState3D::_get_rest_info(const Ref<PhysicsShapeQuery
 	return r;
 }
 
+Dictionary PhysicsDirectSpaceState3D::_intersect_rays(const Ref<PhysicsRayQueryParameters3D> &p_ray_query, const PackedVector3Array &p_from, const PackedVector3Array &p_to) {
+	ERR_FAIL_COND_V(!p_ray_query.is_valid(), Dictionary());
+	ERR_FAIL_COND_V_MSG(p_from.size() != p_to.size(), Dictionary(), "The amount of ray origins and ends must be the same.");
+
+	const int count = p_from.size();
+	Vector<RayResult> results;
+	results.resize(count);
+	Vector<bool> hits;
+	hits.resize(count);
+	hits.fill(false);
+	intersect_rays(p_ray_query->get_parameters(), p_from.ptr(), p_to.ptr(), count, results.ptrw(), hits.ptrw());
+
+	PackedByteArray hit;
+	PackedVector3Array position;
+	PackedVector3Array normal;
+	PackedInt32Array face_index;
+	PackedInt64Array collider_id;
+	PackedInt32Array shape;
+	Array rid;
+	hit.resize(count);
+	position.resize(count);
+	normal.resize(count);
+	face_index.resize(count);
+	collider_id.resize(count);
+	shape.resize(count);
+	rid.resize(count);
+	for (int i = 0; i < count; i++) {
+		const RayResult &result = results[i];
+		hit.write[i] = hits[i];
+		position.write[i] = hits[i] ? result.position : Vector3();
+		normal.write[i] = hits[i] ? result.normal : Vector3();
+		face_index.write[i] = hits[i] ? result.face_index : -1;
+		collider_id.write[i] = hits[i] ? int64_t(result.collider_id) : 0;
+		shape.write[i] = hits[i] ? result.shape : 0;
+		rid[i] = hits[i] ? result.rid : RID();
+	}
+
+	Dictionary d;
+	d["hit"] = hit;
+	d["position"] = position;
+	d["normal"] = normal;
+	d["face_index"] = face_index;
+	d["collider_id"] = collider_id;
+	d["shape"] = shape;
+	d["rid"] = rid;
+
+	return d;
+}
+
+Dictionary PhysicsDirectSpaceState3D::_intersect_shapes(const Ref<PhysicsShapeQueryParameters3D> &p_shape_query, const PackedVector3Array &p_origins, int p_max_results) {
+	ERR_FAIL_COND_V(!p_shape_query.is_valid(), Dictionary());
+	ERR_FAIL_COND_V(p_max_results <= 0, Dictionary());
+
+	const int count = p_origins.size();
+	Vector<Transform3D> transforms;
+	transforms.resize(count);
+	for (int i = 0; i < count; i++) {
+		transforms.write[i] = Transform3D(p_shape_query->get_parameters().transform.basis, p_origins[i]);
+	}
+
+	Vector<ShapeResult> results;
+	results.resize(count * p_max_results);
+	PackedInt32Array result_count;
+	result_count.resize(count);
+	result_count.fill(0);
+	intersect_shapes(p_shape_query->get_parameters(), transforms.ptr(), count, results.ptrw(), result_count.ptrw(), p_max_results);
+
+	PackedInt64Array collider_id;
+	PackedInt32Array shape;
+	Array rid;
+	collider_id.resize(count * p_max_results);
+	shape.resize(count * p_max_results);
+	rid.resize(count * p_max_results);
+	for (int i = 0; i < count; i++) {
+		for (int j = 0; j < p_max_results; j++) {
+			const int index = i * p_max_results + j;
+			const bool valid = j < result_count[i];
+			collider_id.write[index] = valid ? int64_t(results[index].collider_id) : 0;
+			shape.write[index] = valid ? results[index].shape : 0;
+			rid[index] = valid ? results[index].rid : RID();
+		}
+	}
+
+	Dictionary d;
+	d["count"] = result_count;
+	d["collider_id"] = collider_id;
+	d["shape"] = shape;
+	d["rid"] = rid;
+
+	return d;
+}
+
+Vector<real_t> PhysicsDirectSpaceState3D::_cast_motions(const Ref<PhysicsShapeQueryParameters3D> &p_shape_query, const PackedVector3Array &p_origins) {
+	ERR_FAIL_COND_V(!p_shape_query.is_valid(), Vector<real_t>());
+
+	const int count = p_origins.size();
+	Vector<Transform3D> transforms;
+	transforms.resize(count);
+	for (int i = 0; i < count; i++) {
+		transforms.write[i] = Transform3D(p_shape_query->get_parameters().transform.basis, p_origins[i]);
+	}
+
+	Vector<real_t> closest_safe;
+	Vector<real_t> closest_unsafe;
+	closest_safe.resize(count);
+	closest_unsafe.resize(count);
+	if (!cast_motions(p_shape_query->get_parameters(), transforms.ptr(), count, closest_safe.ptrw(), closest_unsafe.ptrw())) {
+		return Vector<real_t>();
+	}
+
+	Vector<real_t> ret;
+	ret.resize(count * 2);
+	for (int i = 0; i < count; i++) {
+		ret.write[i * 2 + 0] = closest_safe[i];
+		ret.write[i * 2 + 1] = closest_unsafe[i];
+	}
+	return ret;
+}
+
+void PhysicsDirectSpaceState3D::intersect_rays(const RayParameters &p_parameters, const Vector3 *p_from, const Vector3 *p_to, int p_count, RayResult *r_results, bool *r_hits) {
+	RayParameters parameters = p_parameters;
+	for (int i = 0; i < p_count; i++) {
+		parameters.from = p_from[i];
+		parameters.to = p_to[i];
+		r_hits[i] = intersect_ray(parameters, r_results[i]);
+	}
+}
+
+void PhysicsDirectSpaceState3D::intersect_shapes(const ShapeParameters &p_parameters, const Transform3D *p_transforms, int p_count, ShapeResult *r_results, int *r_result_counts, int p_result_max) {
+	ShapeParameters parameters = p_parameters;
+	for (int i = 0; i < p_count; i++) {
+		parameters.transform = p_transforms[i];
+		r_result_counts[i] = intersect_shape(parameters, r_results + i * p_result_max, p_result_max);
+	}
+}
+
+bool PhysicsDirectSpaceState3D::cast_motions(const ShapeParameters &p_parameters, const Transform3D *p_transforms, int p_count, real_t *r_closest_safe, real_t *r_closest_unsafe) {
+	ShapeParameters parameters = p_parameters;
+	for (int i = 0; i < p_count; i++) {
+		parameters.transform = p_transforms[i];
+		if (!cast_motion(parameters, r_closest_safe[i], r_closest_unsafe[i])) {
+			return false;
+		}
+	}
+	return true;
+}
+
 PhysicsDirectSpaceState3D::PhysicsDirectSpaceState3D() {
 }
 
@@ -484,6 +631,9 @@ void PhysicsDirectSpaceState3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("cast_motion", "parameters"), &PhysicsDirectSpaceState3D::_cast_motion);
 	ClassDB::bind_method(D_METHOD("collide_shape", "parameters", "max_results"), &PhysicsDirectSpaceState3D::_collide_shape, DEFVAL(32));
 	ClassDB::bind_method(D_METHOD("get_rest_info", "parameters"), &PhysicsDirectSpaceState3D::_get_rest_info);
+	ClassDB::bind_method(D_METHOD("intersect_rays", "parameters", "from", "to"), &PhysicsDirectSpaceState3D::_intersect_rays);
+	ClassDB::bind_method(D_METHOD("intersect_shapes", "parameters", "origins", "max_results"), &PhysicsDirectSpaceState3D::_intersect_shapes, DEFVAL(1));
+	ClassDB::bind_method(D_METHOD("cast_motions", "parameters", "origins"), &PhysicsDirectSpaceState3D::_cast_motions);
 }
 
 ///////////////////////////////
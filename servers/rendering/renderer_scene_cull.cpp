@@ -158,7 +158,7 @@ void RendererSceneCull::_instance_pair(Instance *p_A, Instance *p_B) {
 		light->geometries.insert(A);
 
 		if (geom->can_cast_shadows) {
-			light->shadow_dirty = true;
+			light->mark_shadow_casters_dirty();
 		}
 
 		if (A->scenario && A->array_index >= 0) {
@@ -265,7 +265,7 @@ void RendererSceneCull::_instance_unpair(Instance *p_A, Instance *p_B) {
 		light->geometries.erase(A);
 
 		if (geom->can_cast_shadows) {
-			light->shadow_dirty = true;
+			light->mark_shadow_casters_dirty();
 		}
 
 		if (A->scenario && A->array_index >= 0) {
@@ -871,7 +871,7 @@ void RendererSceneCull::instance_set_layer_mask(RID p_instance, uint32_t p_mask)
 		if (geom->can_cast_shadows) {
 			for (HashSet<RendererSceneCull::Instance *>::Iterator I = geom->lights.begin(); I != geom->lights.end(); ++I) {
 				InstanceLightData *light = static_cast<InstanceLightData *>((*I)->base_data);
-				light->shadow_dirty = true;
+				light->mark_shadow_casters_dirty();
 			}
 		}
 	}
@@ -1557,7 +1557,45 @@ void RendererSceneCull::instance_geometry_get_shader_parameter_list(RID p_instan
 	}
 }
 
-void RendererSceneCull::_update_instance(Instance *p_instance) {
+AABB RendererSceneCull::_get_instance_bvh_aabb(const Instance *p_instance, const AABB &p_transformed_aabb) {
+	//quantize to improve moving object performance
+	AABB bvh_aabb = p_transformed_aabb;
+
+	if (p_instance->indexer_id.is_valid() && bvh_aabb != p_instance->prev_transformed_aabb) {
+		//assume motion, see if bounds need to be quantized
+		AABB motion_aabb = bvh_aabb.merge(p_instance->prev_transformed_aabb);
+		float motion_longest_axis = motion_aabb.get_longest_axis_size();
+		float longest_axis = p_transformed_aabb.get_longest_axis_size();
+
+		if (motion_longest_axis < longest_axis * 2) {
+			//moved but not a lot, use motion aabb quantizing
+			float quantize_size = Math::pow(2.0, Math::ceil(Math::log(motion_longest_axis) / Math::log(2.0))) * 0.5; //one fifth
+			bvh_aabb.quantize(quantize_size);
+		}
+	}
+
+	return bvh_aabb;
+}
+
+void RendererSceneCull::_update_instance_bounds_threaded(uint32_t p_thread, DirtyInstanceBatch *p_batch) {
+	uint32_t total_threads = WorkerThreadPool::get_singleton()->get_thread_count();
+	uint32_t count = p_batch->instances.size();
+	uint32_t from = p_thread * count / total_threads;
+	uint32_t to = (p_thread + 1 == total_threads) ? count : ((p_thread + 1) * count / total_threads);
+
+	_update_instance_bounds(*p_batch, from, to);
+}
+
+void RendererSceneCull::_update_instance_bounds(DirtyInstanceBatch &p_batch, uint32_t p_from, uint32_t p_to) {
+	// Only reads the instance and writes to its own slot, so chunks can run in parallel.
+	for (uint32_t i = p_from; i < p_to; i++) {
+		const Instance *instance = p_batch.instances[i];
+		p_batch.transformed_aabbs[i] = instance->transform.xform(instance->aabb);
+		p_batch.bvh_aabbs[i] = _get_instance_bvh_aabb(instance, p_batch.transformed_aabbs[i]);
+	}
+}
+
+void RendererSceneCull::_update_instance(Instance *p_instance, const AABB *p_transformed_aabb, const AABB *p_bvh_aabb) {
 	p_instance->version++;
 
 	if (p_instance->base_type == RS::INSTANCE_LIGHT) {
@@ -1565,7 +1603,7 @@ void RendererSceneCull::_update_instance(Instance *p_instance) {
 
 		RSG::light_storage->light_instance_set_transform(light->instance, p_instance->transform);
 		RSG::light_storage->light_instance_set_aabb(light->instance, p_instance->transform.xform(p_instance->aabb));
-		light->shadow_dirty = true;
+		light->mark_shadow_casters_dirty();
 
 		RS::LightBakeMode bake_mode = RSG::light_storage->light_get_bake_mode(p_instance->base);
 		if (RSG::light_storage->light_get_type(p_instance->base) != RS::LIGHT_DIRECTIONAL && bake_mode != light->bake_mode) {
@@ -1640,7 +1678,7 @@ void RendererSceneCull::_update_instance(Instance *p_instance) {
 	}
 
 	AABB new_aabb;
-	new_aabb = p_instance->transform.xform(p_instance->aabb);
+	new_aabb = p_transformed_aabb ? *p_transformed_aabb : p_instance->transform.xform(p_instance->aabb);
 	p_instance->transformed_aabb = new_aabb;
 
 	if ((1 << p_instance->base_type) & RS::INSTANCE_GEOMETRY_MASK) {
@@ -1650,7 +1688,7 @@ void RendererSceneCull::_update_instance(Instance *p_instance) {
 		if (geom->can_cast_shadows) {
 			for (const Instance *E : geom->lights) {
 				InstanceLightData *light = static_cast<InstanceLightData *>(E->base_data);
-				light->shadow_dirty = true;
+				light->mark_shadow_casters_dirty();
 			}
 		}
 
@@ -1676,25 +1714,12 @@ void RendererSceneCull::_update_instance(Instance *p_instance) {
 		return;
 	}
 
-	//quantize to improve moving object performance
-	AABB bvh_aabb = p_instance->transformed_aabb;
-
-	if (p_instance->indexer_id.is_valid() && bvh_aabb != p_instance->prev_transformed_aabb) {
-		//assume motion, see if bounds need to be quantized
-		AABB motion_aabb = bvh_aabb.merge(p_instance->prev_transformed_aabb);
-		float motion_longest_axis = motion_aabb.get_longest_axis_size();
-		float longest_axis = p_instance->transformed_aabb.get_longest_axis_size();
-
-		if (motion_longest_axis < longest_axis * 2) {
-			//moved but not a lot, use motion aabb quantizing
-			float quantize_size = Math::pow(2.0, Math::ceil(Math::log(motion_longest_axis) / Math::log(2.0))) * 0.5; //one fifth
-			bvh_aabb.quantize(quantize_size);
-		}
-	}
+	AABB bvh_aabb = p_bvh_aabb ? *p_bvh_aabb : _get_instance_bvh_aabb(p_instance, p_instance->transformed_aabb);
 
 	if (!p_instance->indexer_id.is_valid()) {
 		if ((1 << p_instance->base_type) & RS::INSTANCE_GEOMETRY_MASK) {
 			p_instance->indexer_id = p_instance->scenario->indexers[Scenario::INDEXER_GEOMETRY].insert(bvh_aabb, p_instance);
+			p_instance->scenario->geometry_indexer_version++;
 		} else {
 			p_instance->indexer_id = p_instance->scenario->indexers[Scenario::INDEXER_VOLUMES].insert(bvh_aabb, p_instance);
 		}
@@ -1862,6 +1887,7 @@ void RendererSceneCull::_unpair_instance(Instance *p_instance) {
 
 	if ((1 << p_instance->base_type) & RS::INSTANCE_GEOMETRY_MASK) {
 		p_instance->scenario->indexers[Scenario::INDEXER_GEOMETRY].remove(p_instance->indexer_id);
+		p_instance->scenario->geometry_indexer_version++;
 	} else {
 		p_instance->scenario->indexers[Scenario::INDEXER_VOLUMES].remove(p_instance->indexer_id);
 	}
@@ -2291,6 +2317,49 @@ void RendererSceneCull::_light_instance_setup_directional_shadow(int p_shadow_in
 	}
 }
 
+const LocalVector<RendererSceneCull::Instance *> &RendererSceneCull::_light_instance_get_shadow_casters(InstanceLightData *p_light, uint32_t p_pass, const Vector<Plane> &p_planes, Scenario *p_scenario) {
+	LocalVector<Instance *> &casters = p_light->shadow_casters[p_pass];
+	if (p_light->shadow_casters_indexer_version != p_scenario->geometry_indexer_version) {
+		// A cached caster may have been freed.
+		p_light->shadow_casters_valid = 0;
+		p_light->shadow_casters_indexer_version = p_scenario->geometry_indexer_version;
+	}
+	if (p_light->shadow_casters_valid & (1 << p_pass)) {
+		// Neither the light nor any of its casters changed since the last query.
+		return casters;
+	}
+
+	instance_shadow_cull_result.clear();
+
+	Vector<Vector3> points = Geometry3D::compute_convex_mesh_points(&p_planes[0], p_planes.size());
+
+	struct CullConvex {
+		PagedArray<Instance *> *result;
+		_FORCE_INLINE_ bool operator()(void *p_data) {
+			Instance *p_instance = (Instance *)p_data;
+			result->push_back(p_instance);
+			return false;
+		}
+	};
+
+	CullConvex cull_convex;
+	cull_convex.result = &instance_shadow_cull_result;
+
+	p_scenario->indexers[Scenario::INDEXER_GEOMETRY].convex_query(p_planes.ptr(), p_planes.size(), points.ptr(), points.size(), cull_convex);
+
+	// Keep every potential caster, the cheap per-frame checks (e.g. layers) are done by the caller.
+	casters.clear();
+	for (uint32_t i = 0; i < instance_shadow_cull_result.size(); i++) {
+		Instance *instance = instance_shadow_cull_result[i];
+		if (instance->visible && ((1 << instance->base_type) & RS::INSTANCE_GEOMETRY_MASK) && static_cast<InstanceGeometryData *>(instance->base_data)->can_cast_shadows) {
+			casters.push_back(instance);
+		}
+	}
+	p_light->shadow_casters_valid |= 1 << p_pass;
+
+	return casters;
+}
+
 bool RendererSceneCull::_light_instance_update_shadow(Instance *p_instance, const Transform3D p_cam_transform, const Projection &p_cam_projection, bool p_cam_orthogonal, bool p_cam_vaspect, RID p_shadow_atlas, Scenario *p_scenario, float p_screen_mesh_lod_threshold, uint32_t p_visible_layers) {
 	InstanceLightData *light = static_cast<InstanceLightData *>(p_instance->base_data);
 
@@ -2325,28 +2394,12 @@ bool RendererSceneCull::_light_instance_update_shadow(Instance *p_instance, cons
 					planes.write[4] = light_transform.xform(Plane(Vector3(0, -1, z).normalized(), radius));
 					planes.write[5] = light_transform.xform(Plane(Vector3(0, 0, -z), 0));
 
-					instance_shadow_cull_result.clear();
-
-					Vector<Vector3> points = Geometry3D::compute_convex_mesh_points(&planes[0], planes.size());
-
-					struct CullConvex {
-						PagedArray<Instance *> *result;
-						_FORCE_INLINE_ bool operator()(void *p_data) {
-							Instance *p_instance = (Instance *)p_data;
-							result->push_back(p_instance);
-							return false;
-						}
-					};
-
-					CullConvex cull_convex;
-					cull_convex.result = &instance_shadow_cull_result;
-
-					p_scenario->indexers[Scenario::INDEXER_GEOMETRY].convex_query(planes.ptr(), planes.size(), points.ptr(), points.size(), cull_convex);
+					const LocalVector<Instance *> &casters = _light_instance_get_shadow_casters(light, i, planes, p_scenario);
 
 					RendererSceneRender::RenderShadowData &shadow_data = render_shadow_data[max_shadows_used++];
 
-					for (int j = 0; j < (int)instance_shadow_cull_result.size(); j++) {
-						Instance *instance = instance_shadow_cull_result[j];
+					for (uint32_t j = 0; j < casters.size(); j++) {
+						Instance *instance = casters[j];
 						if (!instance->visible || !((1 << instance->base_type) & RS::INSTANCE_GEOMETRY_MASK) || !static_cast<InstanceGeometryData *>(instance->base_data)->can_cast_shadows || !(p_visible_layers & instance->layer_mask)) {
 							continue;
 						} else {
@@ -2403,28 +2456,12 @@ bool RendererSceneCull::_light_instance_update_shadow(Instance *p_instance, cons
 
 					Vector<Plane> planes = cm.get_projection_planes(xform);
 
-					instance_shadow_cull_result.clear();
-
-					Vector<Vector3> points = Geometry3D::compute_convex_mesh_points(&planes[0], planes.size());
-
-					struct CullConvex {
-						PagedArray<Instance *> *result;
-						_FORCE_INLINE_ bool operator()(void *p_data) {
-							Instance *p_instance = (Instance *)p_data;
-							result->push_back(p_instance);
-							return false;
-						}
-					};
-
-					CullConvex cull_convex;
-					cull_convex.result = &instance_shadow_cull_result;
-
-					p_scenario->indexers[Scenario::INDEXER_GEOMETRY].convex_query(planes.ptr(), planes.size(), points.ptr(), points.size(), cull_convex);
+					const LocalVector<Instance *> &casters = _light_instance_get_shadow_casters(light, i, planes, p_scenario);
 
 					RendererSceneRender::RenderShadowData &shadow_data = render_shadow_data[max_shadows_used++];
 
-					for (int j = 0; j < (int)instance_shadow_cull_result.size(); j++) {
-						Instance *instance = instance_shadow_cull_result[j];
+					for (uint32_t j = 0; j < casters.size(); j++) {
+						Instance *instance = casters[j];
 						if (!instance->visible || !((1 << instance->base_type) & RS::INSTANCE_GEOMETRY_MASK) || !static_cast<InstanceGeometryData *>(instance->base_data)->can_cast_shadows || !(p_visible_layers & instance->layer_mask)) {
 							continue;
 						} else {
@@ -2466,28 +2503,12 @@ bool RendererSceneCull::_light_instance_update_shadow(Instance *p_instance, cons
 
 			Vector<Plane> planes = cm.get_projection_planes(light_transform);
 
-			instance_shadow_cull_result.clear();
-
-			Vector<Vector3> points = Geometry3D::compute_convex_mesh_points(&planes[0], planes.size());
-
-			struct CullConvex {
-				PagedArray<Instance *> *result;
-				_FORCE_INLINE_ bool operator()(void *p_data) {
-					Instance *p_instance = (Instance *)p_data;
-					result->push_back(p_instance);
-					return false;
-				}
-			};
-
-			CullConvex cull_convex;
-			cull_convex.result = &instance_shadow_cull_result;
-
-			p_scenario->indexers[Scenario::INDEXER_GEOMETRY].convex_query(planes.ptr(), planes.size(), points.ptr(), points.size(), cull_convex);
+			const LocalVector<Instance *> &casters = _light_instance_get_shadow_casters(light, 0, planes, p_scenario);
 
 			RendererSceneRender::RenderShadowData &shadow_data = render_shadow_data[max_shadows_used++];
 
-			for (int j = 0; j < (int)instance_shadow_cull_result.size(); j++) {
-				Instance *instance = instance_shadow_cull_result[j];
+			for (uint32_t j = 0; j < casters.size(); j++) {
+				Instance *instance = casters[j];
 				if (!instance->visible || !((1 << instance->base_type) & RS::INSTANCE_GEOMETRY_MASK) || !static_cast<InstanceGeometryData *>(instance->base_data)->can_cast_shadows || !(p_visible_layers & instance->layer_mask)) {
 					continue;
 				} else {
@@ -2733,23 +2754,41 @@ void RendererSceneCull::_scene_cull(CullData &cull_data, InstanceCullResult &cul
 	Transform3D inv_cam_transform = cull_data.cam_transform.inverse();
 	float z_near = cull_data.camera_matrix->get_z_near();
 
+	// Frustum tests are done a block of instances at a time, for the camera and every shadow cascade.
+	InstanceBoundsBlock bounds_block;
+	uint32_t frustum_mask = 0;
+	uint32_t cascade_masks[RendererSceneRender::MAX_DIRECTIONAL_LIGHTS][RendererSceneRender::MAX_DIRECTIONAL_LIGHT_CASCADES];
+	uint32_t block_bit = 0;
+
 	for (uint64_t i = p_from; i < p_to; i++) {
 		bool mesh_visible = false;
 
+		const uint32_t block_index = (i - p_from) % InstanceBoundsBlock::SIZE;
+		if (block_index == 0) {
+			bounds_block.load(cull_data.scenario->instance_aabbs, i, MIN(p_to - i, uint64_t(InstanceBoundsBlock::SIZE)));
+			frustum_mask = bounds_block.cull(cull_data.cull->frustum);
+			for (uint32_t j = 0; j < cull_data.cull->shadow_count; j++) {
+				for (uint32_t k = 0; k < cull_data.cull->shadows[j].cascade_count; k++) {
+					cascade_masks[j][k] = bounds_block.cull(cull_data.cull->shadows[j].cascades[k].frustum);
+				}
+			}
+		}
+		block_bit = 1u << block_index;
+
 		InstanceData &idata = cull_data.scenario->instance_data[i];
 		uint32_t visibility_flags = idata.flags & (InstanceData::FLAG_VISIBILITY_DEPENDENCY_HIDDEN_CLOSE_RANGE | InstanceData::FLAG_VISIBILITY_DEPENDENCY_HIDDEN | InstanceData::FLAG_VISIBILITY_DEPENDENCY_FADE_CHILDREN);
 		int32_t visibility_check = -1;
 
 #define HIDDEN_BY_VISIBILITY_CHECKS (visibility_flags == InstanceData::FLAG_VISIBILITY_DEPENDENCY_HIDDEN_CLOSE_RANGE || visibility_flags == InstanceData::FLAG_VISIBILITY_DEPENDENCY_HIDDEN)
 #define LAYER_CHECK (cull_data.visible_layers & idata.layer_mask)
-#define IN_FRUSTUM(f) (cull_data.scenario->instance_aabbs[i].in_frustum(f))
+#define IN_FRUSTUM(m) ((m) & block_bit)
 #define VIS_RANGE_CHECK ((idata.visibility_index == -1) || _visibility_range_check<false>(cull_data.scenario->instance_visibility[idata.visibility_index], cull_data.cam_transform.origin, cull_data.visibility_viewport_mask) == 0)
 #define VIS_PARENT_CHECK (_visibility_parent_check(cull_data, idata))
 #define VIS_CHECK (visibility_check < 0 ? (visibility_check = (visibility_flags != InstanceData::FLAG_VISIBILITY_DEPENDENCY_NEEDS_CHECK || (VIS_RANGE_CHECK && VIS_PARENT_CHECK))) : visibility_check)
 #define OCCLUSION_CULLED (cull_data.occlusion_buffer != nullptr && (cull_data.scenario->instance_data[i].flags & InstanceData::FLAG_IGNORE_OCCLUSION_CULLING) == 0 && cull_data.occlusion_buffer->is_occluded(cull_data.scenario->instance_aabbs[i].bounds, cull_data.cam_transform.origin, inv_cam_transform, *cull_data.camera_matrix, z_near))
 
 		if (!HIDDEN_BY_VISIBILITY_CHECKS) {
-			if ((LAYER_CHECK && IN_FRUSTUM(cull_data.cull->frustum) && VIS_CHECK && !OCCLUSION_CULLED) || (cull_data.scenario->instance_data[i].flags & InstanceData::FLAG_IGNORE_ALL_CULLING)) {
+			if ((LAYER_CHECK && IN_FRUSTUM(frustum_mask) && VIS_CHECK && !OCCLUSION_CULLED) || (cull_data.scenario->instance_data[i].flags & InstanceData::FLAG_IGNORE_ALL_CULLING)) {
 				uint32_t base_type = idata.flags & InstanceData::FLAG_BASE_TYPE_MASK;
 				if (base_type == RS::INSTANCE_LIGHT) {
 					cull_result.lights.push_back(idata.instance);
@@ -2941,7 +2980,7 @@ void RendererSceneCull::_scene_cull(CullData &cull_data, InstanceCullResult &cul
 
 			for (uint32_t j = 0; j < cull_data.cull->shadow_count; j++) {
 				for (uint32_t k = 0; k < cull_data.cull->shadows[j].cascade_count; k++) {
-					if (IN_FRUSTUM(cull_data.cull->shadows[j].cascades[k].frustum) && VIS_CHECK) {
+					if (IN_FRUSTUM(cascade_masks[j][k]) && VIS_CHECK) {
 						uint32_t base_type = idata.flags & InstanceData::FLAG_BASE_TYPE_MASK;
 
 						if (((1 << base_type) & RS::INSTANCE_GEOMETRY_MASK) && idata.flags & InstanceData::FLAG_CAST_SHADOWS && LAYER_CHECK) {
@@ -3786,6 +3825,17 @@ void RendererSceneCull::_update_instance_shader_uniforms_from_material(HashMap<S
 }
 
 void RendererSceneCull::_update_dirty_instance(Instance *p_instance) {
+	_update_dirty_instance_dependencies(p_instance);
+
+	_instance_update_list.remove(&p_instance->update_item);
+
+	_update_instance(p_instance);
+
+	p_instance->update_aabb = false;
+	p_instance->update_dependencies = false;
+}
+
+void RendererSceneCull::_update_dirty_instance_dependencies(Instance *p_instance) {
 	if (p_instance->update_aabb) {
 		_update_instance_aabb(p_instance);
 	}
@@ -3953,7 +4003,7 @@ void RendererSceneCull::_update_dirty_instance(Instance *p_instance) {
 				//ability to cast shadows change, let lights now
 				for (const Instance *E : geom->lights) {
 					InstanceLightData *light = static_cast<InstanceLightData *>(E->base_data);
-					light->shadow_dirty = true;
+					light->mark_shadow_casters_dirty();
 				}
 
 				geom->can_cast_shadows = can_cast_shadows;
@@ -4010,18 +4060,38 @@ void RendererSceneCull::_update_dirty_instance(Instance *p_instance) {
 			geom->geometry_instance->set_surface_materials(p_instance->materials);
 		}
 	}
-
-	_instance_update_list.remove(&p_instance->update_item);
-
-	_update_instance(p_instance);
-
-	p_instance->update_aabb = false;
-	p_instance->update_dependencies = false;
 }
 
 void RendererSceneCull::update_dirty_instances() {
+	DirtyInstanceBatch &batch = dirty_instance_batch;
+
+	// Updating instances may queue others (e.g. geometry captured by a moved lightmap), so repeat until settled.
 	while (_instance_update_list.first()) {
-		_update_dirty_instance(_instance_update_list.first()->self());
+		// Dependencies and local bounds are queried from the storages, which must happen on this thread.
+		batch.instances.clear();
+		while (_instance_update_list.first()) {
+			Instance *instance = _instance_update_list.first()->self();
+			_update_dirty_instance_dependencies(instance);
+			_instance_update_list.remove(&instance->update_item);
+			instance->update_aabb = false;
+			instance->update_dependencies = false;
+			batch.instances.push_back(instance);
+		}
+
+		uint32_t count = batch.instances.size();
+		batch.transformed_aabbs.resize(count);
+		batch.bvh_aabbs.resize(count);
+		if (count > thread_cull_threshold) {
+			WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &RendererSceneCull::_update_instance_bounds_threaded, &batch, WorkerThreadPool::get_singleton()->get_thread_count(), -1, true, SNAME("UpdateInstanceBounds"));
+			WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+		} else {
+			_update_instance_bounds(batch, 0, count);
+		}
+
+		// BVH refitting and pairing modify shared structures, so they stay serial.
+		for (uint32_t i = 0; i < count; i++) {
+			_update_instance(batch.instances[i], &batch.transformed_aabbs[i], &batch.bvh_aabbs[i]);
+		}
 	}
 
 	// Update dirty resources after dirty instances as instance updates may affect resources.
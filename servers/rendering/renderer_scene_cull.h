@@ -46,6 +46,11 @@
 #include "servers/rendering/storage/utilities.h"
 #include "servers/xr/xr_interface.h"
 
+#if !defined(REAL_T_IS_DOUBLE) && (defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1))
+#define RENDERER_SCENE_CULL_SSE
+#include <xmmintrin.h>
+#endif
+
 class RendererSceneCull : public RenderingMethod {
 public:
 	RendererSceneRender *scene_render = nullptr;
@@ -241,6 +246,63 @@ public:
 		}
 	};
 
+	struct InstanceBoundsBlock {
+		// Bounds of consecutive instances transposed into SoA form, so they can be tested
+		// against a plane several at a time. Results match InstanceBounds::in_frustum().
+
+		static constexpr uint32_t SIZE = 32; // One bit per instance in the resulting masks.
+
+		alignas(16) real_t bounds[6][SIZE];
+		uint32_t count = 0;
+
+		_FORCE_INLINE_ void load(const PagedArray<InstanceBounds> &p_bounds, uint64_t p_from, uint32_t p_count) {
+			count = MIN(p_count, SIZE);
+			for (uint32_t i = 0; i < count; i++) {
+				const real_t *src = p_bounds[p_from + i].bounds;
+				for (uint32_t j = 0; j < 6; j++) {
+					bounds[j][i] = src[j];
+				}
+			}
+			for (uint32_t i = count; i < SIZE; i++) {
+				for (uint32_t j = 0; j < 6; j++) {
+					bounds[j][i] = 0;
+				}
+			}
+		}
+
+		// Returns a mask with a bit set for each instance which may be inside the frustum.
+		_FORCE_INLINE_ uint32_t cull(const Frustum &p_frustum) const {
+			const uint32_t valid = count == SIZE ? 0xFFFFFFFF : ((1u << count) - 1);
+			uint32_t outside = 0;
+			for (uint32_t i = 0; i < p_frustum.plane_count && (outside & valid) != valid; i++) {
+				const Plane &plane = p_frustum.planes_ptr[i];
+				const PlaneSign &signs = p_frustum.plane_signs_ptr[i];
+				const real_t *xs = bounds[signs.signs[0]];
+				const real_t *ys = bounds[signs.signs[1]];
+				const real_t *zs = bounds[signs.signs[2]];
+#ifdef RENDERER_SCENE_CULL_SSE
+				const __m128 nx = _mm_set1_ps(plane.normal.x);
+				const __m128 ny = _mm_set1_ps(plane.normal.y);
+				const __m128 nz = _mm_set1_ps(plane.normal.z);
+				const __m128 d = _mm_set1_ps(plane.d);
+				const __m128 zero = _mm_setzero_ps();
+				for (uint32_t j = 0; j < SIZE; j += 4) {
+					// Same operation order as Plane::distance_to(), so results are identical.
+					__m128 dist = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, _mm_load_ps(xs + j)), _mm_mul_ps(ny, _mm_load_ps(ys + j))), _mm_mul_ps(nz, _mm_load_ps(zs + j)));
+					dist = _mm_sub_ps(dist, d);
+					outside |= uint32_t(_mm_movemask_ps(_mm_cmpge_ps(dist, zero))) << j;
+				}
+#else
+				for (uint32_t j = 0; j < SIZE; j++) {
+					const real_t dist = plane.normal.x * xs[j] + plane.normal.y * ys[j] + plane.normal.z * zs[j] - plane.d;
+					outside |= uint32_t(dist >= 0.0) << j;
+				}
+#endif
+			}
+			return ~outside & valid;
+		}
+	};
+
 	struct InstanceVisibilityNotifierData;
 
 	struct InstanceData {
@@ -331,6 +393,10 @@ public:
 
 		LocalVector<RID> dynamic_lights;
 
+		// Changes whenever a geometry enters or leaves INDEXER_GEOMETRY. Light shadow caster caches
+		// can hold geometries the light isn't paired with, so they are dropped when it changes.
+		uint64_t geometry_indexer_version = 0;
+
 		PagedArray<InstanceBounds> instance_aabbs;
 		PagedArray<InstanceData> instance_data;
 		VisibilityArray instance_visibility;
@@ -685,11 +751,22 @@ public:
 
 		HashSet<Instance *> geometries;
 
+		// Shadow casters found by the last query of each shadow pass (up to 6 for cube maps).
+		// They are reused until the light or one of its casters changes.
+		LocalVector<Instance *> shadow_casters[6];
+		uint32_t shadow_casters_valid = 0; // One bit per pass.
+		uint64_t shadow_casters_indexer_version = 0; // Scenario::geometry_indexer_version the casters were found with.
+
 		Instance *baked_light = nullptr;
 
 		RS::LightBakeMode bake_mode;
 		uint32_t max_sdfgi_cascade = 2;
 
+		_FORCE_INLINE_ void mark_shadow_casters_dirty() {
+			shadow_dirty = true;
+			shadow_casters_valid = 0;
+		}
+
 		InstanceLightData() {
 			bake_mode = RS::LIGHT_BAKE_DISABLED;
 			shadow_dirty = true;
@@ -1005,14 +1082,30 @@ public:
 	virtual Variant instance_geometry_get_shader_parameter(RID p_instance, const StringName &p_parameter) const;
 	virtual Variant instance_geometry_get_shader_parameter_default_value(RID p_instance, const StringName &p_parameter) const;
 
-	_FORCE_INLINE_ void _update_instance(Instance *p_instance);
+	// Dirty instances are updated in batches: world and BVH bounds are computed in parallel
+	// into contiguous arrays, then consumed serially to refit the BVH and repair pairs.
+	struct DirtyInstanceBatch {
+		LocalVector<Instance *> instances;
+		LocalVector<AABB> transformed_aabbs;
+		LocalVector<AABB> bvh_aabbs;
+	};
+
+	DirtyInstanceBatch dirty_instance_batch;
+
+	static _FORCE_INLINE_ AABB _get_instance_bvh_aabb(const Instance *p_instance, const AABB &p_transformed_aabb);
+	void _update_instance_bounds_threaded(uint32_t p_thread, DirtyInstanceBatch *p_batch);
+	void _update_instance_bounds(DirtyInstanceBatch &p_batch, uint32_t p_from, uint32_t p_to);
+
+	_FORCE_INLINE_ void _update_instance(Instance *p_instance, const AABB *p_transformed_aabb = nullptr, const AABB *p_bvh_aabb = nullptr);
 	_FORCE_INLINE_ void _update_instance_aabb(Instance *p_instance);
+	_FORCE_INLINE_ void _update_dirty_instance_dependencies(Instance *p_instance);
 	_FORCE_INLINE_ void _update_dirty_instance(Instance *p_instance);
 	_FORCE_INLINE_ void _update_instance_lightmap_captures(Instance *p_instance);
 	void _unpair_instance(Instance *p_instance);
 
 	void _light_instance_setup_directional_shadow(int p_shadow_index, Instance *p_instance, const Transform3D p_cam_transform, const Projection &p_cam_projection, bool p_cam_orthogonal, bool p_cam_vaspect);
 
+	const LocalVector<Instance *> &_light_instance_get_shadow_casters(InstanceLightData *p_light, uint32_t p_pass, const Vector<Plane> &p_planes, Scenario *p_scenario);
 	_FORCE_INLINE_ bool _light_instance_update_shadow(Instance *p_instance, const Transform3D p_cam_transform, const Projection &p_cam_projection, bool p_cam_orthogonal, bool p_cam_vaspect, RID p_shadow_atlas, Scenario *p_scenario, float p_scren_mesh_lod_threshold, uint32_t p_visible_layers = 0xFFFFFF);
 
 	RID _render_get_environment(RID p_camera, RID p_scenario);
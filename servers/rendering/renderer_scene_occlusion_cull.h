@@ -33,12 +33,17 @@
 
 #include "core/math/projection.h"
 #include "core/templates/local_vector.h"
+#include "core/templates/safe_refcount.h"
 #include "servers/rendering_server.h"
 
 class RendererSceneOcclusionCull {
 protected:
 	static RendererSceneOcclusionCull *singleton;
 
+	// Timings of the last buffer update, written from the render thread.
+	SafeNumeric<uint64_t> update_time_usec;
+	SafeNumeric<uint64_t> raycast_time_usec;
+
 public:
 	class HZBuffer {
 	protected:
@@ -192,6 +197,9 @@ public:
 
 	virtual void set_build_quality(RS::ViewportOcclusionCullingBuildQuality p_quality) {}
 
+	double get_update_time() const { return update_time_usec.get() / 1000000.0; }
+	double get_raycast_time() const { return raycast_time_usec.get() / 1000000.0; }
+
 	RendererSceneOcclusionCull() {
 		singleton = this;
 	};
@@ -326,6 +326,106 @@ TEST_CASE("[Marshalls] FLOAT double precision Variant decoding") {
 	CHECK(r_len == 12);
 	CHECK(variant == Variant(0.33333333333333333));
 }
+
+static Variant encode_decode_round_trip(const Variant &p_variant) {
+	int len = 0;
+	REQUIRE(encode_variant(p_variant, nullptr, len) == OK);
+	Vector<uint8_t> buffer;
+	buffer.resize(len);
+	int written_len = 0;
+	REQUIRE(encode_variant(p_variant, buffer.ptrw(), written_len) == OK);
+	CHECK(written_len == len);
+
+	Variant decoded;
+	int decoded_len = 0;
+	CHECK(decode_variant(decoded, buffer.ptr(), buffer.size(), &decoded_len) == OK);
+	CHECK(decoded_len == len);
+	return decoded;
+}
+
+TEST_CASE("[Marshalls] Packed arrays and strings round trip") {
+	PackedInt32Array ints = { 1, -2, 3, INT32_MAX };
+	PackedInt64Array longs = { 1, -2, INT64_MAX };
+	PackedFloat32Array floats = { 0.5f, -1.25f };
+	PackedFloat64Array doubles = { 0.1, -1e300 };
+	PackedByteArray bytes = { 1, 2, 3, 4, 5 };
+	PackedVector2Array vec2s = { Vector2(1, 2), Vector2(-3, 4.5) };
+	PackedVector3Array vec3s = { Vector3(1, 2, 3), Vector3(-4, 5, 6.5) };
+	PackedColorArray colors = { Color(1, 0.5, 0.25, 1), Color(0, 0, 0, 0) };
+	PackedStringArray strings = { "ascii", "ünïcödé", "" };
+
+	CHECK(encode_decode_round_trip(ints) == Variant(ints));
+	CHECK(encode_decode_round_trip(longs) == Variant(longs));
+	CHECK(encode_decode_round_trip(floats) == Variant(floats));
+	CHECK(encode_decode_round_trip(doubles) == Variant(doubles));
+	CHECK(encode_decode_round_trip(bytes) == Variant(bytes));
+	CHECK(encode_decode_round_trip(vec2s) == Variant(vec2s));
+	CHECK(encode_decode_round_trip(vec3s) == Variant(vec3s));
+	CHECK(encode_decode_round_trip(colors) == Variant(colors));
+	CHECK(encode_decode_round_trip(strings) == Variant(strings));
+	CHECK(encode_decode_round_trip("ascii") == Variant("ascii"));
+	CHECK(encode_decode_round_trip(String::utf8("ünïcödé ✓")) == Variant(String::utf8("ünïcödé ✓")));
+}
+
+TEST_CASE("[Marshalls] Typed arrays and dictionaries round trip") {
+	TypedArray<Vector3> vectors;
+	vectors.push_back(Vector3(1, 2, 3));
+	vectors.push_back(Vector3(4, 5, 6));
+	Array decoded_vectors = encode_decode_round_trip(vectors);
+	CHECK(decoded_vectors.size() == 2);
+	CHECK(decoded_vectors[1] == Variant(Vector3(4, 5, 6)));
+
+	int len = 0;
+	CHECK(encode_variant(vectors, nullptr, len) == OK);
+	CHECK(len == 4 + 4 + 2 * (4 + 3 * int(sizeof(real_t))));
+
+	Dictionary dict;
+	dict["position"] = Vector2(1, 2);
+	dict["name"] = "player";
+	dict[42] = PackedInt32Array({ 1, 2 });
+	Dictionary decoded_dict = encode_decode_round_trip(dict);
+	CHECK(decoded_dict.size() == 3);
+	CHECK(decoded_dict["position"] == Variant(Vector2(1, 2)));
+	CHECK(decoded_dict["name"] == Variant("player"));
+	CHECK(decoded_dict[42] == Variant(PackedInt32Array({ 1, 2 })));
+}
+
+TEST_CASE("[Marshalls] Packed array views") {
+	PackedInt32Array ints = { 10, 20, 30 };
+	int len = 0;
+	REQUIRE(encode_variant(ints, nullptr, len) == OK);
+	Vector<uint8_t> buffer;
+	buffer.resize(len);
+	REQUIRE(encode_variant(ints, buffer.ptrw(), len) == OK);
+
+	PackedArrayView view;
+	int view_len = 0;
+	CHECK(decode_packed_array_view(view, buffer.ptr(), buffer.size(), &view_len) == OK);
+	CHECK(view_len == len);
+	CHECK(view.type == Variant::PACKED_INT32_ARRAY);
+	CHECK(view.count == 3);
+	CHECK(view.element_size == 4);
+	CHECK(view.data == buffer.ptr() + 8);
+	CHECK(decode_uint32(view.data + 4 * 2) == 30);
+
+	PackedByteArray bytes = { 1, 2, 3 };
+	REQUIRE(encode_variant(bytes, nullptr, len) == OK);
+	buffer.resize(len);
+	REQUIRE(encode_variant(bytes, buffer.ptrw(), len) == OK);
+	CHECK(decode_packed_array_view(view, buffer.ptr(), buffer.size(), &view_len) == OK);
+	CHECK(view_len == 12);
+	CHECK(view.count == 3);
+	CHECK(view.data[2] == 3);
+
+	ERR_PRINT_OFF;
+	REQUIRE(encode_variant("not a packed array", nullptr, len) == OK);
+	buffer.resize(len);
+	REQUIRE(encode_variant("not a packed array", buffer.ptrw(), len) == OK);
+	CHECK(decode_packed_array_view(view, buffer.ptr(), buffer.size()) == ERR_INVALID_DATA);
+	// Truncated data.
+	CHECK(decode_packed_array_view(view, buffer.ptr(), 6) == ERR_INVALID_DATA);
+	ERR_PRINT_ON;
+}
 } // namespace TestMarshalls
 
 #endif // TEST_MARSHALLS_H
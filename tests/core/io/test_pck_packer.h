@@ -117,6 +117,73 @@ TEST_CASE("[PCKPacker] Pack a PCK file with some files and directories") {
 			f->get_length() <= 27000,
 			"The generated non-empty PCK file shouldn't be too large.");
 }
+
+TEST_CASE("[PCKPacker] Read compressed files from a PCK file") {
+	// Compressible, and spanning several blocks with a partial last one.
+	const uint64_t size = PACK_COMPRESSED_BLOCK_SIZE * 5 + 123;
+	Vector<uint8_t> data;
+	data.resize(size);
+	for (uint64_t i = 0; i < size; i++) {
+		data.write[i] = (i * 7 / 64 + i % 3) % 251;
+	}
+	const String source_path = OS::get_singleton()->get_cache_path().path_join("compressed_source.bin");
+	{
+		Ref<FileAccess> f = FileAccess::open(source_path, FileAccess::WRITE);
+		REQUIRE(f.is_valid());
+		f->store_buffer(data.ptr(), data.size());
+	}
+
+	PCKPacker pck_packer;
+	const String output_pck_path = OS::get_singleton()->get_cache_path().path_join("output_compressed.pck");
+	REQUIRE(pck_packer.pck_start(output_pck_path) == OK);
+	CHECK(pck_packer.add_file("res://compressed_pck/compressed.bin", source_path, false, true) == OK);
+	CHECK(pck_packer.add_file("res://compressed_pck/stored.bin", source_path) == OK);
+	CHECK(pck_packer.add_file("res://compressed_pck/dir/version.py", OS::get_singleton()->get_executable_path().get_base_dir().path_join("../version.py"), false, true) == OK);
+	REQUIRE(pck_packer.flush() == OK);
+
+	CHECK_MESSAGE(
+			FileAccess::get_file_as_bytes(output_pck_path).size() < int64_t(size) * 3 / 2,
+			"The compressed file should take much less space than the stored one.");
+
+	// Replaces the project's pack data until the end of the test, so the files aren't added to it.
+	PackedData packed_data;
+	CHECK(packed_data.add_pack(output_pck_path, false, 0) == OK);
+
+	CHECK(packed_data.has_path("res://compressed_pck/compressed.bin"));
+	CHECK(packed_data.has_path("res://compressed_pck/dir/version.py"));
+	CHECK_FALSE(packed_data.has_path("res://compressed_pck/missing.bin"));
+
+	Ref<FileAccess> compressed = packed_data.try_open_path("res://compressed_pck/compressed.bin");
+	Ref<FileAccess> stored = packed_data.try_open_path("res://compressed_pck/stored.bin");
+	REQUIRE(compressed.is_valid());
+	REQUIRE(stored.is_valid());
+	CHECK(compressed->get_length() == size);
+	CHECK_MESSAGE(compressed->get_buffer(size) == data, "The whole compressed file should be read back unchanged.");
+	CHECK_MESSAGE(stored->get_buffer(size) == data, "The whole stored file should be read back unchanged.");
+	CHECK(compressed->eof_reached() == false);
+	CHECK(compressed->get_8() == 0);
+	CHECK(compressed->eof_reached());
+
+	// Across a block boundary, then backwards.
+	const uint64_t positions[] = { PACK_COMPRESSED_BLOCK_SIZE * 3 - 10, 5, size - 20 };
+	for (uint64_t position : positions) {
+		compressed->seek(position);
+		Vector<uint8_t> read = compressed->get_buffer(20);
+		REQUIRE(read.size() == 20);
+		CHECK(memcmp(read.ptr(), data.ptr() + position, 20) == 0);
+		compressed->seek(position + 1);
+		CHECK(compressed->get_8() == data[position + 1]);
+	}
+
+	Ref<DirAccess> da = packed_data.try_open_directory("res://compressed_pck/dir");
+	REQUIRE(da.is_valid());
+	CHECK(da->file_exists("version.py"));
+	CHECK(FileAccess::get_file_as_string("res://compressed_pck/dir/version.py").begins_with("short_name"));
+
+	compressed.unref();
+	stored.unref();
+	da.unref();
+}
 } // namespace TestPCKPacker
 
 #endif // TEST_PCK_PACKER_H
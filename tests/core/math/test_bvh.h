@@ -0,0 +1,279 @@
+/**************************************************************************/
+/*  test_bvh.h                                                            */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_BVH_H
+#define TEST_BVH_H
+
+#include "core/math/bvh.h"
+#include "core/math/random_pcg.h"
+
+#include "tests/test_macros.h"
+
+namespace TestBVH {
+
+struct Item {
+	int id = 0;
+};
+
+// Same setup as the physics broadphases, which pair and cull everything by default.
+class ItemPairTestFunction {
+public:
+	static bool user_pair_check(const Item *p_a, const Item *p_b) {
+		return true;
+	}
+};
+
+class ItemCullTestFunction {
+public:
+	static bool user_cull_check(const Item *p_a, const Item *p_b) {
+		return true;
+	}
+};
+
+typedef BVH_Manager<Item, 2, true, 32, ItemPairTestFunction, ItemCullTestFunction> ItemBVH;
+
+TEST_CASE("[BVH] Segment packets give the same results as single segments") {
+	const int item_count = 500;
+	const int segment_count = 100;
+	const int result_max = 16;
+
+	ItemBVH bvh;
+	LocalVector<Item> items;
+	items.resize(item_count);
+
+	RandomPCG rng(42);
+
+	for (int i = 0; i < item_count; i++) {
+		items[i].id = i;
+		Vector3 position(rng.random(-20.0f, 20.0f), rng.random(-20.0f, 20.0f), rng.random(-20.0f, 20.0f));
+		Vector3 size(rng.random(1.0f, 5.0f), rng.random(1.0f, 5.0f), rng.random(1.0f, 5.0f));
+		// Spread the items over both trees.
+		bvh.create(&items[i], true, i % 2, 3, AABB(position, size), i);
+	}
+	bvh.update();
+
+	LocalVector<Vector3> from;
+	LocalVector<Vector3> to;
+	for (int i = 0; i < segment_count; i++) {
+		// Most segments start close together, like rays cast from a group of characters.
+		from.push_back(Vector3(rng.random(-5.0f, 5.0f), rng.random(-5.0f, 5.0f), rng.random(-5.0f, 5.0f)));
+		to.push_back(Vector3(rng.random(-30.0f, 30.0f), rng.random(-30.0f, 30.0f), rng.random(-30.0f, 30.0f)));
+	}
+
+	LocalVector<Item *> packet_results;
+	LocalVector<int> packet_subindices;
+	LocalVector<int> packet_counts;
+	packet_results.resize(segment_count * result_max);
+	packet_subindices.resize(segment_count * result_max);
+	packet_counts.resize(segment_count);
+	bvh.cull_segments(from.ptr(), to.ptr(), segment_count, packet_results.ptr(), packet_counts.ptr(), result_max, nullptr, 0xFFFFFFFF, packet_subindices.ptr());
+
+	int total_hits = 0;
+	bool identical = true;
+	for (int i = 0; i < segment_count; i++) {
+		Item *results[result_max];
+		int subindices[result_max];
+		int count = bvh.cull_segment(from[i], to[i], results, result_max, nullptr, 0xFFFFFFFF, subindices);
+
+		identical = identical && count == packet_counts[i];
+		for (int j = 0; identical && j < count; j++) {
+			identical = results[j] == packet_results[i * result_max + j] && subindices[j] == packet_subindices[i * result_max + j];
+		}
+		total_hits += count;
+	}
+
+	CHECK_MESSAGE(identical, "Every segment in a packet should get the same results, in the same order, as when culled on its own.");
+	CHECK_MESSAGE(total_hits > segment_count, "The segments should hit a reasonable amount of items.");
+}
+
+TEST_CASE("[BVH] Segment packets respect the tree collision mask") {
+	ItemBVH bvh;
+	Item items[2];
+	bvh.create(&items[0], true, 0, 3, AABB(Vector3(-1, -1, -1), Vector3(2, 2, 2)));
+	bvh.create(&items[1], true, 1, 3, AABB(Vector3(-1, -1, 4), Vector3(2, 2, 2)));
+	bvh.update();
+
+	const Vector3 from[2] = { Vector3(0, 0, -10), Vector3(0, 5, -10) };
+	const Vector3 to[2] = { Vector3(0, 0, 10), Vector3(0, 5, 10) };
+	Item *results[2 * 4];
+	int counts[2];
+
+	bvh.cull_segments(from, to, 2, results, counts, 4, nullptr, 0xFFFFFFFF);
+	CHECK(counts[0] == 2);
+	CHECK(counts[1] == 0);
+
+	bvh.cull_segments(from, to, 2, results, counts, 4, nullptr, 2);
+	CHECK(counts[0] == 1);
+	CHECK(results[0] == &items[1]);
+	CHECK(counts[1] == 0);
+
+	// Results stop at the maximum per segment.
+	bvh.cull_segments(from, to, 2, results, counts, 1, nullptr, 0xFFFFFFFF);
+	CHECK(counts[0] == 1);
+}
+
+// Keeps track of the pairs reported by the callbacks, and the order they were reported in.
+struct PairLog {
+	int item_count = 0;
+	LocalVector<uint8_t> paired;
+	LocalVector<int64_t> events;
+
+	void set_paired(const Item *p_a, const Item *p_b, bool p_paired) {
+		const int a = MIN(p_a->id, p_b->id);
+		const int b = MAX(p_a->id, p_b->id);
+		paired[a * item_count + b] = p_paired;
+		// Unpairs are stored as negative events.
+		const int64_t key = int64_t(a) * item_count + b + 1;
+		events.push_back(p_paired ? key : -key);
+	}
+
+	static void *pair_callback(void *p_self, uint32_t p_handle_a, Item *p_a, int p_subindex_a, uint32_t p_handle_b, Item *p_b, int p_subindex_b) {
+		static_cast<PairLog *>(p_self)->set_paired(p_a, p_b, true);
+		return nullptr;
+	}
+
+	static void unpair_callback(void *p_self, uint32_t p_handle_a, Item *p_a, int p_subindex_a, uint32_t p_handle_b, Item *p_b, int p_subindex_b, void *p_pair_data) {
+		static_cast<PairLog *>(p_self)->set_paired(p_a, p_b, false);
+	}
+};
+
+// Enough items to be split over several pairing tasks.
+struct PairingScene {
+	static const int ITEM_COUNT = 600;
+
+	ItemBVH bvh;
+	LocalVector<Item> items;
+	LocalVector<BVHHandle> handles;
+	PairLog log;
+
+	PairingScene() {
+		items.resize(ITEM_COUNT);
+		log.item_count = ITEM_COUNT;
+		log.paired.resize(ITEM_COUNT * ITEM_COUNT);
+		for (uint8_t &paired : log.paired) {
+			paired = 0;
+		}
+		bvh.set_pair_callback(PairLog::pair_callback, &log);
+		bvh.set_unpair_callback(PairLog::unpair_callback, &log);
+	}
+
+	static AABB random_aabb(RandomPCG &r_rng) {
+		Vector3 position(r_rng.random(-20.0f, 20.0f), r_rng.random(-20.0f, 20.0f), r_rng.random(-20.0f, 20.0f));
+		Vector3 size(r_rng.random(1.0f, 5.0f), r_rng.random(1.0f, 5.0f), r_rng.random(1.0f, 5.0f));
+		return AABB(position, size);
+	}
+
+	void create_items(RandomPCG &r_rng) {
+		for (int i = 0; i < ITEM_COUNT; i++) {
+			items[i].id = i;
+			handles.push_back(bvh.create(&items[i], true, 0, 1, random_aabb(r_rng), i));
+		}
+		bvh.update();
+	}
+
+	// Returns the amount of pairs that don't match the overlaps of the items.
+	int count_wrong_pairs(int &r_pair_count) {
+		int wrong = 0;
+		r_pair_count = 0;
+		for (int i = 0; i < ITEM_COUNT; i++) {
+			AABB aabb_a;
+			bvh.item_get_AABB(handles[i], aabb_a);
+			for (int j = i + 1; j < ITEM_COUNT; j++) {
+				AABB aabb_b;
+				bvh.item_get_AABB(handles[j], aabb_b);
+				const bool paired = log.paired[i * ITEM_COUNT + j];
+				wrong += paired != aabb_a.intersects(aabb_b);
+				r_pair_count += paired;
+			}
+		}
+		return wrong;
+	}
+};
+
+TEST_CASE("[BVH] Pairs follow the overlaps when many items move") {
+	PairingScene scene;
+	RandomPCG rng(7);
+	scene.create_items(rng);
+
+	int pair_count = 0;
+	CHECK(scene.count_wrong_pairs(pair_count) == 0);
+	CHECK_MESSAGE(pair_count > PairingScene::ITEM_COUNT / 2, "The items should overlap a reasonable amount.");
+
+	for (int frame = 0; frame < 3; frame++) {
+		for (int i = 0; i < PairingScene::ITEM_COUNT; i++) {
+			scene.bvh.move(scene.handles[i], PairingScene::random_aabb(rng));
+		}
+		scene.bvh.update();
+		CHECK(scene.count_wrong_pairs(pair_count) == 0);
+	}
+
+	// Moving every item away from the others should remove all pairs.
+	for (int i = 0; i < PairingScene::ITEM_COUNT; i++) {
+		scene.bvh.move(scene.handles[i], AABB(Vector3(i * 10, 0, 0), Vector3(1, 1, 1)));
+	}
+	scene.bvh.update();
+	CHECK(scene.count_wrong_pairs(pair_count) == 0);
+	CHECK(pair_count == 0);
+}
+
+TEST_CASE("[BVH] Pair callbacks don't depend on the order items were moved in") {
+	PairingScene forward;
+	PairingScene backward;
+	RandomPCG rng_forward(3);
+	RandomPCG rng_backward(3);
+	forward.create_items(rng_forward);
+	backward.create_items(rng_backward);
+
+	LocalVector<AABB> aabbs;
+	for (int i = 0; i < PairingScene::ITEM_COUNT; i++) {
+		aabbs.push_back(PairingScene::random_aabb(rng_forward));
+	}
+	for (int i = 0; i < PairingScene::ITEM_COUNT; i++) {
+		forward.bvh.move(forward.handles[i], aabbs[i]);
+	}
+	for (int i = PairingScene::ITEM_COUNT - 1; i >= 0; i--) {
+		backward.bvh.move(backward.handles[i], aabbs[i]);
+	}
+	forward.log.events.clear();
+	backward.log.events.clear();
+	forward.bvh.update();
+	backward.bvh.update();
+
+	bool identical = forward.log.events.size() == backward.log.events.size();
+	for (uint32_t i = 0; identical && i < forward.log.events.size(); i++) {
+		identical = forward.log.events[i] == backward.log.events[i];
+	}
+	CHECK(forward.log.events.size() > 0);
+	CHECK_MESSAGE(identical, "The same pairs should be reported in the same order.");
+}
+
+} // namespace TestBVH
+
+#endif // TEST_BVH_H
@@ -0,0 +1,75 @@
+/**************************************************************************/
+/*  test_memory.h                                                         */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_MEMORY_H
+#define TEST_MEMORY_H
+
+#include "core/os/memory.h"
+
+#include "tests/test_macros.h"
+
+namespace TestMemory {
+
+#ifdef DEBUG_ENABLED
+TEST_CASE("[Memory] Tagged allocation tracking") {
+	Memory::set_tracking_enabled(true);
+
+	const uint64_t usage = Memory::get_tag_usage(Memory::TAG_NAVIGATION);
+	const uint64_t alloc_count = Memory::get_tag_alloc_count(Memory::TAG_NAVIGATION);
+
+	void *tagged = nullptr;
+	{
+		MemoryTagScope memory_tag(Memory::TAG_NAVIGATION);
+		tagged = memalloc(1024);
+	}
+	CHECK(Memory::get_tag_usage(Memory::TAG_NAVIGATION) == usage + 1024);
+	CHECK(Memory::get_tag_alloc_count(Memory::TAG_NAVIGATION) == alloc_count + 1);
+
+	// Reallocating outside the scope keeps the original tag.
+	tagged = memrealloc(tagged, 2048);
+	CHECK(Memory::get_tag_usage(Memory::TAG_NAVIGATION) == usage + 2048);
+
+	memfree(tagged);
+	CHECK(Memory::get_tag_usage(Memory::TAG_NAVIGATION) == usage);
+
+	// Allocations made while tracking was disabled are never attributed to a tag.
+	Memory::set_tracking_enabled(false);
+	void *untracked = memalloc(512);
+	Memory::set_tracking_enabled(true);
+	memfree(untracked);
+	CHECK(Memory::get_tag_usage(Memory::TAG_NAVIGATION) == usage);
+
+	Memory::set_tracking_enabled(false);
+}
+#endif
+
+} // namespace TestMemory
+
+#endif // TEST_MEMORY_H
@@ -0,0 +1,112 @@
+/**************************************************************************/
+/*  test_string_name.h                                                    */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_STRING_NAME_H
+#define TEST_STRING_NAME_H
+
+#include "core/object/worker_thread_pool.h"
+#include "core/string/string_name.h"
+
+#include "tests/test_macros.h"
+
+namespace TestStringName {
+
+TEST_CASE("[StringName] Interning") {
+	const StringName from_cstring = StringName("string_name_test");
+	const StringName from_string = StringName(String("string_name_test"));
+	const StringName from_static = _scs_create("string_name_test");
+
+	CHECK(from_cstring == from_string);
+	CHECK(from_cstring == from_static);
+	CHECK(from_cstring.data_unique_pointer() == from_string.data_unique_pointer());
+	CHECK(from_cstring.hash() == String("string_name_test").hash());
+
+	CHECK(StringName::search("string_name_test") == from_cstring);
+	CHECK(StringName::search(String("string_name_test")) == from_cstring);
+	CHECK(StringName::search("string_name_test_does_not_exist") == StringName());
+}
+
+static const int CONCURRENT_NAME_COUNT = 1024;
+static const int CONCURRENT_ROUNDS = 4;
+static LocalVector<LocalVector<StringName>> concurrent_shared_names;
+static LocalVector<LocalVector<StringName>> concurrent_own_names;
+
+static void concurrent_intern(void *p_userdata, uint32_t p_index) {
+	LocalVector<StringName> &shared = concurrent_shared_names[p_index];
+	LocalVector<StringName> &own = concurrent_own_names[p_index];
+	shared.resize(CONCURRENT_NAME_COUNT);
+	own.resize(CONCURRENT_NAME_COUNT);
+	for (int round = 0; round < CONCURRENT_ROUNDS; round++) {
+		for (int i = 0; i < CONCURRENT_NAME_COUNT; i++) {
+			// Names created by all threads at once, starting from a different one in each thread.
+			const int shared_index = (i + p_index * 97) % CONCURRENT_NAME_COUNT;
+			shared[shared_index] = StringName("concurrent_shared_name_" + itos(shared_index) + "_" + itos(round));
+			// Names only created by this thread.
+			own[i] = StringName("concurrent_own_name_" + itos(p_index) + "_" + itos(i) + "_" + itos(round));
+		}
+	}
+}
+
+TEST_CASE("[StringName] Concurrent interning") {
+	const int task_count = MAX(2, WorkerThreadPool::get_singleton()->get_thread_count());
+
+	// None of the names exist yet, so the threads insert them into the table concurrently.
+	// Names of the previous round are released as the next ones are created.
+	concurrent_shared_names.resize(task_count);
+	concurrent_own_names.resize(task_count);
+	WorkerThreadPool::GroupID group = WorkerThreadPool::get_singleton()->add_native_group_task(concurrent_intern, nullptr, task_count, task_count, true);
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group);
+
+	const int last_round = CONCURRENT_ROUNDS - 1;
+	bool shared_unique = true;
+	bool own_unique = true;
+	for (int i = 0; i < CONCURRENT_NAME_COUNT; i++) {
+		const String shared_string = "concurrent_shared_name_" + itos(i) + "_" + itos(last_round);
+		const StringName shared = StringName::search(shared_string);
+		shared_unique &= shared != StringName() && String(shared) == shared_string;
+		for (int t = 0; t < task_count; t++) {
+			shared_unique &= concurrent_shared_names[t][i].data_unique_pointer() == shared.data_unique_pointer();
+
+			const String own_string = "concurrent_own_name_" + itos(t) + "_" + itos(i) + "_" + itos(last_round);
+			const StringName own = concurrent_own_names[t][i];
+			own_unique &= String(own) == own_string && StringName::search(own_string).data_unique_pointer() == own.data_unique_pointer();
+		}
+	}
+	CHECK_MESSAGE(shared_unique, "Names created concurrently by several threads must resolve to a single StringName.");
+	CHECK_MESSAGE(own_unique, "Names created concurrently by a single thread must be found in the table.");
+	CHECK_MESSAGE(StringName::search("concurrent_shared_name_0_0") == StringName(), "Released names must be removed from the table.");
+
+	concurrent_shared_names.clear();
+	concurrent_own_names.clear();
+}
+
+} // namespace TestStringName
+
+#endif // TEST_STRING_NAME_H
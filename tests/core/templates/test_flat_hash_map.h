@@ -0,0 +1,163 @@
+/**************************************************************************/
+/*  test_flat_hash_map.h                                                  */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_FLAT_HASH_MAP_H
+#define TEST_FLAT_HASH_MAP_H
+
+#include "core/templates/flat_hash_map.h"
+
+#include "tests/test_macros.h"
+
+namespace TestFlatHashMap {
+
+TEST_CASE("[FlatHashMap] Insert element") {
+	FlatHashMap<int, int> map;
+	FlatHashMap<int, int>::Iterator e = map.insert(42, 84);
+
+	CHECK(e);
+	CHECK(e->key == 42);
+	CHECK(e->value == 84);
+	CHECK(map[42] == 84);
+	CHECK(map.has(42));
+	CHECK(map.find(42));
+}
+
+TEST_CASE("[FlatHashMap] Overwrite element") {
+	FlatHashMap<int, int> map;
+	map.insert(42, 84);
+	map.insert(42, 1234);
+
+	CHECK(map[42] == 1234);
+	CHECK(map.size() == 1);
+}
+
+TEST_CASE("[FlatHashMap] Erase via element") {
+	FlatHashMap<int, int> map;
+	FlatHashMap<int, int>::Iterator e = map.insert(42, 84);
+	map.remove(e);
+	CHECK(!map.has(42));
+	CHECK(!map.find(42));
+	CHECK(map.is_empty());
+}
+
+TEST_CASE("[FlatHashMap] Erase via key") {
+	FlatHashMap<int, int> map;
+	map.insert(42, 84);
+	CHECK(map.erase(42));
+	CHECK(!map.erase(42));
+	CHECK(!map.has(42));
+	CHECK(!map.find(42));
+}
+
+TEST_CASE("[FlatHashMap] Many elements") {
+	FlatHashMap<int, int> map;
+	const int count = 10000;
+	for (int i = 0; i < count; i++) {
+		map.insert(i * 7, i);
+	}
+	CHECK(map.size() == count);
+	CHECK(map.get_capacity() >= uint32_t(count));
+
+	bool all_found = true;
+	for (int i = 0; i < count; i++) {
+		const int *value = map.getptr(i * 7);
+		all_found &= value != nullptr && *value == i;
+	}
+	CHECK(all_found);
+	CHECK(!map.has(1));
+
+	// Erase every other element, tombstones must not hide the remaining ones.
+	for (int i = 0; i < count; i += 2) {
+		map.erase(i * 7);
+	}
+	CHECK(map.size() == count / 2);
+	bool remaining_found = true;
+	for (int i = 0; i < count; i++) {
+		remaining_found &= map.has(i * 7) == (i % 2 == 1);
+	}
+	CHECK(remaining_found);
+
+	// Churn through insertions and erasures without growing.
+	const uint32_t capacity = map.get_capacity();
+	for (int i = 0; i < count * 4; i++) {
+		map.insert(-1 - i, i);
+		map.erase(-1 - i);
+	}
+	CHECK(map.size() == count / 2);
+	CHECK(map.get_capacity() == capacity);
+}
+
+TEST_CASE("[FlatHashMap] Iteration") {
+	FlatHashMap<int, int> map;
+	for (int i = 0; i < 100; i++) {
+		map.insert(i, i * 2);
+	}
+
+	int visited = 0;
+	int key_sum = 0;
+	bool values_match = true;
+	for (const KeyValue<int, int> &E : map) {
+		visited++;
+		key_sum += E.key;
+		values_match &= E.value == E.key * 2;
+	}
+	CHECK(visited == 100);
+	CHECK(key_sum == 4950);
+	CHECK(values_match);
+
+	for (KeyValue<int, int> &E : map) {
+		E.value = 0;
+	}
+	CHECK(map[99] == 0);
+}
+
+TEST_CASE("[FlatHashMap] String keys, copy and clear") {
+	FlatHashMap<String, String> map;
+	for (int i = 0; i < 200; i++) {
+		map[itos(i)] = "value_" + itos(i);
+	}
+
+	FlatHashMap<String, String> copy = map;
+	map.clear();
+	CHECK(map.is_empty());
+	CHECK(!map.has("5"));
+
+	CHECK(copy.size() == 200);
+	CHECK(copy["5"] == "value_5");
+	CHECK(copy.get("199") == "value_199");
+
+	map = copy;
+	CHECK(map.size() == 200);
+	CHECK(map["42"] == "value_42");
+}
+
+} // namespace TestFlatHashMap
+
+#endif // TEST_FLAT_HASH_MAP_H
@@ -31,7 +31,9 @@
 #ifndef TEST_RID_H
 #define TEST_RID_H
 
+#include "core/object/worker_thread_pool.h"
 #include "core/templates/rid.h"
+#include "core/templates/rid_owner.h"
 
 #include "tests/test_macros.h"
 
@@ -96,6 +98,109 @@ TEST_CASE("[RID] 'get_local_index'") {
 	CHECK(RID::from_uint64(4'294'967'295).get_local_index() == 4'294'967'295);
 	CHECK(RID::from_uint64(4'294'967'297).get_local_index() == 1);
 }
+
+TEST_CASE("[RID_Owner] Batched allocation and free") {
+	RID_Owner<int, true> owner;
+	const uint32_t count = 50000;
+	LocalVector<RID> rids;
+	rids.resize(count);
+
+	owner.make_rids(count, rids.ptr());
+	CHECK(owner.get_rid_count() == count);
+
+	bool all_owned = true;
+	for (uint32_t i = 0; i < count; i++) {
+		all_owned &= owner.owns(rids[i]);
+		*owner.get_or_null(rids[i]) = i;
+	}
+	CHECK(all_owned);
+
+	LocalVector<int *> ptrs;
+	ptrs.resize(count);
+	owner.get_or_null_batch(rids.ptr(), count, ptrs.ptr());
+	bool all_match = true;
+	for (uint32_t i = 0; i < count; i++) {
+		all_match &= ptrs[i] != nullptr && *ptrs[i] == int(i);
+	}
+	CHECK(all_match);
+
+	owner.free_rids(rids.ptr(), count);
+	CHECK(owner.get_rid_count() == 0);
+	CHECK_FALSE(owner.owns(rids[0]));
+	CHECK(owner.get_or_null(rids[count - 1]) == nullptr);
+}
+
+TEST_CASE("[RID_PtrOwner] Batched allocation and free") {
+	const uint32_t count = 1000;
+	LocalVector<int> values;
+	LocalVector<int *> ptrs;
+	values.resize(count);
+	ptrs.resize(count);
+	for (uint32_t i = 0; i < count; i++) {
+		values[i] = i;
+		ptrs[i] = &values[i];
+	}
+
+	RID_PtrOwner<int, true> owner;
+	LocalVector<RID> rids;
+	rids.resize(count);
+	owner.make_rids(count, ptrs.ptr(), rids.ptr());
+	CHECK(owner.get_rid_count() == count);
+
+	LocalVector<int *> found;
+	found.resize(count);
+	owner.get_or_null_batch(rids.ptr(), count, found.ptr());
+	bool all_match = true;
+	for (uint32_t i = 0; i < count; i++) {
+		all_match &= found[i] == &values[i];
+	}
+	CHECK(all_match);
+
+	owner.free_rids(rids.ptr(), count);
+	CHECK(owner.get_rid_count() == 0);
+	owner.get_or_null_batch(rids.ptr(), 1, found.ptr());
+	CHECK(found[0] == nullptr);
+}
+
+static RID_Owner<int, true> concurrent_owner;
+static LocalVector<RID> concurrent_rids;
+static SafeNumeric<uint32_t> concurrent_failures;
+
+static void concurrent_lookup_and_allocate(void *p_userdata, uint32_t p_index) {
+	if (p_index == 0) {
+		// Keep growing the allocator while the other tasks look up existing RIDs.
+		LocalVector<RID> new_rids;
+		new_rids.resize(20000);
+		concurrent_owner.make_rids(new_rids.size(), new_rids.ptr());
+		concurrent_owner.free_rids(new_rids.ptr(), new_rids.size());
+		return;
+	}
+	for (uint32_t round = 0; round < 100; round++) {
+		for (uint32_t i = 0; i < concurrent_rids.size(); i++) {
+			int *value = concurrent_owner.get_or_null(concurrent_rids[i]);
+			if (value == nullptr || *value != int(i)) {
+				concurrent_failures.increment();
+			}
+		}
+	}
+}
+
+TEST_CASE("[RID_Owner] Concurrent lookups while allocating") {
+	concurrent_rids.resize(1000);
+	for (uint32_t i = 0; i < concurrent_rids.size(); i++) {
+		concurrent_rids[i] = concurrent_owner.make_rid(i);
+	}
+
+	const int task_count = MAX(2, WorkerThreadPool::get_singleton()->get_thread_count());
+	WorkerThreadPool::GroupID group = WorkerThreadPool::get_singleton()->add_native_group_task(concurrent_lookup_and_allocate, nullptr, task_count, task_count, true);
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group);
+
+	CHECK(concurrent_failures.get() == 0);
+
+	concurrent_owner.free_rids(concurrent_rids.ptr(), concurrent_rids.size());
+	concurrent_rids.clear();
+	CHECK(concurrent_owner.get_rid_count() == 0);
+}
 } // namespace TestRID
 
 #endif // TEST_RID_H
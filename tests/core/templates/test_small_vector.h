@@ -0,0 +1,124 @@
+/**************************************************************************/
+/*  test_small_vector.h                                                   */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_SMALL_VECTOR_H
+#define TEST_SMALL_VECTOR_H
+
+#include "core/templates/local_vector.h"
+#include "core/templates/small_vector.h"
+
+#include "tests/test_macros.h"
+
+namespace TestSmallVector {
+
+TEST_CASE("[SmallVector] List Initialization.") {
+	SmallVector<int, 4> vector{ 0, 1, 2, 3, 4 };
+
+	CHECK(vector.size() == 5);
+	CHECK(vector[0] == 0);
+	CHECK(vector[1] == 1);
+	CHECK(vector[2] == 2);
+	CHECK(vector[3] == 3);
+	CHECK(vector[4] == 4);
+}
+
+TEST_CASE("[SmallVector] Inline storage.") {
+	SmallVector<int, 4> vector;
+	for (int i = 0; i < 4; i++) {
+		vector.push_back(i);
+	}
+	CHECK(vector.is_inline());
+	CHECK(vector.get_capacity() == 4);
+
+	vector.push_back(4);
+	CHECK_FALSE(vector.is_inline());
+	CHECK(vector.get_capacity() == 8);
+	for (int i = 0; i < 5; i++) {
+		CHECK(vector[i] == i);
+	}
+
+	vector.reset();
+	CHECK(vector.is_empty());
+	CHECK(vector.is_inline());
+}
+
+TEST_CASE("[SmallVector] Remove.") {
+	SmallVector<int, 2> vector{ 0, 1, 2, 3, 4 };
+
+	vector.remove_at(0);
+	CHECK(vector.size() == 4);
+	CHECK(vector[0] == 1);
+	CHECK(vector[3] == 4);
+
+	vector.remove_at_unordered(0);
+	CHECK(vector.size() == 3);
+	CHECK(vector[0] == 4);
+	CHECK(vector.find(2) == 1);
+	CHECK(vector.find(1) == -1);
+}
+
+TEST_CASE("[SmallVector] Copy non-trivial elements.") {
+	SmallVector<String, 2> vector;
+	vector.push_back("a");
+	vector.push_back("b");
+	vector.push_back("c");
+
+	SmallVector<String, 2> copy = vector;
+	vector[0] = "changed";
+	CHECK(copy.size() == 3);
+	CHECK(copy[0] == "a");
+	CHECK(copy[2] == "c");
+
+	Vector<String> converted = copy;
+	CHECK(converted.size() == 3);
+	CHECK(converted[1] == "b");
+}
+
+TEST_CASE("[SmallVector] Stored in a LocalVector.") {
+	// Growing the LocalVector moves the SmallVectors bitwise, inline elements must still be found.
+	LocalVector<SmallVector<int, 4>> vectors;
+	for (int i = 0; i < 64; i++) {
+		SmallVector<int, 4> vector;
+		for (int j = 0; j <= i % 8; j++) {
+			vector.push_back(i * 10 + j);
+		}
+		vectors.push_back(vector);
+	}
+	for (int i = 0; i < 64; i++) {
+		CHECK(vectors[i].size() == uint32_t(i % 8 + 1));
+		CHECK(vectors[i].is_inline() == (i % 8 < 4));
+		CHECK(vectors[i][0] == i * 10);
+		CHECK(vectors[i][i % 8] == i * 10 + i % 8);
+	}
+}
+
+} // namespace TestSmallVector
+
+#endif // TEST_SMALL_VECTOR_H
@@ -0,0 +1,135 @@
+/**************************************************************************/
+/*  test_audio_decode_ring.h                                              */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_AUDIO_DECODE_RING_H
+#define TEST_AUDIO_DECODE_RING_H
+
+#include "servers/audio/audio_decode_ring.h"
+
+#include "tests/test_macros.h"
+
+namespace TestAudioDecodeRing {
+
+// Produces frames numbered from `position`, up to `length`.
+struct CountingDecoder {
+	int position = 0;
+	int length = 0;
+
+	static int decode(void *p_userdata, AudioFrame *p_buffer, int p_frames) {
+		CountingDecoder *decoder = (CountingDecoder *)p_userdata;
+		int decoded = MIN(p_frames, decoder->length - decoder->position);
+		for (int i = 0; i < decoded; i++) {
+			p_buffer[i] = AudioFrame(decoder->position + i, -(decoder->position + i));
+		}
+		decoder->position += decoded;
+		return decoded;
+	}
+};
+
+TEST_CASE("[Audio][DecodeRing] Reset decodes the first chunk right away") {
+	CountingDecoder decoder;
+	decoder.length = 1000;
+
+	AudioDecodeRing ring;
+	ring.init(&CountingDecoder::decode, &decoder, 256, 64);
+	{
+		MutexLock lock(ring.get_decode_mutex());
+		ring.reset();
+	}
+	CHECK(ring.get_buffered_frames() == 64);
+
+	AudioFrame frames[100];
+	CHECK(ring.read(frames, 100) == 64);
+	for (int i = 0; i < 64; i++) {
+		CHECK(frames[i].l == i);
+		CHECK(frames[i].r == -i);
+	}
+	CHECK_FALSE(ring.is_finished());
+}
+
+TEST_CASE("[Audio][DecodeRing] Worker decodes ahead until the stream ends") {
+	CountingDecoder decoder;
+	decoder.length = 1000;
+
+	AudioDecodeRing ring;
+	ring.init(&CountingDecoder::decode, &decoder, 256, 64);
+	{
+		MutexLock lock(ring.get_decode_mutex());
+		ring.reset();
+	}
+
+	// Read in odd sizes, so reads wrap around the end of the ring.
+	AudioFrame frames[37];
+	int expected = 0;
+	bool in_order = true;
+	while (!ring.is_finished() && expected <= decoder.length) {
+		int read = ring.read(frames, 37);
+		for (int i = 0; i < read; i++) {
+			in_order = in_order && frames[i].l == expected;
+			expected++;
+		}
+		ring.request_decode();
+		ring.finish();
+	}
+	CHECK(in_order);
+	CHECK(expected == decoder.length);
+	CHECK(ring.is_finished());
+}
+
+TEST_CASE("[Audio][DecodeRing] Reset discards frames decoded before a seek") {
+	CountingDecoder decoder;
+	decoder.length = 1000;
+
+	AudioDecodeRing ring;
+	ring.init(&CountingDecoder::decode, &decoder, 256, 64);
+	{
+		MutexLock lock(ring.get_decode_mutex());
+		ring.reset();
+	}
+	ring.request_decode();
+	ring.finish();
+	CHECK(ring.get_buffered_frames() == 256);
+
+	{
+		MutexLock lock(ring.get_decode_mutex());
+		decoder.position = 500;
+		ring.reset();
+	}
+	CHECK(ring.get_buffered_frames() == 64);
+
+	AudioFrame frames[64];
+	CHECK(ring.read(frames, 64) == 64);
+	CHECK(frames[0].l == 500);
+	CHECK(frames[63].l == 563);
+}
+
+} // namespace TestAudioDecodeRing
+
+#endif // TEST_AUDIO_DECODE_RING_H
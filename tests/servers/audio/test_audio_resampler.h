@@ -0,0 +1,164 @@
+/**************************************************************************/
+/*  test_audio_resampler.h                                                */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_AUDIO_RESAMPLER_H
+#define TEST_AUDIO_RESAMPLER_H
+
+#include "servers/audio/audio_resampler.h"
+
+#include "tests/test_macros.h"
+
+namespace TestAudioResampler {
+
+constexpr int SOURCE_FRAMES = 4096;
+
+// Sine wave with `p_frequency` cycles per frame, preceded by enough silent history for every kernel.
+static LocalVector<AudioFrame> gen_source(double p_frequency) {
+	LocalVector<AudioFrame> source;
+	source.resize(AudioResampler::MAX_HISTORY + SOURCE_FRAMES);
+	for (int i = 0; i < AudioResampler::MAX_HISTORY; i++) {
+		source[i] = AudioFrame(0, 0);
+	}
+	for (int i = 0; i < SOURCE_FRAMES; i++) {
+		source[AudioResampler::MAX_HISTORY + i] = AudioFrame(Math::sin(Math_TAU * p_frequency * i), Math::cos(Math_TAU * p_frequency * i));
+	}
+	return source;
+}
+
+// Output frames that can be produced from the source, starting at p_offset.
+static int get_output_frames(uint64_t p_offset, uint64_t p_increment) {
+	return ((uint64_t(SOURCE_FRAMES) << AudioResampler::FP_BITS) - p_offset) / p_increment;
+}
+
+// Largest difference between the resampled sine and the exact one.
+static float measure_error(AudioResampler::Quality p_quality, double p_frequency, uint64_t p_increment) {
+	LocalVector<AudioFrame> source = gen_source(p_frequency);
+	// Skip the start, where the kernels still read the silent history.
+	const uint64_t offset = uint64_t(AudioResampler::MAX_HISTORY) << AudioResampler::FP_BITS;
+	const int frames = get_output_frames(offset, p_increment);
+	LocalVector<AudioFrame> output;
+	output.resize(frames);
+
+	AudioResampler::resample(p_quality, source.ptr() + AudioResampler::MAX_HISTORY, output.ptr(), frames, offset, p_increment);
+
+	// Kernels interpolate around the middle of the frames they read.
+	const double delay = (AudioResampler::get_history(p_quality) + 1) / 2;
+	float error = 0.0f;
+	for (int i = 0; i < frames; i++) {
+		double position = double(offset + i * p_increment) / AudioResampler::FP_LEN - delay;
+		error = MAX(error, Math::abs(output[i].l - float(Math::sin(Math_TAU * p_frequency * position))));
+		error = MAX(error, Math::abs(output[i].r - float(Math::cos(Math_TAU * p_frequency * position))));
+	}
+	return error;
+}
+
+TEST_CASE("[Audio][Resampler] Cubic kernel matches per-frame cubic interpolation") {
+	LocalVector<AudioFrame> source = gen_source(0.17);
+	const AudioFrame *src = source.ptr() + AudioResampler::MAX_HISTORY;
+	const uint64_t increment = uint64_t(0.813 * AudioResampler::FP_LEN);
+	// Odd, so the scalar tail is covered too.
+	const int frames = 333;
+
+	LocalVector<AudioFrame> output;
+	output.resize(frames);
+	AudioResampler::resample(AudioResampler::QUALITY_CUBIC, src, output.ptr(), frames, 0, increment);
+
+	bool identical = true;
+	uint64_t offset = 0;
+	for (int i = 0; i < frames; i++) {
+		int idx = offset >> AudioResampler::FP_BITS;
+		float mu = (offset & AudioResampler::FP_MASK) / float(AudioResampler::FP_LEN);
+		AudioFrame y0 = src[idx - 3];
+		AudioFrame y1 = src[idx - 2];
+		AudioFrame y2 = src[idx - 1];
+		AudioFrame y3 = src[idx - 0];
+
+		float mu2 = mu * mu;
+		AudioFrame a0 = 3 * y1 - 3 * y2 + y3 - y0;
+		AudioFrame a1 = 2 * y0 - 5 * y1 + 4 * y2 - y3;
+		AudioFrame a2 = y2 - y0;
+		AudioFrame a3 = 2 * y1;
+		AudioFrame expected = (a0 * mu * mu2 + a1 * mu2 + a2 * mu + a3) / 2;
+
+		identical = identical && output[i].l == expected.l && output[i].r == expected.r;
+		offset += increment;
+	}
+	CHECK_MESSAGE(identical, "The cubic kernel should give exactly the same results as before.");
+}
+
+TEST_CASE("[Audio][Resampler] Sinc kernels keep constant signals unchanged") {
+	LocalVector<AudioFrame> source;
+	source.resize(AudioResampler::MAX_HISTORY + SOURCE_FRAMES);
+	for (uint32_t i = 0; i < source.size(); i++) {
+		source[i] = AudioFrame(0.5, -0.25);
+	}
+
+	const double speeds[] = { 0.7, 1.0, 1.3, 1.9 };
+	for (int quality = AudioResampler::QUALITY_SINC_8; quality <= AudioResampler::QUALITY_SINC_16; quality++) {
+		AudioResampler::set_quality(AudioResampler::Quality(quality));
+		for (double speed : speeds) {
+			const uint64_t increment = uint64_t(speed * AudioResampler::FP_LEN);
+			const int frames = get_output_frames(0, increment);
+			LocalVector<AudioFrame> output;
+			output.resize(frames);
+			AudioResampler::resample(AudioResampler::Quality(quality), source.ptr() + AudioResampler::MAX_HISTORY, output.ptr(), frames, 0, increment);
+
+			float error = 0.0f;
+			for (int i = 0; i < frames; i++) {
+				error = MAX(error, Math::abs(output[i].l - 0.5f));
+				error = MAX(error, Math::abs(output[i].r + 0.25f));
+			}
+			CHECK(error < 1e-5);
+		}
+	}
+	AudioResampler::set_quality(AudioResampler::QUALITY_CUBIC);
+}
+
+TEST_CASE("[Audio][Resampler] Sinc kernels keep high frequencies more accurately") {
+	AudioResampler::set_quality(AudioResampler::QUALITY_SINC_8);
+	AudioResampler::set_quality(AudioResampler::QUALITY_SINC_16);
+	AudioResampler::set_quality(AudioResampler::QUALITY_CUBIC);
+
+	// Upsampling, as when playing 22050 Hz samples at 44100 Hz with a slight pitch change.
+	const uint64_t increment = uint64_t(0.73 * AudioResampler::FP_LEN);
+	const double frequencies[] = { 0.1, 0.2, 0.3 };
+	for (double frequency : frequencies) {
+		const float cubic_error = measure_error(AudioResampler::QUALITY_CUBIC, frequency, increment);
+		const float sinc_8_error = measure_error(AudioResampler::QUALITY_SINC_8, frequency, increment);
+		const float sinc_16_error = measure_error(AudioResampler::QUALITY_SINC_16, frequency, increment);
+		CHECK(sinc_8_error < cubic_error);
+		CHECK(sinc_16_error < sinc_8_error);
+	}
+	CHECK(measure_error(AudioResampler::QUALITY_SINC_16, 0.3, increment) < 0.01);
+}
+
+} // namespace TestAudioResampler
+
+#endif // TEST_AUDIO_RESAMPLER_H
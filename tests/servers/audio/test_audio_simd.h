@@ -0,0 +1,182 @@
+/**************************************************************************/
+/*  test_audio_simd.h                                                     */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_AUDIO_SIMD_H
+#define TEST_AUDIO_SIMD_H
+
+#include "servers/audio/audio_filter_sw.h"
+#include "servers/audio/audio_simd.h"
+#include "servers/audio/effects/eq_filter.h"
+
+#include "tests/test_macros.h"
+
+namespace TestAudioSIMD {
+
+// Odd, so the scalar tails of the kernels are covered too.
+constexpr int FRAME_COUNT = 67;
+
+Vector<AudioFrame> gen_frames(int p_count) {
+	Vector<AudioFrame> frames;
+	frames.resize(p_count);
+	for (int i = 0; i < p_count; i++) {
+		frames.write[i] = AudioFrame(Math::sin(i * 0.37f), Math::cos(i * 0.21f) * 0.5f);
+	}
+	return frames;
+}
+
+TEST_CASE("[Audio][SIMD] Volume ramp matches the scalar mix") {
+	Vector<AudioFrame> src = gen_frames(FRAME_COUNT);
+	Vector<AudioFrame> dst = gen_frames(FRAME_COUNT);
+	Vector<AudioFrame> expected = dst;
+	AudioFrame vol_start = AudioFrame(0.25f, 1.0f);
+	AudioFrame vol_final = AudioFrame(0.75f, 0.0f);
+
+	for (int i = 0; i < FRAME_COUNT; i++) {
+		float lerp_param = (float)i / FRAME_COUNT;
+		expected.write[i] += (vol_final * lerp_param + (1 - lerp_param) * vol_start) * src[i];
+	}
+
+	audio_simd_mix_ramp(dst.ptrw(), src.ptr(), vol_start, vol_final, FRAME_COUNT, true);
+
+	for (int i = 0; i < FRAME_COUNT; i++) {
+		CHECK(dst[i].l == doctest::Approx(expected[i].l));
+		CHECK(dst[i].r == doctest::Approx(expected[i].r));
+	}
+
+	audio_simd_mix_ramp(dst.ptrw(), src.ptr(), vol_start, vol_start, FRAME_COUNT, false);
+
+	for (int i = 0; i < FRAME_COUNT; i++) {
+		CHECK(dst[i].l == doctest::Approx(src[i].l * vol_start.l));
+		CHECK(dst[i].r == doctest::Approx(src[i].r * vol_start.r));
+	}
+}
+
+TEST_CASE("[Audio][SIMD] Scaling reports the peak of each channel") {
+	Vector<AudioFrame> frames = gen_frames(FRAME_COUNT);
+	frames.write[FRAME_COUNT - 1] = AudioFrame(-3.0f, 0.1f);
+	frames.write[10] = AudioFrame(0.1f, 2.0f);
+
+	AudioFrame peak = audio_simd_scale_peak(frames.ptrw(), 0.5f, FRAME_COUNT);
+
+	CHECK(peak.l == doctest::Approx(1.5f));
+	CHECK(peak.r == doctest::Approx(1.0f));
+	CHECK(frames[FRAME_COUNT - 1].l == doctest::Approx(-1.5f));
+	CHECK(frames[10].r == doctest::Approx(1.0f));
+}
+
+TEST_CASE("[Audio][SIMD] Per-frame gains and accumulation") {
+	Vector<AudioFrame> src = gen_frames(FRAME_COUNT);
+	Vector<AudioFrame> dst;
+	dst.resize(FRAME_COUNT);
+	Vector<float> gains;
+	gains.resize(FRAME_COUNT);
+	for (int i = 0; i < FRAME_COUNT; i++) {
+		gains.write[i] = i * 0.1f;
+	}
+
+	audio_simd_apply_gains(dst.ptrw(), src.ptr(), gains.ptr(), FRAME_COUNT);
+	audio_simd_mix(dst.ptrw(), src.ptr(), FRAME_COUNT);
+
+	for (int i = 0; i < FRAME_COUNT; i++) {
+		CHECK(dst[i].l == doctest::Approx(src[i].l * (gains[i] + 1.0f)));
+		CHECK(dst[i].r == doctest::Approx(src[i].r * (gains[i] + 1.0f)));
+	}
+}
+
+TEST_CASE("[Audio][SIMD] Stereo filter matches two mono processors") {
+	AudioFilterSW filter;
+	filter.set_mode(AudioFilterSW::HIGHSHELF);
+	filter.set_sampling_rate(44100);
+	filter.set_cutoff(2000);
+	filter.set_resonance(1);
+	filter.set_gain(0.5);
+
+	AudioFilterSW::Processor stereo_l, stereo_r, mono_l, mono_r;
+	AudioFilterSW::Processor *processors[4] = { &stereo_l, &stereo_r, &mono_l, &mono_r };
+	for (AudioFilterSW::Processor *processor : processors) {
+		processor->set_filter(&filter);
+		processor->update_coeffs();
+		processor->update_coeffs(FRAME_COUNT); // Interpolates towards the same coefficients.
+	}
+
+	Vector<AudioFrame> frames = gen_frames(FRAME_COUNT);
+	Vector<AudioFrame> expected = frames;
+
+	AudioFilterSW::Processor::process_stereo(&stereo_l, &stereo_r, frames.ptrw(), FRAME_COUNT, true);
+	for (int i = 0; i < FRAME_COUNT; i++) {
+		mono_l.process_one_interp(expected.write[i].l);
+		mono_r.process_one_interp(expected.write[i].r);
+	}
+
+	for (int i = 0; i < FRAME_COUNT; i++) {
+		CHECK(frames[i].l == doctest::Approx(expected[i].l));
+		CHECK(frames[i].r == doctest::Approx(expected[i].r));
+	}
+}
+
+TEST_CASE("[Audio][SIMD] EQ bands match the per-band filters") {
+	EQ eq;
+	eq.set_mix_rate(44100);
+	eq.set_preset_band_mode(EQ::PRESET_6_BANDS);
+	const int band_count = eq.get_band_count();
+
+	Vector<EQ::BandProcess> bands;
+	Vector<EQ::BandProcess> expected_bands;
+	Vector<float> gains;
+	for (int i = 0; i < band_count; i++) {
+		bands.push_back(eq.get_band_processor(i));
+		expected_bands.push_back(eq.get_band_processor(i));
+		gains.push_back(0.5f + i * 0.25f);
+	}
+
+	Vector<AudioFrame> src = gen_frames(FRAME_COUNT);
+	Vector<AudioFrame> dst;
+	dst.resize(FRAME_COUNT);
+
+	// Twice, so the history written back by the first call is used.
+	for (int pass = 0; pass < 2; pass++) {
+		EQ::process_bands(bands.ptrw(), gains.ptr(), band_count, &src[0].l, &dst.write[0].l, FRAME_COUNT, 2);
+
+		for (int i = 0; i < FRAME_COUNT; i++) {
+			float expected = 0;
+			for (int j = 0; j < band_count; j++) {
+				float sample = src[i].l;
+				expected_bands.write[j].process_one(sample);
+				expected += sample * gains[j];
+			}
+			CHECK(dst[i].l == doctest::Approx(expected));
+			CHECK(dst[i].r == 0); // Untouched by the stride.
+		}
+	}
+}
+
+} // namespace TestAudioSIMD
+
+#endif // TEST_AUDIO_SIMD_H
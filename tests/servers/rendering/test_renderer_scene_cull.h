@@ -0,0 +1,102 @@
+/**************************************************************************/
+/*  test_renderer_scene_cull.h                                            */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_RENDERER_SCENE_CULL_H
+#define TEST_RENDERER_SCENE_CULL_H
+
+#include "servers/rendering/renderer_scene_cull.h"
+
+#include "core/math/random_pcg.h"
+
+#include "tests/test_macros.h"
+
+namespace TestRendererSceneCull {
+
+typedef RendererSceneCull::InstanceBounds InstanceBounds;
+typedef RendererSceneCull::InstanceBoundsBlock InstanceBoundsBlock;
+typedef RendererSceneCull::Frustum Frustum;
+
+static void fill_random_bounds(PagedArray<InstanceBounds> &r_bounds, uint32_t p_count, RandomPCG &p_rng) {
+	for (uint32_t i = 0; i < p_count; i++) {
+		Vector3 position(p_rng.random(-500.0f, 500.0f), p_rng.random(-50.0f, 50.0f), p_rng.random(-500.0f, 500.0f));
+		Vector3 size(p_rng.random(0.1f, 10.0f), p_rng.random(0.1f, 10.0f), p_rng.random(0.1f, 10.0f));
+		r_bounds.push_back(InstanceBounds(AABB(position, size)));
+	}
+}
+
+static Frustum make_frustum(const Vector3 &p_origin, const Vector3 &p_target) {
+	Projection projection;
+	projection.set_perspective(75.0, 16.0 / 9.0, 0.05, 300.0);
+	return Frustum(projection.get_projection_planes(Transform3D().looking_at(p_target - p_origin).translated(p_origin)));
+}
+
+TEST_CASE("[RendererSceneCull] Block frustum culling matches per-instance culling") {
+	PagedArrayPool<InstanceBounds> pool;
+	PagedArray<InstanceBounds> bounds;
+	bounds.set_page_pool(&pool);
+
+	RandomPCG rng(1234);
+	// Not a multiple of the block size, so the last block is partial.
+	const uint32_t count = 10000 + InstanceBoundsBlock::SIZE / 2;
+	fill_random_bounds(bounds, count, rng);
+
+	const Vector3 origins[] = { Vector3(), Vector3(100, 10, -50), Vector3(-400, 0, 400) };
+	const Vector3 targets[] = { Vector3(0, 0, -1), Vector3(0, -20, 300), Vector3(400, 0, -400) };
+	for (int f = 0; f < 3; f++) {
+		const Frustum frustum = make_frustum(origins[f], targets[f]);
+		InstanceBoundsBlock block;
+		uint32_t mismatches = 0;
+		uint32_t visible = 0;
+		for (uint32_t i = 0; i < count; i += InstanceBoundsBlock::SIZE) {
+			block.load(bounds, i, count - i);
+			const uint32_t mask = block.cull(frustum);
+			for (uint32_t j = 0; j < block.count; j++) {
+				const bool in_block = (mask >> j) & 1;
+				if (in_block != bounds[i + j].in_frustum(frustum)) {
+					mismatches++;
+				}
+				visible += in_block;
+			}
+			if (block.count < InstanceBoundsBlock::SIZE) {
+				CHECK_MESSAGE((mask >> block.count) == 0, "Bits past the end of a partial block should never be set.");
+			}
+		}
+		CHECK_MESSAGE(mismatches == 0, "Block culling should give the same result as culling each instance.");
+		CHECK(visible > 0);
+		CHECK(visible < count);
+	}
+
+	bounds.reset();
+	pool.reset();
+}
+
+} // namespace TestRendererSceneCull
+
+#endif // TEST_RENDERER_SCENE_CULL_H
@@ -0,0 +1,163 @@
+/**************************************************************************/
+/*  test_physics_server_2d.h                                              */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_PHYSICS_SERVER_2D_H
+#define TEST_PHYSICS_SERVER_2D_H
+
+#include "servers/physics_2d/godot_physics_server_2d.h"
+
+#include "tests/test_macros.h"
+
+namespace TestPhysicsServer2D {
+
+static const real_t STEP = 1.0 / 60.0;
+
+static RID create_space(PhysicsServer2D *p_server) {
+	RID space = p_server->space_create();
+	p_server->space_set_active(space, true);
+	p_server->area_set_param(space, PhysicsServer2D::AREA_PARAM_GRAVITY, 980.0);
+	p_server->area_set_param(space, PhysicsServer2D::AREA_PARAM_GRAVITY_VECTOR, Vector2(0, 1));
+	p_server->space_set_param(space, PhysicsServer2D::SPACE_PARAM_CONTACT_RECYCLE_RADIUS, 1.0);
+	p_server->space_set_param(space, PhysicsServer2D::SPACE_PARAM_BODY_LINEAR_VELOCITY_SLEEP_THRESHOLD, 2.0);
+	p_server->space_set_param(space, PhysicsServer2D::SPACE_PARAM_BODY_ANGULAR_VELOCITY_SLEEP_THRESHOLD, Math::deg_to_rad(8.0));
+	p_server->space_set_param(space, PhysicsServer2D::SPACE_PARAM_BODY_TIME_TO_SLEEP, 0.5);
+	return space;
+}
+
+static RID create_box(PhysicsServer2D *p_server, RID p_space, PhysicsServer2D::BodyMode p_mode, const Vector2 &p_position, const Vector2 &p_half_extents) {
+	RID shape = p_server->rectangle_shape_create();
+	p_server->shape_set_data(shape, p_half_extents);
+	RID body = p_server->body_create();
+	p_server->body_set_mode(body, p_mode);
+	p_server->body_add_shape(body, shape);
+	p_server->body_set_state(body, PhysicsServer2D::BODY_STATE_TRANSFORM, Transform2D(0, p_position));
+	p_server->body_set_space(body, p_space);
+	return body;
+}
+
+static void free_body(PhysicsServer2D *p_server, RID p_body) {
+	RID shape = p_server->body_get_shape(p_body, 0);
+	p_server->free(p_body);
+	p_server->free(shape);
+}
+
+static void step(PhysicsServer2D *p_server, int p_steps) {
+	for (int i = 0; i < p_steps; i++) {
+		p_server->sync();
+		p_server->flush_queries();
+		p_server->end_sync();
+		p_server->step(STEP);
+	}
+}
+
+TEST_CASE("[PhysicsServer2D] Contact normals follow a rotating platform") {
+	PhysicsServer2D *server = memnew(GodotPhysicsServer2D);
+	server->init();
+	server->set_active(true);
+	RID space = create_space(server);
+
+	RID platform = create_box(server, space, PhysicsServer2D::BODY_MODE_KINEMATIC, Vector2(), Vector2(200, 10));
+	RID box = create_box(server, space, PhysicsServer2D::BODY_MODE_RIGID, Vector2(0, -20), Vector2(10, 10));
+	server->body_set_max_contacts_reported(box, 4);
+	step(server, 60);
+
+	// Slower than the rotation that forces a new collision test on its own, so that the box keeps
+	// resting on the platform and contacts would be reused for as long as the pair rotates together.
+	const real_t angular_step = 0.005;
+	bool normals_follow = true;
+	for (int i = 1; i <= 60; i++) {
+		server->body_set_state(platform, PhysicsServer2D::BODY_STATE_TRANSFORM, Transform2D(angular_step * i, Vector2()));
+		step(server, 1);
+
+		const Transform2D platform_xform = server->body_get_state(platform, PhysicsServer2D::BODY_STATE_TRANSFORM);
+		const Vector2 platform_up = -platform_xform.columns[1].normalized();
+		PhysicsDirectBodyState2D *state = server->body_get_direct_state(box);
+		REQUIRE(state);
+		REQUIRE(state->get_contact_count() > 0);
+		for (int j = 0; j < state->get_contact_count(); j++) {
+			// Up to the rotation allowed before contacts are updated.
+			normals_follow &= Math::abs(state->get_contact_local_normal(j).dot(platform_up)) > Math::cos(real_t(0.02));
+		}
+	}
+	CHECK(normals_follow);
+	CHECK(server->body_get_state(platform, PhysicsServer2D::BODY_STATE_TRANSFORM).operator Transform2D().get_rotation() == doctest::Approx(angular_step * 60));
+
+	free_body(server, box);
+	free_body(server, platform);
+	server->free(space);
+	server->finish();
+	memdelete(server);
+}
+
+TEST_CASE("[PhysicsServer2D] Active and sleeping islands") {
+	PhysicsServer2D *server = memnew(GodotPhysicsServer2D);
+	server->init();
+	server->set_active(true);
+	RID space = create_space(server);
+
+	RID floor = create_box(server, space, PhysicsServer2D::BODY_MODE_STATIC, Vector2(), Vector2(1000, 10));
+	// A stack of two boxes, and a box on its own. The static floor doesn't connect them.
+	RID bottom = create_box(server, space, PhysicsServer2D::BODY_MODE_RIGID, Vector2(-200, -20), Vector2(10, 10));
+	RID top = create_box(server, space, PhysicsServer2D::BODY_MODE_RIGID, Vector2(-200, -40), Vector2(10, 10));
+	RID single = create_box(server, space, PhysicsServer2D::BODY_MODE_RIGID, Vector2(200, -20), Vector2(10, 10));
+
+	step(server, 5);
+	CHECK(server->get_process_info(PhysicsServer2D::INFO_ACTIVE_ISLAND_COUNT) == 2);
+	CHECK(server->get_process_info(PhysicsServer2D::INFO_SLEEPING_ISLAND_COUNT) == 0);
+
+	step(server, 300);
+	CHECK(bool(server->body_get_state(top, PhysicsServer2D::BODY_STATE_SLEEPING)));
+	CHECK(bool(server->body_get_state(single, PhysicsServer2D::BODY_STATE_SLEEPING)));
+	CHECK(server->get_process_info(PhysicsServer2D::INFO_ACTIVE_ISLAND_COUNT) == 0);
+	CHECK(server->get_process_info(PhysicsServer2D::INFO_SLEEPING_ISLAND_COUNT) == 2);
+
+	// Moving a body of the stack wakes up the whole island.
+	server->body_apply_central_impulse(top, Vector2(50, 0));
+	step(server, 1);
+	CHECK_FALSE(bool(server->body_get_state(bottom, PhysicsServer2D::BODY_STATE_SLEEPING)));
+	CHECK(server->get_process_info(PhysicsServer2D::INFO_ACTIVE_ISLAND_COUNT) == 1);
+	CHECK(server->get_process_info(PhysicsServer2D::INFO_SLEEPING_ISLAND_COUNT) == 1);
+
+	// Removing the last sleeping body of an island removes the island.
+	free_body(server, single);
+	step(server, 1);
+	CHECK(server->get_process_info(PhysicsServer2D::INFO_SLEEPING_ISLAND_COUNT) == 0);
+
+	free_body(server, top);
+	free_body(server, bottom);
+	free_body(server, floor);
+	server->free(space);
+	server->finish();
+	memdelete(server);
+}
+
+} // namespace TestPhysicsServer2D
+
+#endif // TEST_PHYSICS_SERVER_2D_H